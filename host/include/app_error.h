@@ -0,0 +1,60 @@
+/** @file app_error.h
+ *
+ * @brief Host stand-in for nRF SDK error handler.
+ *
+ * @details Errors end up in app_error_fault_handler of @ref blesc_error,
+ *          whose reset stand-in stops the simulation.
+ */
+
+#ifndef APP_ERROR_H__
+#define APP_ERROR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+#include "nordic_common.h"
+
+#define NRF_FAULT_ID_SDK_RANGE_START (0x00004000)
+#define NRF_FAULT_ID_SDK_ERROR       (NRF_FAULT_ID_SDK_RANGE_START + 1)
+#define NRF_FAULT_ID_SDK_ASSERT      (NRF_FAULT_ID_SDK_RANGE_START + 2)
+
+/** Information about an error, passed to app_error_fault_handler. */
+typedef struct {
+    uint32_t        line_num;    /**< Line number of the error. */
+    uint8_t const * p_file_name; /**< File name of the error. */
+    uint32_t        err_code;    /**< Error code. */
+} error_info_t;
+
+/** Information about a failed assertion, passed to app_error_fault_handler. */
+typedef struct {
+    uint16_t        line_num;    /**< Line number of the assertion. */
+    uint8_t const * p_file_name; /**< File name of the assertion. */
+} assert_info_t;
+
+void app_error_fault_handler(uint32_t id, uint32_t pc, uint32_t info);
+
+void app_error_handler(uint32_t error_code, uint32_t line_num, const uint8_t * p_file_name);
+
+void assert_nrf_callback(uint16_t line_num, const uint8_t * p_file_name);
+
+#define APP_ERROR_HANDLER(ERR_CODE) \
+    do {                            \
+        app_error_handler((ERR_CODE), __LINE__, (uint8_t *)__FILE__); \
+    } while (0)
+
+#define APP_ERROR_CHECK(ERR_CODE)                  \
+    do {                                           \
+        const uint32_t LOCAL_ERR_CODE = (ERR_CODE); \
+        if (LOCAL_ERR_CODE != NRF_SUCCESS) {       \
+            APP_ERROR_HANDLER(LOCAL_ERR_CODE);     \
+        }                                          \
+    } while (0)
+
+#define ASSERT(expr)                                                  \
+    do {                                                              \
+        if (!(expr)) {                                                \
+            assert_nrf_callback((uint16_t)__LINE__, (uint8_t *)__FILE__); \
+        }                                                             \
+    } while (0)
+
+#endif // APP_ERROR_H__
@@ -0,0 +1,63 @@
+/** @file app_timer.h
+ *
+ * @brief Host stand-in for app_timer on the virtual 32768 Hz RTC.
+ */
+
+#ifndef APP_TIMER_H__
+#define APP_TIMER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_config.h"
+#include "sdk_errors.h"
+#include "nordic_common.h"
+#include "app_util.h"
+
+#define APP_TIMER_CLOCK_FREQ        32768                  /**< Clock frequency of the RTC timer used to implement the app timer module. */
+#define APP_TIMER_MIN_TIMEOUT_TICKS 5                      /**< Minimum value of the timeout_ticks parameter of app_timer_start(). */
+#define APP_TIMER_MAX_CNT_VAL       0x00FFFFFF             /**< Maximum counter value that can be returned by app_timer_cnt_get. */
+
+/** Convert milliseconds to timer ticks. */
+#define APP_TIMER_TICKS(MS)                                \
+            ((uint32_t)ROUNDED_DIV(                        \
+            (MS) * (uint64_t)APP_TIMER_CLOCK_FREQ,         \
+            1000 * (APP_TIMER_CONFIG_RTC_FREQUENCY + 1)))
+
+/** Application time-out handler type. */
+typedef void (*app_timer_timeout_handler_t)(void * p_context);
+
+/** Timer modes. */
+typedef enum {
+    APP_TIMER_MODE_SINGLE_SHOT, /**< The timer will expire only once. */
+    APP_TIMER_MODE_REPEATED     /**< The timer will restart each time it expires. */
+} app_timer_mode_t;
+
+/** Timer node. */
+typedef struct app_timer_s {
+    struct app_timer_s *        next;         /**< Next timer in the list of created timers. */
+    uint64_t                    expiry;       /**< Virtual RTC tick the timer expires at. */
+    uint32_t                    generation;   /**< Bumped on every start and stop, expiry events of an older run are dropped. */
+    uint32_t                    period;       /**< Timer period (for repeating timers). */
+    app_timer_mode_t            mode;         /**< Timer mode. */
+    bool                        is_running;   /**< True if timer is running, False otherwise. */
+    bool                        is_created;   /**< True if the timer is in the list of created timers. */
+    app_timer_timeout_handler_t handler;      /**< User handler for the timer. */
+    void *                      p_context;    /**< General purpose pointer. Will be passed to the timeout handler when the timer expires. */
+} app_timer_t;
+
+typedef app_timer_t * app_timer_id_t;
+
+/** Create a timer identifier and statically allocate memory for the timer. */
+#define APP_TIMER_DEF(timer_id)                       \
+    static app_timer_t CONCAT_2(timer_id,_data) = {0}; \
+    static const app_timer_id_t timer_id = &CONCAT_2(timer_id,_data)
+
+ret_code_t app_timer_init(void);
+ret_code_t app_timer_create(app_timer_id_t const * p_timer_id, app_timer_mode_t mode, app_timer_timeout_handler_t timeout_handler);
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context);
+ret_code_t app_timer_stop(app_timer_id_t timer_id);
+ret_code_t app_timer_stop_all(void);
+uint32_t app_timer_cnt_get(void);
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from);
+
+#endif // APP_TIMER_H__
@@ -0,0 +1,35 @@
+/** @file app_util.h
+ *
+ * @brief Host stand-in for nRF SDK utility macros.
+ */
+
+#ifndef APP_UTIL_H__
+#define APP_UTIL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "nordic_common.h"
+
+#define STATIC_ASSERT(EXPR) _Static_assert((EXPR), #EXPR)
+
+#define ROUNDED_DIV(A, B)  (((A) + ((B) / 2)) / (B))
+#define CEIL_DIV(A, B)     (((A) + (B) - 1) / (B))
+
+#define BOOTLOADER_ADDRESS 0xFFFFFFFF /**< No bootloader on host */
+
+#define MSEC_TO_UNITS(TIME, RESOLUTION) (((TIME) * 1000) / (RESOLUTION))
+
+enum {
+    UNIT_0_625_MS = 625,
+    UNIT_1_25_MS  = 1250,
+    UNIT_10_MS    = 10000
+};
+
+#ifndef __ALIGN
+#define __ALIGN(n) __attribute__((aligned(n)))
+#endif
+#ifndef __WEAK
+#define __WEAK __attribute__((weak))
+#endif
+
+#endif // APP_UTIL_H__
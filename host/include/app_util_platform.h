@@ -0,0 +1,21 @@
+/** @file app_util_platform.h
+ *
+ * @brief Host stand-in for nRF SDK platform utilities.
+ *
+ * @details Simulation runs interrupt handlers from the main loop,
+ *          so critical regions need no locking.
+ */
+
+#ifndef APP_UTIL_PLATFORM_H__
+#define APP_UTIL_PLATFORM_H__
+
+#include <stdint.h>
+#include "nrf.h"
+#include "nrf_soc.h"
+#include "app_util.h"
+#include "app_error.h"
+
+#define CRITICAL_REGION_ENTER() {
+#define CRITICAL_REGION_EXIT()  }
+
+#endif // APP_UTIL_PLATFORM_H__
@@ -0,0 +1,62 @@
+/** @file ble.h
+ *
+ * @brief Host stand-in for SoftDevice BLE event and configuration API.
+ */
+
+#ifndef BLE_H__
+#define BLE_H__
+
+#include <stdint.h>
+#include "ble_types.h"
+#include "ble_gap.h"
+#include "ble_gatt.h"
+#include "ble_gattc.h"
+#include "ble_gatts.h"
+
+#define BLE_CONN_CFG_BASE  0x20
+#define BLE_CONN_CFG_GAP   (BLE_CONN_CFG_BASE + 0) /**< BLE GAP specific connection configuration. */
+#define BLE_CONN_CFG_GATTC (BLE_CONN_CFG_BASE + 1) /**< BLE GATTC specific connection configuration. */
+#define BLE_CONN_CFG_GATTS (BLE_CONN_CFG_BASE + 2) /**< BLE GATTS specific connection configuration. */
+#define BLE_CONN_CFG_GATT  (BLE_CONN_CFG_BASE + 3) /**< BLE GATT specific connection configuration. */
+
+#define BLE_CONN_CFG_TAG_DEFAULT 0 /**< Default configuration tag. */
+
+/** Common BLE Event header. */
+typedef struct {
+    uint16_t evt_id;  /**< Value from a BLE_<module>_EVT series. */
+    uint16_t evt_len; /**< Length in octets including this header. */
+} ble_evt_hdr_t;
+
+/** Common BLE Event type, wrapping the module specific event reports. */
+typedef struct {
+    ble_evt_hdr_t header; /**< Event header. */
+    union {
+        ble_gap_evt_t   gap_evt;   /**< GAP originated event. */
+        ble_gattc_evt_t gattc_evt; /**< GATT client originated event. */
+        ble_gatts_evt_t gatts_evt; /**< GATT server originated event. */
+    } evt;
+} ble_evt_t;
+
+/** GATTC connection configuration. */
+typedef struct {
+    uint8_t write_cmd_tx_queue_size; /**< Guaranteed minimum number of Write without Response that can be queued. */
+} ble_gattc_conn_cfg_t;
+
+/** BLE connection configuration. */
+typedef struct {
+    uint8_t conn_cfg_tag; /**< The application chosen tag. */
+    union {
+        ble_gattc_conn_cfg_t gattc_conn_cfg; /**< GATTC connection configuration. */
+    } params;
+} ble_conn_cfg_t;
+
+/** Configuration structure used in @ref sd_ble_cfg_set. */
+typedef union {
+    ble_conn_cfg_t conn_cfg; /**< Connection specific configurations. */
+} ble_cfg_t;
+
+uint32_t sd_ble_cfg_set(uint32_t cfg_id, ble_cfg_t const * p_cfg, uint32_t app_ram_base);
+uint32_t sd_ble_uuid_vs_add(ble_uuid128_t const * p_vs_uuid, uint8_t * p_uuid_type);
+uint32_t sd_ble_uuid_vs_remove(uint8_t * p_uuid_type);
+
+#endif // BLE_H__
@@ -0,0 +1,36 @@
+/** @file ble_advdata.h
+ *
+ * @brief Host stand-in for advertising data encoder.
+ */
+
+#ifndef BLE_ADVDATA_H__
+#define BLE_ADVDATA_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_types.h"
+
+/** Advertising data name type. */
+typedef enum {
+    BLE_ADVDATA_NO_NAME,    /**< Include no device name in advertising data. */
+    BLE_ADVDATA_SHORT_NAME, /**< Include short device name in advertising data. */
+    BLE_ADVDATA_FULL_NAME   /**< Include full device name in advertising data. */
+} ble_advdata_name_type_t;
+
+/** UUID list type. */
+typedef struct {
+    uint16_t     uuid_cnt; /**< Number of UUID entries. */
+    ble_uuid_t * p_uuids;  /**< Pointer to UUID array entries. */
+} ble_advdata_uuid_list_t;
+
+/** Advertising data structure. */
+typedef struct {
+    ble_advdata_name_type_t name_type;          /**< Type of device name. */
+    bool                    include_appearance; /**< Determines if Appearance shall be included. */
+    uint8_t                 flags;              /**< Advertising data Flags field. */
+    ble_advdata_uuid_list_t uuids_complete;     /**< List of UUIDs in the 'Complete' list. */
+} ble_advdata_t;
+
+ret_code_t ble_advdata_encode(ble_advdata_t const * const p_advdata, uint8_t * const p_encoded_data, uint16_t * const p_len);
+
+#endif // BLE_ADVDATA_H__
@@ -0,0 +1,42 @@
+/** @file ble_conn_params.h
+ *
+ * @brief Host stand-in for connection parameters negotiation. Peers accept the requested parameters.
+ */
+
+#ifndef BLE_CONN_PARAMS_H__
+#define BLE_CONN_PARAMS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+
+/** Connection Parameters Module event type. */
+typedef enum {
+    BLE_CONN_PARAMS_EVT_FAILED,    /**< Negotiation procedure failed. */
+    BLE_CONN_PARAMS_EVT_SUCCEEDED  /**< Negotiation procedure succeeded. */
+} ble_conn_params_evt_type_t;
+
+/** Connection Parameters Module event. */
+typedef struct {
+    ble_conn_params_evt_type_t evt_type;    /**< Type of event. */
+    uint16_t                   conn_handle; /**< Connection the event refers to. */
+} ble_conn_params_evt_t;
+
+/** Connection Parameters Module event handler type. */
+typedef void (*ble_conn_params_evt_handler_t) (ble_conn_params_evt_t * p_evt);
+
+/** Connection Parameters Module init structure. */
+typedef struct {
+    ble_gap_conn_params_t *       p_conn_params;                  /**< Pointer to the connection parameters desired by the application. */
+    uint32_t                      first_conn_params_update_delay; /**< Time from initiating event to first time sd_ble_gap_conn_param_update is called (in number of timer ticks). */
+    uint32_t                      next_conn_params_update_delay;  /**< Time between each call to sd_ble_gap_conn_param_update after the first (in number of timer ticks). */
+    uint8_t                       max_conn_params_update_count;   /**< Number of attempts before giving up the negotiation. */
+    uint16_t                      start_on_notify_cccd_handle;    /**< If procedure is to be started when notification is started, set this to the handle of the corresponding CCCD. */
+    bool                          disconnect_on_fail;             /**< Set to TRUE if a failed connection parameters update shall cause an automatic disconnection. */
+    ble_conn_params_evt_handler_t evt_handler;                    /**< Event handler to be called for handling events in the Connection Parameters. */
+    void (*error_handler)(uint32_t nrf_error);                    /**< Function to be called in case of an error. */
+} ble_conn_params_init_t;
+
+uint32_t ble_conn_params_init(const ble_conn_params_init_t * p_init);
+
+#endif // BLE_CONN_PARAMS_H__
@@ -0,0 +1,10 @@
+/** @file ble_conn_state.h
+ *
+ * @brief Host stand-in for connection state module.
+ */
+
+#ifndef BLE_CONN_STATE_H__
+#define BLE_CONN_STATE_H__
+
+
+#endif // BLE_CONN_STATE_H__
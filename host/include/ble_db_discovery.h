@@ -0,0 +1,62 @@
+/** @file ble_db_discovery.h
+ *
+ * @brief Host stand-in for database discovery. The peer database is read from the simulated peer after the round trips it would take.
+ */
+
+#ifndef BLE_DB_DISCOVERY_H__
+#define BLE_DB_DISCOVERY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_config.h"
+#include "ble.h"
+#include "ble_gatt_db.h"
+#include "nrf_sdh_ble.h"
+
+/** Macro for defining a ble_db_discovery instance. */
+#define BLE_DB_DISCOVERY_DEF(_name)                                 \
+static ble_db_discovery_t _name = {.discovery_in_progress = 0};     \
+NRF_SDH_BLE_OBSERVER(_name ## _obs,                                 \
+                     BLE_DB_DISC_BLE_OBSERVER_PRIO,                 \
+                     ble_db_discovery_on_ble_evt, &_name)
+
+/** Type of the DB Discovery event. */
+typedef enum {
+    BLE_DB_DISCOVERY_COMPLETE,      /**< Event indicating that the discovery of one service is complete. */
+    BLE_DB_DISCOVERY_ERROR,         /**< Event indicating that an internal error has occurred in the DB Discovery module. */
+    BLE_DB_DISCOVERY_SRV_NOT_FOUND, /**< Event indicating that the service was not found at the peer. */
+    BLE_DB_DISCOVERY_AVAILABLE      /**< Event indicating that the DB discovery instance is available. */
+} ble_db_discovery_evt_type_t;
+
+/** DB Discovery event. */
+typedef struct {
+    ble_db_discovery_evt_type_t evt_type;    /**< Type of event. */
+    uint16_t                    conn_handle; /**< Handle of the connection for which this event has occurred. */
+    union {
+        ble_gatt_db_srv_t discovered_db; /**< Structure containing the information about the GATT Database at the server. */
+        void *            p_db_instance; /**< Pointer to DB discovery instance. */
+        uint32_t          err_code;      /**< nRF Error code indicating the type of error which occurred. */
+    } params;
+} ble_db_discovery_evt_t;
+
+/** DB Discovery event handler type. */
+typedef void (* ble_db_discovery_evt_handler_t)(ble_db_discovery_evt_t * p_evt);
+
+/** DB Discovery structure. */
+typedef struct {
+    ble_gatt_db_srv_t services[1];           /**< Information related to the current service being discovered. */
+    uint8_t           srv_count;             /**< Number of services at the peer's GATT database. */
+    uint8_t           curr_char_ind;         /**< Index of the current characteristic being discovered. */
+    uint8_t           curr_srv_ind;          /**< Index of the current service being discovered. */
+    bool              discovery_in_progress; /**< Variable to indicate if there is a service discovery in progress. */
+    uint8_t           discoveries_count;     /**< Number of service discoveries made. */
+    uint16_t          conn_handle;           /**< Connection handle on which the discovery is started. */
+    uint32_t          generation;            /**< Discovery run, stale replies of an older run are dropped. */
+} ble_db_discovery_t;
+
+uint32_t ble_db_discovery_init(ble_db_discovery_evt_handler_t evt_handler);
+uint32_t ble_db_discovery_start(ble_db_discovery_t * p_db_discovery, uint16_t conn_handle);
+uint32_t ble_db_discovery_evt_register(ble_uuid_t const * p_uuid);
+void ble_db_discovery_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context);
+
+#endif // BLE_DB_DISCOVERY_H__
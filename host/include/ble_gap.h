@@ -0,0 +1,262 @@
+/** @file ble_gap.h
+ *
+ * @brief Host stand-in for SoftDevice Generic Access Profile API.
+ */
+
+#ifndef BLE_GAP_H__
+#define BLE_GAP_H__
+
+#include <stdint.h>
+#include "ble_types.h"
+#include "ble_hci.h"
+
+#define BLE_GAP_EVT_BASE 0x10
+
+/** GAP event IDs. */
+enum BLE_GAP_EVTS {
+    BLE_GAP_EVT_CONNECTED = BLE_GAP_EVT_BASE,   /**< Connected to peer. */
+    BLE_GAP_EVT_DISCONNECTED,                   /**< Disconnected from peer. */
+    BLE_GAP_EVT_CONN_PARAM_UPDATE,              /**< Connection Parameters updated. */
+    BLE_GAP_EVT_SEC_PARAMS_REQUEST,             /**< Request to provide security parameters. */
+    BLE_GAP_EVT_SEC_INFO_REQUEST,               /**< Request to provide security information. */
+    BLE_GAP_EVT_PASSKEY_DISPLAY,                /**< Request to display a passkey to the user. */
+    BLE_GAP_EVT_KEY_PRESSED,                    /**< Notification of a keypress on the remote device. */
+    BLE_GAP_EVT_AUTH_KEY_REQUEST,               /**< Request to provide an authentication key. */
+    BLE_GAP_EVT_LESC_DHKEY_REQUEST,             /**< Request to calculate an LE Secure Connections DHKey. */
+    BLE_GAP_EVT_AUTH_STATUS,                    /**< Authentication procedure completed with status. */
+    BLE_GAP_EVT_CONN_SEC_UPDATE,                /**< Connection security updated. */
+    BLE_GAP_EVT_TIMEOUT,                        /**< Timeout expired. */
+    BLE_GAP_EVT_RSSI_CHANGED,                   /**< RSSI report. */
+    BLE_GAP_EVT_ADV_REPORT,                     /**< Advertising report. */
+    BLE_GAP_EVT_SEC_REQUEST,                    /**< Security Request. */
+    BLE_GAP_EVT_CONN_PARAM_UPDATE_REQUEST,      /**< Connection Parameter Update Request. */
+    BLE_GAP_EVT_SCAN_REQ_REPORT,                /**< Scan request report. */
+    BLE_GAP_EVT_PHY_UPDATE_REQUEST,             /**< PHY Update Request. */
+    BLE_GAP_EVT_PHY_UPDATE,                     /**< PHY Update Procedure is complete. */
+    BLE_GAP_EVT_DATA_LENGTH_UPDATE_REQUEST,     /**< Data Length Update Request. */
+    BLE_GAP_EVT_DATA_LENGTH_UPDATE,             /**< LL Data Channel PDU payload length updated. */
+    BLE_GAP_EVT_QOS_CHANNEL_SURVEY_REPORT,      /**< Channel survey report. */
+    BLE_GAP_EVT_ADV_SET_TERMINATED,             /**< Advertising set terminated. */
+};
+
+#define BLE_GAP_ROLE_INVALID 0x0
+#define BLE_GAP_ROLE_PERIPH  0x1
+#define BLE_GAP_ROLE_CENTRAL 0x2
+
+#define BLE_GAP_TIMEOUT_SRC_SCAN 0x01 /**< Scanning timeout. */
+#define BLE_GAP_TIMEOUT_SRC_CONN 0x02 /**< Connection timeout. */
+
+#define BLE_GAP_ADDR_TYPE_PUBLIC                        0x00
+#define BLE_GAP_ADDR_TYPE_RANDOM_STATIC                 0x01
+#define BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE     0x02
+#define BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_NON_RESOLVABLE 0x03
+#define BLE_GAP_ADDR_TYPE_ANONYMOUS                     0x7F
+
+#define BLE_GAP_ADDR_LEN (6)
+
+#define BLE_GAP_PHY_AUTO  0x00
+#define BLE_GAP_PHY_1MBPS 0x01
+#define BLE_GAP_PHY_2MBPS 0x02
+#define BLE_GAP_PHY_CODED 0x04
+#define BLE_GAP_PHY_NOT_SET 0xFF
+
+#define BLE_GAP_SCAN_FP_ACCEPT_ALL 0x00
+
+#define BLE_GAP_ADV_SET_HANDLE_NOT_SET      (0xFF)
+#define BLE_GAP_ADV_SET_DATA_SIZE_MAX       (31)
+#define BLE_GAP_ADV_TYPE_CONNECTABLE_SCANNABLE_UNDIRECTED 0x01
+#define BLE_GAP_ADV_FP_ANY                  0x00
+#define BLE_GAP_ADV_TIMEOUT_GENERAL_UNLIMITED (0)
+#define BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE (0x06)
+
+#define BLE_GAP_AD_TYPE_FLAGS                         0x01
+#define BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_COMPLETE  0x07
+#define BLE_GAP_AD_TYPE_COMPLETE_LOCAL_NAME           0x09
+#define BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA    0xFF
+
+#define BLE_GAP_SEC_STATUS_PAIRING_NOT_SUPP 0x85
+
+#define BLE_GAP_SCAN_BUFFER_MIN (31)
+
+/** Set sec_mode pointed to by ptr to have no access rights. */
+#define BLE_GAP_CONN_SEC_MODE_SET_OPEN(ptr) do { (ptr)->sm = 1; (ptr)->lv = 1; } while (0)
+
+/** Bluetooth Low Energy address. */
+typedef struct {
+    uint8_t addr_id_peer : 1;           /**< Only valid for peer addresses. */
+    uint8_t addr_type    : 7;           /**< See BLE_GAP_ADDR_TYPES. */
+    uint8_t addr[BLE_GAP_ADDR_LEN];     /**< 48-bit address, LSB format. */
+} ble_gap_addr_t;
+
+/** GAP connection parameters. */
+typedef struct {
+    uint16_t min_conn_interval; /**< Minimum Connection Interval in 1.25 ms units. */
+    uint16_t max_conn_interval; /**< Maximum Connection Interval in 1.25 ms units. */
+    uint16_t slave_latency;     /**< Slave Latency in number of connection events. */
+    uint16_t conn_sup_timeout;  /**< Connection Supervision Timeout in 10 ms units. */
+} ble_gap_conn_params_t;
+
+/** GAP connection security modes. */
+typedef struct {
+    uint8_t sm : 4; /**< Security Mode (1 or 2), 0 for no permissions at all. */
+    uint8_t lv : 4; /**< Level (1, 2, 3 or 4), 0 for no permissions at all. */
+} ble_gap_conn_sec_mode_t;
+
+/** Advertising report type. */
+typedef struct {
+    uint16_t connectable   : 1; /**< Connectable advertising event type. */
+    uint16_t scannable     : 1; /**< Scannable advertising event type. */
+    uint16_t directed      : 1; /**< Directed advertising event type. */
+    uint16_t scan_response : 1; /**< Received a scan response. */
+    uint16_t extended_pdu  : 1; /**< Received an extended advertising set. */
+    uint16_t status        : 2; /**< Data status. */
+    uint16_t reserved      : 9; /**< Reserved for future use. */
+} ble_gap_adv_report_type_t;
+
+/** GAP scanning parameters. */
+typedef struct {
+    uint8_t  extended      : 1; /**< If 1, the scanner will accept extended advertising packets. */
+    uint8_t  report_incomplete_evts : 1; /**< Not supported. */
+    uint8_t  active        : 1; /**< If 1, perform active scanning by sending scan requests. */
+    uint8_t  filter_policy : 2; /**< Scanning filter policy. */
+    uint8_t  scan_phys;         /**< Bitfield of PHYs to scan on. */
+    uint16_t interval;          /**< Scan interval in 625 us units. */
+    uint16_t window;            /**< Scan window in 625 us units. */
+    uint16_t timeout;           /**< Scan timeout in 10 ms units. */
+    uint8_t  channel_mask[5];   /**< Channel mask for primary and secondary advertising channels. */
+} ble_gap_scan_params_t;
+
+/** GAP advertising parameters. */
+typedef struct {
+    struct {
+        uint8_t type;            /**< Advertising type. */
+        uint8_t anonymous  : 1;  /**< Omit advertiser's address from all PDUs. */
+        uint8_t include_tx_power : 1; /**< Include TxPower. */
+    } properties;                    /**< The properties of the advertising events. */
+    ble_gap_addr_t const * p_peer_addr; /**< Address of a known peer. */
+    uint32_t interval;               /**< Advertising interval in 625 us units. */
+    uint16_t duration;               /**< Advertising duration in 10 ms units. */
+    uint8_t  max_adv_evts;           /**< Maximum advertising events. */
+    uint8_t  channel_mask[5];        /**< Channel mask for primary and secondary advertising channels. */
+    uint8_t  filter_policy;          /**< Filter Policy. */
+    uint8_t  primary_phy;            /**< Primary advertising PHY. */
+    uint8_t  secondary_phy;          /**< Secondary advertising PHY. */
+    uint8_t  set_id : 4;             /**< Advertising Set ID. */
+    uint8_t  scan_req_notification : 1; /**< Enable scan request notifications. */
+} ble_gap_adv_params_t;
+
+/** GAP advertising data buffers. */
+typedef struct {
+    ble_data_t adv_data;      /**< Advertising data. */
+    ble_data_t scan_rsp_data; /**< Scan response data. */
+} ble_gap_adv_data_t;
+
+/** PHYs. */
+typedef struct {
+    uint8_t tx_phys; /**< Preferred transmit PHYs. */
+    uint8_t rx_phys; /**< Preferred receive PHYs. */
+} ble_gap_phys_t;
+
+/** Event structure for BLE_GAP_EVT_CONNECTED. */
+typedef struct {
+    ble_gap_addr_t        peer_addr;   /**< Bluetooth address of the peer device. */
+    uint8_t               role;        /**< BLE role for this connection. */
+    ble_gap_conn_params_t conn_params; /**< GAP Connection Parameters. */
+    uint8_t               adv_handle;  /**< Advertising handle in which advertising has ended. */
+} ble_gap_evt_connected_t;
+
+/** Event structure for BLE_GAP_EVT_DISCONNECTED. */
+typedef struct {
+    uint8_t reason; /**< HCI error code. */
+} ble_gap_evt_disconnected_t;
+
+/** Event structure for BLE_GAP_EVT_TIMEOUT. */
+typedef struct {
+    uint8_t src; /**< Source of timeout event. */
+    union {
+        ble_data_t adv_report_buffer; /**< Buffer of a timed out scanner. */
+    } params;
+} ble_gap_evt_timeout_t;
+
+/** Event structure for BLE_GAP_EVT_ADV_REPORT. */
+typedef struct {
+    ble_gap_adv_report_type_t type;       /**< Advertising report type. */
+    ble_gap_addr_t            peer_addr;  /**< Bluetooth address of the peer device. */
+    ble_gap_addr_t            direct_addr; /**< Target address. */
+    uint8_t                   primary_phy; /**< Primary PHY. */
+    uint8_t                   secondary_phy; /**< Secondary PHY. */
+    int8_t                    tx_power;   /**< TX Power reported by the advertiser. */
+    int8_t                    rssi;       /**< Received Signal Strength Indication in dBm. */
+    uint8_t                   ch_index;   /**< Channel Index on which the last advertising packet is received. */
+    uint8_t                   set_id;     /**< Set ID of the received advertising data. */
+    uint16_t                  data_id : 12; /**< Advertising Data ID. */
+    ble_data_t                data;       /**< Received advertising or scan response data. */
+    struct {
+        uint16_t aux_offset;
+        uint8_t  aux_phy;
+    } aux_pointer;                        /**< Not used. */
+} ble_gap_evt_adv_report_t;
+
+/** Event structure for BLE_GAP_EVT_CONN_PARAM_UPDATE_REQUEST. */
+typedef struct {
+    ble_gap_conn_params_t conn_params; /**< GAP Connection Parameters. */
+} ble_gap_evt_conn_param_update_request_t;
+
+/** Event structure for BLE_GAP_EVT_PHY_UPDATE_REQUEST. */
+typedef struct {
+    ble_gap_phys_t peer_preferred_phys; /**< The PHYs the peer prefers to use. */
+} ble_gap_evt_phy_update_request_t;
+
+#define BLE_GAP_DATA_LENGTH_AUTO    0  /**< Auto select data length parameters. */
+#define BLE_GAP_DATA_LENGTH_DEFAULT 27 /**< Default data length. */
+
+/** Data length parameters. */
+typedef struct {
+    uint16_t max_tx_octets;  /**< Maximum number of payload octets that a Controller supports for transmission. */
+    uint16_t max_rx_octets;  /**< Maximum number of payload octets that a Controller supports for reception. */
+    uint16_t max_tx_time_us; /**< Maximum number of microseconds that a Controller supports for transmission. */
+    uint16_t max_rx_time_us; /**< Maximum number of microseconds that a Controller supports for reception. */
+} ble_gap_data_length_params_t;
+
+/** Data length limitation. */
+typedef struct {
+    uint16_t tx_payload_limited_octets; /**< Reduction of payload octets for transmission. */
+    uint16_t rx_payload_limited_octets; /**< Reduction of payload octets for reception. */
+    uint16_t tx_rx_time_limited_us;     /**< Reduction of time for transmission and reception. */
+} ble_gap_data_length_limitation_t;
+
+/** Event structure for BLE_GAP_EVT_DATA_LENGTH_UPDATE. */
+typedef struct {
+    ble_gap_data_length_params_t effective_params; /**< The effective data length parameters. */
+} ble_gap_evt_data_length_update_t;
+
+/** GAP event structure. */
+typedef struct {
+    uint16_t conn_handle; /**< Connection Handle on which event occurred. */
+    union {
+        ble_gap_evt_connected_t                 connected;
+        ble_gap_evt_disconnected_t              disconnected;
+        ble_gap_evt_timeout_t                   timeout;
+        ble_gap_evt_adv_report_t                adv_report;
+        ble_gap_evt_conn_param_update_request_t conn_param_update_request;
+        ble_gap_evt_phy_update_request_t        phy_update_request;
+        ble_gap_evt_data_length_update_t        data_length_update;
+    } params; /**< Event Parameters. */
+} ble_gap_evt_t;
+
+uint32_t sd_ble_gap_device_name_set(ble_gap_conn_sec_mode_t const * p_write_perm, uint8_t const * p_dev_name, uint16_t len);
+uint32_t sd_ble_gap_ppcp_set(ble_gap_conn_params_t const * p_conn_params);
+uint32_t sd_ble_gap_adv_set_configure(uint8_t * p_adv_handle, ble_gap_adv_data_t const * p_adv_data, ble_gap_adv_params_t const * p_adv_params);
+uint32_t sd_ble_gap_adv_start(uint8_t adv_handle, uint8_t conn_cfg_tag);
+uint32_t sd_ble_gap_adv_stop(uint8_t adv_handle);
+uint32_t sd_ble_gap_scan_start(ble_gap_scan_params_t const * p_scan_params, ble_data_t const * p_adv_report_buffer);
+uint32_t sd_ble_gap_scan_stop(void);
+uint32_t sd_ble_gap_connect(ble_gap_addr_t const * p_peer_addr, ble_gap_scan_params_t const * p_scan_params, ble_gap_conn_params_t const * p_conn_params, uint8_t conn_cfg_tag);
+uint32_t sd_ble_gap_connect_cancel(void);
+uint32_t sd_ble_gap_disconnect(uint16_t conn_handle, uint8_t hci_status_code);
+uint32_t sd_ble_gap_conn_param_update(uint16_t conn_handle, ble_gap_conn_params_t const * p_conn_params);
+uint32_t sd_ble_gap_phy_update(uint16_t conn_handle, ble_gap_phys_t const * p_gap_phys);
+uint32_t sd_ble_gap_data_length_update(uint16_t conn_handle, ble_gap_data_length_params_t const * p_dl_params, ble_gap_data_length_limitation_t * p_dl_limitation);
+uint32_t sd_ble_gap_sec_params_reply(uint16_t conn_handle, uint8_t sec_status, void const * p_sec_params, void const * p_sec_keyset);
+
+#endif // BLE_GAP_H__
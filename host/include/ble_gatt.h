@@ -0,0 +1,52 @@
+/** @file ble_gatt.h
+ *
+ * @brief Host stand-in for common SoftDevice GATT definitions.
+ */
+
+#ifndef BLE_GATT_H__
+#define BLE_GATT_H__
+
+#include <stdint.h>
+#include "ble_types.h"
+
+#define BLE_GATT_ATT_MTU_DEFAULT 23     /**< Default ATT MTU, in bytes. */
+#define BLE_GATT_HANDLE_INVALID  0x0000 /**< Invalid Attribute Handle. */
+#define BLE_GATT_HANDLE_START    0x0001 /**< First Attribute Handle. */
+#define BLE_GATT_HANDLE_END      0xFFFF /**< Last Attribute Handle. */
+
+#define BLE_GATT_TIMEOUT_SRC_PROTOCOL 0x00 /**< ATT Protocol timeout. */
+
+#define BLE_GATT_OP_INVALID      0x00 /**< Invalid Operation. */
+#define BLE_GATT_OP_WRITE_REQ    0x01 /**< Write Request. */
+#define BLE_GATT_OP_WRITE_CMD    0x02 /**< Write Command. */
+
+#define BLE_GATT_EXEC_WRITE_FLAG_PREPARED_CANCEL 0x00
+#define BLE_GATT_EXEC_WRITE_FLAG_PREPARED_WRITE  0x01
+
+#define BLE_GATT_HVX_INVALID      0x00 /**< Invalid Operation. */
+#define BLE_GATT_HVX_NOTIFICATION 0x01 /**< Handle Value Notification. */
+#define BLE_GATT_HVX_INDICATION   0x02 /**< Handle Value Indication. */
+
+#define BLE_GATT_STATUS_SUCCESS                  0x0000
+#define BLE_GATT_STATUS_UNKNOWN                  0x0001
+#define BLE_GATT_STATUS_ATTERR_INVALID_HANDLE    0x0101
+#define BLE_GATT_STATUS_ATTERR_ATTRIBUTE_NOT_FOUND 0x010A
+
+/** GATT Characteristic Properties. */
+typedef struct {
+    uint8_t broadcast       : 1; /**< Broadcasting of the value permitted. */
+    uint8_t read            : 1; /**< Reading the value permitted. */
+    uint8_t write_wo_resp   : 1; /**< Writing the value with Write Command permitted. */
+    uint8_t write           : 1; /**< Writing the value with Write Request permitted. */
+    uint8_t notify          : 1; /**< Notification of the value permitted. */
+    uint8_t indicate        : 1; /**< Indications of the value permitted. */
+    uint8_t auth_signed_wr  : 1; /**< Writing the value with Signed Write Command permitted. */
+} ble_gatt_char_props_t;
+
+/** GATT Characteristic Extended Properties. */
+typedef struct {
+    uint8_t reliable_wr : 1; /**< Writing the value with Queued Write operations permitted. */
+    uint8_t wr_aux      : 1; /**< Writing the Characteristic User Description descriptor permitted. */
+} ble_gatt_char_ext_props_t;
+
+#endif // BLE_GATT_H__
@@ -0,0 +1,32 @@
+/** @file ble_gatt_db.h
+ *
+ * @brief Host stand-in for GATT database definitions.
+ */
+
+#ifndef BLE_GATT_DB_H__
+#define BLE_GATT_DB_H__
+
+#include <stdint.h>
+#include "ble.h"
+#include "ble_gattc.h"
+
+#define BLE_GATT_DB_MAX_CHARS 6 /**< The maximum number of characteristics present in a service record. */
+
+/** Characteristic along with its descriptor handles. */
+typedef struct {
+    ble_gattc_char_t characteristic;    /**< Structure containing information about the characteristic. */
+    uint16_t         cccd_handle;       /**< CCCD Handle value for this characteristic. */
+    uint16_t         ext_prop_handle;   /**< Extended Properties Handle value for this characteristic. */
+    uint16_t         user_desc_handle;  /**< User Description Handle value for this characteristic. */
+    uint16_t         report_ref_handle; /**< Report Reference Handle value for this characteristic. */
+} ble_gatt_db_char_t;
+
+/** Service record with its characteristics. */
+typedef struct {
+    ble_uuid_t               srv_uuid;                                  /**< UUID of the service. */
+    uint8_t                  char_count;                                /**< Number of characteristics present in the service. */
+    ble_gattc_handle_range_t handle_range;                              /**< Service Handle Range. */
+    ble_gatt_db_char_t       charateristics[BLE_GATT_DB_MAX_CHARS];     /**< Array of information related to the characteristics present in the service. */
+} ble_gatt_db_srv_t;
+
+#endif // BLE_GATT_DB_H__
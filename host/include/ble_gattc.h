@@ -0,0 +1,144 @@
+/** @file ble_gattc.h
+ *
+ * @brief Host stand-in for SoftDevice Generic Attribute Profile Client API.
+ */
+
+#ifndef BLE_GATTC_H__
+#define BLE_GATTC_H__
+
+#include <stdint.h>
+#include "ble_types.h"
+#include "ble_gatt.h"
+
+#define BLE_GATTC_EVT_BASE 0x30
+
+/** GATT Client event IDs. */
+enum BLE_GATTC_EVTS {
+    BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP = BLE_GATTC_EVT_BASE, /**< Primary Service Discovery Response event. */
+    BLE_GATTC_EVT_REL_DISC_RSP,                            /**< Relationship Discovery Response event. */
+    BLE_GATTC_EVT_CHAR_DISC_RSP,                           /**< Characteristic Discovery Response event. */
+    BLE_GATTC_EVT_DESC_DISC_RSP,                           /**< Descriptor Discovery Response event. */
+    BLE_GATTC_EVT_ATTR_INFO_DISC_RSP,                      /**< Attribute Information Response event. */
+    BLE_GATTC_EVT_CHAR_VAL_BY_UUID_READ_RSP,               /**< Read By UUID Response event. */
+    BLE_GATTC_EVT_READ_RSP,                                /**< Read Response event. */
+    BLE_GATTC_EVT_CHAR_VALS_READ_RSP,                      /**< Read multiple Response event. */
+    BLE_GATTC_EVT_WRITE_RSP,                               /**< Write Response event. */
+    BLE_GATTC_EVT_HVX,                                     /**< Handle Value Notification or Indication event. */
+    BLE_GATTC_EVT_EXCHANGE_MTU_RSP,                        /**< Exchange MTU Response event. */
+    BLE_GATTC_EVT_TIMEOUT,                                 /**< Timeout event. */
+    BLE_GATTC_EVT_WRITE_CMD_TX_COMPLETE,                   /**< Write without Response transmission complete. */
+};
+
+/** Operation Handle Range. */
+typedef struct {
+    uint16_t start_handle; /**< Start Handle. */
+    uint16_t end_handle;   /**< End Handle. */
+} ble_gattc_handle_range_t;
+
+/** GATT service. */
+typedef struct {
+    ble_uuid_t               uuid;         /**< Service UUID. */
+    ble_gattc_handle_range_t handle_range; /**< Service Handle Range. */
+} ble_gattc_service_t;
+
+/** GATT characteristic. */
+typedef struct {
+    ble_uuid_t            uuid;                 /**< Characteristic UUID. */
+    ble_gatt_char_props_t char_props;           /**< Characteristic Properties. */
+    uint8_t               char_ext_props : 1;   /**< Extended properties present. */
+    uint16_t              handle_decl;          /**< Handle of the Characteristic Declaration. */
+    uint16_t              handle_value;         /**< Handle of the Characteristic Value. */
+} ble_gattc_char_t;
+
+/** GATT descriptor. */
+typedef struct {
+    uint16_t   handle; /**< Descriptor Handle. */
+    ble_uuid_t uuid;   /**< Descriptor UUID. */
+} ble_gattc_desc_t;
+
+/** Write Parameters. */
+typedef struct {
+    uint8_t         write_op; /**< Write Operation to be performed. */
+    uint8_t         flags;    /**< Flags. */
+    uint16_t        handle;   /**< Handle to the attribute to be written. */
+    uint16_t        offset;   /**< Offset in bytes. */
+    uint16_t        len;      /**< Length of data in bytes. */
+    uint8_t const * p_value;  /**< Pointer to the value data. */
+} ble_gattc_write_params_t;
+
+/** Event structure for BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP. */
+typedef struct {
+    uint16_t            count;       /**< Service count. */
+    ble_gattc_service_t services[1]; /**< Service data. */
+} ble_gattc_evt_prim_srvc_disc_rsp_t;
+
+/** Event structure for BLE_GATTC_EVT_READ_RSP. */
+typedef struct {
+    uint16_t handle;  /**< Attribute Handle. */
+    uint16_t offset;  /**< Offset of the attribute data. */
+    uint16_t len;     /**< Attribute data length. */
+    uint8_t  data[1]; /**< Attribute data. */
+} ble_gattc_evt_read_rsp_t;
+
+/** Event structure for BLE_GATTC_EVT_CHAR_VALS_READ_RSP. */
+typedef struct {
+    uint16_t len;       /**< Concatenated Attribute values length. */
+    uint8_t  values[1]; /**< Attribute values. */
+} ble_gattc_evt_char_vals_read_rsp_t;
+
+/** Event structure for BLE_GATTC_EVT_WRITE_RSP. */
+typedef struct {
+    uint16_t handle;   /**< Attribute Handle. */
+    uint8_t  write_op; /**< Type of write operation. */
+    uint16_t offset;   /**< Data offset. */
+    uint16_t len;      /**< Data length. */
+    uint8_t  data[1];  /**< Data. */
+} ble_gattc_evt_write_rsp_t;
+
+/** Event structure for BLE_GATTC_EVT_HVX. */
+typedef struct {
+    uint16_t handle;  /**< Handle to which the HVx operation applies. */
+    uint8_t  type;    /**< Indication or Notification. */
+    uint16_t len;     /**< Attribute data length. */
+    uint8_t  data[1]; /**< Attribute data. */
+} ble_gattc_evt_hvx_t;
+
+/** Event structure for BLE_GATTC_EVT_EXCHANGE_MTU_RSP. */
+typedef struct {
+    uint16_t server_rx_mtu; /**< Server RX MTU size. */
+} ble_gattc_evt_exchange_mtu_rsp_t;
+
+/** Event structure for BLE_GATTC_EVT_TIMEOUT. */
+typedef struct {
+    uint8_t src; /**< Timeout source. */
+} ble_gattc_evt_timeout_t;
+
+/** Event structure for BLE_GATTC_EVT_WRITE_CMD_TX_COMPLETE. */
+typedef struct {
+    uint8_t count; /**< Number of write without response transmissions completed. */
+} ble_gattc_evt_write_cmd_tx_complete_t;
+
+/** GATTC event structure. */
+typedef struct {
+    uint16_t conn_handle;  /**< Connection Handle on which event occurred. */
+    uint16_t gatt_status;  /**< GATT status code for the operation. */
+    uint16_t error_handle; /**< In case of error: The handle causing the error. */
+    union {
+        ble_gattc_evt_prim_srvc_disc_rsp_t    prim_srvc_disc_rsp;
+        ble_gattc_evt_read_rsp_t              read_rsp;
+        ble_gattc_evt_char_vals_read_rsp_t    char_vals_read_rsp;
+        ble_gattc_evt_write_rsp_t             write_rsp;
+        ble_gattc_evt_hvx_t                   hvx;
+        ble_gattc_evt_exchange_mtu_rsp_t      exchange_mtu_rsp;
+        ble_gattc_evt_timeout_t               timeout;
+        ble_gattc_evt_write_cmd_tx_complete_t write_cmd_tx_complete;
+    } params; /**< Event Parameters. */
+} ble_gattc_evt_t;
+
+uint32_t sd_ble_gattc_primary_services_discover(uint16_t conn_handle, uint16_t start_handle, ble_uuid_t const * p_srvc_uuid);
+uint32_t sd_ble_gattc_read(uint16_t conn_handle, uint16_t handle, uint16_t offset);
+uint32_t sd_ble_gattc_read_multiple(uint16_t conn_handle, uint16_t const * p_handles, uint16_t handle_count);
+uint32_t sd_ble_gattc_exchange_mtu_request(uint16_t conn_handle, uint16_t client_rx_mtu);
+uint32_t sd_ble_gattc_write(uint16_t conn_handle, ble_gattc_write_params_t const * p_write_params);
+
+#endif // BLE_GATTC_H__
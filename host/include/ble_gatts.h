@@ -0,0 +1,139 @@
+/** @file ble_gatts.h
+ *
+ * @brief Host stand-in for SoftDevice Generic Attribute Profile Server API.
+ */
+
+#ifndef BLE_GATTS_H__
+#define BLE_GATTS_H__
+
+#include <stdint.h>
+#include "ble_types.h"
+#include "ble_gatt.h"
+#include "ble_gap.h"
+
+#define BLE_GATTS_EVT_BASE 0x50
+
+/** GATT Server event IDs. */
+enum BLE_GATTS_EVTS {
+    BLE_GATTS_EVT_WRITE = BLE_GATTS_EVT_BASE, /**< Write operation performed. */
+    BLE_GATTS_EVT_RW_AUTHORIZE_REQUEST,       /**< Read/Write Authorization request. */
+    BLE_GATTS_EVT_SYS_ATTR_MISSING,           /**< A persistent system attribute access is pending. */
+    BLE_GATTS_EVT_HVC,                        /**< Handle Value Confirmation. */
+    BLE_GATTS_EVT_SC_CONFIRM,                 /**< Service Changed Confirmation. */
+    BLE_GATTS_EVT_EXCHANGE_MTU_REQUEST,       /**< Exchange MTU Request. */
+    BLE_GATTS_EVT_TIMEOUT,                    /**< Peer failed to respond to an ATT request in time. */
+    BLE_GATTS_EVT_HVN_TX_COMPLETE,            /**< Handle Value Notification transmission complete. */
+};
+
+#define BLE_GATTS_SRVC_TYPE_INVALID   0x00 /**< Invalid Service Type. */
+#define BLE_GATTS_SRVC_TYPE_PRIMARY   0x01 /**< Primary Service. */
+#define BLE_GATTS_SRVC_TYPE_SECONDARY 0x02 /**< Secondary Type. */
+
+#define BLE_GATTS_VLOC_INVALID 0x00 /**< Invalid Attribute Value Location. */
+#define BLE_GATTS_VLOC_STACK   0x01 /**< Attribute Value is located in stack memory. */
+#define BLE_GATTS_VLOC_USER    0x02 /**< Attribute Value is located in user memory. */
+
+/** Attribute metadata. */
+typedef struct {
+    ble_gap_conn_sec_mode_t read_perm;  /**< Read permissions. */
+    ble_gap_conn_sec_mode_t write_perm; /**< Write permissions. */
+    uint8_t                 vlen    :1; /**< Variable length attribute. */
+    uint8_t                 vloc    :2; /**< Value location. */
+    uint8_t                 rd_auth :1; /**< Read authorization and value will be requested from the application. */
+    uint8_t                 wr_auth :1; /**< Write authorization will be requested from the application. */
+} ble_gatts_attr_md_t;
+
+/** GATT Attribute. */
+typedef struct {
+    ble_uuid_t const *          p_uuid;    /**< Pointer to the attribute UUID. */
+    ble_gatts_attr_md_t const * p_attr_md; /**< Pointer to the attribute metadata structure. */
+    uint16_t                    init_len;  /**< Initial attribute value length in bytes. */
+    uint16_t                    init_offs; /**< Initial attribute value offset in bytes. */
+    uint16_t                    max_len;   /**< Maximum attribute value length in bytes. */
+    uint8_t *                   p_value;   /**< Pointer to the attribute data. */
+} ble_gatts_attr_t;
+
+/** GATT Attribute Value. */
+typedef struct {
+    uint16_t  len;     /**< Length in bytes to be written or read. */
+    uint16_t  offset;  /**< Attribute value offset. */
+    uint8_t * p_value; /**< Pointer to where value is stored or will be stored. */
+} ble_gatts_value_t;
+
+/** GATT Characteristic Presentation Format. */
+typedef struct {
+    uint8_t  format;      /**< Format of the value. */
+    int8_t   exponent;    /**< Exponent for integer data types. */
+    uint16_t unit;        /**< Unit from Bluetooth Assigned Numbers. */
+    uint8_t  name_space;  /**< Namespace from Bluetooth Assigned Numbers. */
+    uint16_t desc;        /**< Namespace description from Bluetooth Assigned Numbers. */
+} ble_gatts_char_pf_t;
+
+/** GATT Characteristic metadata. */
+typedef struct {
+    ble_gatt_char_props_t       char_props;           /**< Characteristic Properties. */
+    ble_gatt_char_ext_props_t   char_ext_props;       /**< Characteristic Extended Properties. */
+    uint8_t const *             p_char_user_desc;     /**< Pointer to a UTF-8 encoded string. */
+    uint16_t                    char_user_desc_max_size; /**< The maximum size in bytes of the user description descriptor. */
+    uint16_t                    char_user_desc_size;  /**< The size of the user description. */
+    ble_gatts_char_pf_t const * p_char_pf;            /**< Pointer to a presentation format structure. */
+    ble_gatts_attr_md_t const * p_user_desc_md;       /**< Attribute metadata for the User Description descriptor. */
+    ble_gatts_attr_md_t const * p_cccd_md;            /**< Attribute metadata for the Client Characteristic Configuration Descriptor. */
+    ble_gatts_attr_md_t const * p_sccd_md;            /**< Attribute metadata for the Server Characteristic Configuration Descriptor. */
+} ble_gatts_char_md_t;
+
+/** GATT Characteristic Definition Handles. */
+typedef struct {
+    uint16_t value_handle;     /**< Handle to the characteristic value. */
+    uint16_t user_desc_handle; /**< Handle to the User Description descriptor. */
+    uint16_t cccd_handle;      /**< Handle to the Client Characteristic Configuration Descriptor. */
+    uint16_t sccd_handle;      /**< Handle to the Server Characteristic Configuration Descriptor. */
+} ble_gatts_char_handles_t;
+
+/** GATT HVx parameters. */
+typedef struct {
+    uint16_t        handle; /**< Characteristic Value Handle. */
+    uint8_t         type;   /**< Indication or Notification. */
+    uint16_t        offset; /**< Offset within the attribute value. */
+    uint16_t *      p_len;  /**< Length in bytes to be written, length in bytes written after return. */
+    uint8_t const * p_data; /**< Actual data content. */
+} ble_gatts_hvx_params_t;
+
+/** Event structure for BLE_GATTS_EVT_WRITE. */
+typedef struct {
+    uint16_t   handle;   /**< Attribute Handle. */
+    ble_uuid_t uuid;     /**< Attribute UUID. */
+    uint8_t    op;       /**< Type of write operation. */
+    uint8_t    auth_required; /**< Writing operation deferred due to authorization requirement. */
+    uint16_t   offset;   /**< Offset for the write operation. */
+    uint16_t   len;      /**< Length of the received data. */
+    uint8_t    data[1];  /**< Received data. */
+} ble_gatts_evt_write_t;
+
+/** Event structure for BLE_GATTS_EVT_SYS_ATTR_MISSING. */
+typedef struct {
+    uint8_t hint; /**< Hint (currently unused). */
+} ble_gatts_evt_sys_attr_missing_t;
+
+/** Event structure for BLE_GATTS_EVT_TIMEOUT. */
+typedef struct {
+    uint8_t src; /**< Timeout source. */
+} ble_gatts_evt_timeout_t;
+
+/** GATTS event structure. */
+typedef struct {
+    uint16_t conn_handle; /**< Connection Handle on which the event occurred. */
+    union {
+        ble_gatts_evt_write_t            write;
+        ble_gatts_evt_sys_attr_missing_t sys_attr_missing;
+        ble_gatts_evt_timeout_t          timeout;
+    } params; /**< Event Parameters. */
+} ble_gatts_evt_t;
+
+uint32_t sd_ble_gatts_service_add(uint8_t type, ble_uuid_t const * p_uuid, uint16_t * p_handle);
+uint32_t sd_ble_gatts_characteristic_add(uint16_t service_handle, ble_gatts_char_md_t const * p_char_md, ble_gatts_attr_t const * p_attr_char_value, ble_gatts_char_handles_t * p_handles);
+uint32_t sd_ble_gatts_value_set(uint16_t conn_handle, uint16_t handle, ble_gatts_value_t * p_value);
+uint32_t sd_ble_gatts_hvx(uint16_t conn_handle, ble_gatts_hvx_params_t const * p_hvx_params);
+uint32_t sd_ble_gatts_sys_attr_set(uint16_t conn_handle, uint8_t const * p_sys_attr_data, uint16_t len, uint32_t flags);
+
+#endif // BLE_GATTS_H__
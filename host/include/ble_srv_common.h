@@ -0,0 +1,25 @@
+/** @file ble_srv_common.h
+ *
+ * @brief Host stand-in for common service definitions.
+ */
+
+#ifndef BLE_SRV_COMMON_H__
+#define BLE_SRV_COMMON_H__
+
+#include <stdint.h>
+#include "ble.h"
+#include "app_error.h"
+
+#define OPCODE_LENGTH 1 /**< Length of opcode inside a notification. */
+#define HANDLE_LENGTH 2 /**< Length of handle inside a notification. */
+
+#define BLE_CCCD_VALUE_LEN 2 /**< The length of a CCCD value. */
+
+/** Security settings structure for a characteristic with CCCD. */
+typedef struct {
+    ble_gap_conn_sec_mode_t cccd_write_perm; /**< Write permissions for Client Characteristic Configuration Descriptor. */
+    ble_gap_conn_sec_mode_t read_perm;       /**< Read permissions. */
+    ble_gap_conn_sec_mode_t write_perm;      /**< Write permissions. */
+} ble_srv_cccd_security_mode_t;
+
+#endif // BLE_SRV_COMMON_H__
@@ -0,0 +1,45 @@
+/** @file ble_types.h
+ *
+ * @brief Host stand-in for common SoftDevice BLE types.
+ */
+
+#ifndef BLE_TYPES_H__
+#define BLE_TYPES_H__
+
+#include <stdint.h>
+#include "nrf_error.h"
+
+#define BLE_CONN_HANDLE_INVALID 0xFFFF /**< Invalid connection handle. */
+
+#define BLE_UUID_TYPE_UNKNOWN      0x00 /**< Invalid UUID type. */
+#define BLE_UUID_TYPE_BLE          0x01 /**< Bluetooth SIG UUID (16-bit). */
+#define BLE_UUID_TYPE_VENDOR_BEGIN 0x02 /**< Vendor UUID types start at this index (128-bit). */
+
+#define NRF_ERROR_STK_BASE_NUM_BLE        (NRF_ERROR_STK_BASE_NUM + 0x000)
+#define BLE_ERROR_NOT_ENABLED             (NRF_ERROR_STK_BASE_NUM + 0x001)
+#define BLE_ERROR_INVALID_CONN_HANDLE     (NRF_ERROR_STK_BASE_NUM + 0x002)
+#define BLE_ERROR_INVALID_ATTR_HANDLE     (NRF_ERROR_STK_BASE_NUM + 0x003)
+#define BLE_ERROR_INVALID_ADV_HANDLE      (NRF_ERROR_STK_BASE_NUM + 0x004)
+#define BLE_ERROR_INVALID_ROLE            (NRF_ERROR_STK_BASE_NUM + 0x005)
+#define BLE_ERROR_BLOCKED_BY_OTHER_LINKS  (NRF_ERROR_STK_BASE_NUM + 0x006)
+#define BLE_ERROR_GAP_INVALID_BLE_ADDR    (NRF_ERROR_STK_BASE_NUM + 0x200 + 0x002)
+#define BLE_ERROR_GATTS_SYS_ATTR_MISSING  (NRF_ERROR_STK_BASE_NUM + 0x400 + 0x001)
+
+/** 128 bit UUID values. */
+typedef struct {
+    uint8_t uuid128[16]; /**< Little-Endian UUID bytes. */
+} ble_uuid128_t;
+
+/** Bluetooth Low Energy UUID type, encapsulates both 16-bit and 128-bit UUIDs. */
+typedef struct {
+    uint16_t uuid; /**< 16-bit UUID value or octets 12-13 of 128-bit UUID. */
+    uint8_t  type; /**< UUID type, see BLE_UUID_TYPES. */
+} ble_uuid_t;
+
+/** Data structure. */
+typedef struct {
+    uint8_t * p_data; /**< Pointer to the data buffer provided to/from the application. */
+    uint16_t  len;    /**< Length of the data buffer, in bytes. */
+} ble_data_t;
+
+#endif // BLE_TYPES_H__
@@ -0,0 +1,49 @@
+/** @file bsp.h
+ *
+ * @brief Host stand-in for board support package. LEDs and buttons do nothing.
+ */
+
+#ifndef BSP_H__
+#define BSP_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#define BSP_INIT_NONE    0        /**< No initialization of LEDs or buttons. */
+#define BSP_INIT_LEDS    (1 << 0) /**< Enable LEDs during initialization. */
+#define BSP_INIT_BUTTONS (1 << 1) /**< Enable buttons during initialization. */
+
+#define BSP_BOARD_LED_0 0
+#define BSP_BOARD_LED_1 1
+#define BSP_BOARD_LED_2 2
+#define BSP_BOARD_LED_3 3
+
+/** BSP indication states. */
+typedef enum {
+    BSP_INDICATE_IDLE,      /**< See \ref BSP_INDICATE_IDLE. */
+    BSP_INDICATE_SCANNING,  /**< See \ref BSP_INDICATE_SCANNING. */
+    BSP_INDICATE_ADVERTISING, /**< See \ref BSP_INDICATE_ADVERTISING. */
+    BSP_INDICATE_CONNECTED, /**< See \ref BSP_INDICATE_CONNECTED. */
+} bsp_indication_t;
+
+/** BSP events. */
+typedef enum {
+    BSP_EVENT_NOTHING = 0,         /**< Assign this event to an action to prevent the action from generating an event. */
+    BSP_EVENT_DEFAULT,             /**< Assign this event to an action to assign the default event to the action. */
+    BSP_EVENT_CLEAR_BONDING_DATA,  /**< Persistent bonding data should be erased. */
+    BSP_EVENT_KEY_0 = 0x10,        /**< Default event of the push action of BSP_BUTTON_0. */
+    BSP_EVENT_KEY_1,               /**< Default event of the push action of BSP_BUTTON_1. */
+    BSP_EVENT_KEY_2,               /**< Default event of the push action of BSP_BUTTON_2. */
+    BSP_EVENT_KEY_3,               /**< Default event of the push action of BSP_BUTTON_3. */
+} bsp_event_t;
+
+/** BSP module event callback. */
+typedef void (*bsp_event_callback_t)(bsp_event_t);
+
+void bsp_board_init(uint32_t init_flags);
+void bsp_board_led_on(uint32_t led_idx);
+void bsp_board_led_off(uint32_t led_idx);
+uint32_t bsp_init(uint32_t type, bsp_event_callback_t callback);
+uint32_t bsp_indication_set(bsp_indication_t indicate);
+
+#endif // BSP_H__
@@ -0,0 +1,126 @@
+/** @file fds.h
+ *
+ * @brief Host stand-in for Flash Data Storage, kept in memory.
+ */
+
+#ifndef FDS_H__
+#define FDS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+/** FDS return values. */
+enum {
+    FDS_SUCCESS = NRF_SUCCESS,  /**< The operation completed successfully. */
+    FDS_ERR_OPERATION_TIMEOUT,  /**< Error. The operation timed out. */
+    FDS_ERR_NOT_INITIALIZED,    /**< Error. The module has not been initialized. */
+    FDS_ERR_UNALIGNED_ADDR,     /**< Error. The input data is not aligned to a word boundary. */
+    FDS_ERR_INVALID_ARG,        /**< Error. The parameter contains invalid data. */
+    FDS_ERR_NULL_ARG,           /**< Error. The parameter is NULL. */
+    FDS_ERR_NO_OPEN_RECORDS,    /**< Error. The record is not open, so it cannot be closed. */
+    FDS_ERR_NO_SPACE_IN_FLASH,  /**< Error. There is no space in flash memory. */
+    FDS_ERR_NO_SPACE_IN_QUEUES, /**< Error. There is no space in the internal queues. */
+    FDS_ERR_RECORD_TOO_LARGE,   /**< Error. The record exceeds the maximum allowed size. */
+    FDS_ERR_NOT_FOUND,          /**< Error. The record was not found. */
+    FDS_ERR_NO_PAGES,           /**< Error. No flash pages are available. */
+    FDS_ERR_USER_LIMIT_REACHED, /**< Error. The maximum number of users has been reached. */
+    FDS_ERR_CRC_CHECK_FAILED,   /**< Error. The CRC check failed. */
+    FDS_ERR_BUSY,               /**< Error. The underlying flash subsystem was busy. */
+    FDS_ERR_INTERNAL,           /**< Error. An internal error occurred. */
+};
+
+/** Record header. */
+typedef struct {
+    uint16_t record_key;   /**< The record key. */
+    uint16_t length_words; /**< The length of the record data (in 4-byte words). */
+    uint16_t file_id;      /**< The ID of the file that the record belongs to. */
+    uint16_t crc16;        /**< CRC16-CCITT check value. */
+    uint32_t record_id;    /**< The unique record ID (32 bits). */
+} fds_header_t;
+
+/** Record descriptor. */
+typedef struct {
+    uint32_t         record_id;     /**< The unique record ID. */
+    uint32_t const * p_record;      /**< The last known location of the record in flash. */
+    uint16_t         gc_run_count;  /**< Number of times garbage collection has been run. */
+    bool             record_is_open; /**< Whether the record is currently open. */
+} fds_record_desc_t;
+
+/** Record data as read from flash. */
+typedef struct {
+    fds_header_t const * p_header; /**< Location of the record header in flash. */
+    void const *         p_data;   /**< Location of the record data in flash. */
+} fds_flash_record_t;
+
+/** A record. */
+typedef struct {
+    uint16_t file_id; /**< The ID of the file that the record belongs to. */
+    uint16_t key;     /**< The record key. */
+    struct {
+        void const * p_data;       /**< Pointer to the data to store. Must be word-aligned. */
+        uint32_t     length_words; /**< Length of data in 4-byte words. */
+    } data;
+} fds_record_t;
+
+/** Search token. */
+typedef struct {
+    uint32_t const * p_addr;   /**< Last record found. */
+    uint16_t         page;     /**< Page to search. */
+} fds_find_token_t;
+
+/** FDS event IDs. */
+typedef enum {
+    FDS_EVT_INIT,       /**< Event for @ref fds_init. */
+    FDS_EVT_WRITE,      /**< Event for @ref fds_record_write. */
+    FDS_EVT_UPDATE,     /**< Event for fds_record_update. */
+    FDS_EVT_DEL_RECORD, /**< Event for @ref fds_record_delete. */
+    FDS_EVT_DEL_FILE,   /**< Event for fds_file_delete. */
+    FDS_EVT_GC          /**< Event for fds_gc. */
+} fds_evt_id_t;
+
+/** An FDS event. */
+typedef struct {
+    fds_evt_id_t id;     /**< The event ID. */
+    ret_code_t   result; /**< The result of the operation related to this event. */
+    union {
+        struct {
+            uint32_t record_id;
+            uint16_t file_id;
+            uint16_t record_key;
+            bool     is_record_updated;
+        } write; /**< Information for @ref FDS_EVT_WRITE events. */
+        struct {
+            uint32_t record_id;
+            uint16_t file_id;
+            uint16_t record_key;
+        } del;   /**< Information for @ref FDS_EVT_DEL_RECORD events. */
+    };
+} fds_evt_t;
+
+/** File system statistics. */
+typedef struct {
+    uint16_t pages_available; /**< The number of pages available. */
+    uint16_t open_records;    /**< The number of open records. */
+    uint16_t valid_records;   /**< The number of valid records. */
+    uint16_t dirty_records;   /**< The number of deleted ("dirty") records. */
+    uint16_t words_reserved;  /**< The number of words reserved by @ref fds_reserve(). */
+    uint16_t words_used;      /**< The number of words written to flash, including those reserved for future writes. */
+    uint16_t largest_contig;  /**< The largest number of free contiguous words in the file system. */
+    uint16_t freeable_words;  /**< The largest number of words that can be reclaimed by garbage collection. */
+    bool     corruption;      /**< Filesystem corruption has been detected. */
+} fds_stat_t;
+
+/** FDS event handler function prototype. */
+typedef void (*fds_cb_t)(fds_evt_t const * p_evt);
+
+ret_code_t fds_register(fds_cb_t cb);
+ret_code_t fds_init(void);
+ret_code_t fds_record_find(uint16_t file_id, uint16_t record_key, fds_record_desc_t * p_desc, fds_find_token_t * p_token);
+ret_code_t fds_record_open(fds_record_desc_t * p_desc, fds_flash_record_t * p_flash_record);
+ret_code_t fds_record_close(fds_record_desc_t * p_desc);
+ret_code_t fds_record_write(fds_record_desc_t * p_desc, fds_record_t const * p_record);
+ret_code_t fds_record_delete(fds_record_desc_t * p_desc);
+ret_code_t fds_stat(fds_stat_t * p_stat);
+
+#endif // FDS_H__
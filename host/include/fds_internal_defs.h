@@ -0,0 +1,16 @@
+/** @file fds_internal_defs.h
+ *
+ * @brief Host stand-in for Flash Data Storage page layout.
+ */
+
+#ifndef FDS_INTERNAL_DEFS_H__
+#define FDS_INTERNAL_DEFS_H__
+
+#include "sdk_config.h"
+
+#define FDS_PAGE_TAG_SIZE      2
+#define FDS_PHY_PAGE_SIZE      (FDS_VIRTUAL_PAGE_SIZE)
+#define FDS_PHY_PAGES          (FDS_VIRTUAL_PAGES)
+#define FDS_PHY_PAGES_RESERVED ((FDS_VIRTUAL_PAGES_RESERVED * FDS_VIRTUAL_PAGE_SIZE) / FDS_PHY_PAGE_SIZE)
+
+#endif // FDS_INTERNAL_DEFS_H__
@@ -0,0 +1,28 @@
+/** @file nordic_common.h
+ *
+ * @brief Host stand-in for common nRF SDK macros.
+ */
+
+#ifndef NORDIC_COMMON_H__
+#define NORDIC_COMMON_H__
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) < (b) ? (b) : (a))
+#endif
+
+#define UNUSED_VARIABLE(X)     ((void)(X))
+#define UNUSED_PARAMETER(X)    UNUSED_VARIABLE(X)
+#define UNUSED_RETURN_VALUE(X) UNUSED_VARIABLE(X)
+
+#define NRF_MODULE_ENABLED(module) ((defined(module ## _ENABLED) && (module ## _ENABLED)) ? 1 : 0)
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+/** Concatenates two parameters, expanding macros first. */
+#define CONCAT_2(p1, p2)      CONCAT_2_(p1, p2)
+#define CONCAT_2_(p1, p2)     p1##p2
+
+#endif // NORDIC_COMMON_H__
@@ -0,0 +1,46 @@
+/** @file nrf.h
+ *
+ * @brief Host stand-in for nRF52 device registers.
+ *
+ * @details Only the registers BLEAM Scanner reads are present.
+ */
+
+#ifndef NRF_H__
+#define NRF_H__
+
+#include <stdint.h>
+
+/** Factory information configuration registers. */
+typedef struct {
+    uint32_t CODEPAGESIZE; /**< Code memory page size. */
+    uint32_t CODESIZE;     /**< Code memory size, pages. */
+    uint32_t DEVICEID[2];  /**< Device identifier. */
+} NRF_FICR_Type;
+
+extern NRF_FICR_Type sim_ficr;
+#define NRF_FICR (&sim_ficr)
+
+/** Core debug registers. */
+typedef struct {
+    uint32_t DEMCR; /**< Debug Exception and Monitor Control Register. */
+} CoreDebug_Type;
+
+/** Data watchpoint and trace registers. */
+typedef struct {
+    uint32_t CTRL;   /**< Control Register. */
+    uint32_t CYCCNT; /**< Cycle Count Register, never counts on host. */
+} DWT_Type;
+
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk     (1UL << 0)
+
+extern CoreDebug_Type sim_core_debug;
+extern DWT_Type sim_dwt;
+#define CoreDebug (&sim_core_debug)
+#define DWT       (&sim_dwt)
+
+void NVIC_SystemReset(void);
+
+#define __disable_irq() ((void)0)
+
+#endif // NRF_H__
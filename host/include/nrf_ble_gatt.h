@@ -0,0 +1,56 @@
+/** @file nrf_ble_gatt.h
+ *
+ * @brief Host stand-in for GATT module. ATT MTU and data length are negotiated with the simulated peer.
+ */
+
+#ifndef NRF_BLE_GATT_H__
+#define NRF_BLE_GATT_H__
+
+#include <stdint.h>
+#include "sdk_config.h"
+#include "ble.h"
+#include "nrf_sdh_ble.h"
+
+/** Macro for defining a nrf_ble_gatt instance. */
+#define NRF_BLE_GATT_DEF(_name)                        \
+static nrf_ble_gatt_t _name;                           \
+NRF_SDH_BLE_OBSERVER(_name ## _obs,                    \
+                     NRF_BLE_GATT_BLE_OBSERVER_PRIO,   \
+                     nrf_ble_gatt_on_ble_evt, &_name)
+
+/** GATT module event types. */
+typedef enum {
+    NRF_BLE_GATT_EVT_ATT_MTU_UPDATED     = 0xA77, /**< The ATT_MTU size was updated. */
+    NRF_BLE_GATT_EVT_DATA_LENGTH_UPDATED = 0xDA7A, /**< The data length was updated. */
+} nrf_ble_gatt_evt_id_t;
+
+/** GATT module event. */
+typedef struct {
+    nrf_ble_gatt_evt_id_t evt_id;      /**< Event ID. */
+    uint16_t              conn_handle; /**< Connection handle on which the event happened. */
+    union {
+        uint16_t att_mtu_effective;    /**< Effective ATT_MTU. */
+        uint8_t  data_length;          /**< Data length value. */
+    } params;
+} nrf_ble_gatt_evt_t;
+
+typedef struct nrf_ble_gatt_s nrf_ble_gatt_t;
+
+/** GATT module event handler type. */
+typedef void (*nrf_ble_gatt_evt_handler_t) (nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_t const * p_evt);
+
+/** GATT module instance. */
+struct nrf_ble_gatt_s {
+    uint16_t                   att_mtu_desired_periph;  /**< Requested ATT_MTU size for the next peripheral connection that is established. */
+    uint16_t                   att_mtu_desired_central; /**< Requested ATT_MTU size for the next central connection that is established. */
+    uint8_t                    data_length;             /**< Data length to use for the next connection that is established. */
+    nrf_ble_gatt_evt_handler_t evt_handler;             /**< GATT event handler. */
+};
+
+ret_code_t nrf_ble_gatt_init(nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_handler_t evt_handler);
+ret_code_t nrf_ble_gatt_att_mtu_periph_set(nrf_ble_gatt_t * p_gatt, uint16_t desired_mtu);
+ret_code_t nrf_ble_gatt_att_mtu_central_set(nrf_ble_gatt_t * p_gatt, uint16_t desired_mtu);
+ret_code_t nrf_ble_gatt_data_length_set(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle, uint8_t data_length);
+void nrf_ble_gatt_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context);
+
+#endif // NRF_BLE_GATT_H__
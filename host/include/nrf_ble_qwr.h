@@ -0,0 +1,34 @@
+/** @file nrf_ble_qwr.h
+ *
+ * @brief Host stand-in for Queued Writes module.
+ */
+
+#ifndef NRF_BLE_QWR_H__
+#define NRF_BLE_QWR_H__
+
+#include <stdint.h>
+#include "sdk_config.h"
+#include "ble.h"
+
+/** Macro for defining a nrf_ble_qwr instance. */
+#define NRF_BLE_QWR_DEF(_name) static nrf_ble_qwr_t _name
+
+/** Queued Writes module error handler type. */
+typedef void (* nrf_ble_qwr_error_handler_t) (uint32_t nrf_error);
+
+/** Queued Writes structure. */
+typedef struct {
+    uint8_t                     initialized; /**< Flag that indicates whether the module has been initialized. */
+    uint16_t                    conn_handle; /**< Connection handle. */
+    nrf_ble_qwr_error_handler_t error_handler; /**< Error handler. */
+} nrf_ble_qwr_t;
+
+/** Queued Writes init structure. */
+typedef struct {
+    nrf_ble_qwr_error_handler_t error_handler; /**< Error handler. */
+} nrf_ble_qwr_init_t;
+
+ret_code_t nrf_ble_qwr_init(nrf_ble_qwr_t * p_qwr, nrf_ble_qwr_init_t const * p_qwr_init);
+ret_code_t nrf_ble_qwr_conn_handle_assign(nrf_ble_qwr_t * p_qwr, uint16_t conn_handle);
+
+#endif // NRF_BLE_QWR_H__
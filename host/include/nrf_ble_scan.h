@@ -0,0 +1,80 @@
+/** @file nrf_ble_scan.h
+ *
+ * @brief Host stand-in for scanning module. Filters are not implemented, every report is passed as not found.
+ */
+
+#ifndef NRF_BLE_SCAN_H__
+#define NRF_BLE_SCAN_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_common.h"
+#include "ble.h"
+#include "nrf_sdh_ble.h"
+
+/** Macro for defining a nrf_ble_scan instance. */
+#define NRF_BLE_SCAN_DEF(_name)                            \
+    static nrf_ble_scan_t _name;                           \
+    NRF_SDH_BLE_OBSERVER(_name ## _ble_obs,                \
+                         NRF_BLE_SCAN_OBSERVER_PRIO,       \
+                         nrf_ble_scan_on_ble_evt, &_name)
+
+/** Scanning module event types. */
+typedef enum {
+    NRF_BLE_SCAN_EVT_FILTER_MATCH,         /**< A filter is matched or all filters are matched in the multifilter mode. */
+    NRF_BLE_SCAN_EVT_WHITELIST_REQUEST,    /**< Request the whitelist from the main application. */
+    NRF_BLE_SCAN_EVT_WHITELIST_ADV_REPORT, /**< Device is found on the whitelist. */
+    NRF_BLE_SCAN_EVT_NOT_FOUND,            /**< The filter was not matched for the scan data. */
+    NRF_BLE_SCAN_EVT_SCAN_TIMEOUT,         /**< Scan timeout. */
+    NRF_BLE_SCAN_EVT_CONNECTING_ERROR,     /**< Error occurred when establishing the connection. */
+    NRF_BLE_SCAN_EVT_CONNECTED             /**< Connected to device. */
+} nrf_ble_scan_evt_t;
+
+/** Scanning module event. */
+typedef struct {
+    nrf_ble_scan_evt_t scan_evt_id; /**< Type of event propagated to the main application. */
+    union {
+        ble_gap_evt_adv_report_t const * p_not_found; /**< Advertising report event parameters when filter is not found. */
+        struct {
+            ble_gap_evt_timeout_t const * p_timeout; /**< Timeout event parameters. */
+        } timeout;
+        struct {
+            ret_code_t err_code; /**< Indicates success or failure of an API procedure. */
+        } connecting_err;
+        struct {
+            ble_gap_evt_connected_t const * p_connected; /**< Connected event parameters. */
+            uint16_t                        conn_handle; /**< Connection handle of the device on which the event occurred. */
+        } connected;
+    } params;
+    ble_gap_scan_params_t const * p_scan_params; /**< GAP scanning parameters. */
+} scan_evt_t;
+
+/** Scanning module event handler type. */
+typedef void (*nrf_ble_scan_evt_handler_t)(scan_evt_t const * p_scan_evt);
+
+/** Scanning module init structure. */
+typedef struct {
+    ble_gap_scan_params_t const * p_scan_param;     /**< BLE GAP scan parameters required to initialize the module. */
+    bool                          connect_if_match; /**< If set to true, the module automatically connects after a filter match. */
+    ble_gap_conn_params_t const * p_conn_param;     /**< Connection parameters. */
+    uint8_t                       conn_cfg_tag;     /**< Variable to keep track of what connection settings will be used. */
+} nrf_ble_scan_init_t;
+
+/** Scanning module instance. */
+typedef struct {
+    bool                       connect_if_match; /**< If set to true, the module automatically connects after a filter match. */
+    ble_gap_conn_params_t      conn_params;      /**< Connection parameters. */
+    uint8_t                    conn_cfg_tag;     /**< Variable to keep track of what connection settings will be used. */
+    ble_gap_scan_params_t      scan_params;      /**< GAP scanning parameters. */
+    nrf_ble_scan_evt_handler_t evt_handler;      /**< Handler for the scanning events. */
+    uint8_t                    scan_buffer_data[NRF_BLE_SCAN_BUFFER]; /**< Buffer where advertising reports will be stored by the SoftDevice. */
+    ble_data_t                 scan_buffer;      /**< Structure-stored pointer to the buffer where advertising reports will be stored by the SoftDevice. */
+} nrf_ble_scan_t;
+
+ret_code_t nrf_ble_scan_init(nrf_ble_scan_t * const p_scan_ctx, nrf_ble_scan_init_t const * const p_init, nrf_ble_scan_evt_handler_t evt_handler);
+ret_code_t nrf_ble_scan_params_set(nrf_ble_scan_t * const p_scan_ctx, ble_gap_scan_params_t const * const p_scan_param);
+ret_code_t nrf_ble_scan_start(nrf_ble_scan_t const * const p_scan_ctx);
+void nrf_ble_scan_stop(void);
+void nrf_ble_scan_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_contex);
+
+#endif // NRF_BLE_SCAN_H__
@@ -0,0 +1,36 @@
+/** @file nrf_crypto.h
+ *
+ * @brief Host stand-in for nrf_crypto, SHA-256 HMAC only.
+ */
+
+#ifndef NRF_CRYPTO_H__
+#define NRF_CRYPTO_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sdk_errors.h"
+#include "nrf_crypto_error.h"
+#include "nrf_crypto_init.h"
+#include "nrf_crypto_rng.h"
+
+#define NRF_CRYPTO_HASH_SIZE_SHA256 (32) /**< Size of SHA-256 hash digest. */
+
+/** HMAC algorithm info. */
+typedef struct {
+    size_t digest_size; /**< Digest size in bytes. */
+} nrf_crypto_hmac_info_t;
+
+/** HMAC context. */
+typedef struct {
+    uint32_t dummy; /**< Context is not used on host. */
+} nrf_crypto_hmac_context_t;
+
+extern const nrf_crypto_hmac_info_t g_nrf_crypto_hmac_sha256_info;
+
+ret_code_t nrf_crypto_hmac_calculate(nrf_crypto_hmac_context_t * const p_context,
+                                     nrf_crypto_hmac_info_t const * p_info,
+                                     uint8_t * p_digest, size_t * const p_digest_size,
+                                     uint8_t const * p_key, size_t key_size,
+                                     uint8_t const * p_data, size_t data_size);
+
+#endif // NRF_CRYPTO_H__
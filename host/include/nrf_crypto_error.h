@@ -0,0 +1,21 @@
+/** @file nrf_crypto_error.h
+ *
+ * @brief Host stand-in for nrf_crypto error codes.
+ */
+
+#ifndef NRF_CRYPTO_ERROR_H__
+#define NRF_CRYPTO_ERROR_H__
+
+#define NRF_ERROR_CRYPTO_ERR_BASE                 (0x8500) /**< Base value for nrf_crypto errors. */
+#define NRF_ERROR_CRYPTO_NOT_INITIALIZED          (NRF_ERROR_CRYPTO_ERR_BASE + 0x01) /**< nrf_crypto_init was not called. */
+#define NRF_ERROR_CRYPTO_CONTEXT_NULL             (NRF_ERROR_CRYPTO_ERR_BASE + 0x02) /**< Context is NULL. */
+#define NRF_ERROR_CRYPTO_CONTEXT_NOT_INITIALIZED  (NRF_ERROR_CRYPTO_ERR_BASE + 0x03) /**< Context was not initialized. */
+#define NRF_ERROR_CRYPTO_FEATURE_UNAVAILABLE      (NRF_ERROR_CRYPTO_ERR_BASE + 0x04) /**< Feature is not available. */
+#define NRF_ERROR_CRYPTO_BUSY                     (NRF_ERROR_CRYPTO_ERR_BASE + 0x05) /**< Backend is busy. */
+#define NRF_ERROR_CRYPTO_INPUT_NULL               (NRF_ERROR_CRYPTO_ERR_BASE + 0x06) /**< Input is NULL. */
+#define NRF_ERROR_CRYPTO_INPUT_LENGTH             (NRF_ERROR_CRYPTO_ERR_BASE + 0x07) /**< Input length is invalid. */
+#define NRF_ERROR_CRYPTO_INPUT_LOCATION           (NRF_ERROR_CRYPTO_ERR_BASE + 0x08) /**< Input is not in RAM. */
+#define NRF_ERROR_CRYPTO_OUTPUT_NULL              (NRF_ERROR_CRYPTO_ERR_BASE + 0x09) /**< Output is NULL. */
+#define NRF_ERROR_CRYPTO_OUTPUT_LENGTH            (NRF_ERROR_CRYPTO_ERR_BASE + 0x0A) /**< Output buffer is too small. */
+
+#endif // NRF_CRYPTO_ERROR_H__
@@ -0,0 +1,13 @@
+/** @file nrf_crypto_init.h
+ *
+ * @brief Host stand-in for nrf_crypto initialization.
+ */
+
+#ifndef NRF_CRYPTO_INIT_H__
+#define NRF_CRYPTO_INIT_H__
+
+#include "sdk_errors.h"
+
+ret_code_t nrf_crypto_init(void);
+
+#endif // NRF_CRYPTO_INIT_H__
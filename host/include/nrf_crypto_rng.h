@@ -0,0 +1,16 @@
+/** @file nrf_crypto_rng.h
+ *
+ * @brief Host stand-in for nrf_crypto RNG, seeded from the simulation seed.
+ */
+
+#ifndef NRF_CRYPTO_RNG_H__
+#define NRF_CRYPTO_RNG_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sdk_errors.h"
+
+ret_code_t nrf_crypto_rng_init(void * p_context, void * p_temp_buffer);
+ret_code_t nrf_crypto_rng_vector_generate(uint8_t * const p_target, size_t size);
+
+#endif // NRF_CRYPTO_RNG_H__
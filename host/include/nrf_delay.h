@@ -0,0 +1,13 @@
+/** @file nrf_delay.h
+ *
+ * @brief Host stand-in for busy-wait delays, which advance the virtual clock.
+ */
+
+#ifndef NRF_DELAY_H__
+#define NRF_DELAY_H__
+
+#include <stdint.h>
+
+void nrf_delay_ms(uint32_t ms_time);
+
+#endif // NRF_DELAY_H__
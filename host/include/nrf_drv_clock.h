@@ -0,0 +1,10 @@
+/** @file nrf_drv_clock.h
+ *
+ * @brief Host stand-in for clock driver.
+ */
+
+#ifndef NRF_DRV_CLOCK_H__
+#define NRF_DRV_CLOCK_H__
+
+
+#endif // NRF_DRV_CLOCK_H__
@@ -0,0 +1,66 @@
+/** @file nrf_drv_saadc.h
+ *
+ * @brief Host stand-in for SAADC driver. Samples complete after a fixed conversion time.
+ */
+
+#ifndef NRF_DRV_SAADC_H__
+#define NRF_DRV_SAADC_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+/** SAADC sample value. */
+typedef int16_t nrf_saadc_value_t;
+
+/** SAADC analog inputs. */
+typedef enum {
+    NRF_SAADC_INPUT_DISABLED,
+    NRF_SAADC_INPUT_VDD = 9,
+} nrf_saadc_input_t;
+
+/** SAADC channel configuration. */
+typedef struct {
+    nrf_saadc_input_t pin_p; /**< Input positive pin selection. */
+    nrf_saadc_input_t pin_n; /**< Input negative pin selection. */
+} nrf_saadc_channel_config_t;
+
+/** SAADC driver configuration. */
+typedef struct {
+    uint8_t resolution;         /**< Resolution configuration. */
+    uint8_t oversample;         /**< Oversampling configuration. */
+    uint8_t interrupt_priority; /**< Interrupt priority. */
+} nrf_drv_saadc_config_t;
+
+/** SAADC driver event types. */
+typedef enum {
+    NRF_DRV_SAADC_EVT_DONE,         /**< Event generated when the buffer is filled with samples. */
+    NRF_DRV_SAADC_EVT_LIMIT,        /**< Event generated after one of the limits is reached. */
+    NRF_DRV_SAADC_EVT_CALIBRATEDONE /**< Event generated when the calibration is complete. */
+} nrf_drv_saadc_evt_type_t;
+
+/** SAADC driver event. */
+typedef struct {
+    nrf_drv_saadc_evt_type_t type; /**< Event type. */
+    union {
+        struct {
+            nrf_saadc_value_t * p_buffer; /**< Pointer to buffer with converted samples. */
+            uint16_t            size;     /**< Number of samples in the buffer. */
+        } done;                           /**< Data for @ref NRF_DRV_SAADC_EVT_DONE event. */
+    } data;
+} nrf_drv_saadc_evt_t;
+
+/** SAADC event handler. */
+typedef void (*nrf_drv_saadc_event_handler_t)(nrf_drv_saadc_evt_t const * p_event);
+
+#define NRF_DRV_SAADC_DEFAULT_CHANNEL_CONFIG_SE(PIN_P) \
+    {                                                  \
+        .pin_p = (nrf_saadc_input_t)(PIN_P),           \
+        .pin_n = NRF_SAADC_INPUT_DISABLED,             \
+    }
+
+ret_code_t nrf_drv_saadc_init(nrf_drv_saadc_config_t const * p_config, nrf_drv_saadc_event_handler_t event_handler);
+ret_code_t nrf_drv_saadc_channel_init(uint8_t channel, nrf_saadc_channel_config_t const * const p_config);
+ret_code_t nrf_drv_saadc_buffer_convert(nrf_saadc_value_t * buffer, uint16_t size);
+ret_code_t nrf_drv_saadc_sample(void);
+
+#endif // NRF_DRV_SAADC_H__
@@ -0,0 +1,38 @@
+/** @file nrf_drv_wdt.h
+ *
+ * @brief Host stand-in for watchdog driver. The watchdog reload runs on the virtual clock.
+ */
+
+#ifndef NRF_DRV_WDT_H__
+#define NRF_DRV_WDT_H__
+
+#include <stdint.h>
+#include "sdk_config.h"
+#include "sdk_errors.h"
+
+/** Watchdog event handler. */
+typedef void (*nrf_wdt_event_handler_t)(void);
+
+/** Watchdog channel ID. */
+typedef uint8_t nrf_drv_wdt_channel_id;
+
+/** Watchdog driver configuration. */
+typedef struct {
+    uint32_t behaviour;          /**< WDT behaviour when CPU is sleeping or halted. */
+    uint32_t reload_value;       /**< WDT reload value in ms. */
+    uint8_t  interrupt_priority; /**< WDT interrupt priority. */
+} nrf_drv_wdt_config_t;
+
+#define NRF_DRV_WDT_DEAFULT_CONFIG                                \
+    {                                                             \
+        .behaviour          = WDT_CONFIG_BEHAVIOUR,               \
+        .reload_value       = WDT_CONFIG_RELOAD_VALUE,            \
+        .interrupt_priority = WDT_CONFIG_IRQ_PRIORITY,            \
+    }
+
+ret_code_t nrf_drv_wdt_init(nrf_drv_wdt_config_t const * p_config, nrf_wdt_event_handler_t wdt_event_handler);
+ret_code_t nrf_drv_wdt_channel_alloc(nrf_drv_wdt_channel_id * p_channel_id);
+void nrf_drv_wdt_enable(void);
+void nrf_drv_wdt_channel_feed(nrf_drv_wdt_channel_id channel_id);
+
+#endif // NRF_DRV_WDT_H__
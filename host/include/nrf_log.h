@@ -0,0 +1,26 @@
+/** @file nrf_log.h
+ *
+ * @brief Host stand-in for logger frontend, printing through the application log.
+ */
+
+#ifndef NRF_LOG_H__
+#define NRF_LOG_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "log.h"
+
+#define NRF_LOG_ERROR(...)   log_printf(LOG_LEVEL_ERROR, __FILENAME__, __LINE__, log_timestamp_get(), __VA_ARGS__)
+#define NRF_LOG_WARNING(...) log_printf(LOG_LEVEL_WARN, __FILENAME__, __LINE__, log_timestamp_get(), __VA_ARGS__)
+#define NRF_LOG_INFO(...)    log_printf(LOG_LEVEL_INFO, __FILENAME__, __LINE__, log_timestamp_get(), __VA_ARGS__)
+#define NRF_LOG_DEBUG(...)   log_printf(LOG_LEVEL_DBG1, __FILENAME__, __LINE__, log_timestamp_get(), __VA_ARGS__)
+
+#define NRF_LOG_PUSH(_str)   (_str)
+
+#define NRF_LOG_FLOAT_MARKER "%s%d.%02d"
+#define NRF_LOG_FLOAT(val) (((val) < 0 && (val) > -1.0) ? "-" : ""), \
+                           (int)(val),                                   \
+                           (int)((((val) > 0) ? (val) - (int)(val)       \
+                                              : (int)(val) - (val)) * 100)
+
+#endif // NRF_LOG_H__
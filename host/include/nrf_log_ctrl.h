@@ -0,0 +1,15 @@
+/** @file nrf_log_ctrl.h
+ *
+ * @brief Host stand-in for logger control.
+ */
+
+#ifndef NRF_LOG_CTRL_H__
+#define NRF_LOG_CTRL_H__
+
+#include "nrf_log.h"
+
+#define NRF_LOG_INIT(timestamp_func) NRF_SUCCESS
+#define NRF_LOG_PROCESS()            false
+#define NRF_LOG_FINAL_FLUSH()        ((void)0)
+
+#endif // NRF_LOG_CTRL_H__
@@ -0,0 +1,11 @@
+/** @file nrf_log_default_backends.h
+ *
+ * @brief Host stand-in for logger backends.
+ */
+
+#ifndef NRF_LOG_DEFAULT_BACKENDS_H__
+#define NRF_LOG_DEFAULT_BACKENDS_H__
+
+#define NRF_LOG_DEFAULT_BACKENDS_INIT() ((void)0)
+
+#endif // NRF_LOG_DEFAULT_BACKENDS_H__
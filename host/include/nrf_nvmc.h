@@ -0,0 +1,10 @@
+/** @file nrf_nvmc.h
+ *
+ * @brief Host stand-in for NVMC HAL.
+ */
+
+#ifndef NRF_NVMC_H__
+#define NRF_NVMC_H__
+
+
+#endif // NRF_NVMC_H__
@@ -0,0 +1,10 @@
+/** @file nrf_power.h
+ *
+ * @brief Host stand-in for POWER HAL.
+ */
+
+#ifndef NRF_POWER_H__
+#define NRF_POWER_H__
+
+
+#endif // NRF_POWER_H__
@@ -0,0 +1,41 @@
+/** @file nrf_pwr_mgmt.h
+ *
+ * @brief Host stand-in for power management. Sleeping advances the virtual clock.
+ */
+
+#ifndef NRF_PWR_MGMT_H__
+#define NRF_PWR_MGMT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+/** Power management shutdown types. */
+typedef enum {
+    NRF_PWR_MGMT_SHUTDOWN_GOTO_SYSOFF,   /**< Go to System OFF. */
+    NRF_PWR_MGMT_SHUTDOWN_STAY_IN_SYSOFF, /**< Go to System OFF and stay there. */
+    NRF_PWR_MGMT_SHUTDOWN_GOTO_DFU,      /**< Go to DFU mode. */
+    NRF_PWR_MGMT_SHUTDOWN_RESET,         /**< Reset chip. */
+    NRF_PWR_MGMT_SHUTDOWN_CONTINUE       /**< Continue shutdown. */
+} nrf_pwr_mgmt_shutdown_t;
+
+/** Shutdown event types. */
+typedef enum {
+    NRF_PWR_MGMT_EVT_PREPARE_WAKEUP = NRF_PWR_MGMT_SHUTDOWN_GOTO_SYSOFF, /**< Application will prepare the wakeup mechanism. */
+    NRF_PWR_MGMT_EVT_PREPARE_SYSOFF = NRF_PWR_MGMT_SHUTDOWN_STAY_IN_SYSOFF, /**< Application will prepare to stay in System OFF state. */
+    NRF_PWR_MGMT_EVT_PREPARE_DFU    = NRF_PWR_MGMT_SHUTDOWN_GOTO_DFU,    /**< Application will prepare to enter DFU mode. */
+    NRF_PWR_MGMT_EVT_PREPARE_RESET  = NRF_PWR_MGMT_SHUTDOWN_RESET,       /**< Application will prepare to chip reset. */
+} nrf_pwr_mgmt_evt_t;
+
+/** Shutdown handler. */
+typedef bool (*nrf_pwr_mgmt_shutdown_handler_t)(nrf_pwr_mgmt_evt_t event);
+
+/** Macro for registering a shutdown handler. Shutdown is not simulated, the handler is only referenced. */
+#define NRF_PWR_MGMT_HANDLER_REGISTER(_handler, _priority) \
+    static nrf_pwr_mgmt_shutdown_handler_t const _handler##_pwr_mgmt __attribute__((used)) = (_handler)
+
+ret_code_t nrf_pwr_mgmt_init(void);
+void nrf_pwr_mgmt_run(void);
+void nrf_pwr_mgmt_shutdown(nrf_pwr_mgmt_shutdown_t shutdown_type);
+
+#endif // NRF_PWR_MGMT_H__
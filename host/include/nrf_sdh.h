@@ -0,0 +1,17 @@
+/** @file nrf_sdh.h
+ *
+ * @brief Host stand-in for SoftDevice handler.
+ */
+
+#ifndef NRF_SDH_H__
+#define NRF_SDH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+ret_code_t nrf_sdh_enable_request(void);
+ret_code_t nrf_sdh_disable_request(void);
+bool nrf_sdh_is_enabled(void);
+
+#endif // NRF_SDH_H__
@@ -0,0 +1,44 @@
+/** @file nrf_sdh_ble.h
+ *
+ * @brief Host stand-in for SoftDevice handler BLE support. Observers are collected in a linker section, like in the SDK.
+ */
+
+#ifndef NRF_SDH_BLE_H__
+#define NRF_SDH_BLE_H__
+
+#include <stdint.h>
+#include "sdk_config.h"
+#include "sdk_errors.h"
+#include "ble.h"
+
+/** BLE stack event handler. */
+typedef void (*nrf_sdh_ble_evt_handler_t)(ble_evt_t const * p_ble_evt, void * p_context);
+
+/** BLE event observer. */
+typedef struct {
+    nrf_sdh_ble_evt_handler_t handler;   /**< BLE event handler. */
+    void *                    p_context; /**< A parameter to the event handler. */
+    uint8_t                   prio;      /**< Observer priority, lower is called first. */
+} nrf_sdh_ble_evt_observer_t;
+
+/**@brief Macro for registering a BLE stack event observer.
+ *
+ * @param _name     Observer name.
+ * @param _prio     Priority of the observer event handler.
+ * @param _handler  BLE event handler.
+ * @param _context  Parameter to the event handler.
+ * @hideinitializer
+ */
+#define NRF_SDH_BLE_OBSERVER(_name, _prio, _handler, _context)                        \
+    static nrf_sdh_ble_evt_observer_t const _name                                     \
+        __attribute__((section("sdh_ble_observers"), used, aligned(sizeof(void *)))) = \
+    {                                                                                 \
+        .handler   = _handler,                                                        \
+        .p_context = _context,                                                        \
+        .prio      = _prio,                                                           \
+    }
+
+ret_code_t nrf_sdh_ble_default_cfg_set(uint8_t conn_cfg_tag, uint32_t * p_ram_start);
+ret_code_t nrf_sdh_ble_enable(uint32_t * p_app_ram_start);
+
+#endif // NRF_SDH_BLE_H__
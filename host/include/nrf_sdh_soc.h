@@ -0,0 +1,11 @@
+/** @file nrf_sdh_soc.h
+ *
+ * @brief Host stand-in for SoftDevice handler SoC event support.
+ */
+
+#ifndef NRF_SDH_SOC_H__
+#define NRF_SDH_SOC_H__
+
+#include "nrf_soc.h"
+
+#endif // NRF_SDH_SOC_H__
@@ -0,0 +1,18 @@
+/** @file nrf_sdm.h
+ *
+ * @brief Host stand-in for SoftDevice manager.
+ */
+
+#ifndef NRF_SDM_H__
+#define NRF_SDM_H__
+
+#include <stdint.h>
+
+#define NRF_FAULT_ID_SD_RANGE_START  0x00000000
+#define NRF_FAULT_ID_APP_RANGE_START 0x00001000
+#define NRF_FAULT_ID_SD_ASSERT       (NRF_FAULT_ID_SD_RANGE_START + 1) /**< SoftDevice assertion. */
+#define NRF_FAULT_ID_APP_MEMACC      (NRF_FAULT_ID_APP_RANGE_START + 1) /**< Application invalid memory access. */
+
+uint32_t sd_softdevice_disable(void);
+
+#endif // NRF_SDM_H__
@@ -0,0 +1,22 @@
+/** @file nrf_soc.h
+ *
+ * @brief Host stand-in for SoftDevice SoC library.
+ */
+
+#ifndef NRF_SOC_H__
+#define NRF_SOC_H__
+
+#include <stdint.h>
+#include "nrf_error.h"
+
+#define NRF_ERROR_SOC_RAND_NOT_ENOUGH_VALUES (NRF_ERROR_SOC_BASE_NUM + 2) /**< Not enough random bytes available. */
+
+uint32_t sd_power_gpregret_get(uint32_t gpregret_id, uint32_t * p_gpregret);
+uint32_t sd_power_gpregret_set(uint32_t gpregret_id, uint32_t gpregret_msk);
+uint32_t sd_power_gpregret_clr(uint32_t gpregret_id, uint32_t gpregret_msk);
+uint32_t sd_rand_application_bytes_available_get(uint8_t * p_bytes_available);
+uint32_t sd_rand_application_vector_get(uint8_t * p_buff, uint8_t length);
+uint32_t sd_flash_page_erase(uint32_t page_number);
+uint32_t sd_nvic_SystemReset(void);
+
+#endif // NRF_SOC_H__
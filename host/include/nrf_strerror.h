@@ -0,0 +1,13 @@
+/** @file nrf_strerror.h
+ *
+ * @brief Host stand-in for error code to string conversion.
+ */
+
+#ifndef NRF_STRERROR_H__
+#define NRF_STRERROR_H__
+
+#include "sdk_errors.h"
+
+char const * nrf_strerror_get(ret_code_t code);
+
+#endif // NRF_STRERROR_H__
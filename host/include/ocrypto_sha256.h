@@ -0,0 +1,23 @@
+/** @file ocrypto_sha256.h
+ *
+ * @brief Host stand-in for Oberon SHA-256 with the same incremental API.
+ */
+
+#ifndef OCRYPTO_SHA256_H__
+#define OCRYPTO_SHA256_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/** SHA-256 context. */
+typedef struct {
+    uint32_t h[8];          /**< Hash state. */
+    uint8_t  buffer[64];    /**< Partial input block. */
+    uint64_t length;        /**< Processed input length in bytes. */
+} ocrypto_sha256_ctx;
+
+void ocrypto_sha256_init(ocrypto_sha256_ctx * ctx);
+void ocrypto_sha256_update(ocrypto_sha256_ctx * ctx, const uint8_t * in, size_t in_len);
+void ocrypto_sha256_final(ocrypto_sha256_ctx * ctx, uint8_t r[32]);
+
+#endif // OCRYPTO_SHA256_H__
@@ -0,0 +1,39 @@
+/** @file sdk_common.h
+ *
+ * @brief Host stand-in for nRF SDK common includes and parameter checks.
+ */
+
+#ifndef SDK_COMMON_H__
+#define SDK_COMMON_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "sdk_config.h"
+#include "nordic_common.h"
+#include "sdk_errors.h"
+#include "app_util.h"
+
+#define VERIFY_SUCCESS(statement)                  \
+    do {                                           \
+        uint32_t _err_code = (uint32_t)(statement); \
+        if (_err_code != NRF_SUCCESS) {            \
+            return _err_code;                      \
+        }                                          \
+    } while (0)
+
+#define VERIFY_PARAM_NOT_NULL(param) \
+    do {                             \
+        if ((param) == NULL) {       \
+            return NRF_ERROR_NULL;   \
+        }                            \
+    } while (0)
+
+#define VERIFY_PARAM_NOT_NULL_VOID(param) \
+    do {                                  \
+        if ((param) == NULL) {            \
+            return;                       \
+        }                                 \
+    } while (0)
+
+#endif // SDK_COMMON_H__
@@ -0,0 +1,15 @@
+#ifndef SIM_LOG_H__
+#define SIM_LOG_H__
+
+#include <stdarg.h>
+#include <stdint.h>
+
+/**@brief Log callback of the host build, stamps messages with the virtual clock.
+ *
+ * Forced into every translation unit so that LOG_CALLBACK_DEFAULT resolves
+ * to it in main.c without touching the firmware sources.
+ */
+void sim_log_callback(uint32_t dbg_level, const char * p_filename, uint16_t line,
+                      uint32_t timestamp, const char * format, va_list arguments);
+
+#endif /* SIM_LOG_H__ */
@@ -0,0 +1,247 @@
+/** @file sim.h
+ *
+ * @brief Virtual clock, event queue and statistics of the BLEAM Scanner host simulator.
+ *
+ * @details Everything the firmware waits for, timers, radio, flash and ADC, is an event
+ *          on one queue ordered by virtual time in microseconds. @ref nrf_pwr_mgmt_run
+ *          jumps straight to the next event instead of sleeping, so days of scanning
+ *          take seconds of host time.
+ */
+
+#ifndef SIM_H__
+#define SIM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ble.h"
+#include "ble_gatt_db.h"
+
+#define SIM_US_PER_MS  1000ULL                    /**< Microseconds in a millisecond. */
+#define SIM_US_PER_SEC 1000000ULL                 /**< Microseconds in a second. */
+#define SIM_US_PER_DAY (86400ULL * SIM_US_PER_SEC) /**< Microseconds in a day. */
+
+#define SIM_LATENCY_MAX 65536 /**< Maximum number of report latency samples kept. */
+
+/**@brief Source of an event, used to tell what woke the CPU up. */
+typedef enum {
+    SIM_WAKE_TIMER, /**< RTC compare of app_timer. */
+    SIM_WAKE_RADIO, /**< SoftDevice BLE event. */
+    SIM_WAKE_FLASH, /**< FDS operation completed. */
+    SIM_WAKE_OTHER, /**< Peripheral such as SAADC. */
+    SIM_WAKE_CNT    /**< Number of wakeup sources. */
+} sim_wake_t;
+
+/**@brief Event callback.
+ *
+ * @param[in] p_ctx    Context given to @ref sim_post.
+ * @param[in] arg      Argument given to @ref sim_post.
+ *
+ * @returns True if the event reached the application and woke the CPU up.
+ */
+typedef bool (*sim_evt_fn_t)(void * p_ctx, uint64_t arg);
+
+/**@brief Simulation settings, filled from the command line. */
+typedef struct {
+    uint32_t days;           /**< Simulated time, days. */
+    uint32_t bleams;         /**< Number of BLEAM devices. */
+    uint32_t slow_peers;     /**< Number of BLEAM devices that ask for slower connection parameters. */
+    uint32_t noise;          /**< Number of other advertisers around. */
+    uint32_t seed;           /**< Random seed. */
+    uint32_t start_ms;       /**< Time of day at power on, ms. */
+    uint32_t present_from_ms; /**< Time of day BLEAM devices arrive, ms. */
+    uint32_t present_to_ms;  /**< Time of day BLEAM devices leave, ms. */
+    int32_t  rtc_ppm;        /**< RTC crystal error, ppm. */
+    uint16_t node_id;        /**< Node ID stored in configuration record. */
+    bool     unconfigured;   /**< Start without configuration record. */
+    int      verbosity;      /**< Highest firmware log level to print. */
+} sim_config_t;
+
+/**@brief Radio and link statistics kept by the SoftDevice stand-in. */
+typedef struct {
+    uint64_t scan_us;             /**< Radio on time while scanning, us. */
+    uint64_t initiate_us;         /**< Radio on time while initiating connections, us. */
+    uint64_t conn_us;             /**< Radio on time in connection events, us. */
+    uint64_t adv_us;              /**< Radio on time while advertising, us. */
+    uint32_t reports_bleam;       /**< BLEAM advertising reports delivered. */
+    uint32_t reports_other;       /**< Other advertising reports delivered. */
+    uint32_t connect_attempts;    /**< Calls to sd_ble_gap_connect(). */
+    uint32_t connects;            /**< Connections established. */
+    uint32_t connect_timeouts;    /**< Connection attempts that timed out. */
+    uint32_t supervision_timeouts; /**< Connections lost because the peer went away. */
+    uint32_t conn_events;         /**< Connection events. */
+    uint32_t discoveries;         /**< Service discoveries. */
+    uint32_t param_updates;       /**< Connection parameter updates. */
+} sim_radio_stats_t;
+
+/**@brief Statistics of the simulated BLEAM devices. */
+typedef struct {
+    uint32_t sessions;       /**< Connections that delivered RSSI data. */
+    uint32_t sig_ok;         /**< Signatures that matched the node key. */
+    uint32_t sig_bad;        /**< Signatures that did not match. */
+    uint32_t rssi_writes;    /**< RSSI data packets received. */
+    uint32_t health_writes;  /**< Health packets received. */
+    uint32_t time_reads;     /**< Reads of the time characteristic. */
+    uint32_t latency_cnt;    /**< Number of report latency samples, only the first @ref SIM_LATENCY_MAX are kept. */
+    uint32_t latency_ms[SIM_LATENCY_MAX]; /**< Time from first report to delivered RSSI data, ms. */
+} sim_peer_stats_t;
+
+extern sim_config_t      g_sim_config;
+extern sim_radio_stats_t g_sim_radio;
+extern sim_peer_stats_t  g_sim_peers;
+
+/* sim_clock.c */
+
+/**@brief Function for getting the virtual time.
+ *
+ * @returns Microseconds since power on.
+ */
+uint64_t sim_now_us(void);
+
+/**@brief Function for getting the true time of day.
+ *
+ * @returns Milliseconds since midnight, not affected by RTC error.
+ */
+uint32_t sim_time_of_day_ms(void);
+
+/**@brief Function for scheduling an event.
+ *
+ * @param[in] at_us    Virtual time of the event, us. Past times run as soon as possible.
+ * @param[in] kind     Wakeup source the event counts as.
+ * @param[in] fn       Callback to run.
+ * @param[in] p_ctx    Context passed to the callback.
+ * @param[in] arg      Argument passed to the callback.
+ *
+ * @returns Nothing.
+ */
+void sim_post(uint64_t at_us, sim_wake_t kind, sim_evt_fn_t fn, void * p_ctx, uint64_t arg);
+
+/**@brief Function for getting a uniformly distributed random number.
+ *
+ * @returns Random 32-bit value.
+ */
+uint32_t sim_rand(void);
+
+/**@brief Function for getting a uniformly distributed random number in [0, 1).
+ *
+ * @returns Random value.
+ */
+double sim_randf(void);
+
+/**@brief Function for getting a normally distributed random number.
+ *
+ * @returns Random value with zero mean and unit variance.
+ */
+double sim_gauss(void);
+
+/**@brief Function for arming the watchdog.
+ *
+ * @param[in] reload_ms    Watchdog reload value, ms.
+ *
+ * @returns Nothing.
+ */
+void sim_wdt_start(uint32_t reload_ms);
+
+/**@brief Function for feeding the watchdog.
+ *
+ * @returns Nothing.
+ */
+void sim_wdt_feed(void);
+
+/**@brief Function for counting the CPU wakeups so far.
+ *
+ * @param[out] p_counts    Array of @ref SIM_WAKE_CNT wakeup counts by source.
+ *
+ * @returns Total number of wakeups.
+ */
+uint64_t sim_wakeups_get(uint64_t * p_counts);
+
+/* sim_softdevice.c */
+
+/**@brief Function for creating the simulated BLEAM devices and other advertisers.
+ *
+ * @param[in] p_app_key    Application key the BLEAM devices verify signatures with.
+ *
+ * @returns Nothing.
+ */
+void sim_sd_world_init(uint8_t const * p_app_key);
+
+/**@brief Function for passing a BLE event to all observers in priority order.
+ *
+ * @param[in] p_ble_evt    Event to pass.
+ *
+ * @returns Nothing.
+ */
+void sim_sd_evt_dispatch(ble_evt_t const * p_ble_evt);
+
+/**@brief Callback of a finished service discovery.
+ *
+ * @param[in] conn_handle    Connection handle.
+ * @param[in] p_srv          Discovered service, NULL if not found.
+ */
+typedef void (*sim_sd_discovery_cb_t)(uint16_t conn_handle, ble_gatt_db_srv_t const * p_srv);
+
+/**@brief Function for discovering a service and its characteristics at the peer.
+ *
+ * @details Takes as many request/response round trips as the real procedure would
+ *          with the current ATT MTU, then calls @p callback unless the link is lost.
+ *
+ * @param[in] conn_handle    Connection handle.
+ * @param[in] p_uuid         UUID of the service.
+ * @param[in] callback       Callback to call when done.
+ *
+ * @retval NRF_SUCCESS                      Discovery started.
+ * @retval BLE_ERROR_INVALID_CONN_HANDLE    No such connection.
+ * @retval NRF_ERROR_BUSY                   Another client procedure is in progress.
+ */
+uint32_t sim_sd_discover(uint16_t conn_handle, ble_uuid_t const * p_uuid, sim_sd_discovery_cb_t callback);
+
+/**@brief Function for finishing open radio activity accounting at the end of the run.
+ *
+ * @returns Nothing.
+ */
+void sim_sd_accounting_close(void);
+
+/**@brief Function for printing statistics of each BLEAM device.
+ *
+ * @returns Nothing.
+ */
+void sim_sd_peers_print(void);
+
+/* sim_sdk.c */
+
+/**@brief Function for storing the configuration record in simulated flash before boot.
+ *
+ * @param[in] p_data    Record data.
+ * @param[in] words     Record length, words.
+ *
+ * @returns Nothing.
+ */
+void sim_fds_preload(void const * p_data, uint16_t words);
+
+/* sim_crypto.c */
+
+/**@brief Function for computing HMAC SHA256.
+ *
+ * @param[out] p_digest    32 bytes of digest.
+ * @param[in]  p_key       Key.
+ * @param[in]  key_size    Key length, bytes.
+ * @param[in]  p_data      Data.
+ * @param[in]  data_size   Data length, bytes.
+ *
+ * @returns Nothing.
+ */
+void sim_hmac_sha256(uint8_t * p_digest, uint8_t const * p_key, size_t key_size,
+                     uint8_t const * p_data, size_t data_size);
+
+/* sim_main.c */
+
+/**@brief Function for ending the simulation.
+ *
+ * @param[in] p_reason    Why the simulation ended, NULL if the requested time has passed.
+ *
+ * @returns Never.
+ */
+void sim_finish(const char * p_reason) __attribute__((noreturn));
+
+#endif // SIM_H__
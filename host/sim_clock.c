@@ -0,0 +1,311 @@
+/** @file sim_clock.c
+ *
+ * @brief Virtual clock of the host simulator with app_timer, power management and watchdog on top of it.
+ *
+ * @details The RTC runs off the virtual clock with the crystal error from the command
+ *          line, the same error BLEAM time sync has to correct on the real node.
+ *          @ref nrf_pwr_mgmt_run plays the role of WFE: it runs queued events until one
+ *          of them reaches the application, and counts one CPU wakeup for each moment
+ *          the application is woken up at.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "app_timer.h"
+#include "nrf_delay.h"
+#include "nrf_pwr_mgmt.h"
+
+/**@brief Queued event. */
+typedef struct {
+    uint64_t     at_us; /**< Virtual time of the event, us. */
+    uint64_t     seq;   /**< Posting order, keeps events of the same time in order. */
+    sim_evt_fn_t fn;    /**< Callback. */
+    void *       p_ctx; /**< Callback context. */
+    uint64_t     arg;   /**< Callback argument. */
+    sim_wake_t   kind;  /**< Wakeup source. */
+} sim_evt_t;
+
+static uint64_t    m_now_us;      /**< Virtual time, us. */
+static sim_evt_t * m_heap;        /**< Binary min-heap of events. */
+static size_t      m_heap_len;    /**< Number of queued events. */
+static size_t      m_heap_size;   /**< Allocated heap entries. */
+static uint64_t    m_seq;         /**< Next event sequence number. */
+static uint64_t    m_rng_state;   /**< Random generator state. */
+
+static uint64_t m_wakeups[SIM_WAKE_CNT]; /**< CPU wakeups by source. */
+static uint64_t m_last_wake_us;          /**< Time of the latest wakeup, us. */
+static bool     m_woken;                 /**< Flag denoting that the CPU has been woken up at least once. */
+
+static bool     m_wdt_running;   /**< Flag denoting that the watchdog is armed. */
+static uint64_t m_wdt_reload_us; /**< Watchdog reload value, us. */
+static uint64_t m_wdt_fed_us;    /**< Time of the latest feed, us. */
+
+static bool m_timer_initialized; /**< Flag denoting that app_timer has been initialized. */
+
+/**@brief Function for comparing two events by time and posting order.
+ *
+ * @returns True if @p p_a runs before @p p_b.
+ */
+static bool evt_before(sim_evt_t const * p_a, sim_evt_t const * p_b) {
+    return (p_a->at_us != p_b->at_us) ? (p_a->at_us < p_b->at_us) : (p_a->seq < p_b->seq);
+}
+
+/**@brief Function for taking the earliest event off the queue.
+ *
+ * @returns Nothing.
+ */
+static void heap_pop(void) {
+    m_heap[0] = m_heap[--m_heap_len];
+    size_t pos = 0;
+    for (;;) {
+        size_t best = pos;
+        const size_t left = 2 * pos + 1;
+        const size_t right = left + 1;
+        if (m_heap_len > left && evt_before(&m_heap[left], &m_heap[best])) {
+            best = left;
+        }
+        if (m_heap_len > right && evt_before(&m_heap[right], &m_heap[best])) {
+            best = right;
+        }
+        if (best == pos) {
+            break;
+        }
+        const sim_evt_t tmp = m_heap[pos];
+        m_heap[pos] = m_heap[best];
+        m_heap[best] = tmp;
+        pos = best;
+    }
+}
+
+void sim_post(uint64_t at_us, sim_wake_t kind, sim_evt_fn_t fn, void * p_ctx, uint64_t arg) {
+    if (m_heap_len == m_heap_size) {
+        m_heap_size = m_heap_size ? 2 * m_heap_size : 256;
+        m_heap = realloc(m_heap, m_heap_size * sizeof(sim_evt_t));
+        if (NULL == m_heap) {
+            fprintf(stderr, "sim: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    size_t pos = m_heap_len++;
+    const sim_evt_t evt = {
+        .at_us = MAX(at_us, m_now_us),
+        .seq   = m_seq++,
+        .fn    = fn,
+        .p_ctx = p_ctx,
+        .arg   = arg,
+        .kind  = kind,
+    };
+    while (0 < pos && evt_before(&evt, &m_heap[(pos - 1) / 2])) {
+        m_heap[pos] = m_heap[(pos - 1) / 2];
+        pos = (pos - 1) / 2;
+    }
+    m_heap[pos] = evt;
+}
+
+uint64_t sim_now_us(void) {
+    return m_now_us;
+}
+
+uint32_t sim_time_of_day_ms(void) {
+    return (uint32_t)((g_sim_config.start_ms + m_now_us / SIM_US_PER_MS) % (SIM_US_PER_DAY / SIM_US_PER_MS));
+}
+
+uint32_t sim_rand(void) {
+    if (0 == m_rng_state) {
+        m_rng_state = 0x9E3779B97F4A7C15ULL * (g_sim_config.seed + 1);
+    }
+    // xorshift64*
+    m_rng_state ^= m_rng_state >> 12;
+    m_rng_state ^= m_rng_state << 25;
+    m_rng_state ^= m_rng_state >> 27;
+    return (uint32_t)((m_rng_state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+double sim_randf(void) {
+    return sim_rand() / 4294967296.0;
+}
+
+double sim_gauss(void) {
+    // Box-Muller, one of the pair is enough
+    const double u = 1.0 - sim_randf();
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * sim_randf());
+}
+
+/**@brief Function for reading the RTC.
+ *
+ * @returns RTC ticks since power on, not wrapped to 24 bits.
+ */
+static uint64_t rtc_ticks(void) {
+    const __int128 rate = (__int128)APP_TIMER_CLOCK_FREQ * (1000000 + g_sim_config.rtc_ppm);
+    return (uint64_t)((__int128)m_now_us * rate / 1000000000000LL);
+}
+
+/**@brief Function for converting an RTC tick to virtual time.
+ *
+ * @param[in] ticks    RTC ticks since power on.
+ *
+ * @returns Earliest virtual time the RTC reaches @p ticks at, us.
+ */
+static uint64_t rtc_ticks_to_us(uint64_t ticks) {
+    const __int128 rate = (__int128)APP_TIMER_CLOCK_FREQ * (1000000 + g_sim_config.rtc_ppm);
+    return (uint64_t)(((__int128)ticks * 1000000000000LL + rate - 1) / rate);
+}
+
+/**@brief Function for handling an RTC compare event of a timer.
+ *
+ * @param[in] p_ctx    Timer.
+ * @param[in] arg      Timer generation the event was scheduled for.
+ *
+ * @returns True if the timer was still running.
+ */
+static bool timer_expire(void * p_ctx, uint64_t arg) {
+    app_timer_t * p_timer = p_ctx;
+    if (!p_timer->is_running || p_timer->generation != arg) {
+        return false;
+    }
+    if (APP_TIMER_MODE_REPEATED == p_timer->mode) {
+        p_timer->expiry += p_timer->period;
+        sim_post(rtc_ticks_to_us(p_timer->expiry), SIM_WAKE_TIMER, timer_expire, p_timer, p_timer->generation);
+    } else {
+        p_timer->is_running = false;
+    }
+    p_timer->handler(p_timer->p_context);
+    return true;
+}
+
+ret_code_t app_timer_init(void) {
+    m_timer_initialized = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_create(app_timer_id_t const * p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler) {
+    if (!m_timer_initialized) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (NULL == timeout_handler) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (NULL == p_timer_id || NULL == *p_timer_id) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    app_timer_t * p_timer = *p_timer_id;
+    if (p_timer->is_running) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    p_timer->mode = mode;
+    p_timer->handler = timeout_handler;
+    p_timer->is_created = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context) {
+    if (APP_TIMER_MIN_TIMEOUT_TICKS > timeout_ticks || APP_TIMER_MAX_CNT_VAL < timeout_ticks) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (NULL == timer_id || !timer_id->is_created || NULL == timer_id->handler) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    // Legacy app_timer leaves a running timer alone
+    if (timer_id->is_running) {
+        return NRF_SUCCESS;
+    }
+    timer_id->p_context = p_context;
+    timer_id->period = (APP_TIMER_MODE_REPEATED == timer_id->mode) ? timeout_ticks : 0;
+    timer_id->expiry = rtc_ticks() + timeout_ticks;
+    timer_id->is_running = true;
+    ++timer_id->generation;
+    sim_post(rtc_ticks_to_us(timer_id->expiry), SIM_WAKE_TIMER, timer_expire, timer_id, timer_id->generation);
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id) {
+    if (NULL == timer_id || NULL == timer_id->handler) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    timer_id->is_running = false;
+    ++timer_id->generation;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop_all(void) {
+    // Pending expiry events find their timers stopped, nothing else to do
+    return NRF_SUCCESS;
+}
+
+uint32_t app_timer_cnt_get(void) {
+    return (uint32_t)(rtc_ticks() & APP_TIMER_MAX_CNT_VAL);
+}
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from) {
+    return (ticks_to - ticks_from) & APP_TIMER_MAX_CNT_VAL;
+}
+
+ret_code_t nrf_pwr_mgmt_init(void) {
+    return NRF_SUCCESS;
+}
+
+void nrf_pwr_mgmt_run(void) {
+    const uint64_t end_us = g_sim_config.days * SIM_US_PER_DAY;
+    for (;;) {
+        if (0 == m_heap_len) {
+            sim_finish("nothing left to wake up for");
+        }
+        const sim_evt_t evt = m_heap[0];
+        if (m_wdt_running && evt.at_us > m_wdt_fed_us + m_wdt_reload_us && m_wdt_fed_us + m_wdt_reload_us <= end_us) {
+            m_now_us = m_wdt_fed_us + m_wdt_reload_us;
+            sim_finish("watchdog reset");
+        }
+        if (evt.at_us > end_us) {
+            m_now_us = end_us;
+            sim_finish(NULL);
+        }
+        heap_pop();
+        m_now_us = MAX(m_now_us, evt.at_us);
+        if (evt.fn(evt.p_ctx, evt.arg)) {
+            if (!m_woken || m_last_wake_us != m_now_us) {
+                ++m_wakeups[evt.kind];
+            }
+            m_woken = true;
+            m_last_wake_us = m_now_us;
+            return;
+        }
+    }
+}
+
+void nrf_pwr_mgmt_shutdown(nrf_pwr_mgmt_shutdown_t shutdown_type) {
+    UNUSED_PARAMETER(shutdown_type);
+    sim_finish("shutdown");
+}
+
+void nrf_delay_ms(uint32_t ms_time) {
+    // Busy wait, queued events run late
+    m_now_us += ms_time * SIM_US_PER_MS;
+}
+
+void sim_wdt_start(uint32_t reload_ms) {
+    m_wdt_running = true;
+    m_wdt_reload_us = reload_ms * SIM_US_PER_MS;
+    m_wdt_fed_us = m_now_us;
+}
+
+void sim_wdt_feed(void) {
+    m_wdt_fed_us = m_now_us;
+}
+
+uint64_t sim_wakeups_get(uint64_t * p_counts) {
+    uint64_t total = 0;
+    for (int kind = 0; SIM_WAKE_CNT > kind; ++kind) {
+        p_counts[kind] = m_wakeups[kind];
+        total += m_wakeups[kind];
+    }
+    return total;
+}
+
+void NVIC_SystemReset(void) {
+    sim_finish("system reset");
+}
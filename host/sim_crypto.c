@@ -0,0 +1,210 @@
+/** @file sim_crypto.c
+ *
+ * @brief nrf_crypto of the host simulator: SHA-256, HMAC SHA-256 and a seeded RNG.
+ *
+ * @details SHA-256 follows FIPS 180-4 and HMAC follows RFC 2104, so signatures
+ *          computed by the firmware are the ones a real BLEAM device would check.
+ *          Random numbers come from the simulation seed, runs are reproducible.
+ */
+
+#include <string.h>
+
+#include "sim.h"
+#include "nordic_common.h"
+#include "nrf_crypto.h"
+#include "ocrypto_sha256.h"
+
+#define SHA256_BLOCK_SIZE  64 /**< SHA-256 block size, bytes. */
+#define SHA256_DIGEST_SIZE 32 /**< SHA-256 digest size, bytes. */
+
+const nrf_crypto_hmac_info_t g_nrf_crypto_hmac_sha256_info = {.digest_size = NRF_CRYPTO_HASH_SIZE_SHA256};
+
+static bool m_crypto_initialized; /**< Flag denoting that nrf_crypto is initialized. */
+static bool m_rng_initialized;    /**< Flag denoting that the RNG is initialized. */
+
+/** SHA-256 round constants. */
+static const uint32_t m_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/**@brief Function for rotating a word right.
+ *
+ * @returns Rotated word.
+ */
+static uint32_t ror(uint32_t value, uint8_t bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+/**@brief Function for processing one 64-byte block.
+ *
+ * @param[in,out] p_ctx      Hash state.
+ * @param[in]     p_block    Block.
+ *
+ * @returns Nothing.
+ */
+static void sha256_block(ocrypto_sha256_ctx * p_ctx, uint8_t const * p_block) {
+    uint32_t w[64];
+    for (uint8_t index = 0; 16 > index; ++index) {
+        w[index] = (uint32_t)p_block[4 * index] << 24 | (uint32_t)p_block[4 * index + 1] << 16 |
+                   (uint32_t)p_block[4 * index + 2] << 8 | p_block[4 * index + 3];
+    }
+    for (uint8_t index = 16; 64 > index; ++index) {
+        const uint32_t s0 = ror(w[index - 15], 7) ^ ror(w[index - 15], 18) ^ (w[index - 15] >> 3);
+        const uint32_t s1 = ror(w[index - 2], 17) ^ ror(w[index - 2], 19) ^ (w[index - 2] >> 10);
+        w[index] = w[index - 16] + s0 + w[index - 7] + s1;
+    }
+
+    uint32_t a = p_ctx->h[0], b = p_ctx->h[1], c = p_ctx->h[2], d = p_ctx->h[3];
+    uint32_t e = p_ctx->h[4], f = p_ctx->h[5], g = p_ctx->h[6], h = p_ctx->h[7];
+    for (uint8_t index = 0; 64 > index; ++index) {
+        const uint32_t t1 = h + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + ((e & f) ^ (~e & g)) + m_k[index] + w[index];
+        const uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    p_ctx->h[0] += a;
+    p_ctx->h[1] += b;
+    p_ctx->h[2] += c;
+    p_ctx->h[3] += d;
+    p_ctx->h[4] += e;
+    p_ctx->h[5] += f;
+    p_ctx->h[6] += g;
+    p_ctx->h[7] += h;
+}
+
+void ocrypto_sha256_init(ocrypto_sha256_ctx * ctx) {
+    static const uint32_t h0[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(ctx->h, h0, sizeof(h0));
+    ctx->length = 0;
+}
+
+void ocrypto_sha256_update(ocrypto_sha256_ctx * ctx, const uint8_t * in, size_t in_len) {
+    size_t used = ctx->length % SHA256_BLOCK_SIZE;
+    ctx->length += in_len;
+    while (0 < in_len) {
+        const size_t chunk = MIN(in_len, SHA256_BLOCK_SIZE - used);
+        memcpy(&ctx->buffer[used], in, chunk);
+        used += chunk;
+        in += chunk;
+        in_len -= chunk;
+        if (SHA256_BLOCK_SIZE == used) {
+            sha256_block(ctx, ctx->buffer);
+            used = 0;
+        }
+    }
+}
+
+void ocrypto_sha256_final(ocrypto_sha256_ctx * ctx, uint8_t r[32]) {
+    const uint64_t bits = ctx->length * 8;
+    size_t used = ctx->length % SHA256_BLOCK_SIZE;
+    ctx->buffer[used++] = 0x80;
+    if (SHA256_BLOCK_SIZE - 8 < used) {
+        memset(&ctx->buffer[used], 0, SHA256_BLOCK_SIZE - used);
+        sha256_block(ctx, ctx->buffer);
+        used = 0;
+    }
+    memset(&ctx->buffer[used], 0, SHA256_BLOCK_SIZE - 8 - used);
+    for (uint8_t index = 0; 8 > index; ++index) {
+        ctx->buffer[SHA256_BLOCK_SIZE - 1 - index] = (uint8_t)(bits >> (8 * index));
+    }
+    sha256_block(ctx, ctx->buffer);
+    for (uint8_t index = 0; 32 > index; ++index) {
+        r[index] = (uint8_t)(ctx->h[index / 4] >> (24 - 8 * (index % 4)));
+    }
+}
+
+void sim_hmac_sha256(uint8_t * p_digest, uint8_t const * p_key, size_t key_size,
+                     uint8_t const * p_data, size_t data_size) {
+    uint8_t key_block[SHA256_BLOCK_SIZE] = {0};
+    uint8_t pad[SHA256_BLOCK_SIZE];
+    uint8_t inner[SHA256_DIGEST_SIZE];
+    ocrypto_sha256_ctx ctx;
+
+    // Keys longer than a block are hashed first
+    if (SHA256_BLOCK_SIZE < key_size) {
+        ocrypto_sha256_init(&ctx);
+        ocrypto_sha256_update(&ctx, p_key, key_size);
+        ocrypto_sha256_final(&ctx, key_block);
+    } else {
+        memcpy(key_block, p_key, key_size);
+    }
+
+    for (uint8_t index = 0; SHA256_BLOCK_SIZE > index; ++index) {
+        pad[index] = key_block[index] ^ 0x36;
+    }
+    ocrypto_sha256_init(&ctx);
+    ocrypto_sha256_update(&ctx, pad, sizeof(pad));
+    ocrypto_sha256_update(&ctx, p_data, data_size);
+    ocrypto_sha256_final(&ctx, inner);
+
+    for (uint8_t index = 0; SHA256_BLOCK_SIZE > index; ++index) {
+        pad[index] = key_block[index] ^ 0x5c;
+    }
+    ocrypto_sha256_init(&ctx);
+    ocrypto_sha256_update(&ctx, pad, sizeof(pad));
+    ocrypto_sha256_update(&ctx, inner, sizeof(inner));
+    ocrypto_sha256_final(&ctx, p_digest);
+}
+
+ret_code_t nrf_crypto_init(void) {
+    m_crypto_initialized = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_crypto_hmac_calculate(nrf_crypto_hmac_context_t * const p_context,
+                                     nrf_crypto_hmac_info_t const * p_info,
+                                     uint8_t * p_digest, size_t * const p_digest_size,
+                                     uint8_t const * p_key, size_t key_size,
+                                     uint8_t const * p_data, size_t data_size) {
+    UNUSED_PARAMETER(p_context);
+    if (!m_crypto_initialized) {
+        return NRF_ERROR_CRYPTO_NOT_INITIALIZED;
+    }
+    if (NULL == p_info || NULL == p_digest || NULL == p_digest_size || NULL == p_key) {
+        return NRF_ERROR_CRYPTO_INPUT_NULL;
+    }
+    if (p_info->digest_size > *p_digest_size) {
+        return NRF_ERROR_CRYPTO_OUTPUT_LENGTH;
+    }
+    sim_hmac_sha256(p_digest, p_key, key_size, p_data, data_size);
+    *p_digest_size = p_info->digest_size;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_crypto_rng_init(void * p_context, void * p_temp_buffer) {
+    UNUSED_PARAMETER(p_context);
+    UNUSED_PARAMETER(p_temp_buffer);
+    if (!m_crypto_initialized) {
+        return NRF_ERROR_CRYPTO_NOT_INITIALIZED;
+    }
+    m_rng_initialized = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_crypto_rng_vector_generate(uint8_t * const p_target, size_t size) {
+    if (!m_rng_initialized) {
+        return NRF_ERROR_CRYPTO_CONTEXT_NOT_INITIALIZED;
+    }
+    if (NULL == p_target) {
+        return NRF_ERROR_CRYPTO_OUTPUT_NULL;
+    }
+    for (size_t index = 0; size > index; ++index) {
+        p_target[index] = (uint8_t)sim_rand();
+    }
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,256 @@
+/** @file sim_main.c
+ *
+ * @brief Entry point of the BLEAM Scanner host simulator.
+ *
+ * @details Parses the scenario from the command line, stores the configuration record,
+ *          places the BLEAM devices and boots the unchanged firmware. When the requested
+ *          time has passed, or the firmware resets, prints radio on time, CPU wakeups,
+ *          report latency and what the BLEAM devices received.
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "global_app_config.h"
+#include "log.h"
+
+int blesc_main(void);
+
+sim_config_t g_sim_config = {
+    .days            = 1,
+    .bleams          = 3,
+    .slow_peers      = 0,
+    .noise           = 20,
+    .seed            = 1,
+    .start_ms        = 6 * 3600 * 1000,
+    .present_from_ms = 8 * 3600 * 1000,
+    .present_to_ms   = 18 * 3600 * 1000,
+    .rtc_ppm         = 30,
+    .node_id         = 0x0001,
+    .unconfigured    = false,
+    .verbosity       = LOG_LEVEL_WARN,
+};
+
+/** Application key of the simulated installation, shared by the node and all BLEAM devices. */
+static const uint8_t m_app_key[BLEAM_KEY_SIZE] = {
+    0x42, 0x4C, 0x45, 0x41, 0x4D, 0x2D, 0x53, 0x49, 0x4D, 0x2D, 0x4B, 0x45, 0x59, 0x2D, 0x30, 0x31,
+};
+
+void sim_log_callback(uint32_t dbg_level, const char * p_filename, uint16_t line,
+                      uint32_t timestamp, const char * format, va_list arguments) {
+    UNUSED_PARAMETER(timestamp);
+    static const char levels[] = "AEWRI123";
+    if ((uint32_t)g_sim_config.verbosity < dbg_level) {
+        return;
+    }
+    char message[256];
+    vsnprintf(message, sizeof(message), format, arguments);
+    // Firmware lines end with CR LF for RTT viewers
+    for (char * p_char = message; '\0' != *p_char; ++p_char) {
+        if ('\r' == *p_char) {
+            memmove(p_char, p_char + 1, strlen(p_char));
+            --p_char;
+        }
+    }
+    const uint64_t now_ms = sim_now_us() / SIM_US_PER_MS;
+    const char * p_basename = strrchr(p_filename, '/');
+    printf("[%c %u %02u:%02u:%02u.%03u] %s:%u %s", (sizeof(levels) - 1 > dbg_level) ? levels[dbg_level] : '?',
+           (unsigned)(now_ms / 86400000), (unsigned)(now_ms / 3600000 % 24), (unsigned)(now_ms / 60000 % 60),
+           (unsigned)(now_ms / 1000 % 60), (unsigned)(now_ms % 1000),
+           (NULL != p_basename) ? p_basename + 1 : p_filename, line, message);
+    if ('\0' == message[0] || '\n' != message[strlen(message) - 1]) {
+        putchar('\n');
+    }
+}
+
+/**@brief Function for ordering latency samples.
+ *
+ * @returns Comparison result for qsort().
+ */
+static int latency_cmp(void const * p_a, void const * p_b) {
+    const uint32_t a = *(uint32_t const *)p_a;
+    const uint32_t b = *(uint32_t const *)p_b;
+    return (a > b) - (a < b);
+}
+
+/**@brief Function for printing a radio on time line.
+ *
+ * @param[in] p_name      Activity.
+ * @param[in] on_us       Radio on time, us.
+ * @param[in] total_us    Simulated time, us.
+ *
+ * @returns Nothing.
+ */
+static void radio_line_print(const char * p_name, uint64_t on_us, uint64_t total_us) {
+    printf("  %-12s %12.3f s  %8.4f %%\n", p_name, on_us / 1e6, 100.0 * on_us / total_us);
+}
+
+void sim_finish(const char * p_reason) {
+    sim_sd_accounting_close();
+    fflush(stdout);
+
+    const uint64_t total_us = MAX(1, sim_now_us());
+    const double hours = total_us / 3.6e9;
+    const uint64_t radio_us = g_sim_radio.scan_us + g_sim_radio.initiate_us + g_sim_radio.conn_us + g_sim_radio.adv_us;
+
+    printf("\n=== BLEAM Scanner host simulation, seed %u ===\n", g_sim_config.seed);
+    printf("Simulated %.3f h, ended by %s\n", hours, (NULL == p_reason) ? "end of run" : p_reason);
+
+    printf("\nRadio on time\n");
+    radio_line_print("scanning", g_sim_radio.scan_us, total_us);
+    radio_line_print("initiating", g_sim_radio.initiate_us, total_us);
+    radio_line_print("connected", g_sim_radio.conn_us, total_us);
+    radio_line_print("advertising", g_sim_radio.adv_us, total_us);
+    radio_line_print("total", radio_us, total_us);
+    // Sleep current all the time plus receive current while the radio is on, CPU time is not modelled
+    const double charge_mah = (APP_CONFIG_ENERGY_SLEEP_UA * (total_us / 1e6) + APP_CONFIG_ENERGY_RX_UA * (radio_us / 1e6)) / 3.6e6;
+    printf("  average current %.1f uA, %.3f mAh per day\n", charge_mah * 1000.0 / hours, charge_mah * 24.0 / hours);
+
+    uint64_t wakeups[SIM_WAKE_CNT];
+    const uint64_t wakeups_total = sim_wakeups_get(wakeups);
+    static const char * const wake_names[SIM_WAKE_CNT] = {"timer", "radio", "flash", "other"};
+    printf("\nCPU wakeups %llu, %.1f per hour\n", (unsigned long long)wakeups_total, wakeups_total / hours);
+    for (int kind = 0; SIM_WAKE_CNT > kind; ++kind) {
+        printf("  %-12s %10llu  %10.1f per hour\n", wake_names[kind], (unsigned long long)wakeups[kind], wakeups[kind] / hours);
+    }
+
+    printf("\nAdvertising reports  BLEAM %u, other %u\n", g_sim_radio.reports_bleam, g_sim_radio.reports_other);
+    printf("Connections          attempts %u, established %u, initiator timeouts %u, supervision timeouts %u\n",
+           g_sim_radio.connect_attempts, g_sim_radio.connects, g_sim_radio.connect_timeouts, g_sim_radio.supervision_timeouts);
+    printf("                     connection events %u, discoveries %u, parameter updates %u\n",
+           g_sim_radio.conn_events, g_sim_radio.discoveries, g_sim_radio.param_updates);
+    printf("BLEAM devices        deliveries %u, signatures ok %u, bad %u\n",
+           g_sim_peers.sessions, g_sim_peers.sig_ok, g_sim_peers.sig_bad);
+    printf("                     RSSI writes %u, health writes %u, time reads %u\n",
+           g_sim_peers.rssi_writes, g_sim_peers.health_writes, g_sim_peers.time_reads);
+
+    if (0 < g_sim_peers.latency_cnt) {
+        const uint32_t cnt = MIN(g_sim_peers.latency_cnt, SIM_LATENCY_MAX);
+        uint32_t * p_samples = g_sim_peers.latency_ms;
+        qsort(p_samples, cnt, sizeof(uint32_t), latency_cmp);
+        uint64_t sum = 0;
+        for (uint32_t index = 0; cnt > index; ++index) {
+            sum += p_samples[index];
+        }
+        printf("Report latency       %u samples of %u, min %.1f s, median %.1f s, p95 %.1f s, max %.1f s, mean %.1f s\n",
+               cnt, g_sim_peers.latency_cnt, p_samples[0] / 1e3, p_samples[cnt / 2] / 1e3, p_samples[(cnt * 95) / 100] / 1e3,
+               p_samples[cnt - 1] / 1e3, (double)sum / cnt / 1e3);
+    } else {
+        printf("Report latency       no samples\n");
+    }
+
+    printf("\n");
+    sim_sd_peers_print();
+    fflush(stdout);
+    exit((NULL == p_reason) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/**@brief Function for parsing a time of day.
+ *
+ * @param[in]  p_text    Time as HH:MM.
+ * @param[out] p_ms      Milliseconds since midnight.
+ *
+ * @returns True if the time is valid.
+ */
+static bool time_parse(const char * p_text, uint32_t * p_ms) {
+    unsigned hours, minutes;
+    if (2 != sscanf(p_text, "%u:%u", &hours, &minutes) || 23 < hours || 59 < minutes) {
+        return false;
+    }
+    *p_ms = (hours * 60 + minutes) * 60000;
+    return true;
+}
+
+/**@brief Function for printing usage.
+ *
+ * @param[in] p_name    Program name.
+ *
+ * @returns Nothing.
+ */
+static void usage_print(const char * p_name) {
+    printf("Usage: %s [options]\n"
+           "  --days N              simulated time, days (default 1)\n"
+           "  --bleams N            BLEAM devices around the node (default 3)\n"
+           "  --slow-peers N        BLEAM devices asking for slower connection parameters (default 0)\n"
+           "  --noise N             other advertisers around the node (default 20)\n"
+           "  --seed N              random seed (default 1)\n"
+           "  --start HH:MM         time of day at power on (default 06:00)\n"
+           "  --present HH:MM-HH:MM when BLEAM devices are around, equal times for always (default 08:00-18:00)\n"
+           "  --ppm N               RTC crystal error, ppm (default 30)\n"
+           "  --node-id N           node ID of the configuration record (default 1)\n"
+           "  --unconfigured        boot without configuration record\n"
+           "  -v                    print firmware log, repeat for more\n",
+           p_name);
+}
+
+int main(int argc, char * argv[]) {
+    static const struct option options[] = {
+        {"days",         required_argument, NULL, 'd'},
+        {"bleams",       required_argument, NULL, 'b'},
+        {"slow-peers",   required_argument, NULL, 'l'},
+        {"noise",        required_argument, NULL, 'n'},
+        {"seed",         required_argument, NULL, 's'},
+        {"start",        required_argument, NULL, 't'},
+        {"present",      required_argument, NULL, 'p'},
+        {"ppm",          required_argument, NULL, 'r'},
+        {"node-id",      required_argument, NULL, 'i'},
+        {"unconfigured", no_argument,       NULL, 'u'},
+        {"help",         no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int option;
+    while (-1 != (option = getopt_long(argc, argv, "vh", options, NULL))) {
+        char * p_dash;
+        switch (option) {
+        case 'd': g_sim_config.days = strtoul(optarg, NULL, 0); break;
+        case 'b': g_sim_config.bleams = strtoul(optarg, NULL, 0); break;
+        case 'l': g_sim_config.slow_peers = strtoul(optarg, NULL, 0); break;
+        case 'n': g_sim_config.noise = strtoul(optarg, NULL, 0); break;
+        case 's': g_sim_config.seed = strtoul(optarg, NULL, 0); break;
+        case 'r': g_sim_config.rtc_ppm = strtol(optarg, NULL, 0); break;
+        case 'i': g_sim_config.node_id = (uint16_t)strtoul(optarg, NULL, 0); break;
+        case 'u': g_sim_config.unconfigured = true; break;
+        case 'v': g_sim_config.verbosity += (LOG_LEVEL_WARN == g_sim_config.verbosity) ? 2 : 1; break;
+        case 't':
+            if (!time_parse(optarg, &g_sim_config.start_ms)) {
+                fprintf(stderr, "Invalid time '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'p':
+            p_dash = strchr(optarg, '-');
+            if (NULL == p_dash || !time_parse(optarg, &g_sim_config.present_from_ms) ||
+                !time_parse(p_dash + 1, &g_sim_config.present_to_ms)) {
+                fprintf(stderr, "Invalid time range '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'h':
+            usage_print(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            usage_print(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (0 == g_sim_config.days || APP_CONFIG_MAX_BLEAMS < g_sim_config.bleams) {
+        fprintf(stderr, "Need at least one day and at most %u BLEAM devices\n", APP_CONFIG_MAX_BLEAMS);
+        return EXIT_FAILURE;
+    }
+    setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+
+    if (!g_sim_config.unconfigured) {
+        // Laid out as configuration_t of main.h: node ID, then key padded to a whole number of words
+        uint32_t record[(sizeof(uint16_t) + BLEAM_KEY_SIZE + 3) / sizeof(uint32_t)] = {0};
+        memcpy(record, &g_sim_config.node_id, sizeof(uint16_t));
+        memcpy((uint8_t *)record + sizeof(uint16_t), m_app_key, sizeof(m_app_key));
+        sim_fds_preload(record, sizeof(record) / sizeof(uint32_t));
+    }
+    sim_sd_world_init(m_app_key);
+
+    blesc_main();
+    sim_finish("main returned");
+}
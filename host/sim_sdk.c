@@ -0,0 +1,734 @@
+/** @file sim_sdk.c
+ *
+ * @brief nRF5 SDK libraries and drivers of the host simulator.
+ *
+ * @details Scanning, GATT and database discovery modules pass SoftDevice events on the
+ *          way the SDK 15.3 ones do for the features BLEAM Scanner uses. FDS keeps
+ *          records in memory and completes operations after one millisecond. SAADC
+ *          reads a fixed battery voltage. LEDs and buttons do nothing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "nordic_common.h"
+#include "app_error.h"
+#include "ble_advdata.h"
+#include "ble_conn_params.h"
+#include "ble_db_discovery.h"
+#include "bsp.h"
+#include "fds.h"
+#include "global_app_config.h"
+#include "log.h"
+#include "nrf.h"
+#include "nrf_ble_gatt.h"
+#include "nrf_ble_qwr.h"
+#include "nrf_ble_scan.h"
+#include "nrf_drv_saadc.h"
+#include "nrf_drv_wdt.h"
+#include "nrf_strerror.h"
+
+#define SIM_FDS_DELAY_US   1000 /**< Time an FDS operation takes, us. */
+#define SIM_FDS_WORDS_MAX  64   /**< Largest record kept, words. */
+#define SIM_FDS_RECORDS    4    /**< Number of records kept. */
+#define SIM_SAADC_US       50   /**< SAADC conversion time, us. */
+#define SIM_SAADC_RAW      776  /**< SAADC result, 2.73 V at the diode with 1/6 gain and 0.6 V reference. */
+#define SIM_DB_DISC_UUIDS  2    /**< Number of services database discovery looks for. */
+
+NRF_FICR_Type  sim_ficr = {.CODEPAGESIZE = 4096, .CODESIZE = 128, .DEVICEID = {0x5C0FFEE5, 0xB1EA0032}};
+CoreDebug_Type sim_core_debug;
+DWT_Type       sim_dwt;
+
+/* Scanning module */
+
+static nrf_ble_scan_t * mp_scan; /**< Scanning module instance. */
+
+ret_code_t nrf_ble_scan_init(nrf_ble_scan_t * const p_scan_ctx, nrf_ble_scan_init_t const * const p_init,
+                             nrf_ble_scan_evt_handler_t evt_handler) {
+    if (NULL == p_scan_ctx || NULL == p_init || NULL == p_init->p_scan_param) {
+        return NRF_ERROR_NULL;
+    }
+    memset(p_scan_ctx, 0, sizeof(nrf_ble_scan_t));
+    p_scan_ctx->evt_handler = evt_handler;
+    p_scan_ctx->connect_if_match = p_init->connect_if_match;
+    p_scan_ctx->conn_cfg_tag = p_init->conn_cfg_tag;
+    p_scan_ctx->scan_params = *p_init->p_scan_param;
+    if (NULL != p_init->p_conn_param) {
+        p_scan_ctx->conn_params = *p_init->p_conn_param;
+    }
+    p_scan_ctx->scan_buffer.p_data = p_scan_ctx->scan_buffer_data;
+    p_scan_ctx->scan_buffer.len = NRF_BLE_SCAN_BUFFER;
+    mp_scan = p_scan_ctx;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_ble_scan_params_set(nrf_ble_scan_t * const p_scan_ctx, ble_gap_scan_params_t const * const p_scan_param) {
+    if (NULL == p_scan_ctx || NULL == p_scan_param) {
+        return NRF_ERROR_NULL;
+    }
+    nrf_ble_scan_stop();
+    p_scan_ctx->scan_params = *p_scan_param;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_ble_scan_start(nrf_ble_scan_t const * const p_scan_ctx) {
+    if (NULL == p_scan_ctx) {
+        return NRF_ERROR_NULL;
+    }
+    const ret_code_t err_code = sd_ble_gap_scan_start(&p_scan_ctx->scan_params, &p_scan_ctx->scan_buffer);
+    // Scanner already running is fine, as in the SDK
+    if (NRF_ERROR_INVALID_STATE != err_code && NRF_SUCCESS != err_code) {
+        return err_code;
+    }
+    return NRF_SUCCESS;
+}
+
+void nrf_ble_scan_stop(void) {
+    UNUSED_RETURN_VALUE(sd_ble_gap_scan_stop());
+}
+
+void nrf_ble_scan_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_contex) {
+    nrf_ble_scan_t * p_scan_ctx = p_contex;
+    ble_gap_evt_t const * p_gap_evt = &p_ble_evt->evt.gap_evt;
+    scan_evt_t scan_evt;
+    memset(&scan_evt, 0, sizeof(scan_evt));
+    scan_evt.p_scan_params = &p_scan_ctx->scan_params;
+
+    switch (p_ble_evt->header.evt_id) {
+    case BLE_GAP_EVT_ADV_REPORT:
+        // No filters, every report is not found
+        scan_evt.scan_evt_id = NRF_BLE_SCAN_EVT_NOT_FOUND;
+        scan_evt.params.p_not_found = &p_gap_evt->params.adv_report;
+        if (NULL != p_scan_ctx->evt_handler) {
+            p_scan_ctx->evt_handler(&scan_evt);
+        }
+        UNUSED_RETURN_VALUE(sd_ble_gap_scan_start(NULL, &p_scan_ctx->scan_buffer));
+        break;
+
+    case BLE_GAP_EVT_TIMEOUT:
+        if (BLE_GAP_TIMEOUT_SRC_SCAN == p_gap_evt->params.timeout.src && NULL != p_scan_ctx->evt_handler) {
+            scan_evt.scan_evt_id = NRF_BLE_SCAN_EVT_SCAN_TIMEOUT;
+            scan_evt.params.timeout.p_timeout = &p_gap_evt->params.timeout;
+            p_scan_ctx->evt_handler(&scan_evt);
+        }
+        break;
+
+    case BLE_GAP_EVT_CONNECTED:
+        if (BLE_GAP_ROLE_CENTRAL == p_gap_evt->params.connected.role && NULL != p_scan_ctx->evt_handler) {
+            scan_evt.scan_evt_id = NRF_BLE_SCAN_EVT_CONNECTED;
+            scan_evt.params.connected.p_connected = &p_gap_evt->params.connected;
+            scan_evt.params.connected.conn_handle = p_gap_evt->conn_handle;
+            p_scan_ctx->evt_handler(&scan_evt);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* GATT module */
+
+ret_code_t nrf_ble_gatt_init(nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_handler_t evt_handler) {
+    if (NULL == p_gatt) {
+        return NRF_ERROR_NULL;
+    }
+    p_gatt->evt_handler = evt_handler;
+    p_gatt->att_mtu_desired_periph = NRF_SDH_BLE_GATT_MAX_MTU_SIZE;
+    p_gatt->att_mtu_desired_central = NRF_SDH_BLE_GATT_MAX_MTU_SIZE;
+    p_gatt->data_length = NRF_SDH_BLE_GAP_DATA_LENGTH;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_ble_gatt_att_mtu_periph_set(nrf_ble_gatt_t * p_gatt, uint16_t desired_mtu) {
+    if (NULL == p_gatt) {
+        return NRF_ERROR_NULL;
+    }
+    if (BLE_GATT_ATT_MTU_DEFAULT > desired_mtu || NRF_SDH_BLE_GATT_MAX_MTU_SIZE < desired_mtu) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    p_gatt->att_mtu_desired_periph = desired_mtu;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_ble_gatt_att_mtu_central_set(nrf_ble_gatt_t * p_gatt, uint16_t desired_mtu) {
+    if (NULL == p_gatt) {
+        return NRF_ERROR_NULL;
+    }
+    if (BLE_GATT_ATT_MTU_DEFAULT > desired_mtu || NRF_SDH_BLE_GATT_MAX_MTU_SIZE < desired_mtu) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    p_gatt->att_mtu_desired_central = desired_mtu;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_ble_gatt_data_length_set(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle, uint8_t data_length) {
+    UNUSED_PARAMETER(conn_handle);
+    if (NULL == p_gatt) {
+        return NRF_ERROR_NULL;
+    }
+    p_gatt->data_length = data_length;
+    return NRF_SUCCESS;
+}
+
+void nrf_ble_gatt_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context) {
+    nrf_ble_gatt_t * p_gatt = p_context;
+    nrf_ble_gatt_evt_t evt;
+    memset(&evt, 0, sizeof(evt));
+
+    switch (p_ble_evt->header.evt_id) {
+    case BLE_GAP_EVT_CONNECTED: {
+        const uint16_t conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+        // Only central links ask for more, configuration clients negotiate themselves
+        if (BLE_GAP_ROLE_CENTRAL != p_ble_evt->evt.gap_evt.params.connected.role) {
+            break;
+        }
+        if (BLE_GATT_ATT_MTU_DEFAULT < p_gatt->att_mtu_desired_central) {
+            ret_code_t err_code = sd_ble_gattc_exchange_mtu_request(conn_handle, p_gatt->att_mtu_desired_central);
+            if (NRF_SUCCESS != err_code) {
+                __LOG(LOG_SRC_APP, LOG_LEVEL_ERROR, "sd_ble_gattc_exchange_mtu_request() returned %u\r\n", err_code);
+            }
+        }
+        if (BLE_GAP_DATA_LENGTH_DEFAULT < p_gatt->data_length) {
+            ble_gap_data_length_params_t dl_params = {
+                .max_tx_octets = p_gatt->data_length,
+                .max_rx_octets = p_gatt->data_length,
+                .max_tx_time_us = BLE_GAP_DATA_LENGTH_AUTO,
+                .max_rx_time_us = BLE_GAP_DATA_LENGTH_AUTO,
+            };
+            ret_code_t err_code = sd_ble_gap_data_length_update(conn_handle, &dl_params, NULL);
+            if (NRF_SUCCESS != err_code) {
+                __LOG(LOG_SRC_APP, LOG_LEVEL_ERROR, "sd_ble_gap_data_length_update() returned %u\r\n", err_code);
+            }
+        }
+    } break;
+
+    case BLE_GATTC_EVT_EXCHANGE_MTU_RSP:
+        evt.evt_id = NRF_BLE_GATT_EVT_ATT_MTU_UPDATED;
+        evt.conn_handle = p_ble_evt->evt.gattc_evt.conn_handle;
+        evt.params.att_mtu_effective = MIN(p_gatt->att_mtu_desired_central,
+                                           p_ble_evt->evt.gattc_evt.params.exchange_mtu_rsp.server_rx_mtu);
+        if (NULL != p_gatt->evt_handler) {
+            p_gatt->evt_handler(p_gatt, &evt);
+        }
+        break;
+
+    case BLE_GAP_EVT_DATA_LENGTH_UPDATE:
+        evt.evt_id = NRF_BLE_GATT_EVT_DATA_LENGTH_UPDATED;
+        evt.conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+        evt.params.data_length = (uint8_t)p_ble_evt->evt.gap_evt.params.data_length_update.effective_params.max_tx_octets;
+        if (NULL != p_gatt->evt_handler) {
+            p_gatt->evt_handler(p_gatt, &evt);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* Database discovery */
+
+static ble_db_discovery_evt_handler_t m_db_disc_handler;            /**< Application handler. */
+static ble_uuid_t           m_db_disc_uuids[SIM_DB_DISC_UUIDS];     /**< Services to look for. */
+static uint8_t              m_db_disc_uuid_cnt;                      /**< Number of services to look for. */
+static ble_db_discovery_t * mp_db_disc;                              /**< Instance of the discovery in progress. */
+static uint32_t             m_db_disc_generation;                    /**< Latest discovery run. */
+
+uint32_t ble_db_discovery_init(ble_db_discovery_evt_handler_t evt_handler) {
+    if (NULL == evt_handler) {
+        return NRF_ERROR_NULL;
+    }
+    m_db_disc_handler = evt_handler;
+    m_db_disc_uuid_cnt = 0;
+    return NRF_SUCCESS;
+}
+
+uint32_t ble_db_discovery_evt_register(ble_uuid_t const * p_uuid) {
+    if (NULL == m_db_disc_handler) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (SIM_DB_DISC_UUIDS <= m_db_disc_uuid_cnt) {
+        return NRF_ERROR_NO_MEM;
+    }
+    m_db_disc_uuids[m_db_disc_uuid_cnt++] = *p_uuid;
+    return NRF_SUCCESS;
+}
+
+/**@brief Function for passing the result of a discovery to the application.
+ *
+ * @param[in] conn_handle    Connection handle.
+ * @param[in] p_srv          Discovered service, NULL if not found.
+ *
+ * @returns Nothing.
+ */
+static void db_discovery_done(uint16_t conn_handle, ble_gatt_db_srv_t const * p_srv) {
+    // Application may have restarted discovery on this instance since
+    if (NULL == mp_db_disc || m_db_disc_generation != mp_db_disc->generation || !mp_db_disc->discovery_in_progress) {
+        return;
+    }
+    ble_db_discovery_evt_t evt;
+    memset(&evt, 0, sizeof(evt));
+    evt.conn_handle = conn_handle;
+    if (NULL != p_srv) {
+        evt.evt_type = BLE_DB_DISCOVERY_COMPLETE;
+        evt.params.discovered_db = *p_srv;
+        mp_db_disc->services[0] = *p_srv;
+        mp_db_disc->srv_count = 1;
+    } else {
+        evt.evt_type = BLE_DB_DISCOVERY_SRV_NOT_FOUND;
+        evt.params.discovered_db.srv_uuid = m_db_disc_uuids[0];
+    }
+    ++mp_db_disc->discoveries_count;
+    mp_db_disc->discovery_in_progress = false;
+    m_db_disc_handler(&evt);
+}
+
+uint32_t ble_db_discovery_start(ble_db_discovery_t * p_db_discovery, uint16_t conn_handle) {
+    if (NULL == p_db_discovery) {
+        return NRF_ERROR_NULL;
+    }
+    if (0 == m_db_disc_uuid_cnt) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (p_db_discovery->discovery_in_progress) {
+        return NRF_ERROR_BUSY;
+    }
+    const uint32_t err_code = sim_sd_discover(conn_handle, &m_db_disc_uuids[0], db_discovery_done);
+    if (NRF_SUCCESS != err_code) {
+        return err_code;
+    }
+    p_db_discovery->conn_handle = conn_handle;
+    p_db_discovery->discovery_in_progress = true;
+    p_db_discovery->generation = ++m_db_disc_generation;
+    mp_db_disc = p_db_discovery;
+    return NRF_SUCCESS;
+}
+
+void ble_db_discovery_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context) {
+    ble_db_discovery_t * p_db_discovery = p_context;
+    if (BLE_GAP_EVT_DISCONNECTED == p_ble_evt->header.evt_id &&
+        p_db_discovery->conn_handle == p_ble_evt->evt.gap_evt.conn_handle) {
+        p_db_discovery->discovery_in_progress = false;
+    }
+}
+
+/* Queued writes, connection parameters and advertising data */
+
+ret_code_t nrf_ble_qwr_init(nrf_ble_qwr_t * p_qwr, nrf_ble_qwr_init_t const * p_qwr_init) {
+    if (NULL == p_qwr || NULL == p_qwr_init) {
+        return NRF_ERROR_NULL;
+    }
+    if (p_qwr->initialized) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    p_qwr->initialized = true;
+    p_qwr->conn_handle = BLE_CONN_HANDLE_INVALID;
+    p_qwr->error_handler = p_qwr_init->error_handler;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_ble_qwr_conn_handle_assign(nrf_ble_qwr_t * p_qwr, uint16_t conn_handle) {
+    if (NULL == p_qwr) {
+        return NRF_ERROR_NULL;
+    }
+    if (!p_qwr->initialized) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    p_qwr->conn_handle = conn_handle;
+    return NRF_SUCCESS;
+}
+
+uint32_t ble_conn_params_init(const ble_conn_params_init_t * p_init) {
+    return (NULL == p_init) ? NRF_ERROR_NULL : NRF_SUCCESS;
+}
+
+ret_code_t ble_advdata_encode(ble_advdata_t const * const p_advdata, uint8_t * const p_encoded_data, uint16_t * const p_len) {
+    if (NULL == p_advdata || NULL == p_encoded_data || NULL == p_len) {
+        return NRF_ERROR_NULL;
+    }
+    const uint16_t max_len = *p_len;
+    uint16_t len = 0;
+    if (0 != p_advdata->flags) {
+        if (max_len < len + 3) {
+            return NRF_ERROR_DATA_SIZE;
+        }
+        p_encoded_data[len++] = 2;
+        p_encoded_data[len++] = BLE_GAP_AD_TYPE_FLAGS;
+        p_encoded_data[len++] = p_advdata->flags;
+    }
+    // UUID values are not known here, the field is sized as a 128-bit UUID and left blank
+    if (0 < p_advdata->uuids_complete.uuid_cnt) {
+        if (max_len < len + 18) {
+            return NRF_ERROR_DATA_SIZE;
+        }
+        p_encoded_data[len++] = 17;
+        p_encoded_data[len++] = BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_COMPLETE;
+        memset(&p_encoded_data[len], 0, 16);
+        len += 16;
+    }
+    *p_len = len;
+    return NRF_SUCCESS;
+}
+
+/* Flash data storage */
+
+/**@brief Record kept in memory. */
+typedef struct {
+    bool         valid;                          /**< Flag denoting that the record exists. */
+    fds_header_t header;                         /**< Record header. */
+    uint32_t     data[SIM_FDS_WORDS_MAX];        /**< Record data. */
+} sim_fds_record_t;
+
+static fds_cb_t         m_fds_cb;                      /**< Registered handler. */
+static bool             m_fds_initialized;             /**< Flag denoting that FDS is initialized. */
+static sim_fds_record_t m_fds_records[SIM_FDS_RECORDS]; /**< Records. */
+static uint32_t         m_fds_record_id;               /**< Latest record ID. */
+
+/**@brief Function for delivering an FDS event.
+ *
+ * @param[in] p_ctx    Event allocated by the operation.
+ * @param[in] arg      Unused.
+ *
+ * @returns Always true.
+ */
+static bool fds_evt_deliver(void * p_ctx, uint64_t arg) {
+    UNUSED_PARAMETER(arg);
+    if (NULL != m_fds_cb) {
+        m_fds_cb(p_ctx);
+    }
+    free(p_ctx);
+    return true;
+}
+
+/**@brief Function for queueing an FDS event.
+ *
+ * @param[in] p_evt    Event to copy.
+ *
+ * @returns Nothing.
+ */
+static void fds_evt_post(fds_evt_t const * p_evt) {
+    fds_evt_t * p_copy = malloc(sizeof(fds_evt_t));
+    if (NULL == p_copy) {
+        fprintf(stderr, "sim: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    *p_copy = *p_evt;
+    sim_post(sim_now_us() + SIM_FDS_DELAY_US, SIM_WAKE_FLASH, fds_evt_deliver, p_copy, 0);
+}
+
+/**@brief Function for getting a record by its descriptor.
+ *
+ * @returns Record, NULL if it does not exist.
+ */
+static sim_fds_record_t * fds_record_get(fds_record_desc_t const * p_desc) {
+    for (uint8_t index = 0; SIM_FDS_RECORDS > index; ++index) {
+        if (m_fds_records[index].valid && p_desc->record_id == m_fds_records[index].header.record_id) {
+            return &m_fds_records[index];
+        }
+    }
+    return NULL;
+}
+
+void sim_fds_preload(void const * p_data, uint16_t words) {
+    sim_fds_record_t * p_record = &m_fds_records[0];
+    p_record->valid = true;
+    p_record->header.file_id = APP_CONFIG_CONFIG_FILE;
+    p_record->header.record_key = APP_CONFIG_CONFIG_REC_KEY;
+    p_record->header.length_words = words;
+    p_record->header.record_id = ++m_fds_record_id;
+    memcpy(p_record->data, p_data, words * sizeof(uint32_t));
+}
+
+ret_code_t fds_register(fds_cb_t cb) {
+    m_fds_cb = cb;
+    return FDS_SUCCESS;
+}
+
+ret_code_t fds_init(void) {
+    const fds_evt_t evt = {.id = FDS_EVT_INIT, .result = FDS_SUCCESS};
+    if (m_fds_initialized) {
+        return FDS_SUCCESS;
+    }
+    m_fds_initialized = true;
+    fds_evt_post(&evt);
+    return FDS_SUCCESS;
+}
+
+ret_code_t fds_record_find(uint16_t file_id, uint16_t record_key, fds_record_desc_t * p_desc, fds_find_token_t * p_token) {
+    if (!m_fds_initialized) {
+        return FDS_ERR_NOT_INITIALIZED;
+    }
+    if (NULL == p_desc || NULL == p_token) {
+        return FDS_ERR_NULL_ARG;
+    }
+    // Token holds the index past the latest match
+    for (uint16_t index = p_token->page; SIM_FDS_RECORDS > index; ++index) {
+        sim_fds_record_t const * p_record = &m_fds_records[index];
+        if (p_record->valid && file_id == p_record->header.file_id && record_key == p_record->header.record_key) {
+            p_desc->record_id = p_record->header.record_id;
+            p_desc->p_record = (uint32_t const *)&p_record->header;
+            p_desc->record_is_open = false;
+            p_token->page = index + 1;
+            p_token->p_addr = p_desc->p_record;
+            return FDS_SUCCESS;
+        }
+    }
+    return FDS_ERR_NOT_FOUND;
+}
+
+ret_code_t fds_record_open(fds_record_desc_t * p_desc, fds_flash_record_t * p_flash_record) {
+    if (NULL == p_desc || NULL == p_flash_record) {
+        return FDS_ERR_NULL_ARG;
+    }
+    sim_fds_record_t const * p_record = fds_record_get(p_desc);
+    if (NULL == p_record) {
+        return FDS_ERR_NOT_FOUND;
+    }
+    p_flash_record->p_header = &p_record->header;
+    p_flash_record->p_data = p_record->data;
+    p_desc->record_is_open = true;
+    return FDS_SUCCESS;
+}
+
+ret_code_t fds_record_close(fds_record_desc_t * p_desc) {
+    if (NULL == p_desc) {
+        return FDS_ERR_NULL_ARG;
+    }
+    if (!p_desc->record_is_open) {
+        return FDS_ERR_NO_OPEN_RECORDS;
+    }
+    p_desc->record_is_open = false;
+    return FDS_SUCCESS;
+}
+
+ret_code_t fds_record_write(fds_record_desc_t * p_desc, fds_record_t const * p_record) {
+    if (!m_fds_initialized) {
+        return FDS_ERR_NOT_INITIALIZED;
+    }
+    if (NULL == p_record) {
+        return FDS_ERR_NULL_ARG;
+    }
+    if (SIM_FDS_WORDS_MAX < p_record->data.length_words) {
+        return FDS_ERR_RECORD_TOO_LARGE;
+    }
+    for (uint8_t index = 0; SIM_FDS_RECORDS > index; ++index) {
+        sim_fds_record_t * p_slot = &m_fds_records[index];
+        if (p_slot->valid) {
+            continue;
+        }
+        p_slot->valid = true;
+        p_slot->header.file_id = p_record->file_id;
+        p_slot->header.record_key = p_record->key;
+        p_slot->header.length_words = (uint16_t)p_record->data.length_words;
+        p_slot->header.record_id = ++m_fds_record_id;
+        memcpy(p_slot->data, p_record->data.p_data, p_record->data.length_words * sizeof(uint32_t));
+        if (NULL != p_desc) {
+            p_desc->record_id = p_slot->header.record_id;
+            p_desc->p_record = (uint32_t const *)&p_slot->header;
+        }
+        fds_evt_t evt = {.id = FDS_EVT_WRITE, .result = FDS_SUCCESS};
+        evt.write.record_id = p_slot->header.record_id;
+        evt.write.file_id = p_record->file_id;
+        evt.write.record_key = p_record->key;
+        fds_evt_post(&evt);
+        return FDS_SUCCESS;
+    }
+    return FDS_ERR_NO_SPACE_IN_FLASH;
+}
+
+ret_code_t fds_record_delete(fds_record_desc_t * p_desc) {
+    if (!m_fds_initialized) {
+        return FDS_ERR_NOT_INITIALIZED;
+    }
+    if (NULL == p_desc) {
+        return FDS_ERR_NULL_ARG;
+    }
+    sim_fds_record_t * p_record = fds_record_get(p_desc);
+    if (NULL == p_record) {
+        return FDS_ERR_NOT_FOUND;
+    }
+    p_record->valid = false;
+    fds_evt_t evt = {.id = FDS_EVT_DEL_RECORD, .result = FDS_SUCCESS};
+    evt.del.record_id = p_record->header.record_id;
+    evt.del.file_id = p_record->header.file_id;
+    evt.del.record_key = p_record->header.record_key;
+    fds_evt_post(&evt);
+    return FDS_SUCCESS;
+}
+
+ret_code_t fds_stat(fds_stat_t * p_stat) {
+    if (NULL == p_stat) {
+        return FDS_ERR_NULL_ARG;
+    }
+    memset(p_stat, 0, sizeof(fds_stat_t));
+    p_stat->pages_available = FDS_VIRTUAL_PAGES;
+    for (uint8_t index = 0; SIM_FDS_RECORDS > index; ++index) {
+        if (m_fds_records[index].valid) {
+            ++p_stat->valid_records;
+            p_stat->words_used += m_fds_records[index].header.length_words + sizeof(fds_header_t) / sizeof(uint32_t);
+        }
+    }
+    return FDS_SUCCESS;
+}
+
+/* SAADC */
+
+static nrf_drv_saadc_event_handler_t m_saadc_handler; /**< Conversion handler. */
+static nrf_saadc_value_t *           m_saadc_buffers[2]; /**< Buffers queued for conversion. */
+static uint8_t                       m_saadc_buffer_cnt; /**< Number of queued buffers. */
+static bool                          m_saadc_busy;       /**< Flag denoting that a conversion is running. */
+
+/**@brief Function for finishing a conversion.
+ *
+ * @returns True if a buffer was filled.
+ */
+static bool saadc_done(void * p_ctx, uint64_t arg) {
+    UNUSED_PARAMETER(p_ctx);
+    UNUSED_PARAMETER(arg);
+    m_saadc_busy = false;
+    if (0 == m_saadc_buffer_cnt) {
+        return false;
+    }
+    nrf_saadc_value_t * p_buffer = m_saadc_buffers[0];
+    m_saadc_buffers[0] = m_saadc_buffers[1];
+    --m_saadc_buffer_cnt;
+    p_buffer[0] = SIM_SAADC_RAW;
+
+    nrf_drv_saadc_evt_t evt = {.type = NRF_DRV_SAADC_EVT_DONE};
+    evt.data.done.p_buffer = p_buffer;
+    evt.data.done.size = 1;
+    m_saadc_handler(&evt);
+    return true;
+}
+
+ret_code_t nrf_drv_saadc_init(nrf_drv_saadc_config_t const * p_config, nrf_drv_saadc_event_handler_t event_handler) {
+    UNUSED_PARAMETER(p_config);
+    if (NULL != m_saadc_handler) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (NULL == event_handler) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    m_saadc_handler = event_handler;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_saadc_channel_init(uint8_t channel, nrf_saadc_channel_config_t const * const p_config) {
+    UNUSED_PARAMETER(p_config);
+    return (0 == channel) ? NRF_SUCCESS : NRF_ERROR_NO_MEM;
+}
+
+ret_code_t nrf_drv_saadc_buffer_convert(nrf_saadc_value_t * buffer, uint16_t size) {
+    if (1 != size) {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+    if (2 <= m_saadc_buffer_cnt) {
+        return NRF_ERROR_BUSY;
+    }
+    m_saadc_buffers[m_saadc_buffer_cnt++] = buffer;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_saadc_sample(void) {
+    if (NULL == m_saadc_handler) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (!m_saadc_busy) {
+        m_saadc_busy = true;
+        sim_post(sim_now_us() + SIM_SAADC_US, SIM_WAKE_OTHER, saadc_done, NULL, 0);
+    }
+    return NRF_SUCCESS;
+}
+
+/* Watchdog */
+
+static bool m_wdt_initialized; /**< Flag denoting that the watchdog is configured. */
+static uint32_t m_wdt_reload_ms; /**< Watchdog reload value, ms. */
+
+ret_code_t nrf_drv_wdt_init(nrf_drv_wdt_config_t const * p_config, nrf_wdt_event_handler_t wdt_event_handler) {
+    UNUSED_PARAMETER(wdt_event_handler);
+    m_wdt_reload_ms = (NULL == p_config) ? WDT_CONFIG_RELOAD_VALUE : p_config->reload_value;
+    m_wdt_initialized = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_wdt_channel_alloc(nrf_drv_wdt_channel_id * p_channel_id) {
+    if (!m_wdt_initialized) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    *p_channel_id = 0;
+    return NRF_SUCCESS;
+}
+
+void nrf_drv_wdt_enable(void) {
+    sim_wdt_start(m_wdt_reload_ms);
+}
+
+void nrf_drv_wdt_channel_feed(nrf_drv_wdt_channel_id channel_id) {
+    UNUSED_PARAMETER(channel_id);
+    sim_wdt_feed();
+}
+
+/* Board support */
+
+void bsp_board_init(uint32_t init_flags) {
+    UNUSED_PARAMETER(init_flags);
+}
+
+void bsp_board_led_on(uint32_t led_idx) {
+    UNUSED_PARAMETER(led_idx);
+}
+
+void bsp_board_led_off(uint32_t led_idx) {
+    UNUSED_PARAMETER(led_idx);
+}
+
+uint32_t bsp_init(uint32_t type, bsp_event_callback_t callback) {
+    UNUSED_PARAMETER(type);
+    UNUSED_PARAMETER(callback);
+    return NRF_SUCCESS;
+}
+
+uint32_t bsp_indication_set(bsp_indication_t indicate) {
+    UNUSED_PARAMETER(indicate);
+    return NRF_SUCCESS;
+}
+
+/* Errors */
+
+char const * nrf_strerror_get(ret_code_t code) {
+    switch (code) {
+    case NRF_SUCCESS:               return "NRF_SUCCESS";
+    case NRF_ERROR_INTERNAL:        return "NRF_ERROR_INTERNAL";
+    case NRF_ERROR_NO_MEM:          return "NRF_ERROR_NO_MEM";
+    case NRF_ERROR_NOT_FOUND:       return "NRF_ERROR_NOT_FOUND";
+    case NRF_ERROR_NOT_SUPPORTED:   return "NRF_ERROR_NOT_SUPPORTED";
+    case NRF_ERROR_INVALID_PARAM:   return "NRF_ERROR_INVALID_PARAM";
+    case NRF_ERROR_INVALID_STATE:   return "NRF_ERROR_INVALID_STATE";
+    case NRF_ERROR_INVALID_LENGTH:  return "NRF_ERROR_INVALID_LENGTH";
+    case NRF_ERROR_DATA_SIZE:       return "NRF_ERROR_DATA_SIZE";
+    case NRF_ERROR_NULL:            return "NRF_ERROR_NULL";
+    case NRF_ERROR_FORBIDDEN:       return "NRF_ERROR_FORBIDDEN";
+    case NRF_ERROR_INVALID_ADDR:    return "NRF_ERROR_INVALID_ADDR";
+    case NRF_ERROR_BUSY:            return "NRF_ERROR_BUSY";
+    case NRF_ERROR_CONN_COUNT:      return "NRF_ERROR_CONN_COUNT";
+    case NRF_ERROR_RESOURCES:       return "NRF_ERROR_RESOURCES";
+    case BLE_ERROR_INVALID_CONN_HANDLE: return "BLE_ERROR_INVALID_CONN_HANDLE";
+    case BLE_ERROR_INVALID_ATTR_HANDLE: return "BLE_ERROR_INVALID_ATTR_HANDLE";
+    default:                        return "Unknown error code";
+    }
+}
+
+void app_error_handler(uint32_t error_code, uint32_t line_num, const uint8_t * p_file_name) {
+    static error_info_t error_info;
+    error_info.line_num = line_num;
+    error_info.p_file_name = p_file_name;
+    error_info.err_code = error_code;
+    fprintf(stderr, "sim: error 0x%X (%s) at %s:%u\n", error_code, nrf_strerror_get(error_code),
+            (char const *)p_file_name, line_num);
+    // Linked below 4 GiB, the pointer fits the 32-bit argument
+    app_error_fault_handler(NRF_FAULT_ID_SDK_ERROR, 0, (uint32_t)(uintptr_t)&error_info);
+}
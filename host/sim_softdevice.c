@@ -0,0 +1,1517 @@
+/** @file sim_softdevice.c
+ *
+ * @brief SoftDevice stand-in of the host simulator and the BLEAM devices it talks to.
+ *
+ * @details Models what the firmware can observe and what costs energy: advertising
+ *          reports received inside scan windows, connection setup, one ATT request
+ *          per round trip, write commands limited by the TX queue and connection
+ *          event airtime, and the radio on time of all of it. BLEAM devices serve
+ *          the BLEAM service, send salt, verify the signature with the node key and
+ *          timestamp the RSSI data they receive.
+ *
+ *          Not modelled: iOS background advertising, scan responses, channel maps,
+ *          retransmissions and more than one link.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "global_app_config.h"
+#include "nordic_common.h"
+#include "nrf.h"
+#include "sdk_config.h"
+#include "nrf_sdh.h"
+#include "nrf_sdh_ble.h"
+#include "nrf_sdm.h"
+#include "nrf_soc.h"
+
+#define SIM_APP_RAM_START    0x20002A00 /**< Application RAM start the SoftDevice reports. */
+#define SIM_CONN_HANDLE      0          /**< Handle of the only link. */
+#define SIM_TX_QUEUE_MAX     16         /**< Largest supported write command TX queue. */
+#define SIM_VS_UUID_MAX      8          /**< Largest supported number of vendor specific UUID bases. */
+#define SIM_EVT_PER_CONN_EVT 8          /**< Largest number of BLE events one connection event produces. */
+
+#define SIM_RX_PROBABILITY   0.9        /**< Probability of receiving a packet sent inside a scan window. */
+#define SIM_SCAN_RAMP_US     140        /**< Radio ramp up and channel switch per scan window, us. */
+#define SIM_CONN_EVT_US      350        /**< Radio on time of an empty connection event, us. */
+#define SIM_PKT_OVERHEAD_US  492        /**< Air time of LL header, CRC, IFS and acknowledgement per packet, us. */
+#define SIM_ADV_EVT_US       1200       /**< Radio on time of a connectable advertising event on three channels, us. */
+#define SIM_CONNECT_DELAY_US 2000       /**< Time from CONNECT_IND to first connection event, us. */
+#define SIM_CONN_EVT_MARGIN  1250       /**< Part of connection interval the SoftDevice keeps free, us. */
+
+#define SIM_ADV_INTERVAL_US  100000     /**< Advertising interval of all devices, us. */
+#define SIM_ADV_DELAY_US     10000      /**< Largest random advertising delay, us. */
+#define SIM_RSSI_SIGMA       4.0        /**< Standard deviation of received RSSI, dBm. */
+#define SIM_PRESENCE_JITTER  (30 * 60 * 1000) /**< Largest deviation of a device from the presence window, ms. */
+
+#define SIM_SERVER_MTU       247        /**< ATT MTU of BLEAM devices. */
+#define SIM_LL_DATA_DEFAULT  27         /**< LL payload before data length update, octets. */
+#define SIM_LL_DATA_MAX      251        /**< Largest LL payload, octets. */
+#define SIM_L2CAP_HDR_LEN    4          /**< L2CAP header length, octets. */
+#define SIM_CHAR_DECL_LEN    21         /**< Characteristic declaration with 128-bit UUID in a discovery response, octets. */
+#define SIM_SALT_LEN         16         /**< Salt length, octets. */
+#define SIM_SIGNATURE_LEN    32         /**< Signature length, octets. */
+
+#define SIM_SLOW_UPDATE_EVT  3          /**< Connection event a slow BLEAM device asks for other parameters at. */
+#define SIM_SLOW_MIN_INTERVAL 24        /**< Minimum connection interval slow BLEAM devices ask for, 1.25 ms units. */
+#define SIM_SLOW_MAX_INTERVAL 40        /**< Maximum connection interval slow BLEAM devices ask for, 1.25 ms units. */
+#define SIM_SLOW_SUP_TIMEOUT  400       /**< Supervision timeout slow BLEAM devices ask for, 10 ms units. */
+#define SIM_UPDATE_INSTANT    6         /**< Connection events from parameter update to its instant. */
+
+#define SIM_BLEAM_UUID       0xB500     /**< BLEAM service UUID. */
+
+/** Attribute handles of the BLEAM service on BLEAM devices. */
+enum {
+    PEER_HANDLE_SERVICE = 0x10,
+    PEER_HANDLE_NOTIFY_DECL,
+    PEER_HANDLE_NOTIFY,
+    PEER_HANDLE_NOTIFY_CCCD,
+    PEER_HANDLE_SIGN_DECL,
+    PEER_HANDLE_SIGN,
+    PEER_HANDLE_RSSI_DECL,
+    PEER_HANDLE_RSSI,
+    PEER_HANDLE_HEALTH_DECL,
+    PEER_HANDLE_HEALTH,
+    PEER_HANDLE_TIME_DECL,
+    PEER_HANDLE_TIME,
+    PEER_CHAR_CNT = 5
+};
+
+/**@brief Simulated BLEAM device. */
+typedef struct {
+    ble_gap_addr_t addr;                        /**< Random static address. */
+    uint8_t        uuid128[16];                 /**< BLEAM service UUID, little endian. */
+    uint8_t        adv_data[BLE_GAP_ADV_SET_DATA_SIZE_MAX]; /**< Advertising data. */
+    uint8_t        adv_len;                     /**< Advertising data length. */
+    double         rssi_mean;                   /**< Mean RSSI at the node, dBm. */
+    uint32_t       present_from_ms;             /**< Time of day the device arrives, ms. */
+    uint32_t       present_to_ms;               /**< Time of day the device leaves, ms. */
+    bool           slow;                        /**< Flag denoting that the device asks for slower connection parameters. */
+    bool           adv_scheduled;               /**< Flag denoting that an advertising event is queued. */
+    bool           report_pending;              /**< Flag denoting that a report was delivered and RSSI data is due. */
+    uint64_t       report_us;                   /**< Time of the first report since the latest delivered RSSI data, us. */
+    uint8_t        salt[SIM_SALT_LEN];          /**< Salt sent in the current connection. */
+    uint8_t        signature[SIM_SIGNATURE_LEN]; /**< Signature received in the current connection. */
+    uint8_t        signature_len;               /**< Signature octets received. */
+    bool           delivered;                   /**< Flag denoting that the current connection delivered RSSI data. */
+    uint32_t       reports;                     /**< Reports delivered to the node. */
+    uint32_t       sessions;                    /**< Connections that delivered RSSI data. */
+    uint32_t       sig_bad;                     /**< Signatures that did not match. */
+} sim_peer_t;
+
+/**@brief Outstanding ATT request. */
+typedef enum {
+    REQ_NONE,      /**< No request. */
+    REQ_WRITE,     /**< Write request. */
+    REQ_READ,      /**< Read request. */
+    REQ_DISCOVERY  /**< Round trip of service discovery. */
+} sim_req_t;
+
+/**@brief Queued write command. */
+typedef struct {
+    uint16_t handle;                /**< Attribute handle. */
+    uint16_t len;                   /**< Value length. */
+    uint8_t  data[SIM_SERVER_MTU];  /**< Value. */
+} sim_write_cmd_t;
+
+/**@brief The only link of the node. */
+typedef struct {
+    bool                  active;            /**< Flag denoting that the link exists. */
+    uint32_t              generation;        /**< Link number, events of older links are dropped. */
+    sim_peer_t *          p_peer;            /**< Connected device. */
+    ble_gap_conn_params_t params;            /**< Connection parameters. */
+    uint64_t              interval_us;       /**< Connection interval, us. */
+    uint32_t              event_cnt;         /**< Connection event counter. */
+    bool                  lost;              /**< Flag denoting that the peer is out of range. */
+    uint64_t              lost_us;           /**< Time the peer went out of range, us. */
+    bool                  terminating;       /**< Flag denoting that the application asked to disconnect. */
+    uint16_t              mtu;               /**< ATT MTU. */
+    uint16_t              ll_data;           /**< LL payload limit, octets. */
+    sim_req_t             req;               /**< Outstanding ATT request. */
+    bool                  req_sent;          /**< Flag denoting that the request is on air. */
+    uint16_t              req_handle;        /**< Attribute handle of the request. */
+    uint8_t               req_data[SIM_SERVER_MTU]; /**< Value of a write request. */
+    uint16_t              req_len;           /**< Value length of a write request. */
+    ble_uuid_t            disc_uuid;         /**< Service to discover. */
+    sim_sd_discovery_cb_t disc_cb;           /**< Discovery callback. */
+    uint8_t               disc_step;         /**< Discovery round trips done: service, characteristics, descriptors. */
+    uint8_t               disc_chars;        /**< Characteristics discovered. */
+    bool                  mtu_pending;       /**< Flag denoting that ATT MTU exchange is in progress. */
+    bool                  mtu_sent;          /**< Flag denoting that ATT MTU request is on air. */
+    uint16_t              mtu_client;        /**< Client RX MTU of the exchange. */
+    bool                  dl_pending;        /**< Flag denoting that data length update is in progress. */
+    uint32_t              dl_event;          /**< Connection event the data length update completes at. */
+    uint16_t              dl_octets;         /**< Requested LL payload, octets. */
+    bool                  update_asked;      /**< Flag denoting that the peer has asked for other parameters. */
+    bool                  update_pending;    /**< Flag denoting that a parameter update is waiting for its instant. */
+    uint32_t              update_event;      /**< Instant of the parameter update. */
+    ble_gap_conn_params_t update_params;     /**< Parameters after the update. */
+    bool                  hvx_pending;       /**< Flag denoting that the peer has a notification to send. */
+    uint32_t              hvx_event;         /**< Connection event the notification goes out at. */
+    sim_write_cmd_t       txq[SIM_TX_QUEUE_MAX]; /**< Write command TX queue. */
+    uint8_t               txq_len;           /**< Queued write commands. */
+} sim_conn_t;
+
+sim_radio_stats_t g_sim_radio;
+sim_peer_stats_t  g_sim_peers;
+
+static sim_peer_t * m_peers;            /**< BLEAM devices. */
+static uint32_t     m_peer_cnt;         /**< Number of BLEAM devices. */
+static bool         m_noise_scheduled;  /**< Flag denoting that an advertising event of other devices is queued. */
+static uint8_t      m_app_key[BLEAM_KEY_SIZE]; /**< Key BLEAM devices verify signatures with. */
+
+static bool     m_sdh_enabled;       /**< Flag denoting that the SoftDevice is enabled. */
+static bool     m_ble_enabled;       /**< Flag denoting that the BLE stack is enabled. */
+static uint8_t  m_vs_limit;          /**< Configured number of vendor specific UUID bases. */
+static uint8_t  m_vs_cnt;            /**< Vendor specific UUID bases added. */
+static ble_uuid128_t m_vs[SIM_VS_UUID_MAX]; /**< Vendor specific UUID bases. */
+static uint8_t  m_tx_queue_size = 1; /**< Configured write command TX queue size. */
+static uint32_t m_gpregret;          /**< Retained register. */
+static uint64_t m_rand_us;           /**< Time the random pool was last drained, us. */
+static uint8_t  m_rand_left;         /**< Random bytes left in the pool after last drain. */
+static uint16_t m_gatts_handle = 1;  /**< Next local attribute handle. */
+
+/**@brief Scanner and initiator. */
+static struct {
+    bool                  scanning;     /**< Flag denoting that the scanner runs, paused or not. */
+    bool                  paused;       /**< Flag denoting that the scanner waits for the application to take a report. */
+    bool                  initiating;   /**< Flag denoting that the initiator runs. */
+    uint32_t              generation;   /**< Initiator run, timeouts of older runs are dropped. */
+    ble_gap_scan_params_t params;       /**< Scan parameters of the scanner or initiator. */
+    ble_data_t            buffer;       /**< Application report buffer. */
+    uint64_t              start_us;     /**< Time the scanner or initiator started, us. */
+    ble_gap_addr_t        target;       /**< Initiator peer address. */
+    ble_gap_conn_params_t conn_params;  /**< Initiator connection parameters. */
+} m_scanner;
+
+/**@brief Advertiser. */
+static struct {
+    bool     configured;  /**< Flag denoting that the advertising set is configured. */
+    bool     active;      /**< Flag denoting that advertising runs. */
+    uint32_t interval;    /**< Advertising interval, 0.625 ms units. */
+    uint64_t start_us;    /**< Time advertising started, us. */
+} m_adv;
+
+static sim_conn_t m_conn; /**< The only link. */
+
+extern nrf_sdh_ble_evt_observer_t const __start_sdh_ble_observers[];
+extern nrf_sdh_ble_evt_observer_t const __stop_sdh_ble_observers[];
+
+static nrf_sdh_ble_evt_observer_t const ** m_observers; /**< Observers sorted by priority. */
+static size_t m_observer_cnt;                          /**< Number of observers. */
+
+/**@brief Function for ordering observers by priority, keeping link order within one priority.
+ *
+ * @returns Comparison result for qsort().
+ */
+static int observer_cmp(void const * p_a, void const * p_b) {
+    nrf_sdh_ble_evt_observer_t const * p_obs_a = *(nrf_sdh_ble_evt_observer_t const * const *)p_a;
+    nrf_sdh_ble_evt_observer_t const * p_obs_b = *(nrf_sdh_ble_evt_observer_t const * const *)p_b;
+    if (p_obs_a->prio != p_obs_b->prio) {
+        return (int)p_obs_a->prio - (int)p_obs_b->prio;
+    }
+    return (p_obs_a < p_obs_b) ? -1 : 1;
+}
+
+void sim_sd_evt_dispatch(ble_evt_t const * p_ble_evt) {
+    if (NULL == m_observers) {
+        m_observer_cnt = __stop_sdh_ble_observers - __start_sdh_ble_observers;
+        m_observers = calloc(m_observer_cnt, sizeof(*m_observers));
+        for (size_t index = 0; m_observer_cnt > index; ++index) {
+            m_observers[index] = &__start_sdh_ble_observers[index];
+        }
+        qsort(m_observers, m_observer_cnt, sizeof(*m_observers), observer_cmp);
+    }
+    for (size_t index = 0; m_observer_cnt > index; ++index) {
+        m_observers[index]->handler(p_ble_evt, m_observers[index]->p_context);
+    }
+}
+
+/**@brief Function for allocating a BLE event.
+ *
+ * @param[in] evt_id    Event ID.
+ * @param[in] extra     Octets of variable length data past the end of @ref ble_evt_t.
+ *
+ * @returns Zeroed event.
+ */
+static ble_evt_t * evt_alloc(uint16_t evt_id, uint16_t extra) {
+    ble_evt_t * p_evt = calloc(1, sizeof(ble_evt_t) + extra);
+    if (NULL == p_evt) {
+        fprintf(stderr, "sim: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    p_evt->header.evt_id = evt_id;
+    p_evt->header.evt_len = sizeof(ble_evt_t) + extra;
+    return p_evt;
+}
+
+/**@brief Function for handing a queued BLE event to the application.
+ *
+ * @returns Always true.
+ */
+static bool evt_deliver(void * p_ctx, uint64_t arg) {
+    UNUSED_PARAMETER(arg);
+    sim_sd_evt_dispatch(p_ctx);
+    free(p_ctx);
+    return true;
+}
+
+/**@brief Function for queueing a BLE event.
+ *
+ * @param[in] p_evt    Event from @ref evt_alloc, freed after delivery.
+ * @param[in] at_us    Delivery time, us.
+ *
+ * @returns Nothing.
+ */
+static void evt_post(ble_evt_t * p_evt, uint64_t at_us) {
+    sim_post(at_us, SIM_WAKE_RADIO, evt_deliver, p_evt, 0);
+}
+
+/**@brief Function for computing air time of an L2CAP payload.
+ *
+ * @param[in] len        ATT PDU length, octets.
+ * @param[in] ll_data    LL payload limit, octets.
+ *
+ * @returns Air time including acknowledgements, us.
+ */
+static uint64_t pdu_air_us(uint16_t len, uint16_t ll_data) {
+    const uint32_t total = len + SIM_L2CAP_HDR_LEN;
+    const uint32_t packets = (total + ll_data - 1) / ll_data;
+    return packets * SIM_PKT_OVERHEAD_US + total * 8;
+}
+
+/**@brief Function for checking whether a BLEAM device is in range.
+ *
+ * @returns True if the device is around at the current time of day.
+ */
+static bool peer_present(sim_peer_t const * p_peer) {
+    const uint32_t tod = sim_time_of_day_ms();
+    if (p_peer->present_from_ms == p_peer->present_to_ms) {
+        return true;
+    }
+    if (p_peer->present_from_ms < p_peer->present_to_ms) {
+        return p_peer->present_from_ms <= tod && p_peer->present_to_ms > tod;
+    }
+    return p_peer->present_from_ms <= tod || p_peer->present_to_ms > tod;
+}
+
+/**@brief Function for drawing the RSSI of a received packet.
+ *
+ * @returns RSSI, dBm.
+ */
+static int8_t rssi_draw(double mean) {
+    const double rssi = mean + SIM_RSSI_SIGMA * sim_gauss();
+    return (int8_t)((-100 > rssi) ? -100 : (-20 < rssi) ? -20 : rssi);
+}
+
+/**@brief Function for adding radio on time of a scan or initiator run.
+ *
+ * @param[in]  end_us    End of the run, us.
+ * @param[out] p_acc     Accumulator to add to.
+ *
+ * @returns Nothing.
+ */
+static void scan_account(uint64_t end_us, uint64_t * p_acc) {
+    const uint64_t interval_us = m_scanner.params.interval * 625ULL;
+    const uint64_t window_us = m_scanner.params.window * 625ULL;
+    const uint64_t duration = end_us - m_scanner.start_us;
+    const uint64_t full = duration / interval_us;
+    const uint64_t rest = duration % interval_us;
+    *p_acc += full * (window_us + SIM_SCAN_RAMP_US);
+    if (0 < rest) {
+        *p_acc += MIN(rest, window_us) + SIM_SCAN_RAMP_US;
+    }
+    m_scanner.start_us = end_us;
+}
+
+/**@brief Function for adding radio on time of advertising so far.
+ *
+ * @returns Nothing.
+ */
+static void adv_account(void) {
+    const uint64_t interval_us = m_adv.interval * 625ULL;
+    const uint64_t now = sim_now_us();
+    const uint64_t events = (now - m_adv.start_us + interval_us - 1) / interval_us;
+    g_sim_radio.adv_us += events * SIM_ADV_EVT_US;
+    m_adv.start_us += events * interval_us;
+}
+
+/**@brief Function for checking whether the radio listens at the current time.
+ *
+ * @returns True if a packet sent now falls into a scan window.
+ */
+static bool scan_window_open(void) {
+    const uint64_t interval_us = m_scanner.params.interval * 625ULL;
+    const uint64_t window_us = m_scanner.params.window * 625ULL;
+    return ((sim_now_us() - m_scanner.start_us) % interval_us) < window_us && SIM_RX_PROBABILITY > sim_randf();
+}
+
+/**@brief Function for delivering an advertising report and pausing the scanner.
+ *
+ * @param[in] p_addr         Advertiser address.
+ * @param[in] connectable    Flag denoting connectable advertising.
+ * @param[in] p_data         Advertising data.
+ * @param[in] len            Advertising data length.
+ * @param[in] rssi           RSSI, dBm.
+ *
+ * @returns Always true.
+ */
+static bool report_deliver(ble_gap_addr_t const * p_addr, bool connectable, uint8_t const * p_data, uint8_t len, int8_t rssi) {
+    // Data goes into the application buffer, which stays with the SoftDevice until scanning resumes
+    len = MIN(len, m_scanner.buffer.len);
+    memcpy(m_scanner.buffer.p_data, p_data, len);
+    m_scanner.paused = true;
+
+    ble_evt_t evt;
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id = BLE_GAP_EVT_ADV_REPORT;
+    evt.header.evt_len = sizeof(evt);
+    evt.evt.gap_evt.conn_handle = BLE_CONN_HANDLE_INVALID;
+    ble_gap_evt_adv_report_t * p_report = &evt.evt.gap_evt.params.adv_report;
+    p_report->type.connectable = connectable;
+    p_report->type.status = 0;
+    p_report->peer_addr = *p_addr;
+    p_report->primary_phy = BLE_GAP_PHY_1MBPS;
+    p_report->secondary_phy = BLE_GAP_PHY_NOT_SET;
+    p_report->tx_power = 127;
+    p_report->rssi = rssi;
+    p_report->ch_index = 37 + sim_rand() % 3;
+    p_report->data.p_data = m_scanner.buffer.p_data;
+    p_report->data.len = len;
+    sim_sd_evt_dispatch(&evt);
+    return true;
+}
+
+static bool conn_event(void * p_ctx, uint64_t arg);
+
+/**@brief Function for establishing the link after the initiator caught an advertising packet.
+ *
+ * @param[in] p_peer    Device to connect to.
+ *
+ * @returns Nothing.
+ */
+static void conn_establish(sim_peer_t * p_peer) {
+    scan_account(sim_now_us(), &g_sim_radio.initiate_us);
+    m_scanner.initiating = false;
+    ++m_scanner.generation;
+    ++g_sim_radio.connects;
+
+    memset(&m_conn, 0, sizeof(sim_conn_t) - sizeof(m_conn.txq));
+    m_conn.txq_len = 0;
+    m_conn.active = true;
+    ++m_conn.generation;
+    m_conn.p_peer = p_peer;
+    m_conn.params = m_scanner.conn_params;
+    m_conn.params.min_conn_interval = m_conn.params.max_conn_interval;
+    m_conn.interval_us = m_conn.params.max_conn_interval * 1250ULL;
+    m_conn.mtu = BLE_GATT_ATT_MTU_DEFAULT;
+    m_conn.ll_data = SIM_LL_DATA_DEFAULT;
+    p_peer->signature_len = 0;
+    p_peer->delivered = false;
+
+    const uint64_t at_us = sim_now_us() + SIM_CONNECT_DELAY_US;
+    ble_evt_t * p_evt = evt_alloc(BLE_GAP_EVT_CONNECTED, 0);
+    p_evt->evt.gap_evt.conn_handle = SIM_CONN_HANDLE;
+    p_evt->evt.gap_evt.params.connected.peer_addr = p_peer->addr;
+    p_evt->evt.gap_evt.params.connected.role = BLE_GAP_ROLE_CENTRAL;
+    p_evt->evt.gap_evt.params.connected.conn_params = m_conn.params;
+    p_evt->evt.gap_evt.params.connected.adv_handle = BLE_GAP_ADV_SET_HANDLE_NOT_SET;
+    evt_post(p_evt, at_us);
+    sim_post(at_us + m_conn.interval_us, SIM_WAKE_RADIO, conn_event, &m_conn, m_conn.generation);
+}
+
+/**@brief Function for handling an advertising event of a BLEAM device.
+ *
+ * @param[in] p_ctx    BLEAM device.
+ * @param[in] arg      Unused.
+ *
+ * @returns True if a report reached the application.
+ */
+static bool peer_adv(void * p_ctx, uint64_t arg) {
+    UNUSED_PARAMETER(arg);
+    sim_peer_t * p_peer = p_ctx;
+    if (!m_scanner.scanning && !m_scanner.initiating) {
+        p_peer->adv_scheduled = false;
+        return false;
+    }
+    sim_post(sim_now_us() + SIM_ADV_INTERVAL_US + sim_rand() % SIM_ADV_DELAY_US, SIM_WAKE_RADIO, peer_adv, p_peer, 0);
+
+    if (!peer_present(p_peer)) {
+        // Reports of a device that left before delivery are lost, not late
+        p_peer->report_pending = false;
+        return false;
+    }
+    if ((m_conn.active && m_conn.p_peer == p_peer) || !scan_window_open()) {
+        return false;
+    }
+    if (m_scanner.initiating) {
+        if (0 == memcmp(m_scanner.target.addr, p_peer->addr.addr, BLE_GAP_ADDR_LEN) &&
+            BLE_GAP_ADDR_TYPE_PUBLIC != m_scanner.target.addr_type) {
+            conn_establish(p_peer);
+        }
+        return false;
+    }
+    if (m_scanner.paused) {
+        return false;
+    }
+    ++g_sim_radio.reports_bleam;
+    ++p_peer->reports;
+    if (!p_peer->report_pending) {
+        p_peer->report_pending = true;
+        p_peer->report_us = sim_now_us();
+    }
+    return report_deliver(&p_peer->addr, true, p_peer->adv_data, p_peer->adv_len, rssi_draw(p_peer->rssi_mean));
+}
+
+/**@brief Function for handling an advertising event of any other device around.
+ *
+ * @details All other devices together make one Poisson process.
+ *
+ * @param[in] p_ctx    Unused.
+ * @param[in] arg      Unused.
+ *
+ * @returns True if a report reached the application.
+ */
+static bool noise_adv(void * p_ctx, uint64_t arg) {
+    UNUSED_PARAMETER(p_ctx);
+    UNUSED_PARAMETER(arg);
+    if (!m_scanner.scanning && !m_scanner.initiating) {
+        m_noise_scheduled = false;
+        return false;
+    }
+    const double mean_us = (double)SIM_ADV_INTERVAL_US / g_sim_config.noise;
+    sim_post(sim_now_us() + (uint64_t)(-mean_us * log(1.0 - sim_randf())) + 1, SIM_WAKE_RADIO, noise_adv, NULL, 0);
+
+    if (!m_scanner.scanning || m_scanner.paused || !scan_window_open()) {
+        return false;
+    }
+    const uint32_t device = sim_rand() % g_sim_config.noise;
+    const ble_gap_addr_t addr = {
+        .addr_type = BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_NON_RESOLVABLE,
+        .addr = {(uint8_t)device, (uint8_t)(device >> 8), 0x5A, 0xA5, 0x3C, 0x3C},
+    };
+    // Flags and manufacturer data of a company other than Apple
+    uint8_t data[3 + 2 + 16] = {0x02, BLE_GAP_AD_TYPE_FLAGS, BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE,
+                                0x12, BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA, 0x59, 0x00};
+    data[7] = (uint8_t)device;
+    ++g_sim_radio.reports_other;
+    return report_deliver(&addr, device & 1, data, sizeof(data), rssi_draw(-85.0));
+}
+
+/**@brief Function for queueing advertising events of everything around once the radio listens.
+ *
+ * @returns Nothing.
+ */
+static void world_wake(void) {
+    for (uint32_t index = 0; m_peer_cnt > index; ++index) {
+        if (!m_peers[index].adv_scheduled) {
+            m_peers[index].adv_scheduled = true;
+            sim_post(sim_now_us() + sim_rand() % SIM_ADV_INTERVAL_US, SIM_WAKE_RADIO, peer_adv, &m_peers[index], 0);
+        }
+    }
+    if (0 < g_sim_config.noise && !m_noise_scheduled) {
+        m_noise_scheduled = true;
+        sim_post(sim_now_us() + sim_rand() % (SIM_ADV_INTERVAL_US / g_sim_config.noise + 1), SIM_WAKE_RADIO, noise_adv, NULL, 0);
+    }
+}
+
+/**@brief Function for handling the initiator timeout.
+ *
+ * @param[in] p_ctx    Unused.
+ * @param[in] arg      Initiator run the timeout belongs to.
+ *
+ * @returns True if the initiator was still running.
+ */
+static bool initiator_timeout(void * p_ctx, uint64_t arg) {
+    UNUSED_PARAMETER(p_ctx);
+    if (!m_scanner.initiating || m_scanner.generation != arg) {
+        return false;
+    }
+    scan_account(sim_now_us(), &g_sim_radio.initiate_us);
+    m_scanner.initiating = false;
+    ++g_sim_radio.connect_timeouts;
+
+    ble_evt_t evt;
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id = BLE_GAP_EVT_TIMEOUT;
+    evt.header.evt_len = sizeof(evt);
+    evt.evt.gap_evt.conn_handle = BLE_CONN_HANDLE_INVALID;
+    evt.evt.gap_evt.params.timeout.src = BLE_GAP_TIMEOUT_SRC_CONN;
+    sim_sd_evt_dispatch(&evt);
+    return true;
+}
+
+/**@brief Function for ending the link.
+ *
+ * @param[in] at_us     Time of the disconnection event, us.
+ * @param[in] reason    HCI reason.
+ *
+ * @returns Nothing.
+ */
+static void conn_end(uint64_t at_us, uint8_t reason) {
+    m_conn.active = false;
+    ++m_conn.generation;
+    ble_evt_t * p_evt = evt_alloc(BLE_GAP_EVT_DISCONNECTED, 0);
+    p_evt->evt.gap_evt.conn_handle = SIM_CONN_HANDLE;
+    p_evt->evt.gap_evt.params.disconnected.reason = reason;
+    evt_post(p_evt, at_us);
+}
+
+/**@brief Function for a BLEAM device to handle a written value.
+ *
+ * @param[in] p_peer    BLEAM device.
+ * @param[in] handle    Attribute handle.
+ * @param[in] p_data    Value.
+ * @param[in] len       Value length.
+ *
+ * @returns GATT status.
+ */
+static uint16_t peer_write(sim_peer_t * p_peer, uint16_t handle, uint8_t const * p_data, uint16_t len) {
+    switch (handle) {
+    case PEER_HANDLE_NOTIFY_CCCD:
+        if (2 != len) {
+            return BLE_GATT_STATUS_UNKNOWN;
+        }
+        if (BLE_GATT_HVX_NOTIFICATION & p_data[0]) {
+            // Notifications on, send salt for the node to sign
+            for (uint8_t index = 0; SIM_SALT_LEN > index; ++index) {
+                p_peer->salt[index] = (uint8_t)sim_rand();
+            }
+            p_peer->signature_len = 0;
+            m_conn.hvx_pending = true;
+            m_conn.hvx_event = m_conn.event_cnt + 1;
+        }
+        return BLE_GATT_STATUS_SUCCESS;
+
+    case PEER_HANDLE_SIGN:
+        if (SIM_SIGNATURE_LEN < p_peer->signature_len + len) {
+            p_peer->signature_len = SIM_SIGNATURE_LEN + 1;
+            return BLE_GATT_STATUS_SUCCESS;
+        }
+        memcpy(p_peer->signature + p_peer->signature_len, p_data, len);
+        p_peer->signature_len += len;
+        if (SIM_SIGNATURE_LEN == p_peer->signature_len) {
+            uint8_t expected[SIM_SIGNATURE_LEN];
+            sim_hmac_sha256(expected, m_app_key, sizeof(m_app_key), p_peer->salt, SIM_SALT_LEN);
+            if (0 == memcmp(expected, p_peer->signature, SIM_SIGNATURE_LEN)) {
+                ++g_sim_peers.sig_ok;
+            } else {
+                ++g_sim_peers.sig_bad;
+                ++p_peer->sig_bad;
+            }
+        }
+        return BLE_GATT_STATUS_SUCCESS;
+
+    case PEER_HANDLE_RSSI:
+        ++g_sim_peers.rssi_writes;
+        if (!p_peer->delivered) {
+            p_peer->delivered = true;
+            ++p_peer->sessions;
+            ++g_sim_peers.sessions;
+            if (p_peer->report_pending) {
+                if (SIM_LATENCY_MAX > g_sim_peers.latency_cnt) {
+                    g_sim_peers.latency_ms[g_sim_peers.latency_cnt] = (uint32_t)((sim_now_us() - p_peer->report_us) / SIM_US_PER_MS);
+                }
+                ++g_sim_peers.latency_cnt;
+            }
+            p_peer->report_pending = false;
+        }
+        return BLE_GATT_STATUS_SUCCESS;
+
+    case PEER_HANDLE_HEALTH:
+        ++g_sim_peers.health_writes;
+        return BLE_GATT_STATUS_SUCCESS;
+
+    default:
+        return BLE_GATT_STATUS_ATTERR_INVALID_HANDLE;
+    }
+}
+
+/**@brief Function for checking whether a BLEAM device serves the service being discovered.
+ *
+ * @returns True if the UUID base registered under the discovered UUID type is the BLEAM service one.
+ */
+static bool peer_service_matches(sim_peer_t const * p_peer, ble_uuid_t const * p_uuid) {
+    const uint8_t index = p_uuid->type - BLE_UUID_TYPE_VENDOR_BEGIN;
+    if (BLE_UUID_TYPE_VENDOR_BEGIN > p_uuid->type || m_vs_cnt <= index || SIM_BLEAM_UUID != p_uuid->uuid) {
+        return false;
+    }
+    uint8_t const * p_base = m_vs[index].uuid128;
+    return 0 == memcmp(p_base, p_peer->uuid128, 12) && 0 == memcmp(p_base + 14, p_peer->uuid128 + 14, 2);
+}
+
+/**@brief Function for filling the discovered BLEAM service database.
+ *
+ * @param[out] p_srv     Service database.
+ * @param[in]  p_uuid    Service UUID as discovered.
+ *
+ * @returns Nothing.
+ */
+static void peer_db_fill(ble_gatt_db_srv_t * p_srv, ble_uuid_t const * p_uuid) {
+    memset(p_srv, 0, sizeof(ble_gatt_db_srv_t));
+    p_srv->srv_uuid = *p_uuid;
+    p_srv->handle_range.start_handle = PEER_HANDLE_SERVICE;
+    p_srv->handle_range.end_handle = PEER_HANDLE_TIME;
+    p_srv->char_count = PEER_CHAR_CNT;
+    static const uint16_t value_handles[PEER_CHAR_CNT] = {
+        PEER_HANDLE_NOTIFY, PEER_HANDLE_SIGN, PEER_HANDLE_RSSI, PEER_HANDLE_HEALTH, PEER_HANDLE_TIME,
+    };
+    for (uint8_t index = 0; PEER_CHAR_CNT > index; ++index) {
+        ble_gatt_db_char_t * p_char = &p_srv->charateristics[index];
+        p_char->characteristic.uuid.uuid = SIM_BLEAM_UUID + 1 + index;
+        p_char->characteristic.uuid.type = p_uuid->type;
+        p_char->characteristic.handle_decl = value_handles[index] - 1;
+        p_char->characteristic.handle_value = value_handles[index];
+        p_char->cccd_handle = BLE_GATT_HANDLE_INVALID;
+    }
+    p_srv->charateristics[0].characteristic.char_props.notify = 1;
+    p_srv->charateristics[0].characteristic.char_props.read = 1;
+    p_srv->charateristics[0].cccd_handle = PEER_HANDLE_NOTIFY_CCCD;
+    for (uint8_t index = 1; 4 > index; ++index) {
+        p_srv->charateristics[index].characteristic.char_props.write_wo_resp = 1;
+        p_srv->charateristics[index].characteristic.char_props.write = 1;
+    }
+    p_srv->charateristics[4].characteristic.char_props.read = 1;
+}
+
+/**@brief Function for finishing service discovery.
+ *
+ * @param[in] p_ctx    Unused.
+ * @param[in] arg      Link the discovery belongs to.
+ *
+ * @returns True if the link still exists.
+ */
+static bool discovery_done(void * p_ctx, uint64_t arg) {
+    UNUSED_PARAMETER(p_ctx);
+    if (!m_conn.active || m_conn.generation != arg) {
+        return false;
+    }
+    sim_sd_discovery_cb_t callback = m_conn.disc_cb;
+    const ble_uuid_t uuid = m_conn.disc_uuid;
+    m_conn.disc_cb = NULL;
+    if (!peer_service_matches(m_conn.p_peer, &uuid)) {
+        callback(SIM_CONN_HANDLE, NULL);
+        return true;
+    }
+    ble_gatt_db_srv_t srv;
+    peer_db_fill(&srv, &uuid);
+    callback(SIM_CONN_HANDLE, &srv);
+    return true;
+}
+
+/**@brief Function for answering the outstanding ATT request.
+ *
+ * @param[out] p_evts    Events to deliver at the end of the connection event.
+ * @param[out] p_cnt     Number of events.
+ * @param[out] p_air_us  Air time of the response, added to.
+ *
+ * @returns True if discovery has finished.
+ */
+static bool request_answer(ble_evt_t ** p_evts, uint8_t * p_cnt, uint64_t * p_air_us) {
+    sim_peer_t * p_peer = m_conn.p_peer;
+    ble_evt_t * p_evt;
+
+    switch (m_conn.req) {
+    case REQ_WRITE: {
+        const uint16_t status = peer_write(p_peer, m_conn.req_handle, m_conn.req_data, m_conn.req_len);
+        p_evt = evt_alloc(BLE_GATTC_EVT_WRITE_RSP, m_conn.req_len);
+        p_evt->evt.gattc_evt.conn_handle = SIM_CONN_HANDLE;
+        p_evt->evt.gattc_evt.gatt_status = status;
+        p_evt->evt.gattc_evt.error_handle = (BLE_GATT_STATUS_SUCCESS == status) ? BLE_GATT_HANDLE_INVALID : m_conn.req_handle;
+        p_evt->evt.gattc_evt.params.write_rsp.handle = m_conn.req_handle;
+        p_evt->evt.gattc_evt.params.write_rsp.write_op = BLE_GATT_OP_WRITE_REQ;
+        p_evt->evt.gattc_evt.params.write_rsp.len = m_conn.req_len;
+        memcpy(p_evt->evt.gattc_evt.params.write_rsp.data, m_conn.req_data, m_conn.req_len);
+        p_evts[(*p_cnt)++] = p_evt;
+        *p_air_us += pdu_air_us(1, m_conn.ll_data);
+        m_conn.req = REQ_NONE;
+        return false;
+    }
+
+    case REQ_READ: {
+        const bool found = (PEER_HANDLE_TIME == m_conn.req_handle);
+        const uint32_t time_ms = sim_time_of_day_ms();
+        if (found) {
+            ++g_sim_peers.time_reads;
+        }
+        p_evt = evt_alloc(BLE_GATTC_EVT_READ_RSP, sizeof(time_ms));
+        p_evt->evt.gattc_evt.conn_handle = SIM_CONN_HANDLE;
+        p_evt->evt.gattc_evt.gatt_status = found ? BLE_GATT_STATUS_SUCCESS : BLE_GATT_STATUS_ATTERR_INVALID_HANDLE;
+        p_evt->evt.gattc_evt.error_handle = found ? BLE_GATT_HANDLE_INVALID : m_conn.req_handle;
+        p_evt->evt.gattc_evt.params.read_rsp.handle = m_conn.req_handle;
+        if (found) {
+            p_evt->evt.gattc_evt.params.read_rsp.len = sizeof(time_ms);
+            memcpy(p_evt->evt.gattc_evt.params.read_rsp.data, &time_ms, sizeof(time_ms));
+        }
+        p_evts[(*p_cnt)++] = p_evt;
+        *p_air_us += pdu_air_us(1 + sizeof(time_ms), m_conn.ll_data);
+        m_conn.req = REQ_NONE;
+        return false;
+    }
+
+    case REQ_DISCOVERY: {
+        // Primary service by UUID, characteristics as many as fit the MTU, then the CCCD
+        uint16_t rsp_len = 1;
+        if (0 == m_conn.disc_step) {
+            m_conn.disc_step = peer_service_matches(p_peer, &m_conn.disc_uuid) ? 1 : 3;
+            rsp_len = 5;
+        } else if (1 == m_conn.disc_step) {
+            const uint8_t per_rsp = MAX(1, (m_conn.mtu - 2) / SIM_CHAR_DECL_LEN);
+            const uint8_t count = MIN(per_rsp, PEER_CHAR_CNT - m_conn.disc_chars);
+            m_conn.disc_chars += count;
+            rsp_len = 2 + count * SIM_CHAR_DECL_LEN;
+            if (PEER_CHAR_CNT == m_conn.disc_chars) {
+                m_conn.disc_step = 2;
+            }
+        } else {
+            m_conn.disc_step = 3;
+            rsp_len = 6;
+        }
+        *p_air_us += pdu_air_us(rsp_len, m_conn.ll_data);
+        if (3 > m_conn.disc_step) {
+            m_conn.req_sent = false;
+            return false;
+        }
+        m_conn.req = REQ_NONE;
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+/**@brief Function for running a connection event.
+ *
+ * @param[in] p_ctx    Unused.
+ * @param[in] arg      Link the event belongs to.
+ *
+ * @returns Always false, events for the application are queued to the end of the connection event.
+ */
+static bool conn_event(void * p_ctx, uint64_t arg) {
+    UNUSED_PARAMETER(p_ctx);
+    if (!m_conn.active || m_conn.generation != arg) {
+        return false;
+    }
+    sim_peer_t * p_peer = m_conn.p_peer;
+    const uint64_t now = sim_now_us();
+    uint64_t air_us = SIM_CONN_EVT_US;
+    ble_evt_t * evts[SIM_EVT_PER_CONN_EVT];
+    uint8_t evt_cnt = 0;
+    bool discovered = false;
+
+    ++m_conn.event_cnt;
+    ++g_sim_radio.conn_events;
+
+    // Peer out of range, the link survives until supervision timeout
+    if (!peer_present(p_peer)) {
+        if (!m_conn.lost) {
+            m_conn.lost = true;
+            m_conn.lost_us = now;
+        }
+        g_sim_radio.conn_us += air_us;
+        if (now - m_conn.lost_us >= m_conn.params.conn_sup_timeout * 10000ULL) {
+            ++g_sim_radio.supervision_timeouts;
+            conn_end(now, BLE_HCI_CONNECTION_TIMEOUT);
+        } else {
+            sim_post(now + m_conn.interval_us, SIM_WAKE_RADIO, conn_event, &m_conn, m_conn.generation);
+        }
+        return false;
+    }
+    m_conn.lost = false;
+
+    if (m_conn.terminating) {
+        g_sim_radio.conn_us += air_us + pdu_air_us(0, m_conn.ll_data);
+        conn_end(now + air_us, BLE_HCI_LOCAL_HOST_TERMINATED_CONNECTION);
+        return false;
+    }
+
+    if (m_conn.update_pending && m_conn.event_cnt >= m_conn.update_event) {
+        m_conn.update_pending = false;
+        m_conn.params = m_conn.update_params;
+        m_conn.params.min_conn_interval = m_conn.params.max_conn_interval;
+        m_conn.interval_us = m_conn.params.max_conn_interval * 1250ULL;
+        ++g_sim_radio.param_updates;
+        ble_evt_t * p_evt = evt_alloc(BLE_GAP_EVT_CONN_PARAM_UPDATE, 0);
+        p_evt->evt.gap_evt.conn_handle = SIM_CONN_HANDLE;
+        p_evt->evt.gap_evt.params.conn_param_update_request.conn_params = m_conn.params;
+        evts[evt_cnt++] = p_evt;
+    }
+
+    // One request per round trip: sent in one event, answered in the next
+    if (REQ_NONE != m_conn.req) {
+        if (m_conn.req_sent) {
+            discovered = request_answer(evts, &evt_cnt, &air_us);
+        } else {
+            m_conn.req_sent = true;
+            air_us += pdu_air_us(3 + m_conn.req_len, m_conn.ll_data);
+        }
+    }
+
+    if (m_conn.mtu_pending) {
+        if (m_conn.mtu_sent) {
+            m_conn.mtu_pending = false;
+            m_conn.mtu = MIN(m_conn.mtu_client, SIM_SERVER_MTU);
+            ble_evt_t * p_evt = evt_alloc(BLE_GATTC_EVT_EXCHANGE_MTU_RSP, 0);
+            p_evt->evt.gattc_evt.conn_handle = SIM_CONN_HANDLE;
+            p_evt->evt.gattc_evt.params.exchange_mtu_rsp.server_rx_mtu = SIM_SERVER_MTU;
+            evts[evt_cnt++] = p_evt;
+        } else {
+            m_conn.mtu_sent = true;
+        }
+        air_us += pdu_air_us(3, m_conn.ll_data);
+    }
+
+    if (m_conn.dl_pending && m_conn.event_cnt >= m_conn.dl_event) {
+        m_conn.dl_pending = false;
+        m_conn.ll_data = MIN(m_conn.dl_octets, SIM_LL_DATA_MAX);
+        ble_evt_t * p_evt = evt_alloc(BLE_GAP_EVT_DATA_LENGTH_UPDATE, 0);
+        p_evt->evt.gap_evt.conn_handle = SIM_CONN_HANDLE;
+        ble_gap_data_length_params_t * p_params = &p_evt->evt.gap_evt.params.data_length_update.effective_params;
+        p_params->max_tx_octets = p_params->max_rx_octets = m_conn.ll_data;
+        p_params->max_tx_time_us = p_params->max_rx_time_us = (m_conn.ll_data + 14) * 8;
+        evts[evt_cnt++] = p_evt;
+        air_us += 2 * pdu_air_us(5, SIM_LL_DATA_DEFAULT);
+    }
+
+    if (p_peer->slow && !m_conn.update_asked && SIM_SLOW_UPDATE_EVT <= m_conn.event_cnt) {
+        m_conn.update_asked = true;
+        ble_evt_t * p_evt = evt_alloc(BLE_GAP_EVT_CONN_PARAM_UPDATE_REQUEST, 0);
+        p_evt->evt.gap_evt.conn_handle = SIM_CONN_HANDLE;
+        ble_gap_conn_params_t * p_params = &p_evt->evt.gap_evt.params.conn_param_update_request.conn_params;
+        p_params->min_conn_interval = SIM_SLOW_MIN_INTERVAL;
+        p_params->max_conn_interval = SIM_SLOW_MAX_INTERVAL;
+        p_params->slave_latency = 0;
+        p_params->conn_sup_timeout = SIM_SLOW_SUP_TIMEOUT;
+        evts[evt_cnt++] = p_evt;
+        air_us += pdu_air_us(12, m_conn.ll_data);
+    }
+
+    if (m_conn.hvx_pending && m_conn.event_cnt >= m_conn.hvx_event) {
+        m_conn.hvx_pending = false;
+        const uint16_t len = 1 + SIM_SALT_LEN;
+        ble_evt_t * p_evt = evt_alloc(BLE_GATTC_EVT_HVX, len);
+        p_evt->evt.gattc_evt.conn_handle = SIM_CONN_HANDLE;
+        p_evt->evt.gattc_evt.params.hvx.handle = PEER_HANDLE_NOTIFY;
+        p_evt->evt.gattc_evt.params.hvx.type = BLE_GATT_HVX_NOTIFICATION;
+        p_evt->evt.gattc_evt.params.hvx.len = len;
+        p_evt->evt.gattc_evt.params.hvx.data[0] = 0;
+        memcpy(&p_evt->evt.gattc_evt.params.hvx.data[1], p_peer->salt, SIM_SALT_LEN);
+        evts[evt_cnt++] = p_evt;
+        air_us += pdu_air_us(3 + len, m_conn.ll_data);
+    }
+
+    // Write commands as long as the connection event lasts
+    const uint64_t budget_us = (m_conn.interval_us > SIM_CONN_EVT_MARGIN) ? m_conn.interval_us - SIM_CONN_EVT_MARGIN : 0;
+    uint8_t sent = 0;
+    while (sent < m_conn.txq_len) {
+        sim_write_cmd_t const * p_cmd = &m_conn.txq[sent];
+        const uint64_t cmd_us = pdu_air_us(3 + p_cmd->len, m_conn.ll_data);
+        if (0 < sent && air_us + cmd_us > budget_us) {
+            break;
+        }
+        air_us += cmd_us;
+        peer_write(p_peer, p_cmd->handle, p_cmd->data, p_cmd->len);
+        ++sent;
+    }
+    if (0 < sent) {
+        m_conn.txq_len -= sent;
+        memmove(&m_conn.txq[0], &m_conn.txq[sent], m_conn.txq_len * sizeof(sim_write_cmd_t));
+        ble_evt_t * p_evt = evt_alloc(BLE_GATTC_EVT_WRITE_CMD_TX_COMPLETE, 0);
+        p_evt->evt.gattc_evt.conn_handle = SIM_CONN_HANDLE;
+        p_evt->evt.gattc_evt.params.write_cmd_tx_complete.count = sent;
+        evts[evt_cnt++] = p_evt;
+    }
+
+    g_sim_radio.conn_us += air_us;
+    for (uint8_t index = 0; evt_cnt > index; ++index) {
+        evt_post(evts[index], now + air_us);
+    }
+    if (discovered) {
+        sim_post(now + air_us, SIM_WAKE_RADIO, discovery_done, NULL, m_conn.generation);
+    }
+    sim_post(now + m_conn.interval_us, SIM_WAKE_RADIO, conn_event, &m_conn, m_conn.generation);
+    return false;
+}
+
+/**@brief Function for checking a connection handle.
+ *
+ * @returns True if the handle is the one of the existing link.
+ */
+static bool conn_valid(uint16_t conn_handle) {
+    return m_conn.active && SIM_CONN_HANDLE == conn_handle;
+}
+
+void sim_sd_world_init(uint8_t const * p_app_key) {
+    memcpy(m_app_key, p_app_key, sizeof(m_app_key));
+    m_peer_cnt = g_sim_config.bleams;
+    m_peers = calloc(MAX(1, m_peer_cnt), sizeof(sim_peer_t));
+    for (uint32_t index = 0; m_peer_cnt > index; ++index) {
+        sim_peer_t * p_peer = &m_peers[index];
+        p_peer->addr.addr_type = BLE_GAP_ADDR_TYPE_RANDOM_STATIC;
+        for (uint8_t byte = 0; BLE_GAP_ADDR_LEN > byte; ++byte) {
+            p_peer->addr.addr[byte] = (uint8_t)sim_rand();
+        }
+        p_peer->addr.addr[5] |= 0xC0;
+
+        // Base of the BLEAM service UUID with a device specific part
+        p_peer->uuid128[0] = p_peer->uuid128[1] = 0xFF;
+        for (uint8_t byte = 2; 12 > byte; ++byte) {
+            p_peer->uuid128[byte] = (uint8_t)sim_rand();
+        }
+        p_peer->uuid128[12] = (uint8_t)(SIM_BLEAM_UUID & 0xFF);
+        p_peer->uuid128[13] = (uint8_t)(SIM_BLEAM_UUID >> 8);
+
+        const uint8_t adv_head[] = {0x02, BLE_GAP_AD_TYPE_FLAGS, BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE,
+                                    1 + sizeof(p_peer->uuid128), BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_COMPLETE};
+        memcpy(p_peer->adv_data, adv_head, sizeof(adv_head));
+        memcpy(p_peer->adv_data + sizeof(adv_head), p_peer->uuid128, sizeof(p_peer->uuid128));
+        p_peer->adv_len = sizeof(adv_head) + sizeof(p_peer->uuid128);
+
+        p_peer->rssi_mean = -55.0 - sim_rand() % 35;
+        const uint32_t day_ms = SIM_US_PER_DAY / SIM_US_PER_MS;
+        if (g_sim_config.present_from_ms == g_sim_config.present_to_ms) {
+            p_peer->present_from_ms = p_peer->present_to_ms = 0;
+        } else {
+            p_peer->present_from_ms = (g_sim_config.present_from_ms + day_ms + sim_rand() % (2 * SIM_PRESENCE_JITTER) - SIM_PRESENCE_JITTER) % day_ms;
+            p_peer->present_to_ms = (g_sim_config.present_to_ms + day_ms + sim_rand() % (2 * SIM_PRESENCE_JITTER) - SIM_PRESENCE_JITTER) % day_ms;
+        }
+        p_peer->slow = (g_sim_config.slow_peers > index);
+    }
+}
+
+void sim_sd_accounting_close(void) {
+    if (m_scanner.scanning) {
+        scan_account(sim_now_us(), &g_sim_radio.scan_us);
+    }
+    if (m_scanner.initiating) {
+        scan_account(sim_now_us(), &g_sim_radio.initiate_us);
+    }
+    if (m_adv.active) {
+        adv_account();
+    }
+}
+
+void sim_sd_peers_print(void) {
+    for (uint32_t index = 0; m_peer_cnt > index; ++index) {
+        sim_peer_t const * p_peer = &m_peers[index];
+        printf("  BLEAM %u  %02X:%02X:%02X:%02X:%02X:%02X  RSSI %4.0f  present %02u:%02u-%02u:%02u%s  "
+               "reports %6u  deliveries %5u  bad signatures %u\n",
+               index, p_peer->addr.addr[5], p_peer->addr.addr[4], p_peer->addr.addr[3],
+               p_peer->addr.addr[2], p_peer->addr.addr[1], p_peer->addr.addr[0], p_peer->rssi_mean,
+               p_peer->present_from_ms / 3600000, p_peer->present_from_ms / 60000 % 60,
+               p_peer->present_to_ms / 3600000, p_peer->present_to_ms / 60000 % 60,
+               p_peer->slow ? "  slow" : "", p_peer->reports, p_peer->sessions, p_peer->sig_bad);
+    }
+}
+
+uint32_t sim_sd_discover(uint16_t conn_handle, ble_uuid_t const * p_uuid, sim_sd_discovery_cb_t callback) {
+    if (!conn_valid(conn_handle)) {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (REQ_NONE != m_conn.req) {
+        return NRF_ERROR_BUSY;
+    }
+    ++g_sim_radio.discoveries;
+    m_conn.req = REQ_DISCOVERY;
+    m_conn.req_sent = false;
+    m_conn.req_len = 4 + 16;
+    m_conn.disc_uuid = *p_uuid;
+    m_conn.disc_cb = callback;
+    m_conn.disc_step = 0;
+    m_conn.disc_chars = 0;
+    return NRF_SUCCESS;
+}
+
+/* SoftDevice handler */
+
+ret_code_t nrf_sdh_enable_request(void) {
+    if (m_sdh_enabled) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    m_sdh_enabled = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_sdh_disable_request(void) {
+    m_sdh_enabled = false;
+    m_ble_enabled = false;
+    return NRF_SUCCESS;
+}
+
+bool nrf_sdh_is_enabled(void) {
+    return m_sdh_enabled;
+}
+
+ret_code_t nrf_sdh_ble_default_cfg_set(uint8_t conn_cfg_tag, uint32_t * p_ram_start) {
+    UNUSED_PARAMETER(conn_cfg_tag);
+    if (!m_sdh_enabled) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    *p_ram_start = SIM_APP_RAM_START;
+    m_vs_limit = MIN(NRF_SDH_BLE_VS_UUID_COUNT, SIM_VS_UUID_MAX);
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_sdh_ble_enable(uint32_t * p_app_ram_start) {
+    if (!m_sdh_enabled || m_ble_enabled) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    *p_app_ram_start = SIM_APP_RAM_START;
+    m_ble_enabled = true;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_softdevice_disable(void) {
+    return nrf_sdh_disable_request();
+}
+
+/* BLE common */
+
+uint32_t sd_ble_cfg_set(uint32_t cfg_id, ble_cfg_t const * p_cfg, uint32_t app_ram_base) {
+    UNUSED_PARAMETER(app_ram_base);
+    if (m_ble_enabled) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (BLE_CONN_CFG_GATTC == cfg_id) {
+        const uint8_t size = p_cfg->conn_cfg.params.gattc_conn_cfg.write_cmd_tx_queue_size;
+        if (SIM_TX_QUEUE_MAX < size) {
+            return NRF_ERROR_NO_MEM;
+        }
+        m_tx_queue_size = MAX(1, size);
+    }
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_uuid_vs_add(ble_uuid128_t const * p_vs_uuid, uint8_t * p_uuid_type) {
+    if (NULL == p_vs_uuid || NULL == p_uuid_type) {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    // Octets 12 and 13 are the 16-bit UUID, the rest is the base
+    for (uint8_t index = 0; m_vs_cnt > index; ++index) {
+        if (0 == memcmp(m_vs[index].uuid128, p_vs_uuid->uuid128, 12) &&
+            0 == memcmp(m_vs[index].uuid128 + 14, p_vs_uuid->uuid128 + 14, 2)) {
+            *p_uuid_type = BLE_UUID_TYPE_VENDOR_BEGIN + index;
+            return NRF_SUCCESS;
+        }
+    }
+    if (m_vs_limit <= m_vs_cnt) {
+        return NRF_ERROR_NO_MEM;
+    }
+    m_vs[m_vs_cnt] = *p_vs_uuid;
+    *p_uuid_type = BLE_UUID_TYPE_VENDOR_BEGIN + m_vs_cnt++;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_uuid_vs_remove(uint8_t * p_uuid_type) {
+    if (0 == m_vs_cnt) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    // Only the latest base can go, NULL or unknown type means the latest one
+    if (NULL != p_uuid_type && BLE_UUID_TYPE_UNKNOWN != *p_uuid_type &&
+        BLE_UUID_TYPE_VENDOR_BEGIN + m_vs_cnt - 1 != *p_uuid_type) {
+        return NRF_ERROR_FORBIDDEN;
+    }
+    --m_vs_cnt;
+    return NRF_SUCCESS;
+}
+
+/* GAP */
+
+uint32_t sd_ble_gap_device_name_set(ble_gap_conn_sec_mode_t const * p_write_perm, uint8_t const * p_dev_name, uint16_t len) {
+    UNUSED_PARAMETER(p_write_perm);
+    UNUSED_PARAMETER(p_dev_name);
+    return (BLE_GAP_ADV_SET_DATA_SIZE_MAX < len) ? NRF_ERROR_DATA_SIZE : NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_ppcp_set(ble_gap_conn_params_t const * p_conn_params) {
+    UNUSED_PARAMETER(p_conn_params);
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_adv_set_configure(uint8_t * p_adv_handle, ble_gap_adv_data_t const * p_adv_data,
+                                      ble_gap_adv_params_t const * p_adv_params) {
+    UNUSED_PARAMETER(p_adv_data);
+    if (m_adv.active) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (NULL != p_adv_params) {
+        if (0x20 > p_adv_params->interval) {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+        m_adv.interval = p_adv_params->interval;
+    }
+    m_adv.configured = true;
+    *p_adv_handle = 0;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_adv_start(uint8_t adv_handle, uint8_t conn_cfg_tag) {
+    UNUSED_PARAMETER(conn_cfg_tag);
+    if (0 != adv_handle || !m_adv.configured) {
+        return BLE_ERROR_INVALID_ADV_HANDLE;
+    }
+    if (m_adv.active || m_conn.active) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    m_adv.active = true;
+    m_adv.start_us = sim_now_us();
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_adv_stop(uint8_t adv_handle) {
+    if (0 != adv_handle) {
+        return BLE_ERROR_INVALID_ADV_HANDLE;
+    }
+    if (!m_adv.active) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    adv_account();
+    m_adv.active = false;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_scan_start(ble_gap_scan_params_t const * p_scan_params, ble_data_t const * p_adv_report_buffer) {
+    if (NULL == p_adv_report_buffer || NULL == p_adv_report_buffer->p_data ||
+        BLE_GAP_SCAN_BUFFER_MIN > p_adv_report_buffer->len) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    // Without parameters a paused scanner resumes with a new buffer
+    if (NULL == p_scan_params) {
+        if (!m_scanner.paused) {
+            return NRF_ERROR_INVALID_STATE;
+        }
+        m_scanner.paused = false;
+        m_scanner.buffer = *p_adv_report_buffer;
+        return NRF_SUCCESS;
+    }
+    if (m_scanner.scanning || m_scanner.initiating) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (p_scan_params->window > p_scan_params->interval || 0x0004 > p_scan_params->window) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    m_scanner.params = *p_scan_params;
+    m_scanner.buffer = *p_adv_report_buffer;
+    m_scanner.start_us = sim_now_us();
+    m_scanner.scanning = true;
+    m_scanner.paused = false;
+    world_wake();
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_scan_stop(void) {
+    if (!m_scanner.scanning) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    scan_account(sim_now_us(), &g_sim_radio.scan_us);
+    m_scanner.scanning = false;
+    m_scanner.paused = false;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_connect(ble_gap_addr_t const * p_peer_addr, ble_gap_scan_params_t const * p_scan_params,
+                            ble_gap_conn_params_t const * p_conn_params, uint8_t conn_cfg_tag) {
+    UNUSED_PARAMETER(conn_cfg_tag);
+    if (NULL == p_peer_addr || NULL == p_scan_params || NULL == p_conn_params) {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_NON_RESOLVABLE < p_peer_addr->addr_type) {
+        return BLE_ERROR_GAP_INVALID_BLE_ADDR;
+    }
+    if (p_scan_params->window > p_scan_params->interval || 0 == p_scan_params->timeout ||
+        p_conn_params->min_conn_interval > p_conn_params->max_conn_interval) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (m_conn.active) {
+        return NRF_ERROR_CONN_COUNT;
+    }
+    if (m_scanner.scanning || m_scanner.initiating || m_adv.active) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    ++g_sim_radio.connect_attempts;
+    m_scanner.params = *p_scan_params;
+    m_scanner.target = *p_peer_addr;
+    m_scanner.conn_params = *p_conn_params;
+    m_scanner.start_us = sim_now_us();
+    m_scanner.initiating = true;
+    ++m_scanner.generation;
+    sim_post(sim_now_us() + p_scan_params->timeout * 10000ULL, SIM_WAKE_RADIO, initiator_timeout, NULL, m_scanner.generation);
+    world_wake();
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_connect_cancel(void) {
+    if (!m_scanner.initiating) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    scan_account(sim_now_us(), &g_sim_radio.initiate_us);
+    m_scanner.initiating = false;
+    ++m_scanner.generation;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_disconnect(uint16_t conn_handle, uint8_t hci_status_code) {
+    if (BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION != hci_status_code &&
+        BLE_HCI_CONN_INTERVAL_UNACCEPTABLE != hci_status_code) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (!conn_valid(conn_handle)) {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (m_conn.terminating) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    m_conn.terminating = true;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_conn_param_update(uint16_t conn_handle, ble_gap_conn_params_t const * p_conn_params) {
+    if (!conn_valid(conn_handle)) {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (NULL == p_conn_params || p_conn_params->min_conn_interval > p_conn_params->max_conn_interval) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (m_conn.update_pending) {
+        return NRF_ERROR_BUSY;
+    }
+    m_conn.update_pending = true;
+    m_conn.update_event = m_conn.event_cnt + SIM_UPDATE_INSTANT;
+    m_conn.update_params = *p_conn_params;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_phy_update(uint16_t conn_handle, ble_gap_phys_t const * p_gap_phys) {
+    UNUSED_PARAMETER(p_gap_phys);
+    return conn_valid(conn_handle) ? NRF_SUCCESS : BLE_ERROR_INVALID_CONN_HANDLE;
+}
+
+uint32_t sd_ble_gap_data_length_update(uint16_t conn_handle, ble_gap_data_length_params_t const * p_dl_params,
+                                       ble_gap_data_length_limitation_t * p_dl_limitation) {
+    UNUSED_PARAMETER(p_dl_limitation);
+    if (!conn_valid(conn_handle)) {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (m_conn.dl_pending) {
+        return NRF_ERROR_BUSY;
+    }
+    m_conn.dl_pending = true;
+    m_conn.dl_event = m_conn.event_cnt + 2;
+    m_conn.dl_octets = (NULL == p_dl_params || 0 == p_dl_params->max_tx_octets) ? SIM_LL_DATA_MAX : p_dl_params->max_tx_octets;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_sec_params_reply(uint16_t conn_handle, uint8_t sec_status, void const * p_sec_params,
+                                     void const * p_sec_keyset) {
+    UNUSED_PARAMETER(sec_status);
+    UNUSED_PARAMETER(p_sec_params);
+    UNUSED_PARAMETER(p_sec_keyset);
+    return conn_valid(conn_handle) ? NRF_SUCCESS : BLE_ERROR_INVALID_CONN_HANDLE;
+}
+
+/* GATT client */
+
+uint32_t sd_ble_gattc_primary_services_discover(uint16_t conn_handle, uint16_t start_handle, ble_uuid_t const * p_srvc_uuid) {
+    UNUSED_PARAMETER(start_handle);
+    UNUSED_PARAMETER(p_srvc_uuid);
+    // Only the iOS discovery path enumerates services, iOS devices are not simulated
+    return conn_valid(conn_handle) ? NRF_ERROR_NOT_SUPPORTED : BLE_ERROR_INVALID_CONN_HANDLE;
+}
+
+uint32_t sd_ble_gattc_read_multiple(uint16_t conn_handle, uint16_t const * p_handles, uint16_t handle_count) {
+    UNUSED_PARAMETER(p_handles);
+    UNUSED_PARAMETER(handle_count);
+    return conn_valid(conn_handle) ? NRF_ERROR_NOT_SUPPORTED : BLE_ERROR_INVALID_CONN_HANDLE;
+}
+
+uint32_t sd_ble_gattc_read(uint16_t conn_handle, uint16_t handle, uint16_t offset) {
+    if (!conn_valid(conn_handle)) {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (BLE_GATT_HANDLE_INVALID == handle || 0 != offset) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (REQ_NONE != m_conn.req) {
+        return NRF_ERROR_BUSY;
+    }
+    m_conn.req = REQ_READ;
+    m_conn.req_sent = false;
+    m_conn.req_handle = handle;
+    m_conn.req_len = 0;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_exchange_mtu_request(uint16_t conn_handle, uint16_t client_rx_mtu) {
+    if (!conn_valid(conn_handle)) {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (BLE_GATT_ATT_MTU_DEFAULT > client_rx_mtu || NRF_SDH_BLE_GATT_MAX_MTU_SIZE < client_rx_mtu) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (m_conn.mtu_pending || BLE_GATT_ATT_MTU_DEFAULT != m_conn.mtu) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    m_conn.mtu_pending = true;
+    m_conn.mtu_sent = false;
+    m_conn.mtu_client = client_rx_mtu;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_write(uint16_t conn_handle, ble_gattc_write_params_t const * p_write_params) {
+    if (!conn_valid(conn_handle)) {
+        return BLE_ERROR_INVALID_CONN_HANDLE;
+    }
+    if (NULL == p_write_params || (0 < p_write_params->len && NULL == p_write_params->p_value)) {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (m_conn.mtu - 3 < p_write_params->len) {
+        return NRF_ERROR_DATA_SIZE;
+    }
+    switch (p_write_params->write_op) {
+    case BLE_GATT_OP_WRITE_REQ:
+        if (REQ_NONE != m_conn.req) {
+            return NRF_ERROR_BUSY;
+        }
+        m_conn.req = REQ_WRITE;
+        m_conn.req_sent = false;
+        m_conn.req_handle = p_write_params->handle;
+        m_conn.req_len = p_write_params->len;
+        memcpy(m_conn.req_data, p_write_params->p_value, p_write_params->len);
+        return NRF_SUCCESS;
+
+    case BLE_GATT_OP_WRITE_CMD: {
+        if (m_tx_queue_size <= m_conn.txq_len) {
+            return NRF_ERROR_RESOURCES;
+        }
+        sim_write_cmd_t * p_cmd = &m_conn.txq[m_conn.txq_len++];
+        p_cmd->handle = p_write_params->handle;
+        p_cmd->len = p_write_params->len;
+        memcpy(p_cmd->data, p_write_params->p_value, p_write_params->len);
+        return NRF_SUCCESS;
+    }
+
+    default:
+        return NRF_ERROR_INVALID_PARAM;
+    }
+}
+
+/* GATT server, used in configuration mode only */
+
+uint32_t sd_ble_gatts_service_add(uint8_t type, ble_uuid_t const * p_uuid, uint16_t * p_handle) {
+    if (NULL == p_uuid || NULL == p_handle) {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    if (BLE_GATTS_SRVC_TYPE_PRIMARY != type && BLE_GATTS_SRVC_TYPE_SECONDARY != type) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (BLE_UUID_TYPE_VENDOR_BEGIN <= p_uuid->type && BLE_UUID_TYPE_VENDOR_BEGIN + m_vs_cnt <= p_uuid->type) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    *p_handle = m_gatts_handle++;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_characteristic_add(uint16_t service_handle, ble_gatts_char_md_t const * p_char_md,
+                                         ble_gatts_attr_t const * p_attr_char_value,
+                                         ble_gatts_char_handles_t * p_handles) {
+    UNUSED_PARAMETER(service_handle);
+    if (NULL == p_char_md || NULL == p_attr_char_value || NULL == p_handles) {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    memset(p_handles, 0, sizeof(ble_gatts_char_handles_t));
+    ++m_gatts_handle; // declaration
+    p_handles->value_handle = m_gatts_handle++;
+    if (p_char_md->char_props.notify || p_char_md->char_props.indicate) {
+        p_handles->cccd_handle = m_gatts_handle++;
+    }
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_value_set(uint16_t conn_handle, uint16_t handle, ble_gatts_value_t * p_value) {
+    UNUSED_PARAMETER(conn_handle);
+    if (NULL == p_value) {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    return (BLE_GATT_HANDLE_INVALID == handle || m_gatts_handle <= handle) ? BLE_ERROR_INVALID_ATTR_HANDLE : NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gatts_hvx(uint16_t conn_handle, ble_gatts_hvx_params_t const * p_hvx_params) {
+    UNUSED_PARAMETER(p_hvx_params);
+    // Configuration clients are not simulated, nobody connects to the node
+    return conn_valid(conn_handle) ? BLE_ERROR_GATTS_SYS_ATTR_MISSING : BLE_ERROR_INVALID_CONN_HANDLE;
+}
+
+uint32_t sd_ble_gatts_sys_attr_set(uint16_t conn_handle, uint8_t const * p_sys_attr_data, uint16_t len, uint32_t flags) {
+    UNUSED_PARAMETER(p_sys_attr_data);
+    UNUSED_PARAMETER(len);
+    UNUSED_PARAMETER(flags);
+    return conn_valid(conn_handle) ? NRF_SUCCESS : BLE_ERROR_INVALID_CONN_HANDLE;
+}
+
+/* SoC */
+
+uint32_t sd_power_gpregret_get(uint32_t gpregret_id, uint32_t * p_gpregret) {
+    if (0 != gpregret_id) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    *p_gpregret = m_gpregret;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_power_gpregret_set(uint32_t gpregret_id, uint32_t gpregret_msk) {
+    if (0 != gpregret_id) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    m_gpregret |= gpregret_msk & 0xFF;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_power_gpregret_clr(uint32_t gpregret_id, uint32_t gpregret_msk) {
+    if (0 != gpregret_id) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    m_gpregret &= ~gpregret_msk;
+    return NRF_SUCCESS;
+}
+
+/**@brief Function for refilling the SoftDevice random pool with time.
+ *
+ * @returns Random bytes available.
+ */
+static uint8_t rand_pool_level(void) {
+    // RNG peripheral with bias correction makes a byte in about 120 us, pool holds 64
+    const uint64_t made = (sim_now_us() - m_rand_us) / 120;
+    return (uint8_t)MIN(64, m_rand_left + made);
+}
+
+uint32_t sd_rand_application_bytes_available_get(uint8_t * p_bytes_available) {
+    *p_bytes_available = rand_pool_level();
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_rand_application_vector_get(uint8_t * p_buff, uint8_t length) {
+    const uint8_t available = rand_pool_level();
+    if (available < length) {
+        return NRF_ERROR_SOC_RAND_NOT_ENOUGH_VALUES;
+    }
+    for (uint8_t index = 0; length > index; ++index) {
+        p_buff[index] = (uint8_t)sim_rand();
+    }
+    m_rand_left = available - length;
+    m_rand_us = sim_now_us();
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_flash_page_erase(uint32_t page_number) {
+    UNUSED_PARAMETER(page_number);
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_nvic_SystemReset(void) {
+    NVIC_SystemReset();
+    return NRF_SUCCESS;
+}
@@ -84,8 +84,9 @@
   #define NRF_SDH_SOC_ENABLED 1
   #define NRF_BLE_CONN_PARAMS_ENABLED 1
 #endif
-#define NRF_SDH_BLE_GATT_MAX_MTU_SIZE 23
-#define NRF_SDH_BLE_GAP_DATA_LENGTH 27
+#define NRF_SDH_BLE_GATT_MAX_MTU_SIZE 247
+#define NRF_SDH_BLE_GAP_DATA_LENGTH 251
+#define NRF_SDH_BLE_GAP_EVENT_LENGTH 24
 #define NRF_SDH_BLE_PERIPHERAL_LINK_COUNT 1
 #define NRF_SDH_BLE_SERVICE_CHANGED 1
 #define NRF_QUEUE_ENABLED 1
@@ -110,6 +111,9 @@
 #endif
 #define APP_TIMER_CONFIG_RTC_FREQUENCY 0
 
+// Sleeping node only wakes up at scan period starts, longest period is 120 s
+#define WDT_CONFIG_RELOAD_VALUE 240000
+
 
 /** @} end of APP_SDK_CONFIG */
 
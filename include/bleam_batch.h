@@ -0,0 +1,139 @@
+/**
+ * @addtogroup bleam_batch
+ * @{
+ */
+
+#ifndef BLEAM_BATCH_H__
+#define BLEAM_BATCH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BLEAM_BATCH_VERSION        3                           /**< Batch frame format version, 2 added RSSI sample age, 3 added session duration */
+#define BLEAM_BATCH_TAG            0xB0                        /**< Batch frame tag in the high nibble of the first byte */
+#define BLEAM_BATCH_FRAME_TAG      (BLEAM_BATCH_TAG | BLEAM_BATCH_VERSION) /**< First byte of a batch frame, tag and version */
+#define BLEAM_BATCH_FILE_NAME_SIZE 13                          /**< Maximum length of file name in error info record */
+#define BLEAM_BATCH_RSSI_RUN_MAX   UINT8_MAX                   /**< Maximum number of samples in one RSSI record */
+
+/**@brief Batch frame record types. */
+typedef enum {
+    BLEAM_BATCH_REC_RSSI = 1, /**< Run of RSSI samples */
+    BLEAM_BATCH_REC_SUMMARY,  /**< RSSI summary */
+    BLEAM_BATCH_REC_HEALTH,   /**< General health status */
+    BLEAM_BATCH_REC_ERROR,    /**< Detailed error info */
+    BLEAM_BATCH_REC_ENERGY,   /**< Energy accounting */
+} bleam_batch_rec_type_t;
+
+/**@brief Batch frame header. */
+typedef struct {
+    uint16_t node_id;   /**< ID of the BLEAM Scanner node that sent the frame */
+    uint16_t seq;       /**< Frame sequence number */
+    uint32_t base_time; /**< System time of the frame in seconds passed since midnight */
+} bleam_batch_header_t;
+
+/**@brief Decoded batch frame record. */
+typedef struct {
+    bleam_batch_rec_type_t type; /**< Record type */
+    union {
+        struct {
+            int8_t   rssi;      /**< Received Signal Strength of BLEAM */
+            uint8_t  aoa;       /**< Angle of arrival of BLEAM signal */
+            uint32_t age_ms;    /**< Time between receiving RSSI and frame base time, ms. 0 in version 1 frames */
+        } rssi;                 /**< @ref BLEAM_BATCH_REC_RSSI, one record per sample */
+        struct {
+            uint16_t count;     /**< Number of summarised RSSI samples */
+            int8_t   min;       /**< Minimum RSSI */
+            int8_t   max;       /**< Maximum RSSI */
+            int8_t   mean;      /**< Mean RSSI */
+            int8_t   median;    /**< Estimated median RSSI */
+            uint16_t variance;  /**< RSSI variance, in 0.1 dB^2 */
+            uint8_t  aoa;       /**< Angle of arrival of BLEAM signal */
+        } summary;              /**< @ref BLEAM_BATCH_REC_SUMMARY */
+        struct {
+            uint8_t  battery_lvl; /**< Battery level in centivolts */
+            uint16_t fw_id;       /**< BLEAM Scanner firmware version number */
+            uint32_t uptime;      /**< Node uptime in minutes */
+            uint32_t system_time; /**< System time in seconds passed since midnight */
+            uint16_t err_id;      /**< Latest error ID */
+            uint8_t  err_type;    /**< Latest error type */
+        } health;                 /**< @ref BLEAM_BATCH_REC_HEALTH */
+        struct {
+            uint32_t err_code;                              /**< Error code */
+            uint16_t line_num;                              /**< Line number where the error occurred */
+            uint8_t  file_name[BLEAM_BATCH_FILE_NAME_SIZE]; /**< File in which the error occurred */
+        } error;                                            /**< @ref BLEAM_BATCH_REC_ERROR */
+        struct {
+            uint32_t scan_secs;  /**< Time spent scanning since boot, seconds */
+            uint32_t conn_secs;  /**< Time spent in connections since boot, seconds */
+            uint32_t sleep_secs; /**< Time CPU spent sleeping since boot, seconds */
+            uint32_t charge_uah; /**< Estimated charge drawn since boot, microampere-hours */
+            uint16_t conn_cnt;   /**< Number of connections since boot */
+            uint32_t session_ms; /**< Duration of the latest finished connection, ms. 0 in version 1 and 2 frames */
+        } energy;                /**< @ref BLEAM_BATCH_REC_ENERGY */
+    } data;                      /**< Record data depending on type */
+} bleam_batch_record_t;
+
+/**@brief Batch frame encoder state. */
+typedef struct {
+    uint8_t *p_buf;     /**< Frame buffer */
+    uint16_t max_len;   /**< Frame buffer size */
+    uint16_t len;       /**< Length of encoded frame */
+    uint16_t run_pos;   /**< Index of open RSSI run sample counter, 0 if none */
+    int8_t   run_rssi;  /**< Latest RSSI in the open RSSI run */
+    uint32_t run_age;   /**< Latest RSSI age in the open RSSI run, ms */
+    uint32_t base_time; /**< Frame base time, seconds */
+} bleam_batch_encoder_t;
+
+/**@brief Batch frame record handler type for @ref bleam_batch_decode().
+ *
+ * @param[in] p_header    Pointer to decoded frame header.
+ * @param[in] p_record    Pointer to decoded record.
+ * @param[in] p_context   Context passed to @ref bleam_batch_decode().
+ */
+typedef void (*bleam_batch_record_handler_t)(bleam_batch_header_t const * p_header,
+                                             bleam_batch_record_t const * p_record,
+                                             void * p_context);
+
+/**@brief Function for starting a new batch frame.
+ *
+ * @param[out] p_enc      Pointer to encoder state.
+ * @param[in]  p_buf      Frame buffer.
+ * @param[in]  max_len    Frame buffer size, maximum length of the frame.
+ * @param[in]  p_header   Pointer to frame header.
+ *
+ * @returns True if the header fits into the buffer, false otherwise.
+ */
+bool bleam_batch_begin(bleam_batch_encoder_t * p_enc, uint8_t * p_buf, uint16_t max_len, bleam_batch_header_t const * p_header);
+
+/**@brief Function for adding a record to a batch frame.
+ *
+ * @details RSSI samples added one after another share a single record.
+ *          If the record does not fit, the frame is left unchanged.
+ *
+ * @param[in,out] p_enc      Pointer to encoder state.
+ * @param[in]     p_record   Pointer to record to add.
+ *
+ * @returns True if the record was added, false otherwise.
+ */
+bool bleam_batch_add(bleam_batch_encoder_t * p_enc, bleam_batch_record_t const * p_record);
+
+/**@brief Function for decoding a batch frame.
+ *
+ * @details Does not depend on the SDK, so that gateway and test tools can use it as is.
+ *          RSSI runs are reported as one record per sample.
+ *          Frames of all versions up to @ref BLEAM_BATCH_VERSION are accepted.
+ *
+ * @param[in]  p_frame     Frame to decode.
+ * @param[in]  len         Frame length.
+ * @param[out] p_header    Pointer to decoded header.
+ * @param[in]  handler     Handler to call for every record, may be NULL.
+ * @param[in]  p_context   Context to pass to the handler.
+ *
+ * @returns True if the whole frame was decoded, false if it is malformed.
+ */
+bool bleam_batch_decode(uint8_t const * p_frame, uint16_t len, bleam_batch_header_t * p_header,
+                        bleam_batch_record_handler_t handler, void * p_context);
+
+#endif // BLEAM_BATCH_H__
+
+/** @}*/
@@ -7,6 +7,8 @@
 #define BLEAM_SEND_HELPER_H__
 
 #include "bleam_service.h"
+#include "bleam_batch.h"
+#include "blesc_energy.h"
 
 #define BLEAM_QUEUE_SIZE 20 /**< Size of the queue array */
 
@@ -17,6 +19,19 @@ typedef struct {
     uint8_t  aoa;                                         /**< Angle of arrival of BLEAM signal */
 } bleam_service_rssi_data_t;
 
+/**@brief BLEAM RSSI summary data structure. */
+typedef struct __attribute((packed)) {
+    uint8_t  msg_type;                                    /**< Flag that signifies this is an RSSI summary. Always should be 0x01 */
+    uint16_t sender_id;                                   /**< ID of the RSSI summary's original sender node */
+    uint16_t count;                                       /**< Number of summarised RSSI samples */
+    int8_t   min;                                         /**< Minimum RSSI */
+    int8_t   max;                                         /**< Maximum RSSI */
+    int8_t   mean;                                        /**< Mean RSSI */
+    int8_t   median;                                      /**< Estimated median RSSI */
+    uint16_t variance;                                    /**< RSSI variance, in 0.1 dB^2 */
+    uint8_t  aoa;                                         /**< Angle of arrival of BLEAM signal */
+} bleam_service_rssi_summary_t;
+
 /** @brief Health general data struct
  */
 typedef struct __attribute((packed)) {
@@ -38,7 +53,19 @@ typedef struct __attribute((packed)) {
     uint8_t  file_name[BLESC_ERR_FILE_NAME_SIZE]; /**< The file in which the error occurred (first 13 symbols) */
 } bleam_service_health_error_info_t;
 
-#define BLEAM_MAX_RSSI_PER_MSG   (BLEAM_MAX_DATA_LEN / sizeof(bleam_service_rssi_data_t))   /**< Maximum amount of RSSI entries in a single message to BLEAM */
+/** @brief Health energy data struct
+ */
+typedef struct __attribute((packed)) {
+    uint8_t  msg_type;   /**< Flag that signifies this is an energy accounting message. Always should be 0x03 */
+    uint32_t scan_secs;  /**< Time spent scanning since boot, seconds */
+    uint32_t conn_secs;  /**< Time spent in connections since boot, seconds */
+    uint32_t sleep_secs; /**< Time CPU spent sleeping since boot, seconds */
+    uint32_t charge_uah; /**< Estimated charge drawn since boot, microampere-hours */
+    uint16_t conn_cnt;   /**< Number of connections since boot */
+    uint8_t  session_ds; /**< Duration of the latest finished connection, 0.1 s, saturates at UINT8_MAX to fit default ATT MTU */
+} bleam_service_health_energy_data_t;
+
+#define BLEAM_MAX_RSSI_PER_MSG   (BLEAM_MAX_DATA_LEN / sizeof(bleam_service_rssi_data_t))   /**< Maximum amount of RSSI entries in a single message to BLEAM with the largest supported ATT MTU */
 
 /**@brief Function for initialising parameters for and starting sending signature to BLEAM.
  *
@@ -64,22 +91,50 @@ void bleam_send_salt(bleam_service_client_t *p_bleam_service_client, uint8_t *p_
  */
 void bleam_send_uninit(void);
 
+/**@brief Function for setting batch frame header fields for data sent in this connection.
+ *
+ * @details Only used with @ref APP_CONFIG_BATCH_FRAME_ENABLED.
+ *
+ * @param[in] node_id       Node ID of this BLEAM Scanner.
+ * @param[in] base_time     BLEAM Scanner system time.
+ *
+ * @returns Nothing.
+ */
+void bleam_send_batch_header_set(uint16_t node_id, uint32_t base_time);
+
+/**@brief Function for getting the characteristic data is being sent to.
+ *
+ * @returns BLEAM service characteristic @ref bleam_service_char_t, 0 if nothing is being sent.
+ */
+uint16_t bleam_send_char_get(void);
+
 /**@brief Function for continuing with assembling and sending data
- * after previous send is confirmed to be over.
+ * after previous sends are confirmed to be over.
+ *
+ * @param[in] tx_count     Number of writes transmitted, from @ref BLE_GATTC_EVT_WRITE_CMD_TX_COMPLETE.
  *
  * @returns Nothing.
  */
-void bleam_send_continue(void);
+void bleam_send_continue(uint8_t tx_count);
 
 /**@brief Function for initialising parameters for and sending salt to BLEAM.
  *
  * @param[in] sender_id     Node ID of this BLEAM Scanner.
  * @param[in] rssi          Received Signal Strength of BLEAM.
  * @param[in] aoa           Angle of arrival of BLEAM signal.
+ * @param[in] age_ms        Time since RSSI was received, ms. Only sent in @ref bleam_batch frames.
  *
  * @returns Nothing.
  */
-void bleam_rssi_queue_add(uint16_t sender_id, int8_t rssi, uint8_t aoa);
+void bleam_rssi_queue_add(uint16_t sender_id, int8_t rssi, uint8_t aoa, uint32_t age_ms);
+
+/**@brief Function for sending an RSSI summary to BLEAM instead of raw RSSI data.
+ *
+ * @param[in] p_summary     Pointer to RSSI summary record.
+ *
+ * @returns Nothing.
+ */
+void bleam_rssi_summary_add(bleam_service_rssi_summary_t const * p_summary);
 
 /**@brief Function for initialising parameters for and sending salt to BLEAM.
  *
@@ -91,6 +146,14 @@ void bleam_rssi_queue_add(uint16_t sender_id, int8_t rssi, uint8_t aoa);
  */
 void bleam_health_queue_add(uint8_t battery_lvl, uint32_t uptime, uint32_t system_time);
 
+/**@brief Function for adding energy accounting data to health messages for BLEAM.
+ *
+ * @param[in] p_report     Pointer to energy accounting report.
+ *
+ * @returns Nothing.
+ */
+void bleam_health_energy_queue_add(blesc_energy_report_t const * p_report);
+
 #endif // BLEAM_SEND_HELPER_H__
 
 /** @}*/
\ No newline at end of file
@@ -44,7 +44,9 @@ typedef enum {
     BLEAM_S_TIME,                            /**< Local BLEAM time. [READ] */
 } bleam_service_char_t;
 
-#define BLEAM_MAX_DATA_LEN                     (NRF_SDH_BLE_GATT_MAX_MTU_SIZE - 3) /**< Maximum length of data to send to BLEAM */
+#define BLEAM_MAX_DATA_LEN                     (NRF_SDH_BLE_GATT_MAX_MTU_SIZE - 3) /**< Maximum length of data to send to BLEAM with the largest supported ATT MTU */
+#define BLEAM_DEFAULT_DATA_LEN                 (BLE_GATT_ATT_MTU_DEFAULT - 3)      /**< Length of data to send to BLEAM before ATT MTU is negotiated */
+#define BLEAM_SALT_DATA_LEN                    BLEAM_DEFAULT_DATA_LEN              /**< Length of salt message to send to BLEAM */
 #define BLEAM_SERVICE_CLIENT_BLE_OBSERVER_PRIO 2                                   /**< Service's BLE observer priority. */
 
 #define BLEAM_SERVICE_CLIENT_DEF(_name)         \
@@ -232,6 +234,25 @@ bleam_service_client_mode_type_t bleam_service_mode_get(void);
  */
 void bleam_service_mode_set(bleam_service_client_mode_type_t p_mode);
 
+/**@brief Function for getting maximum length of data to send to BLEAM in a single write.
+ *
+ * @details Value depends on ATT MTU negotiated with BLEAM and never exceeds @ref BLEAM_MAX_DATA_LEN.
+ *
+ * @returns Maximum length of data in bytes.
+ */
+uint16_t bleam_service_data_len_get(void);
+
+/**@brief Function for setting maximum length of data to send to BLEAM in a single write.
+ *
+ * @details Call after ATT MTU is negotiated. Value is capped at @ref BLEAM_MAX_DATA_LEN
+ *          and reset to @ref BLEAM_DEFAULT_DATA_LEN on disconnection.
+ *
+ * @param[in]   data_len     Maximum length of data in bytes, ATT MTU minus 3.
+ *
+ * @returns Nothing.
+ */
+void bleam_service_data_len_set(uint16_t data_len);
+
 #endif // BLEAM_SERVICE_H__
 
 /** @}*/
\ No newline at end of file
@@ -48,6 +48,15 @@ typedef struct
     } params; /**< Event parameters. */
 } bleam_service_discovery_evt_t;
 
+/** @brief Statistics of a custom service discovery attempt. */
+typedef struct
+{
+    uint16_t services;    /**< Number of primary services enumerated. */
+    uint16_t reads;       /**< Number of read requests for service declarations. */
+    uint16_t round_trips; /**< Number of GATT requests made. */
+    uint32_t duration_ms; /**< Time from discovery start to its end, ms. */
+} bleam_service_discovery_stats_t;
+
 /**@brief Custom service discovery event handler type.
  *
  * @param[in] p_evt    Pointer to the event structure
@@ -74,6 +83,25 @@ typedef void (* bleam_service_discovery_evt_handler_t)(const bleam_service_disco
  */
 void bleam_service_discovery_start(ble_db_discovery_t *const p_db_discovery, uint16_t conn_handle);
 
+/**@brief Function for setting ATT MTU of the connection custom service discovery runs on.
+ *
+ * @details Larger ATT MTU lets more service declarations be read with a single request.
+ *
+ * @param[in] conn_handle    Connection handle.
+ * @param[in] att_mtu        Effective ATT MTU.
+ *
+ * @returns Nothing.
+ */
+void bleam_service_discovery_att_mtu_set(uint16_t conn_handle, uint16_t att_mtu);
+
+/**@brief Function for getting statistics of the latest custom service discovery attempt.
+ *
+ * @param[out] p_stats    Pointer to statistics struct to fill.
+ *
+ * @returns Nothing.
+ */
+void bleam_service_discovery_stats_get(bleam_service_discovery_stats_t * p_stats);
+
 /**@brief Function for handling the Application's BLE Stack events.
  *
  * @param[in]     p_ble_evt Pointer to the BLE event received.
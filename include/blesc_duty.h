@@ -0,0 +1,55 @@
+/**
+ * @addtogroup blesc_duty
+ * @{
+ */
+
+#ifndef BLESC_DUTY_H__
+#define BLESC_DUTY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BLESC_DUTY_BUCKETS    24  /**< Number of time of day buckets, one per hour */
+#define BLESC_DUTY_RATE_ONE   256 /**< BLEAM hit rate that means BLEAMs are seen on every scan */
+
+/**@brief Function for initialising the adaptive duty cycle.
+ *
+ * @details Every time of day bucket starts from the rate that gives the fixed
+ *          day or night period, so the node behaves as before until it learns.
+ *
+ * @returns Nothing.
+ */
+void blesc_duty_init(void);
+
+/**@brief Function for accounting the outcome of a scan.
+ *
+ * @details Hits raise the rate of the bucket quickly, misses lower it slowly,
+ *          so that activity shortens the period at once and quiet lengthens it over time.
+ *
+ * @param[in] system_time     System time of the scan in seconds passed since midnight.
+ * @param[in] bleam_nearby    True if a BLEAM was detected during the scan.
+ *
+ * @returns Nothing.
+ */
+void blesc_duty_outcome(uint32_t system_time, bool bleam_nearby);
+
+/**@brief Function for getting the scan period for a time of day.
+ *
+ * @param[in] system_time    System time in seconds passed since midnight.
+ *
+ * @returns Scan period in seconds, a multiple of @ref BLESC_TIME_PERIOD_SECS
+ *          between @ref APP_CONFIG_DUTY_PERIODS_MIN and @ref APP_CONFIG_DUTY_PERIODS_MAX periods.
+ */
+uint32_t blesc_duty_period_get(uint32_t system_time);
+
+/**@brief Function for getting the learned BLEAM hit rate of a time of day.
+ *
+ * @param[in] system_time    System time in seconds passed since midnight.
+ *
+ * @returns Hit rate, @ref BLESC_DUTY_RATE_ONE if BLEAMs are seen on every scan.
+ */
+uint16_t blesc_duty_rate_get(uint32_t system_time);
+
+#endif // BLESC_DUTY_H__
+
+/** @}*/
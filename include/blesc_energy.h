@@ -0,0 +1,94 @@
+/**
+ * @addtogroup blesc_energy
+ * @{
+ */
+
+#ifndef BLESC_ENERGY_H__
+#define BLESC_ENERGY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BLESC_ENERGY_STATE_CNT 3 /**< Number of node states accounted for, same as in @ref blesc_state_t */
+
+/** @brief Energy accounting report struct
+ */
+typedef struct {
+    uint32_t state_secs[BLESC_ENERGY_STATE_CNT]; /**< Time spent in each node state, seconds */
+    uint32_t scan_secs;                          /**< Time spent with scanner running, seconds */
+    uint32_t conn_secs;                          /**< Time spent in connections, seconds */
+    uint32_t sleep_secs;                         /**< Time CPU spent sleeping, seconds */
+    uint32_t charge_uah;                         /**< Estimated charge drawn since boot, microampere-hours */
+    uint16_t conn_cnt;                           /**< Number of connections since boot */
+    uint32_t session_ms;                         /**< Duration of the latest finished connection, ms */
+} blesc_energy_report_t;
+
+/**@brief Function for initialising energy accounting.
+ *
+ * @param[in] state    Current node state.
+ *
+ * @returns Nothing.
+ */
+void blesc_energy_init(uint8_t state);
+
+/**@brief Function for accounting a node state transition.
+ *
+ * @param[in] state    New node state.
+ *
+ * @returns Nothing.
+ */
+void blesc_energy_state_set(uint8_t state);
+
+/**@brief Function for accounting scanner start.
+ *
+ * @param[in] window      Scan window in units of 0.625 ms.
+ * @param[in] interval    Scan interval in units of 0.625 ms.
+ *
+ * @returns Nothing.
+ */
+void blesc_energy_scan_start(uint16_t window, uint16_t interval);
+
+/**@brief Function for accounting scanner stop.
+ *
+ * @returns Nothing.
+ */
+void blesc_energy_scan_stop(void);
+
+/**@brief Function for accounting connection start or end.
+ *
+ * @param[in] connected    True on connection, false on disconnection.
+ *
+ * @returns Nothing.
+ */
+void blesc_energy_conn_set(bool connected);
+
+/**@brief Function for accounting CPU sleep.
+ *
+ * @details Call before and after putting CPU to sleep.
+ *
+ * @param[in] sleeping    True before going to sleep, false after wakeup.
+ *
+ * @returns Nothing.
+ */
+void blesc_energy_sleep_set(bool sleeping);
+
+/**@brief Function for bringing counters up to date.
+ *
+ * @details Time is taken from @ref blesc_wakeup_ticks_get, which does not wrap,
+ *          so this is only needed to bring counters up to date before reading them.
+ *
+ * @returns Nothing.
+ */
+void blesc_energy_update(void);
+
+/**@brief Function for getting energy accounting report.
+ *
+ * @param[out] p_report    Pointer to the report to fill.
+ *
+ * @returns Nothing.
+ */
+void blesc_energy_report_get(blesc_energy_report_t * p_report);
+
+#endif // BLESC_ENERGY_H__
+
+/** @}*/
@@ -0,0 +1,40 @@
+/**
+ * @addtogroup blesc_rng
+ * @{
+ */
+
+#ifndef BLESC_RNG_H__
+#define BLESC_RNG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**@brief Function for moving random bytes available in SoftDevice into the pool.
+ *
+ * @details Never waits for new random bytes, takes only what SoftDevice already has.
+ *          Call it when CPU is idle, SoftDevice refills its own buffer in the background.
+ *
+ * @returns Nothing.
+ */
+void blesc_rng_pool_fill(void);
+
+/**@brief Function for taking random bytes from the pool.
+ *
+ * @details Tops the pool up from SoftDevice first if it has too few bytes.
+ *
+ * @param[out] p_buf    Buffer to store random bytes in.
+ * @param[in]  len      Number of random bytes to take.
+ *
+ * @returns True if @p p_buf was filled, false if there were not enough random bytes.
+ */
+bool blesc_rng_pool_get(uint8_t * p_buf, uint8_t len);
+
+/**@brief Function for getting the number of random bytes in the pool.
+ *
+ * @returns Number of random bytes in the pool.
+ */
+uint8_t blesc_rng_pool_level(void);
+
+#endif // BLESC_RNG_H__
+
+/** @}*/
@@ -0,0 +1,71 @@
+/**
+ * @addtogroup blesc_scan_tune
+ * @{
+ */
+
+#ifndef BLESC_SCAN_TUNE_H__
+#define BLESC_SCAN_TUNE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BLESC_SCAN_TUNE_LEVELS    4 /**< Number of scan window levels, from narrowest to widest */
+#define BLESC_SCAN_TUNE_STATIC    2 /**< Level that matches fixed @ref SCAN_WINDOW and @ref SCAN_INTERVAL */
+
+/**@brief Function for starting scan window tuning on a wakeup.
+ *
+ * @details Starting level follows the BLEAM hit rate of the time of day,
+ *          but never above @ref BLESC_SCAN_TUNE_STATIC until a report arrives.
+ *
+ * @param[in] hit_rate    BLEAM hit rate, see @ref blesc_duty_rate_get().
+ *
+ * @returns Nothing.
+ */
+void blesc_scan_tune_start(uint16_t hit_rate);
+
+/**@brief Function for stopping scan window tuning when scanner stops.
+ *
+ * @returns Nothing.
+ */
+void blesc_scan_tune_stop(void);
+
+/**@brief Function for accounting a BLEAM or Apple advertising report.
+ *
+ * @details A phone is likely around, so the scanner opens to the widest window at once.
+ *
+ * @returns Nothing.
+ */
+void blesc_scan_tune_report(void);
+
+/**@brief Function for accounting a tuning step.
+ *
+ * @details Call every @ref APP_CONFIG_SCAN_TUNE_STEP_MS while scanning.
+ *          Window shrinks by one level if no reports arrived since the previous step.
+ *
+ * @returns Nothing.
+ */
+void blesc_scan_tune_step(void);
+
+/**@brief Function for checking whether scan parameters have to be updated.
+ *
+ * @details Clears the change flag.
+ *
+ * @returns True if the level changed since the previous call while tuning is running.
+ */
+bool blesc_scan_tune_changed(void);
+
+/**@brief Function for getting current scan window.
+ *
+ * @returns Scan window in units of 0.625 ms.
+ */
+uint16_t blesc_scan_tune_window_get(void);
+
+/**@brief Function for getting current scan interval.
+ *
+ * @returns Scan interval in units of 0.625 ms.
+ */
+uint16_t blesc_scan_tune_interval_get(void);
+
+#endif // BLESC_SCAN_TUNE_H__
+
+/** @}*/
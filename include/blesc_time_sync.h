@@ -0,0 +1,71 @@
+/**
+ * @addtogroup blesc_time_sync
+ * @{
+ */
+
+#ifndef BLESC_TIME_SYNC_H__
+#define BLESC_TIME_SYNC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BLESC_TIME_SYNC_DAY_MS    (24UL * 60 * 60 * 1000) /**< Milliseconds in a day, BLEAM time wraps at midnight */
+#define BLESC_TIME_SYNC_PPM_ONE   1000000                 /**< Parts per million in one */
+
+/**@brief Function for initialising time sync.
+ *
+ * @details Until the first BLEAM time sample, time runs from the given value at boot
+ *          and is considered unknown.
+ *
+ * @param[in] time_ms    Assumed time at boot in milliseconds passed since midnight.
+ *
+ * @returns Nothing.
+ */
+void blesc_time_sync_init(uint32_t time_ms);
+
+/**@brief Function for accounting a time sample received from BLEAM.
+ *
+ * @details The difference between the sample and the time predicted for it
+ *          corrects the drift estimate, then the sample becomes the new reference.
+ *
+ * @param[in] uptime_ms    Node uptime when the sample was received, ms.
+ * @param[in] bleam_ms     BLEAM time in milliseconds passed since midnight.
+ *
+ * @returns Nothing.
+ */
+void blesc_time_sync_sample(uint64_t uptime_ms, uint32_t bleam_ms);
+
+/**@brief Function for getting drift compensated time.
+ *
+ * @param[in] uptime_ms    Node uptime, ms.
+ *
+ * @returns Milliseconds passed since midnight.
+ */
+uint32_t blesc_time_sync_time_get(uint64_t uptime_ms);
+
+/**@brief Function for getting the uncertainty of time.
+ *
+ * @param[in] uptime_ms    Node uptime, ms.
+ *
+ * @returns Maximum expected error of @ref blesc_time_sync_time_get(), ms.
+ *          UINT32_MAX if time has never been received from BLEAM.
+ */
+uint32_t blesc_time_sync_uncertainty_get(uint64_t uptime_ms);
+
+/**@brief Function for checking whether time has to be read from BLEAM.
+ *
+ * @param[in] uptime_ms    Node uptime, ms.
+ *
+ * @returns True if uncertainty exceeds @ref APP_CONFIG_TIME_SYNC_MAX_ERROR_MS.
+ */
+bool blesc_time_sync_needed(uint64_t uptime_ms);
+
+/**@brief Function for getting the estimated RTC drift.
+ *
+ * @returns Drift relative to BLEAM clock, ppm. Positive if RTC runs slow.
+ */
+int32_t blesc_time_sync_drift_get(void);
+
+#endif // BLESC_TIME_SYNC_H__
+
+/** @}*/
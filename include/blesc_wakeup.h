@@ -0,0 +1,95 @@
+/**
+ * @addtogroup blesc_wakeup
+ * @{
+ */
+
+#ifndef BLESC_WAKEUP_H__
+#define BLESC_WAKEUP_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+#define BLESC_WAKEUP_MAX_TIMERS   8    /**< Maximum number of timers the planner can hold */
+#define BLESC_WAKEUP_INVALID_ID   0xFF /**< ID of a timer that has not been created */
+
+typedef uint8_t blesc_wakeup_id_t; /**< Planner timer ID */
+
+/**@brief Planner timer timeout handler type.
+ *
+ * @param[in] p_context   Context passed to @ref blesc_wakeup_start().
+ */
+typedef void (*blesc_wakeup_handler_t)(void * p_context);
+
+/**@brief Planner timer modes. */
+typedef enum {
+    BLESC_WAKEUP_MODE_SINGLE_SHOT, /**< Timer expires once */
+    BLESC_WAKEUP_MODE_REPEATED,    /**< Timer restarts itself on expiry */
+} blesc_wakeup_mode_t;
+
+/**@brief Function for initialising the wakeup planner.
+ *
+ * @details Planner owns a single app_timer instance and keeps it set to the
+ *          earliest deadline of its timers. Has to be called after app_timer_init().
+ *
+ * @returns NRF_SUCCESS or error code of app_timer_create().
+ */
+ret_code_t blesc_wakeup_init(void);
+
+/**@brief Function for creating a planner timer.
+ *
+ * @details A timer may expire up to @p tolerance ticks before its deadline,
+ *          if the node is woken up by another timer anyway. A timer with tolerance
+ *          equal to its timeout runs on every wakeup and wakes the node only
+ *          if nothing else did.
+ *
+ * @param[out] p_id         Pointer to created timer ID.
+ * @param[in]  mode         Timer mode.
+ * @param[in]  tolerance    How early the timer may expire, RTC ticks. 0 for exact deadline.
+ * @param[in]  handler      Timeout handler.
+ *
+ * @retval NRF_SUCCESS              If the timer was created.
+ * @retval NRF_ERROR_NULL           If handler is NULL.
+ * @retval NRF_ERROR_NO_MEM         If there are already @ref BLESC_WAKEUP_MAX_TIMERS timers.
+ */
+ret_code_t blesc_wakeup_create(blesc_wakeup_id_t * p_id, blesc_wakeup_mode_t mode, uint32_t tolerance, blesc_wakeup_handler_t handler);
+
+/**@brief Function for starting or restarting a planner timer.
+ *
+ * @param[in] id          Timer ID.
+ * @param[in] timeout     Time to expiry, RTC ticks. Also the period of repeated timers.
+ * @param[in] p_context   Context to pass to the timeout handler.
+ *
+ * @retval NRF_SUCCESS                If the timer was started.
+ * @retval NRF_ERROR_INVALID_PARAM    If the timer has not been created or timeout is 0.
+ */
+ret_code_t blesc_wakeup_start(blesc_wakeup_id_t id, uint32_t timeout, void * p_context);
+
+/**@brief Function for stopping a planner timer.
+ *
+ * @param[in] id    Timer ID.
+ *
+ * @retval NRF_SUCCESS                If the timer was stopped.
+ * @retval NRF_ERROR_INVALID_PARAM    If the timer has not been created.
+ */
+ret_code_t blesc_wakeup_stop(blesc_wakeup_id_t id);
+
+/**@brief Function for getting RTC ticks since boot.
+ *
+ * @details Not limited by RTC counter overflow, as the planner never sleeps
+ *          long enough for the counter to wrap between reads.
+ *          This is the single clock of the application, all time stamping goes through it.
+ *
+ * @returns RTC ticks since planner initialisation.
+ */
+uint64_t blesc_wakeup_ticks_get(void);
+
+/**@brief Function for getting the number of planner wakeups in the latest full hour.
+ *
+ * @returns Number of wakeups, 0 during the first hour after boot.
+ */
+uint32_t blesc_wakeup_hourly_get(void);
+
+#endif // BLESC_WAKEUP_H__
+
+/** @}*/
@@ -48,8 +48,18 @@
 
 #define APP_CONFIG_SCAN_CONNECT_INTERVAL    10000   /**< Maximum time BLEAM Scanner can spend scanning before it tries to connect, ms. */
 #define APP_CONFIG_BLEAM_INACTIVITY_TIMEOUT 3000    /**< Maximum inactivity time after BLEAM connection before BLEAM Scanner disconnects, ms. */
+#define APP_CONFIG_WAKEUP_TOLERANCE         50      /**<@ingroup blesc_wakeup
+                                                      * How early scan, connection and eco timeouts may expire to share a wakeup with another timer, ms. */
+#define APP_CONFIG_BLEAM_TX_QUEUE_SIZE      4       /**< Number of write commands to BLEAM that can be queued in SoftDevice at once. */
+#define APP_CONFIG_CONN_MAX_FAILURES        3       /**< Failed deliveries after which stored RSSI data of a BLEAM is dropped. */
+#define APP_CONFIG_PEER_CACHE_SIZE          8       /**< Number of recently connected BLEAMs whose service handles and connection profile are remembered. */
 #define APP_CONFIG_MACLIST_TIMEOUT          30000   /**< Expiry timeout for MAC whitelist/blacklist entries, ms. */
-#define APP_CONFIG_RSSI_FILTER_INTERVAL     200     /**< Time interval for RSSI scan timeout before connect, ms. */
+#define APP_CONFIG_MACLIST_SIZE             256     /**< Number of slots in iOS MAC registry, power of two. */
+#define APP_CONFIG_RSSI_FILTER_INTERVAL     1000    /**< Minimum time between two stored RSSI samples of one device, ms. */
+#define APP_CONFIG_RSSI_FILTER_JITTER       500     /**< Maximum random time added to @ref APP_CONFIG_RSSI_FILTER_INTERVAL, ms. 0 disables jitter. */
+#define APP_CONFIG_SCAN_FILTER_ENABLED      1       /**< Drop advertising reports that can not carry BLEAM or iOS data before parsing them. */
+#define APP_CONFIG_SCAN_TUNE_STEP_MS        250     /**<@ingroup blesc_scan_tune
+                                                      * Time without BLEAM or Apple reports after which scan window narrows by one level, ms. */
 
 /** @}*/
 
@@ -69,17 +79,69 @@
 #define BLESC_DAYTIME_START               TIME_TO_SEC(6, 0, 0)     /**< System time that corresponds with start of the day */
 #define BLESC_NIGHTTIME_START             TIME_TO_SEC(1, 0, 0)   /**< System time that corresponds with start of the night */
 
+#define APP_CONFIG_DUTY_PERIODS_MIN       BLESC_TIME_PERIODS_DAY   /**<@ingroup blesc_duty
+                                                                     * Shortest scan period when BLEAMs are seen on every scan, in @ref BLESC_TIME_PERIOD_SECS */
+#define APP_CONFIG_DUTY_PERIODS_MAX       12                       /**<@ingroup blesc_duty
+                                                                     * Longest scan period when no BLEAMs are seen, in @ref BLESC_TIME_PERIOD_SECS */
+#define APP_CONFIG_DUTY_HIT_SHIFT         1                        /**<@ingroup blesc_duty
+                                                                     * Weight of a scan with BLEAMs in hit rate, 1/2^n. Small for fast reaction to activity. */
+#define APP_CONFIG_DUTY_MISS_SHIFT        4                        /**<@ingroup blesc_duty
+                                                                     * Weight of a scan without BLEAMs in hit rate, 1/2^n. Large for slow decay when quiet. */
+
+#define APP_CONFIG_TIME_SYNC_MAX_ERROR_MS 250                      /**<@ingroup blesc_time_sync
+                                                                     * Time uncertainty above which time is read from BLEAM on next connection, ms */
+#define APP_CONFIG_TIME_SYNC_READ_ERROR_MS 50                      /**<@ingroup blesc_time_sync
+                                                                     * Error of a single BLEAM time read, GATT round trip included, ms */
+#define APP_CONFIG_TIME_SYNC_CLOCK_PPM    50                       /**<@ingroup blesc_time_sync
+                                                                     * LFCLK tolerance before drift is learned and bound of drift estimate, ppm */
+#define APP_CONFIG_TIME_SYNC_RESIDUAL_PPM 10                       /**<@ingroup blesc_time_sync
+                                                                     * Lowest drift estimate error, covers temperature changes, ppm */
+#define APP_CONFIG_TIME_SYNC_MIN_SPAN_MS  (10 * 60 * 1000)         /**<@ingroup blesc_time_sync
+                                                                     * Shortest time between BLEAM time samples to estimate drift from, ms */
+#define APP_CONFIG_TIME_SYNC_GAIN_SHIFT   1                        /**<@ingroup blesc_time_sync
+                                                                     * Weight of a new drift measurement in drift estimate, 1/2^n */
+
 /** @} end of bleam_time */
 
 /**@addtogroup bleam_storage
  * @{
  */
-#define APP_CONFIG_MAX_BLEAMS           8       /**< Size of detected devices' RSSI data storage array */
+#define APP_CONFIG_MAX_BLEAMS           64      /**< Size of detected devices' RSSI data storage array, power of two up to 256 */
 #define APP_CONFIG_BLEAM_UUID_SIZE      10      /**< Length of the unique BLEAM UUID part */
 #define APP_CONFIG_RSSI_PER_MSG         5       /**< Number of RSSI scan results per message to BLEAM */
+#define APP_CONFIG_RSSI_SUMMARY_ENABLED 0       /**< Send one RSSI summary per BLEAM and window instead of @ref APP_CONFIG_RSSI_PER_MSG raw samples */
+#define APP_CONFIG_RSSI_SUMMARY_WINDOW  30000   /**< Time to summarise RSSI of a BLEAM before connecting to it, ms. Must be under 512 s RTC wrap. */
 #define BLEAM_KEY_SIZE                 (16)     /**< Size (in octets) of a BLEAM application key.*/
 /** @} end of bleam_storage */
 
+/**@addtogroup bleam_batch
+ * @{
+ */
+#define APP_CONFIG_BATCH_FRAME_ENABLED  0       /**< Send health and RSSI data to BLEAM in @ref bleam_batch frames instead of separate messages */
+/** @} end of bleam_batch */
+
+/**@addtogroup blesc_energy
+ * @{
+ */
+#define APP_CONFIG_ENERGY_SLEEP_UA      3       /**< System ON sleep current with RTC running, uA */
+#define APP_CONFIG_ENERGY_CPU_UA        3700    /**< CPU running current, uA */
+#define APP_CONFIG_ENERGY_RX_UA         5400    /**< Radio receive current, uA */
+#define APP_CONFIG_ENERGY_CONN_UA       150     /**< Average current of connection events at used connection interval, uA */
+/** @} end of blesc_energy */
+
+/**@addtogroup blesc_rng
+ * @{
+ */
+#define APP_CONFIG_RNG_POOL_SIZE        64      /**< Number of pre-generated random bytes kept for salts and error IDs, up to 255 */
+/** @} end of blesc_rng */
+
+/**@addtogroup adv_capture
+ * @{
+ */
+#define APP_CONFIG_ADV_CAPTURE_ENABLED  0       /**< Enable capture and replay of advertising reports. Debug only, costs RAM. */
+#define APP_CONFIG_ADV_CAPTURE_SIZE     64      /**< Number of advertising reports in capture buffer */
+/** @} end of adv_capture */
+
 /**@addtogroup blesc_fds
  * @{
  */
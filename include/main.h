@@ -115,6 +115,19 @@
  * @details For details, please refer to @link_wiki_debug.
  */
 
+/**
+ * @defgroup adv_capture Advertising report capture and replay
+ * @brief Recording advertising reports in the field and feeding them back through the scan pipeline.
+ *
+ * @details With @ref APP_CONFIG_ADV_CAPTURE_ENABLED set, BLEAM Scanner copies the first
+ *          @ref APP_CONFIG_ADV_CAPTURE_SIZE advertising reports it receives into a capture buffer.
+ *          Once the buffer is full, the next time the node goes idle the capture is dumped to log
+ *          and replayed through @ref process_scan_data() in virtual time, which is taken from
+ *          record timestamps. Connection attempts are counted instead of being made.
+ *          Replay reports processing cost per report in CPU cycles, number of connection attempts
+ *          and peak BLEAM storage occupancy, as a baseline for changes to scanning logic.
+ */
+
 /**
  * @defgroup handlers Event handlers
  * @brief All event handlers from the main application.
@@ -129,6 +142,12 @@
 #define MAIN_H__
 
 #include "blesc_error.h"
+#include "blesc_energy.h"
+#include "blesc_rng.h"
+#include "blesc_duty.h"
+#include "blesc_time_sync.h"
+#include "blesc_wakeup.h"
+#include "blesc_scan_tune.h"
 #include "app_config.h"
 #include "app_timer.h"
 #include "app_util_platform.h"
@@ -150,6 +169,7 @@
 
 /* Core */
 #include "nordic_common.h"
+#include "app_util.h"
 #include "nrf.h"
 #include "nrf_ble_gatt.h"
 #include "nrf_ble_qwr.h"
@@ -184,6 +204,7 @@
 /* Crypto */
 #include "nrf_crypto_init.h"
 #include "nrf_crypto.h"
+#include "ocrypto_sha256.h"
 
 /* Ruuvi drivers */
 #ifdef BOARD_RUUVITAG_B
@@ -226,6 +247,18 @@ typedef struct {
     uint8_t  app_key[CONFIG_APP_KEY_SIZE]; /**< BLEAM Scanner node application key */
 } configuration_t;
 
+/**@ingroup bleam_storage
+ * Streaming RSSI summary struct, fixed size whatever the number of samples
+ */
+typedef struct {
+    uint16_t count;                                  /**< Number of summarised samples */
+    int8_t   min;                                    /**< Minimum RSSI */
+    int8_t   max;                                    /**< Maximum RSSI */
+    int8_t   median;                                 /**< Frugal streaming estimate of RSSI median */
+    float    mean;                                   /**< Running mean of RSSI, Welford's method */
+    float    m2;                                     /**< Running sum of squared differences from the mean, Welford's method */
+} blesc_rssi_summary_t;
+
 /**@ingroup bleam_storage
  * Detected devices' RSSI data storage struct
  */
@@ -236,14 +269,30 @@ typedef struct {
     uint8_t  scans_stored_cnt;                       /**< Number of scans in RSSI storage */
     int8_t   rssi[APP_CONFIG_RSSI_PER_MSG];          /**< Received Signal Strength of BLEAM */
     uint8_t  aoa[APP_CONFIG_RSSI_PER_MSG];           /**< Angle of arrival of BLEAM signal */
+    uint16_t offset_ms[APP_CONFIG_RSSI_PER_MSG];     /**< Time of each RSSI after @ref first_seen, ms, saturates at UINT16_MAX */
     uint32_t timestamp;                              /**< Timestamp of last received RSSI */
+    uint32_t sample_gap;                             /**< Time to wait after @ref timestamp before next RSSI is stored, in ticks */
+    uint32_t first_seen;                             /**< Timestamp of the first stored RSSI, for report latency */
+    uint8_t  failures;                               /**< Number of failed attempts to deliver stored RSSI */
+#if APP_CONFIG_RSSI_SUMMARY_ENABLED
+    blesc_rssi_summary_t summary;                    /**< Summary of all RSSI since @ref first_seen */
+#endif
 } blesc_model_rssi_data_t;
 
+/** @ingroup ios_solution
+ * States of iOS device investigation
+ */
+typedef enum {
+    IOS_STATE_NONE     = 0x00, /**< No iOS device is being investigated */
+    IOS_STATE_DISCOVER = 0x01, /**< Unknown iOS device, connect and look for BLEAM service */
+    IOS_STATE_RETRY    = 0x02, /**< Known BLEAM did not show BLEAM service, reconnect and look for it on iOS */
+} ios_state_t;
+
 /** @ingroup ios_solution
  * iOS RSSI data struct
  */
 typedef struct {
-    uint8_t  active;                                    /**< Flag that denotes if this structure is empty or not */
+    uint8_t  state;                                     /**< Investigation state of the device, @ref ios_state_t */
     uint8_t  bleam_uuid[APP_CONFIG_BLEAM_UUID_SIZE]; /**< Bleam UUID for which the RSSI data is collected */
     uint8_t  mac[BLE_GAP_ADDR_LEN];                     /**< Bleam MAC address for which the RSSI data is collected */
     int8_t   rssi;                                      /**< Received Signal Strength of BLEAM */
@@ -252,23 +301,113 @@ typedef struct {
 } bleam_ios_rssi_data_t;
 
 /** @ingroup ios_solution
- * iOS MAC whitelist data struct
+ * Roles of a MAC address in iOS MAC registry
  */
-typedef struct {
-    uint8_t  active;                                    /**< Flag that denotes if this structure is empty or not */
-    uint8_t  bleam_uuid[APP_CONFIG_BLEAM_UUID_SIZE]; /**< Bleam UUID for which the RSSI data is collected */
-    uint8_t  mac[BLE_GAP_ADDR_LEN];                     /**< Bleam MAC address for which the RSSI data is collected */
-    uint32_t timestamp;                                 /**< Timestamp of last received RSSI */
-} bleam_ios_mac_whitelist_t;
+typedef enum {
+    MACLIST_ROLE_NONE      = 0x00, /**< Registry slot is empty */
+    MACLIST_ROLE_WHITELIST = 0x01, /**< Device runs BLEAM in the background */
+    MACLIST_ROLE_BLACKLIST = 0x02, /**< Device was checked and does not run BLEAM */
+} maclist_role_t;
 
 /** @ingroup ios_solution
- * iOS MAC blacklist data struct
+ * iOS MAC registry entry struct
+ */
+typedef struct {
+    uint8_t  mac[BLE_GAP_ADDR_LEN];                  /**< iOS device MAC address */
+    uint8_t  role;                                   /**< Role of the address, @ref maclist_role_t */
+    uint8_t  generation;                             /**< Registry generation the address was last seen in */
+    uint8_t  bleam_uuid[APP_CONFIG_BLEAM_UUID_SIZE]; /**< Bleam UUID of whitelisted device */
+} bleam_ios_mac_entry_t;
+
+/** @ingroup bleam_connect
+ * Recently connected BLEAM cache entry struct
  */
 typedef struct {
-    uint8_t  active;                /**< Flag that denotes if this structure is empty or not */
-    uint8_t  mac[BLE_GAP_ADDR_LEN]; /**< Bleam MAC address for which the RSSI data is collected */
-    uint32_t timestamp;             /**< Timestamp of last received RSSI */
-} bleam_ios_mac_blacklist_t;
+    uint8_t            bleam_uuid[APP_CONFIG_BLEAM_UUID_SIZE]; /**< Bleam UUID of the device */
+    uint8_t            mac[BLE_GAP_ADDR_LEN];                  /**< Bleam MAC address of the device */
+    uint32_t           last_used;                              /**< Value of @ref m_peer_cache_clock at last use, 0 if entry is empty */
+    bool               handles_valid;                          /**< Flag that denotes that @p handles can be used instead of service discovery */
+    uint8_t            conn_profile;                           /**< Connection parameter profile the device accepts, @ref blesc_conn_profile_t */
+    bleam_service_db_t handles;                                /**< BLEAM service handles discovered on the device */
+} bleam_peer_cache_entry_t;
+
+/** @ingroup bleam_connect
+ * Phases of a connection session
+ */
+typedef enum {
+    SESSION_PHASE_NONE = 0,   /**< No session */
+    SESSION_PHASE_CONNECTING, /**< Waiting for connection to be established */
+    SESSION_PHASE_DISCOVERY,  /**< Discovering BLEAM service */
+    SESSION_PHASE_SALT,       /**< Waiting for salt from BLEAM */
+    SESSION_PHASE_SIGN,       /**< Sending signature to BLEAM */
+    SESSION_PHASE_HEALTH,     /**< Sending health data to BLEAM */
+    SESSION_PHASE_RSSI,       /**< Sending RSSI data to BLEAM */
+    SESSION_PHASE_TIME,       /**< Reading time from BLEAM */
+    SESSION_PHASE_DISCONNECT, /**< Waiting for disconnection */
+    SESSION_PHASE_CNT,        /**< Number of session phases */
+} session_phase_t;
+
+/** @ingroup bleam_connect
+ * Connection session struct
+ */
+typedef struct {
+    uint16_t conn_handle;                       /**< Handle of the current connection */
+    uint16_t bleam_index;                       /**< Index of BLEAM device to connect to in storage */
+    bool     scheduled;                         /**< Flag that denotes that the BLEAM came from connection queue and its delivery is accounted on disconnect */
+    uint8_t  phase;                             /**< Current phase, @ref session_phase_t */
+    uint8_t  conn_profile;                      /**< Connection parameter profile, @ref blesc_conn_profile_t */
+    uint8_t  bleam_uuid[APP_CONFIG_BLEAM_UUID_SIZE]; /**< Bleam UUID of the peer, zero for unknown iOS devices */
+    uint8_t  mac[BLE_GAP_ADDR_LEN];             /**< MAC address of the peer */
+    uint8_t  signature_halves;                  /**< Bitwise flags denoting whether each half of the BLEAM signature have been received (binary 01 for first, 10 for second, 11 for both) */
+    bool     handles_cached;                    /**< Flag that denotes that BLEAM service handles came from cache */
+    uint32_t start_tick;                        /**< Timestamp of session start */
+    uint32_t phase_tick;                        /**< Timestamp of current phase start */
+    uint16_t phase_ms[SESSION_PHASE_CNT];       /**< Time spent in each phase of this session, ms, saturates at UINT16_MAX */
+} blesc_session_t;
+
+/** @ingroup adv_capture
+ * Captured advertising report struct
+ */
+typedef struct {
+    uint32_t timestamp;                         /**< RTC ticks at reception */
+    uint8_t  peer_addr[BLE_GAP_ADDR_LEN];       /**< Advertiser address */
+    uint8_t  addr_type;                         /**< Advertiser address type */
+    int8_t   rssi;                              /**< Received Signal Strength */
+    uint8_t  ch_index;                          /**< Advertising channel index */
+    uint8_t  type;                              /**< Report type bits: connectable, scannable, directed, scan response */
+    uint8_t  data_len;                          /**< Length of advertising data */
+    uint8_t  data[NRF_BLE_SCAN_BUFFER];         /**< Advertising data */
+} blesc_adv_capture_t;
+
+/** @ingroup adv_capture
+ * Replay results struct
+ */
+typedef struct {
+    uint32_t reports;                           /**< Number of replayed reports */
+    uint32_t cycles_total;                      /**< CPU cycles spent processing all reports */
+    uint32_t cycles_max;                        /**< CPU cycles spent processing the most expensive report */
+    uint16_t connect_attempts;                  /**< Number of BLEAM and iOS connection attempts */
+    uint16_t storage_used_max;                  /**< Peak number of BLEAMs in storage */
+} blesc_adv_replay_stats_t;
+
+/**@addtogroup bleam_time
+ * @{ */
+#define SYSTEM_TIME_SEC_TICKS          APP_TIMER_TICKS(1000)                              /**< RTC ticks in a second. */
+#define WAKEUP_TOLERANCE               APP_TIMER_TICKS(APP_CONFIG_WAKEUP_TOLERANCE)       /**< How early short timeouts may expire to share a wakeup. */
+#define WDT_FEED_INTERVAL              APP_TIMER_TICKS(WDT_CONFIG_RELOAD_VALUE / 2)       /**< Longest sleep without a watchdog feed. */
+/** @} end of bleam_time */
+
+/**@addtogroup bleam_storage
+ * @{ */
+#define BLEAM_STORAGE_HASH_SIZE        (2 * APP_CONFIG_MAX_BLEAMS)                        /**< Number of slots in BLEAM storage hash index. Must be a power of two. */
+#define BLEAM_STORAGE_HASH_EMPTY       0xFFFF                                             /**< Value of an empty BLEAM storage hash index slot. */
+/** @} end of bleam_storage */
+
+/**@addtogroup ios_solution
+ * @{ */
+#define MACLIST_HASH_SIZE              APP_CONFIG_MACLIST_SIZE                            /**< Number of slots in iOS MAC registry. Must be a power of two. */
+#define MACLIST_MAX_ENTRIES            (MACLIST_HASH_SIZE - MACLIST_HASH_SIZE / 4)        /**< Maximum number of addresses in iOS MAC registry, keeps probe sequences short. */
+/** @} end of ios_solution */
 
 #define RTC_MAX_TICKS                  APP_TIMER_MAX_CNT_VAL                              /**< Maximum counter value that can be returned by @ref app_timer_cnt_get. */
 
@@ -312,8 +451,31 @@ typedef struct {
 #define FIRST_CONN_PARAMS_UPDATE_DELAY APP_TIMER_TICKS(5000)                              /**< Time from initiating event (connect or start of notification) to first time sd_ble_gap_conn_param_update is called (5 seconds). */
 #define NEXT_CONN_PARAMS_UPDATE_DELAY  APP_TIMER_TICKS(30000)                             /**< Time between each call to sd_ble_gap_conn_param_update after the first call (30 seconds). */
 #define MAX_CONN_PARAMS_UPDATE_COUNT   3                                                  /**< Number of attempts before giving up the connection parameter negotiation. */
+#define CONN_SCORE_SAMPLE              64                                                 /**< Connection score of each stored RSSI sample. */
+#define CONN_SCORE_AGE_SEC             8                                                  /**< Connection score of each second since the first stored RSSI sample. */
+#define CONN_SCORE_FAILURE             128                                                /**< Connection score penalty of each failed delivery. */
+
+#define SESSION_HIST_BUCKETS           10                                                 /**< Number of buckets in session phase latency histograms, 8 ms doubling each bucket. */
+#define SESSION_HIST_LOG_PERIOD        16                                                 /**< Number of sessions between logging session phase latency histograms. */
+
+/* Connection parameter profiles for connections to BLEAM */
+#define FAST_MIN_CONN_INTERVAL         MSEC_TO_UNITS(7.5, UNIT_1_25_MS)                   /**< Minimum connection interval of fast transfer profile. */
+#define FAST_MAX_CONN_INTERVAL         MSEC_TO_UNITS(15, UNIT_1_25_MS)                    /**< Maximum connection interval of fast transfer profile. */
+#define FAST_SLAVE_LATENCY             0                                                  /**< Slave latency of fast transfer profile. */
+#define FAST_CONN_SUP_TIMEOUT          MSEC_TO_UNITS(2000, UNIT_10_MS)                    /**< Supervision timeout of fast transfer profile (2 seconds). */
+#define SAFE_MIN_CONN_INTERVAL         MSEC_TO_UNITS(15, UNIT_1_25_MS)                    /**< Minimum connection interval of fallback profile, lowest accepted by iOS. */
+#define SAFE_MAX_CONN_INTERVAL         MSEC_TO_UNITS(45, UNIT_1_25_MS)                    /**< Maximum connection interval of fallback profile. */
+#define SAFE_SLAVE_LATENCY             0                                                  /**< Slave latency of fallback profile. */
+#define SAFE_CONN_SUP_TIMEOUT          MSEC_TO_UNITS(4000, UNIT_10_MS)                    /**< Supervision timeout of fallback profile (4 seconds). */
+
+/**@brief Connection parameter profiles. */
+typedef enum {
+    BLESC_CONN_PROFILE_FAST = 0, /**< Short interval for quick data exchange with BLEAM. */
+    BLESC_CONN_PROFILE_SAFE,     /**< Longer interval for BLEAMs that reject @ref BLESC_CONN_PROFILE_FAST. */
+    BLESC_CONN_PROFILE_CNT,      /**< Number of connection parameter profiles. */
+} blesc_conn_profile_t;
 /** @} end of bleam_connect */
-static void try_bleam_connect(uint8_t p_index);
+static void try_bleam_connect(uint16_t p_index, bool scheduled);
 
 /** @addtogroup bleam_scan
  * @{ */
@@ -325,12 +487,37 @@ typedef struct
     uint16_t                           data_len;                                          /**< Length of data. */
 } data_t;
 
+/** Advertising report classes recognised by @ref process_scan_data() */
+typedef enum {
+    BLESC_ADV_TYPE_IGNORE = 0x00,                                                         /**< Report carries nothing BLEAM Scanner is interested in. */
+    BLESC_ADV_TYPE_BLEAM,                                                                 /**< Report carries a BLEAM service 128-bit UUID. */
+    BLESC_ADV_TYPE_APPLE,                                                                 /**< Report carries Apple manufacturer specific data. */
+} blesc_adv_type_t;
+
+#define ADV_BLEAM_UUID_FIELD_LEN       17                                                 /**< Length of AD structure with a single 128-bit UUID, type octet included. */
+#define ADV_APPLE_DATA_FIELD_LEN       20                                                 /**< Length of AD structure with iOS background manufacturer data, type octet included. */
+#define ADV_APPLE_COMPANY_ID           0x004C                                             /**< Bluetooth SIG company identifier of Apple Inc. */
+#define ADV_REPORT_MIN_LEN             (1 + MIN(ADV_BLEAM_UUID_FIELD_LEN, ADV_APPLE_DATA_FIELD_LEN)) /**< Shortest advertising data that can carry a BLEAM or iOS field. */
+
+/** Advertising report counters of a scanning session */
+typedef struct {
+    uint32_t received;                                                                    /**< Reports delivered by scanning module. */
+    uint32_t filtered;                                                                    /**< Reports dropped before parsing. */
+    uint32_t ignored;                                                                     /**< Reports parsed and found of no interest. */
+    uint32_t bleam;                                                                       /**< Reports carrying BLEAM service UUID. */
+    uint32_t apple;                                                                       /**< Reports carrying Apple manufacturer data. */
+} blesc_scan_stats_t;
+
 #define BLESC_SCAN_TIME                APP_TIMER_TICKS((APP_CONFIG_ECO_SCAN_SECS * 1000)) /**< Time for BLEAM Scanner to scan for BLEAMs between sleeps */
 #define RSSI_FILTER_TIMEOUT            APP_TIMER_TICKS(APP_CONFIG_RSSI_FILTER_INTERVAL)   /**< Minimum time between received RSSI scans from one device. */
+#define RSSI_FILTER_JITTER             APP_TIMER_TICKS(APP_CONFIG_RSSI_FILTER_JITTER)     /**< Maximum random addition to @ref RSSI_FILTER_TIMEOUT. */
+#define RSSI_SUMMARY_WINDOW            APP_TIMER_TICKS(APP_CONFIG_RSSI_SUMMARY_WINDOW)    /**< Time to summarise RSSI of a BLEAM before connecting to it. */
 #define SCAN_CONNECT_TIME              APP_TIMER_TICKS(APP_CONFIG_SCAN_CONNECT_INTERVAL)  /**< Time for BLEAM RSSI scan process. */
-#define MACLIST_TIMEOUT                APP_TIMER_TICKS(APP_CONFIG_MACLIST_TIMEOUT)        /**< Time for BLEAM RSSI scan process. */
-#define SCAN_INTERVAL                  0x00A0                                             /**< Determines scan interval in units of 0.625 millisecond. */
-#define SCAN_WINDOW                    0x0050                                             /**< Determines scan window in units of 0.625 millisecond. */
+#define MACLIST_TIMEOUT                APP_TIMER_TICKS(APP_CONFIG_MACLIST_TIMEOUT)        /**< Lifetime of one iOS MAC registry generation. */
+#define MACLIST_TOLERANCE              (MACLIST_TIMEOUT / 4)                              /**< How early iOS MAC registry generation may advance to share a wakeup. */
+#define SCAN_INTERVAL                  0x00A0                                             /**< Determines scan interval in units of 0.625 millisecond. Tuned while scanning, see @ref blesc_scan_tune. */
+#define SCAN_WINDOW                    0x0050                                             /**< Determines scan window in units of 0.625 millisecond. Tuned while scanning, see @ref blesc_scan_tune. */
+#define SCAN_TUNE_STEP                 APP_TIMER_TICKS(APP_CONFIG_SCAN_TUNE_STEP_MS)      /**< Time between scan window tuning steps. */
 #define SCAN_DURATION                  0x0000                                             /**< Timout when scanning in units if 10 ms. 0x0000 disables timeout. */
 #define CONNECT_TIMEOUT                0x012C                                             /**< Timout when connecting in units of 10 ms. 0x0000 disables timeout. */
 /** @} end of bleam_scan */
@@ -362,7 +549,9 @@ static nrf_saadc_value_t adc_buf[2];
 #define SIGN_KEY_MIN_SIZE              2                                                  /**< Minimal size of key for signing. */
 #define SIGN_KEY_MAX_SIZE              128                                                /**< Maximal size of key for signing. */
 #define SALT_SIZE                      16                                                 /**< Size of salt for signing. */
-#define HEX_MAX_BUF_SIZE               2 + (SIGN_KEY_MAX_SIZE << 1)                       /**< Maximal size of hex buffer for signing. */
+#define SIGN_BLOCK_SIZE                64                                                 /**< Size of SHA-256 block, HMAC key is padded to it. */
+#define SIGN_IPAD                      0x36                                               /**< HMAC inner padding byte. */
+#define SIGN_OPAD                      0x5C                                               /**< HMAC outer padding byte. */
 /** @} end of bleam_security */
 
 /* Misc */
@@ -0,0 +1,373 @@
+/** @file bleam_batch.c
+ *
+ * @defgroup bleam_batch BLEAM batch frame
+ * @{
+ * @ingroup bleam_service
+ *
+ * @brief Encoding and decoding of batch frames with RSSI and health records for BLEAM.
+ *
+ * @details Frame starts with @ref BLEAM_BATCH_FRAME_TAG and a header of node ID,
+ *          sequence number and base time. Typed records follow, one byte of
+ *          @ref bleam_batch_rec_type_t and record fields.
+ *          Unsigned fields are LEB128 varints, signed fields are zigzag varints.
+ *          RSSI samples in a run carry difference from the previous sample in RSSI
+ *          and in age, the first sample carries its age relative to base time.
+ *          Summary statistics carry difference from the mean.
+ */
+
+#include "bleam_batch.h"
+#include <string.h>
+
+/**@brief Batch frame decoder state. */
+typedef struct {
+    uint8_t const *p_buf;   /**< Frame being decoded */
+    uint16_t       len;     /**< Frame length */
+    uint16_t       pos;     /**< Index of the next byte to read */
+    uint8_t        version; /**< Frame format version */
+} bleam_batch_reader_t;
+
+/********************************* ENCODER ********************************/
+
+/**@brief Function for appending a byte to the frame.
+ *
+ * @returns True if the byte fits, false otherwise.
+ */
+static bool batch_put_u8(bleam_batch_encoder_t * p_enc, uint8_t value) {
+    if (p_enc->len >= p_enc->max_len) {
+        return false;
+    }
+    p_enc->p_buf[p_enc->len++] = value;
+    return true;
+}
+
+/**@brief Function for appending an unsigned varint to the frame.
+ *
+ * @returns True if the value fits, false otherwise.
+ */
+static bool batch_put_varint(bleam_batch_encoder_t * p_enc, uint32_t value) {
+    while (0x80 <= value) {
+        if (!batch_put_u8(p_enc, (uint8_t)(value | 0x80))) {
+            return false;
+        }
+        value >>= 7;
+    }
+    return batch_put_u8(p_enc, (uint8_t)value);
+}
+
+/**@brief Function for appending a signed zigzag varint to the frame.
+ *
+ * @returns True if the value fits, false otherwise.
+ */
+static bool batch_put_svarint(bleam_batch_encoder_t * p_enc, int32_t value) {
+    return batch_put_varint(p_enc, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+/**@brief Function for appending an RSSI sample, either to the open run or as a new run.
+ *
+ * @returns True if the sample fits, false otherwise.
+ */
+static bool batch_put_rssi(bleam_batch_encoder_t * p_enc, bleam_batch_record_t const * p_record) {
+    bool age_put;
+    int8_t prev_rssi = 0;
+    if (0 != p_enc->run_pos && BLEAM_BATCH_RSSI_RUN_MAX > p_enc->p_buf[p_enc->run_pos]) {
+        prev_rssi = p_enc->run_rssi;
+        ++p_enc->p_buf[p_enc->run_pos];
+        age_put = batch_put_svarint(p_enc, (int32_t)(p_enc->run_age - p_record->data.rssi.age_ms));
+    } else {
+        if (!batch_put_u8(p_enc, BLEAM_BATCH_REC_RSSI)) {
+            return false;
+        }
+        p_enc->run_pos = p_enc->len;
+        if (!batch_put_u8(p_enc, 1)) {
+            return false;
+        }
+        age_put = batch_put_varint(p_enc, p_record->data.rssi.age_ms);
+    }
+    p_enc->run_rssi = p_record->data.rssi.rssi;
+    p_enc->run_age  = p_record->data.rssi.age_ms;
+    return age_put &&
+           batch_put_svarint(p_enc, p_record->data.rssi.rssi - prev_rssi) &&
+           batch_put_varint(p_enc, p_record->data.rssi.aoa);
+}
+
+/**@brief Function for appending a record other than an RSSI sample.
+ *
+ * @returns True if the record fits, false otherwise.
+ */
+static bool batch_put_record(bleam_batch_encoder_t * p_enc, bleam_batch_record_t const * p_record) {
+    // Any other record closes RSSI run
+    p_enc->run_pos = 0;
+    if (!batch_put_u8(p_enc, p_record->type)) {
+        return false;
+    }
+
+    switch (p_record->type) {
+    case BLEAM_BATCH_REC_SUMMARY: {
+        const int8_t mean = p_record->data.summary.mean;
+        return batch_put_varint(p_enc, p_record->data.summary.count) &&
+               batch_put_svarint(p_enc, mean) &&
+               batch_put_svarint(p_enc, p_record->data.summary.min - mean) &&
+               batch_put_svarint(p_enc, p_record->data.summary.max - mean) &&
+               batch_put_svarint(p_enc, p_record->data.summary.median - mean) &&
+               batch_put_varint(p_enc, p_record->data.summary.variance) &&
+               batch_put_varint(p_enc, p_record->data.summary.aoa);
+    }
+    case BLEAM_BATCH_REC_HEALTH:
+        return batch_put_u8(p_enc, p_record->data.health.battery_lvl) &&
+               batch_put_varint(p_enc, p_record->data.health.fw_id) &&
+               batch_put_varint(p_enc, p_record->data.health.uptime) &&
+               batch_put_svarint(p_enc, (int32_t)(p_record->data.health.system_time - p_enc->base_time)) &&
+               batch_put_varint(p_enc, p_record->data.health.err_id) &&
+               batch_put_u8(p_enc, p_record->data.health.err_type);
+    case BLEAM_BATCH_REC_ERROR: {
+        uint8_t name_len = 0;
+        while (BLEAM_BATCH_FILE_NAME_SIZE > name_len && 0 != p_record->data.error.file_name[name_len]) {
+            ++name_len;
+        }
+        if (!batch_put_varint(p_enc, p_record->data.error.err_code) ||
+            !batch_put_varint(p_enc, p_record->data.error.line_num) ||
+            !batch_put_u8(p_enc, name_len)) {
+            return false;
+        }
+        for (uint8_t cnt = 0; name_len > cnt; ++cnt) {
+            if (!batch_put_u8(p_enc, p_record->data.error.file_name[cnt])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case BLEAM_BATCH_REC_ENERGY:
+        return batch_put_varint(p_enc, p_record->data.energy.scan_secs) &&
+               batch_put_varint(p_enc, p_record->data.energy.conn_secs) &&
+               batch_put_varint(p_enc, p_record->data.energy.sleep_secs) &&
+               batch_put_varint(p_enc, p_record->data.energy.charge_uah) &&
+               batch_put_varint(p_enc, p_record->data.energy.conn_cnt) &&
+               batch_put_varint(p_enc, p_record->data.energy.session_ms);
+    default:
+        return false;
+    }
+}
+
+bool bleam_batch_begin(bleam_batch_encoder_t * p_enc, uint8_t * p_buf, uint16_t max_len, bleam_batch_header_t const * p_header) {
+    p_enc->p_buf     = p_buf;
+    p_enc->max_len   = max_len;
+    p_enc->len       = 0;
+    p_enc->run_pos   = 0;
+    p_enc->run_rssi  = 0;
+    p_enc->run_age   = 0;
+    p_enc->base_time = p_header->base_time;
+    return batch_put_u8(p_enc, BLEAM_BATCH_FRAME_TAG) &&
+           batch_put_varint(p_enc, p_header->node_id) &&
+           batch_put_varint(p_enc, p_header->seq) &&
+           batch_put_varint(p_enc, p_header->base_time);
+}
+
+bool bleam_batch_add(bleam_batch_encoder_t * p_enc, bleam_batch_record_t const * p_record) {
+    const bleam_batch_encoder_t saved = *p_enc;
+    const uint8_t run_cnt = (0 != saved.run_pos) ? p_enc->p_buf[saved.run_pos] : 0;
+
+    const bool added = (BLEAM_BATCH_REC_RSSI == p_record->type) ? batch_put_rssi(p_enc, p_record)
+                                                                : batch_put_record(p_enc, p_record);
+    if (!added) {
+        // Roll back partially written record
+        *p_enc = saved;
+        if (0 != saved.run_pos) {
+            p_enc->p_buf[saved.run_pos] = run_cnt;
+        }
+    }
+    return added;
+}
+
+/********************************* DECODER ********************************/
+
+/**@brief Function for reading a byte from the frame.
+ *
+ * @returns True if the byte was read, false at the end of the frame.
+ */
+static bool batch_get_u8(bleam_batch_reader_t * p_reader, uint8_t * p_value) {
+    if (p_reader->pos >= p_reader->len) {
+        return false;
+    }
+    *p_value = p_reader->p_buf[p_reader->pos++];
+    return true;
+}
+
+/**@brief Function for reading an unsigned varint from the frame.
+ *
+ * @returns True if the value was read, false if it is truncated or too long.
+ */
+static bool batch_get_varint(bleam_batch_reader_t * p_reader, uint32_t * p_value) {
+    uint32_t value = 0;
+    for (uint8_t shift = 0; 32 > shift; shift += 7) {
+        uint8_t byte;
+        if (!batch_get_u8(p_reader, &byte)) {
+            return false;
+        }
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (0 == (byte & 0x80)) {
+            *p_value = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**@brief Function for reading a signed zigzag varint from the frame.
+ *
+ * @returns True if the value was read, false if it is truncated or too long.
+ */
+static bool batch_get_svarint(bleam_batch_reader_t * p_reader, int32_t * p_value) {
+    uint32_t value;
+    if (!batch_get_varint(p_reader, &value)) {
+        return false;
+    }
+    *p_value = (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+    return true;
+}
+
+/**@brief Function for decoding a record other than an RSSI run.
+ *
+ * @returns True if the record was decoded, false if it is malformed.
+ */
+static bool batch_get_record(bleam_batch_reader_t * p_reader, bleam_batch_header_t const * p_header, bleam_batch_record_t * p_record) {
+    uint32_t value[6];
+    int32_t  svalue[4];
+
+    switch (p_record->type) {
+    case BLEAM_BATCH_REC_SUMMARY:
+        if (!batch_get_varint(p_reader, &value[0]) ||
+            !batch_get_svarint(p_reader, &svalue[0]) ||
+            !batch_get_svarint(p_reader, &svalue[1]) ||
+            !batch_get_svarint(p_reader, &svalue[2]) ||
+            !batch_get_svarint(p_reader, &svalue[3]) ||
+            !batch_get_varint(p_reader, &value[1]) ||
+            !batch_get_varint(p_reader, &value[2])) {
+            return false;
+        }
+        p_record->data.summary.count    = value[0];
+        p_record->data.summary.mean     = svalue[0];
+        p_record->data.summary.min      = svalue[0] + svalue[1];
+        p_record->data.summary.max      = svalue[0] + svalue[2];
+        p_record->data.summary.median   = svalue[0] + svalue[3];
+        p_record->data.summary.variance = value[1];
+        p_record->data.summary.aoa      = value[2];
+        return true;
+    case BLEAM_BATCH_REC_HEALTH:
+        if (!batch_get_u8(p_reader, &p_record->data.health.battery_lvl) ||
+            !batch_get_varint(p_reader, &value[0]) ||
+            !batch_get_varint(p_reader, &value[1]) ||
+            !batch_get_svarint(p_reader, &svalue[0]) ||
+            !batch_get_varint(p_reader, &value[2]) ||
+            !batch_get_u8(p_reader, &p_record->data.health.err_type)) {
+            return false;
+        }
+        p_record->data.health.fw_id       = value[0];
+        p_record->data.health.uptime      = value[1];
+        p_record->data.health.system_time = p_header->base_time + svalue[0];
+        p_record->data.health.err_id      = value[2];
+        return true;
+    case BLEAM_BATCH_REC_ERROR: {
+        uint8_t name_len;
+        if (!batch_get_varint(p_reader, &value[0]) ||
+            !batch_get_varint(p_reader, &value[1]) ||
+            !batch_get_u8(p_reader, &name_len) ||
+            BLEAM_BATCH_FILE_NAME_SIZE < name_len) {
+            return false;
+        }
+        memset(p_record->data.error.file_name, 0, BLEAM_BATCH_FILE_NAME_SIZE);
+        for (uint8_t cnt = 0; name_len > cnt; ++cnt) {
+            if (!batch_get_u8(p_reader, &p_record->data.error.file_name[cnt])) {
+                return false;
+            }
+        }
+        p_record->data.error.err_code = value[0];
+        p_record->data.error.line_num = value[1];
+        return true;
+    }
+    case BLEAM_BATCH_REC_ENERGY:
+        value[5] = 0;
+        for (uint8_t cnt = 0; (3 <= p_reader->version ? 6 : 5) > cnt; ++cnt) {
+            if (!batch_get_varint(p_reader, &value[cnt])) {
+                return false;
+            }
+        }
+        p_record->data.energy.scan_secs  = value[0];
+        p_record->data.energy.conn_secs  = value[1];
+        p_record->data.energy.sleep_secs = value[2];
+        p_record->data.energy.charge_uah = value[3];
+        p_record->data.energy.conn_cnt   = value[4];
+        p_record->data.energy.session_ms = value[5];
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool bleam_batch_decode(uint8_t const * p_frame, uint16_t len, bleam_batch_header_t * p_header,
+                        bleam_batch_record_handler_t handler, void * p_context) {
+    bleam_batch_reader_t reader = {.p_buf = p_frame, .len = len, .pos = 0};
+    uint8_t  tag;
+    uint32_t value[3];
+
+    if (!batch_get_u8(&reader, &tag) || BLEAM_BATCH_TAG != (tag & 0xF0) ||
+        0 == (tag & 0x0F) || BLEAM_BATCH_VERSION < (tag & 0x0F) ||
+        !batch_get_varint(&reader, &value[0]) ||
+        !batch_get_varint(&reader, &value[1]) ||
+        !batch_get_varint(&reader, &value[2])) {
+        return false;
+    }
+    p_header->node_id   = value[0];
+    p_header->seq       = value[1];
+    p_header->base_time = value[2];
+    reader.version      = tag & 0x0F;
+
+    while (reader.pos < reader.len) {
+        bleam_batch_record_t record;
+        uint8_t type;
+        batch_get_u8(&reader, &type);
+        record.type = (bleam_batch_rec_type_t)type;
+
+        if (BLEAM_BATCH_REC_RSSI == record.type) {
+            uint8_t  run_cnt;
+            int32_t  rssi = 0;
+            uint32_t age  = 0;
+            if (!batch_get_u8(&reader, &run_cnt)) {
+                return false;
+            }
+            for (bool first = true; 0 < run_cnt; --run_cnt, first = false) {
+                int32_t  delta;
+                uint32_t aoa;
+                if (2 <= reader.version) {
+                    int32_t age_delta;
+                    if (first ? !batch_get_varint(&reader, &age) : !batch_get_svarint(&reader, &age_delta)) {
+                        return false;
+                    }
+                    if (!first) {
+                        age -= age_delta;
+                    }
+                }
+                if (!batch_get_svarint(&reader, &delta) || !batch_get_varint(&reader, &aoa)) {
+                    return false;
+                }
+                rssi += delta;
+                record.data.rssi.rssi   = rssi;
+                record.data.rssi.aoa    = aoa;
+                record.data.rssi.age_ms = age;
+                if (NULL != handler) {
+                    handler(p_header, &record, p_context);
+                }
+            }
+            continue;
+        }
+
+        if (!batch_get_record(&reader, p_header, &record)) {
+            return false;
+        }
+        if (NULL != handler) {
+            handler(p_header, &record, p_context);
+        }
+    }
+    return true;
+}
+
+/** @}*/
@@ -13,21 +13,28 @@
 
 /** RSSI data queue for BLEAM */
 bleam_service_rssi_data_t bleam_rssi_queue[BLEAM_QUEUE_SIZE];
+uint32_t bleam_rssi_queue_age[BLEAM_QUEUE_SIZE]; /**< Time since each RSSI in the queue was received, ms */
 uint16_t bleam_rssi_queue_front; /**< Index of the front element of the RSSI data queue */
 uint16_t bleam_rssi_queue_back;  /**< Index of the back element of the RSSI data queue */
+bleam_service_rssi_summary_t bleam_rssi_summary; /**< RSSI summary to send, msg_type 0 if none */
 
 /* Health data for BLEAM */
 bleam_service_health_general_data_t health_general_message; /**< General health status data message struct. */
 bleam_service_health_error_info_t   health_error_info;      /**< Detailed error info message struct. */
+bleam_service_health_energy_data_t  health_energy_message;  /**< Energy accounting message struct. */
+uint32_t health_energy_session_ms; /**< Duration of the latest finished connection, ms, for @ref bleam_batch frames only */
 
 bleam_service_client_t *m_bleam_service_client; /**< Pointer to BLEAM service client instance */
 uint16_t                m_bleam_send_char;      /**< Characteristic to write to */
 uint8_t                 m_data_index;           /**< Index inside data array */
 uint8_t                *m_signature;            /**< Pointer to array with signature to send */
+uint8_t                 m_tx_credits = APP_CONFIG_BLEAM_TX_QUEUE_SIZE; /**< Free slots in SoftDevice write command TX queue */
+bool                    m_tx_pumping;           /**< Flag that denotes that @ref bleam_send_pump() is running */
+bleam_batch_header_t    m_batch_header;         /**< Header of the next batch frame */
 
 /* Forward declarations */
-static void bleam_send_health(void);
-static void bleam_send_rssi(void);
+static bool bleam_send_health(void);
+static bool bleam_send_rssi(void);
 
 /**@brief Function for writing data to BLEAM.
  *
@@ -35,18 +42,29 @@ static void bleam_send_rssi(void);
  *          of size p_data_len over to bleam_service to be sent to BLEAM.
  *          Function should only be called after connection to BLEAM is established
  *          and the @ref m_bleam_send_char characteristic is discovered.
+ *          Every queued write takes one TX queue credit.
  *
- * @returns Nothing.
+ * @returns True if data was queued for sending, false otherwise.
  */
-static void bleam_send_write_data(uint8_t * p_data_array, uint16_t p_data_len) {
+static bool bleam_send_write_data(uint8_t * p_data_array, uint16_t p_data_len) {
     ret_code_t err_code = NRF_SUCCESS;
     if (0 == p_data_len) {
-        return;
+        return false;
     }
     err_code = bleam_service_data_send(m_bleam_service_client, p_data_array, &p_data_len, m_bleam_send_char);
+    if (NRF_ERROR_RESOURCES == err_code) {
+        // TX queue is full after all, wait for TX complete
+        m_tx_credits = 0;
+        return false;
+    }
     if (err_code != NRF_ERROR_INVALID_STATE) {
         APP_ERROR_CHECK(err_code);
     }
+    if (NRF_SUCCESS != err_code) {
+        return false;
+    }
+    --m_tx_credits;
+    return true;
 }
 
 /**************************** SEND SIGNATURE *****************************/
@@ -58,9 +76,9 @@ static void bleam_send_write_data(uint8_t * p_data_array, uint16_t p_data_len) {
  *          and packs it into an array.
  *          When the array is full, it calls @ref bleam_send_write_data() to write this data.
  *
- * @returns Nothing.
+ * @returns True if a packet was queued for sending, false otherwise.
  */
-static void bleam_send_signature(void) {
+static bool bleam_send_signature(void) {
     if(NRF_CRYPTO_HASH_SIZE_SHA256 <= m_data_index) {
         m_bleam_send_char = 0;
 //        __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLEAM signature send DONE\r\n");
@@ -68,20 +86,25 @@ static void bleam_send_signature(void) {
         bleam_service_client_evt_t evt;
         evt.evt_type = BLEAM_SERVICE_CLIENT_EVT_DONE_SENDING_SIGNATURE;
         m_bleam_service_client->evt_handler(m_bleam_service_client, &evt);
-        return;
+        return false;
     }
 
-    uint16_t data_size = BLEAM_MAX_DATA_LEN;
+    const uint16_t data_len = bleam_service_data_len_get();
+    uint16_t data_size = data_len;
     uint8_t data_array[BLEAM_MAX_DATA_LEN] = {0};
 
-    if(NRF_CRYPTO_HASH_SIZE_SHA256 > m_data_index + BLEAM_MAX_DATA_LEN)
-        data_size = BLEAM_MAX_DATA_LEN;
+    // With negotiated ATT MTU the whole signature fits into one write
+    if(NRF_CRYPTO_HASH_SIZE_SHA256 > m_data_index + data_len)
+        data_size = data_len;
     else
         data_size = NRF_CRYPTO_HASH_SIZE_SHA256 - m_data_index;
     memcpy(data_array, m_signature + m_data_index, data_size);
-    m_data_index = m_data_index + BLEAM_MAX_DATA_LEN;
 
-    bleam_send_write_data(data_array, data_size);
+    if(!bleam_send_write_data(data_array, data_size)) {
+        return false;
+    }
+    m_data_index = m_data_index + data_size;
+    return true;
 }
 
 /**@brief Function for sending salt to BLEAM via signature char.
@@ -91,63 +114,94 @@ static void bleam_send_signature(void) {
  *          and packs it into an array.
  *          When the array is full, it calls @ref bleam_send_write_data() to write this data.
  *
- * @returns Nothing.
+ * @returns True if a packet was queued for sending, false otherwise.
  */
-static void bleam_send_salt_as_signature(void) {
-    uint16_t data_size = BLEAM_MAX_DATA_LEN;
-    bleam_send_write_data(m_signature, data_size);
+static bool bleam_send_salt_as_signature(void) {
+    uint16_t data_size = BLEAM_SALT_DATA_LEN;
+    if(!bleam_send_write_data(m_signature, data_size)) {
+        return false;
+    }
+    // Salt is the whole message, next pass over signature reports it sent
+    m_data_index = NRF_CRYPTO_HASH_SIZE_SHA256;
+    return true;
 }
 
 /****************************** SEND HEALTH ******************************/
 
 /**@brief Function for assembling health data to send to BLEAM.
  *
- * @returns Nothing.
+ * @returns True if a packet was queued for sending, false otherwise.
  */
- static void bleam_send_health(void) {
-    if(0 == health_general_message.msg_type && 0 == health_error_info.msg_type) {
-        bleam_send_rssi();
-        return;
+ static bool bleam_send_health(void) {
+    if(0 == health_general_message.msg_type && 0 == health_error_info.msg_type && 0 == health_energy_message.msg_type) {
+        return bleam_send_rssi();
     }
 
-    uint8_t data_array[BLEAM_MAX_DATA_LEN] = {0};
+    uint8_t *p_message = NULL;
     uint16_t msg_len = 0;
 
     if(0 != health_general_message.msg_type) {
         msg_len = sizeof(bleam_service_health_general_data_t);
-        memcpy(data_array, (uint8_t *)(&health_general_message), msg_len);
-        memset(&health_general_message, 0, msg_len);
+        p_message = (uint8_t *)(&health_general_message);
     } else if (0 != health_error_info.msg_type) {
         msg_len = sizeof(bleam_service_health_error_info_t);
-        memcpy(data_array, (uint8_t *)(&health_error_info), msg_len);
-        memset(&health_error_info, 0, msg_len);
+        p_message = (uint8_t *)(&health_error_info);
+    } else if (0 != health_energy_message.msg_type) {
+        msg_len = sizeof(bleam_service_health_energy_data_t);
+        p_message = (uint8_t *)(&health_energy_message);
     }
 
+    uint8_t data_array[BLEAM_MAX_DATA_LEN] = {0};
+    memcpy(data_array, p_message, msg_len);
+
     m_bleam_send_char = BLEAM_S_HEALTH;
-    bleam_send_write_data(data_array, msg_len);
+    if(!bleam_send_write_data(data_array, msg_len)) {
+        return false;
+    }
+    memset(p_message, 0, msg_len);
+    return true;
 }
 
 /******************************* SEND RSSI *******************************/
 
 /**@brief Function for assembling RSSI data to send to BLEAM.
  *
- * @returns Nothing.
+ * @details When there is no more data to send, BLEAM service is notified
+ *          once every queued write has been transmitted.
+ *
+ * @returns True if a packet was queued for sending, false otherwise.
  */
-static void bleam_send_rssi(void) {
-    uint8_t rssi_in_msg = BLEAM_MAX_RSSI_PER_MSG;
+static bool bleam_send_rssi(void) {
+    if(0 != bleam_rssi_summary.msg_type) {
+        uint8_t data_array[sizeof(bleam_service_rssi_summary_t)];
+        memcpy(data_array, (uint8_t *)(&bleam_rssi_summary), sizeof(bleam_service_rssi_summary_t));
+        m_bleam_send_char = BLEAM_S_RSSI;
+        if(!bleam_send_write_data(data_array, sizeof(bleam_service_rssi_summary_t))) {
+            return false;
+        }
+        memset(&bleam_rssi_summary, 0, sizeof(bleam_service_rssi_summary_t));
+        return true;
+    }
+
+    const uint16_t rssi_per_msg = bleam_service_data_len_get() / sizeof(bleam_service_rssi_data_t);
+    uint16_t rssi_in_msg = rssi_per_msg;
     if(bleam_rssi_queue_back == bleam_rssi_queue_front) {
+        // Wait for data already queued to get on air
+        if(APP_CONFIG_BLEAM_TX_QUEUE_SIZE > m_tx_credits) {
+            return false;
+        }
         bleam_rssi_queue_back = bleam_rssi_queue_front = 0;
         m_bleam_send_char = 0;
 
         bleam_service_client_evt_t evt;
         evt.evt_type = BLEAM_SERVICE_CLIENT_EVT_DONE_SENDING;
         m_bleam_service_client->evt_handler(m_bleam_service_client, &evt);
-        return;
+        return false;
     } else if(bleam_rssi_queue_back > bleam_rssi_queue_front &&
-            bleam_rssi_queue_back - bleam_rssi_queue_front < BLEAM_MAX_RSSI_PER_MSG) {
+            bleam_rssi_queue_back - bleam_rssi_queue_front < rssi_per_msg) {
         rssi_in_msg = bleam_rssi_queue_back - bleam_rssi_queue_front;
     } else if(bleam_rssi_queue_back < bleam_rssi_queue_front &&
-            BLEAM_QUEUE_SIZE - bleam_rssi_queue_front < BLEAM_MAX_RSSI_PER_MSG) {
+            BLEAM_QUEUE_SIZE - bleam_rssi_queue_front < rssi_per_msg) {
         rssi_in_msg = BLEAM_QUEUE_SIZE - bleam_rssi_queue_front;
     }
     
@@ -156,9 +210,157 @@ static void bleam_send_rssi(void) {
     memcpy(data_array, (uint8_t *)(bleam_rssi_queue + bleam_rssi_queue_front), msg_len);
 
     m_bleam_send_char = BLEAM_S_RSSI;
-    bleam_send_write_data(data_array, msg_len);
+    if(!bleam_send_write_data(data_array, msg_len)) {
+        return false;
+    }
     bleam_rssi_queue_front += rssi_in_msg;
     bleam_rssi_queue_front %= BLEAM_QUEUE_SIZE;
+    return true;
+}
+
+#if APP_CONFIG_BATCH_FRAME_ENABLED
+/******************************* SEND BATCH ******************************/
+
+/**@brief Function for assembling health and RSSI data into a batch frame to send to BLEAM.
+ *
+ * @details Packs as many pending messages as fit into a single write.
+ *          Messages are only removed from the queues once the frame is queued for sending.
+ *          If a message does not fit even into an empty frame, it is sent as a separate message.
+ *
+ * @returns True if a packet was queued for sending, false otherwise.
+ */
+static bool bleam_send_batch(void) {
+    if(0 == health_general_message.msg_type && 0 == health_error_info.msg_type && 0 == health_energy_message.msg_type &&
+       0 == bleam_rssi_summary.msg_type && bleam_rssi_queue_back == bleam_rssi_queue_front) {
+        // Nothing left, finish as usual
+        return bleam_send_rssi();
+    }
+
+    uint8_t data_array[BLEAM_MAX_DATA_LEN] = {0};
+    bleam_batch_encoder_t enc;
+    bleam_batch_record_t record;
+    bool general_added = false, error_added = false, energy_added = false, summary_added = false;
+    uint16_t rssi_added = 0;
+
+    if(!bleam_batch_begin(&enc, data_array, bleam_service_data_len_get(), &m_batch_header)) {
+        return bleam_send_health();
+    }
+
+    if(0 != health_general_message.msg_type) {
+        record.type                    = BLEAM_BATCH_REC_HEALTH;
+        record.data.health.battery_lvl = health_general_message.battery_lvl;
+        record.data.health.fw_id       = health_general_message.fw_id;
+        record.data.health.uptime      = health_general_message.uptime;
+        record.data.health.system_time = health_general_message.system_time;
+        record.data.health.err_id      = health_general_message.err_id;
+        record.data.health.err_type    = health_general_message.err_type;
+        general_added = bleam_batch_add(&enc, &record);
+    }
+    if(0 != health_error_info.msg_type) {
+        record.type                = BLEAM_BATCH_REC_ERROR;
+        record.data.error.err_code = health_error_info.err_code;
+        record.data.error.line_num = health_error_info.line_num;
+        memcpy(record.data.error.file_name, health_error_info.file_name, BLEAM_BATCH_FILE_NAME_SIZE);
+        error_added = bleam_batch_add(&enc, &record);
+    }
+    if(0 != health_energy_message.msg_type) {
+        record.type                   = BLEAM_BATCH_REC_ENERGY;
+        record.data.energy.scan_secs  = health_energy_message.scan_secs;
+        record.data.energy.conn_secs  = health_energy_message.conn_secs;
+        record.data.energy.sleep_secs = health_energy_message.sleep_secs;
+        record.data.energy.charge_uah = health_energy_message.charge_uah;
+        record.data.energy.conn_cnt   = health_energy_message.conn_cnt;
+        record.data.energy.session_ms = health_energy_session_ms;
+        energy_added = bleam_batch_add(&enc, &record);
+    }
+    if(0 != bleam_rssi_summary.msg_type) {
+        record.type                  = BLEAM_BATCH_REC_SUMMARY;
+        record.data.summary.count    = bleam_rssi_summary.count;
+        record.data.summary.min      = bleam_rssi_summary.min;
+        record.data.summary.max      = bleam_rssi_summary.max;
+        record.data.summary.mean     = bleam_rssi_summary.mean;
+        record.data.summary.median   = bleam_rssi_summary.median;
+        record.data.summary.variance = bleam_rssi_summary.variance;
+        record.data.summary.aoa      = bleam_rssi_summary.aoa;
+        summary_added = bleam_batch_add(&enc, &record);
+    }
+    for(uint16_t index = bleam_rssi_queue_front; bleam_rssi_queue_back != index; index = (index + 1) % BLEAM_QUEUE_SIZE) {
+        record.type           = BLEAM_BATCH_REC_RSSI;
+        record.data.rssi.rssi = bleam_rssi_queue[index].rssi;
+        record.data.rssi.aoa  = bleam_rssi_queue[index].aoa;
+        record.data.rssi.age_ms = bleam_rssi_queue_age[index];
+        if(!bleam_batch_add(&enc, &record)) {
+            break;
+        }
+        ++rssi_added;
+    }
+
+    if(!general_added && !error_added && !energy_added && !summary_added && 0 == rssi_added) {
+        return bleam_send_health();
+    }
+
+    m_bleam_send_char = BLEAM_S_RSSI;
+    if(!bleam_send_write_data(data_array, enc.len)) {
+        return false;
+    }
+    ++m_batch_header.seq;
+    if(general_added) {
+        memset(&health_general_message, 0, sizeof(bleam_service_health_general_data_t));
+    }
+    if(error_added) {
+        memset(&health_error_info, 0, sizeof(bleam_service_health_error_info_t));
+    }
+    if(energy_added) {
+        memset(&health_energy_message, 0, sizeof(bleam_service_health_energy_data_t));
+    }
+    if(summary_added) {
+        memset(&bleam_rssi_summary, 0, sizeof(bleam_service_rssi_summary_t));
+    }
+    bleam_rssi_queue_front = (bleam_rssi_queue_front + rssi_added) % BLEAM_QUEUE_SIZE;
+    return true;
+}
+#endif // APP_CONFIG_BATCH_FRAME_ENABLED
+
+/**@brief Function for queueing writes to BLEAM while there is data and TX queue credit.
+ *
+ * @details Keeps SoftDevice write command TX queue full, so that several packets
+ *          go on air in a single connection event.
+ *          Data added from BLEAM service event handlers while pumping
+ *          is picked up by the same pass.
+ *
+ * @returns Nothing.
+ */
+static void bleam_send_pump(void) {
+    if(m_tx_pumping) {
+        return;
+    }
+    m_tx_pumping = true;
+    // If sending signature, finish with signature.
+    // Otherwise send all the health first, then RSSI
+    while(0 != m_bleam_send_char && 0 < m_tx_credits && NULL != m_bleam_service_client) {
+        const uint16_t send_char = m_bleam_send_char;
+#if APP_CONFIG_BATCH_FRAME_ENABLED
+        const bool queued = (BLEAM_S_SIGN == send_char) ? bleam_send_signature() : bleam_send_batch();
+#else
+        const bool queued = (BLEAM_S_SIGN == send_char) ? bleam_send_signature() : bleam_send_health();
+#endif
+        // Nothing was queued and the phase is the same, wait for TX complete
+        if(!queued && send_char == m_bleam_send_char) {
+            break;
+        }
+    }
+    m_tx_pumping = false;
+}
+
+/**@brief Function for starting to send health and RSSI data added to the queues.
+ *
+ * @returns Nothing.
+ */
+static void bleam_send_kick(void) {
+    if(0 == m_bleam_send_char && NULL != m_bleam_service_client) {
+        m_bleam_send_char = BLEAM_S_HEALTH;
+        bleam_send_pump();
+    }
 }
 
 /********************************** INTERFACE *********************************/
@@ -168,7 +370,7 @@ void bleam_send_init(bleam_service_client_t *p_bleam_service_client, uint8_t *p_
     m_data_index             = 0;
     m_signature              = p_signature;
     m_bleam_send_char        = BLEAM_S_SIGN;
-    bleam_send_signature();
+    bleam_send_pump();
 }
 
 void bleam_send_salt(bleam_service_client_t *p_bleam_service_client, uint8_t *p_salt) {
@@ -182,35 +384,42 @@ void bleam_send_uninit(void) {
     m_bleam_service_client   = NULL;
     m_signature              = NULL;
     m_bleam_send_char        = 0;
+    m_tx_credits             = APP_CONFIG_BLEAM_TX_QUEUE_SIZE;
+    m_tx_pumping             = false;
     bleam_rssi_queue_front   = 0;
     bleam_rssi_queue_back    = 0;
+    memset(&bleam_rssi_summary, 0, sizeof(bleam_service_rssi_summary_t));
 }
 
-void bleam_send_continue(void) {
-    // If sending signature, finish with signature.
-    // Otherwise send all the health first, then RSSI
-    switch (m_bleam_send_char) {
-    case BLEAM_S_SIGN:
-        bleam_send_signature(); 
-        break;
-    case 0:
-        m_bleam_send_char = BLEAM_S_HEALTH;
-    default:
-        bleam_send_health();
-        break;
-    }
+void bleam_send_batch_header_set(uint16_t node_id, uint32_t base_time) {
+    m_batch_header.node_id   = node_id;
+    m_batch_header.base_time = base_time;
+}
+
+uint16_t bleam_send_char_get(void) {
+    return m_bleam_send_char;
 }
 
-void bleam_rssi_queue_add(uint16_t sender_id, int8_t rssi, uint8_t aoa) {
+void bleam_send_continue(uint8_t tx_count) {
+    m_tx_credits = MIN(m_tx_credits + tx_count, APP_CONFIG_BLEAM_TX_QUEUE_SIZE);
+    bleam_send_pump();
+}
+
+void bleam_rssi_queue_add(uint16_t sender_id, int8_t rssi, uint8_t aoa, uint32_t age_ms) {
     bleam_rssi_queue[bleam_rssi_queue_back].sender_id = sender_id;
     bleam_rssi_queue[bleam_rssi_queue_back].rssi = rssi;
     bleam_rssi_queue[bleam_rssi_queue_back].aoa = aoa;
+    bleam_rssi_queue_age[bleam_rssi_queue_back] = age_ms;
     bleam_rssi_queue_back = (bleam_rssi_queue_back + 1) % BLEAM_QUEUE_SIZE;
     if(bleam_rssi_queue_back == bleam_rssi_queue_front)
         bleam_rssi_queue_front = (bleam_rssi_queue_front + 1) % BLEAM_QUEUE_SIZE;
-    if(0 == m_bleam_send_char && NULL != m_bleam_service_client) {
-        bleam_send_continue();
-    }
+    bleam_send_kick();
+}
+
+void bleam_rssi_summary_add(bleam_service_rssi_summary_t const * p_summary) {
+    memcpy(&bleam_rssi_summary, p_summary, sizeof(bleam_service_rssi_summary_t));
+    bleam_rssi_summary.msg_type = 0x01;
+    bleam_send_kick();
 }
 
 void bleam_health_queue_add(uint8_t battery_lvl, uint32_t uptime, uint32_t system_time) {
@@ -235,9 +444,20 @@ void bleam_health_queue_add(uint8_t battery_lvl, uint32_t uptime, uint32_t syste
         health_error_info.msg_type = 0x00;
     }
 
-    if(0 == m_bleam_send_char && NULL != m_bleam_service_client) {
-        bleam_send_continue();
-    }
+    bleam_send_kick();
+}
+
+void bleam_health_energy_queue_add(blesc_energy_report_t const * p_report) {
+    health_energy_message.msg_type   = 0x03;
+    health_energy_message.scan_secs  = p_report->scan_secs;
+    health_energy_message.conn_secs  = p_report->conn_secs;
+    health_energy_message.sleep_secs = p_report->sleep_secs;
+    health_energy_message.charge_uah = p_report->charge_uah;
+    health_energy_message.conn_cnt   = p_report->conn_cnt;
+    health_energy_message.session_ds = MIN(p_report->session_ms / 100, UINT8_MAX);
+    health_energy_session_ms         = p_report->session_ms;
+
+    bleam_send_kick();
 }
 
 /** @}*/
\ No newline at end of file
@@ -13,6 +13,7 @@
 
 static bool bleam_service_client_initialized = false; /**< Flag denoting whether BLEAM service was initialized or not. */
 static bleam_service_client_mode_type_t m_bleam_service_mode = BLEAM_SERVICE_CLIENT_MODE_NONE; /**< BLEAM Service mode of BLEAM interation. */
+static uint16_t m_bleam_data_len = BLEAM_DEFAULT_DATA_LEN; /**< Maximum length of data in a single write with negotiated ATT MTU. */
 
 /**@brief Function for handling the Disconnect event.
  *
@@ -35,6 +36,7 @@ static void on_disconnect(bleam_service_client_t *p_bleam_service_client, ble_ev
     }
 
     p_bleam_service_client->conn_handle = BLE_CONN_HANDLE_INVALID;
+    m_bleam_data_len = BLEAM_DEFAULT_DATA_LEN;
 
     bleam_service_client_evt_t evt;
 
@@ -258,7 +260,7 @@ uint32_t bleam_service_data_send(bleam_service_client_t *p_bleam_service_client,
     if (p_bleam_service_client == NULL)
         return NRF_ERROR_NULL;
 
-    if (*data_size > BLEAM_MAX_DATA_LEN) {
+    if (*data_size > m_bleam_data_len) {
         //__LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Content too long.\r\n");
         return NRF_ERROR_INVALID_PARAM;
     }
@@ -301,4 +303,12 @@ void bleam_service_mode_set(bleam_service_client_mode_type_t p_mode) {
     m_bleam_service_mode = p_mode;
 }
 
+uint16_t bleam_service_data_len_get(void) {
+    return m_bleam_data_len;
+}
+
+void bleam_service_data_len_set(uint16_t data_len) {
+    m_bleam_data_len = MIN(data_len, BLEAM_MAX_DATA_LEN);
+}
+
 /** @}*/
\ No newline at end of file
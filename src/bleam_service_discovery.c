@@ -5,47 +5,139 @@
  * @ingroup bleam_connect
  *
  * @brief Custom service discovery handler
+ *
+ * @details BLEAM service on iOS has a 128-bit UUID with a base unknown to the SoftDevice,
+ *          so it can't be found with UUID filtered discovery. Primary services are
+ *          enumerated instead, and declarations of services with unknown UUIDs
+ *          are read in batches with Read Multiple requests until the service is found.
  */
 
 #include "bleam_service_discovery.h"
 #include "log.h"
 #include "sdk_common.h"
 #include "app_error.h"
+#include "app_timer.h"
+#include "blesc_wakeup.h"
 
-#define BLE_GATTC_HANDLE_START 0x0001 /**< Default start GATTC handle value */
-#define BLE_GATTC_HANDLE_END   0xFFFF /**< Default end GATTC handle value */
+#define BLE_GATTC_HANDLE_START     0x0001 /**< Default start GATTC handle value */
+#define BLE_GATTC_HANDLE_END       0xFFFF /**< Default end GATTC handle value */
+#define DISCOVERY_CANDIDATES_MAX   16     /**< Maximum number of services with unknown 128-bit UUID to read per discovery response */
+#define DISCOVERY_UUID128_LEN      16     /**< Length of 128-bit UUID as read from service declaration */
 
 static bleam_service_discovery_evt_handler_t m_evt_handler = NULL; /**< External custom service discovery event handler */
 
-static uint16_t                 service_uuid_to_find; /**< 12th and 13th octets of the service UUID being discovered. */
-static ble_gattc_handle_range_t handle_range;         /**< Range of service handles to look the service within. */
-static bool                     m_discovery_started;  /**< Flag denoting whether this service discovery has been started. */
-static bool                     service_found;        /**< Flag denoting whether the service was discovered successfully. */
+static uint16_t service_uuid_to_find; /**< 12th and 13th octets of the service UUID being discovered. */
+static uint16_t m_next_start_handle;  /**< Handle to continue primary service discovery from, @ref BLE_GATTC_HANDLE_START if the whole range is discovered. */
+static bool     m_discovery_started;  /**< Flag denoting whether this service discovery has been started. */
+
+static uint16_t m_candidates[DISCOVERY_CANDIDATES_MAX]; /**< Declaration handles of services that may be the one being discovered. */
+static uint16_t m_candidates_cnt;                       /**< Number of handles in @ref m_candidates. */
+static uint16_t m_candidates_pos;                       /**< Index of the first unread handle in @ref m_candidates. */
+static uint16_t m_reading_cnt;                          /**< Number of handles in the read in progress. */
+static bool     m_read_multiple = true;                 /**< Flag denoting whether peer accepts Read Multiple requests. */
+static uint16_t m_att_mtu = BLE_GATT_ATT_MTU_DEFAULT;   /**< ATT MTU of the connection. */
+
+static uint64_t                        m_start_tick; /**< Timestamp of discovery start. */
+static bleam_service_discovery_stats_t m_stats;      /**< Statistics of the latest discovery attempt. */
 
 static uint16_t m_central_conn_handle = BLE_CONN_HANDLE_INVALID; /**< Connection handle */
 
-/**@brief Function for handling this custom service discovery.
+/**@brief Function for finishing discovery and notifying the application.
+ *
+ * @param[in] evt_type     Type of event to send.
+ * @param[in] p_uuid128    Pointer to 128-bit UUID of the found service, NULL if not found.
  *
  * @returns Nothing.
  */
-static void continue_discovery(void) {
-    // Go to next handle.
-    handle_range.start_handle++;
-    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Scan continues.\r\n");
+static void discovery_finish(bleam_service_discovery_evt_type_t evt_type, uint8_t const * p_uuid128) {
+    m_discovery_started = false;
+    m_stats.duration_ms = (blesc_wakeup_ticks_get() - m_start_tick) * 1000 / APP_TIMER_TICKS(1000);
 
-    // Discover next primary Service.
-    ret_code_t err_code = sd_ble_gattc_primary_services_discover(m_central_conn_handle, handle_range.start_handle, NULL);
-    if (NRF_ERROR_BUSY != err_code && NRF_SUCCESS != err_code) {
-        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "sd_ble_gattc_primary_services_discover returned error code 0x%04X\r\n", err_code);
-        m_discovery_started = false;
-        bleam_service_discovery_evt_t evt = {0};
+    bleam_service_discovery_evt_t evt = {0};
+    evt.evt_type = evt_type;
+    evt.conn_handle = m_central_conn_handle;
+    if (NULL != p_uuid128) {
+        evt.params.err_code = NRF_SUCCESS;
+        memcpy(evt.params.srv_uuid128.uuid128, p_uuid128, DISCOVERY_UUID128_LEN);
+        evt.params.srv_uuid16.uuid = service_uuid_to_find;
+    } else {
         evt.params.err_code = NRF_ERROR_NOT_FOUND;
-        evt.evt_type = BLEAM_SERVICE_DISCOVERY_ERROR;
-        evt.conn_handle = m_central_conn_handle;
-        m_evt_handler(&evt);
+    }
+    m_evt_handler(&evt);
+}
+
+/**@brief Function for discovering primary services starting from a handle.
+ *
+ * @param[in] start_handle    Handle to start discovery from.
+ *
+ * @returns Nothing.
+ */
+static void discover_from(uint16_t start_handle) {
+    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Discovering services from 0x%04X.\r\n", start_handle);
+    ++m_stats.round_trips;
+    ret_code_t err_code = sd_ble_gattc_primary_services_discover(m_central_conn_handle, start_handle, NULL);
+    if (NRF_SUCCESS != err_code) {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "sd_ble_gattc_primary_services_discover returned error code 0x%04X\r\n", err_code);
+        discovery_finish(BLEAM_SERVICE_DISCOVERY_ERROR, NULL);
+    }
+}
+
+/**@brief Function for reading declarations of the next candidate services.
+ *
+ * @details As many 128-bit UUIDs as fit into ATT MTU are read with one Read Multiple request.
+ *          If peer does not support it, declarations are read one by one.
+ *
+ * @returns Nothing.
+ */
+static void read_candidates(void) {
+    ret_code_t err_code;
+    const uint16_t per_read = m_read_multiple ? MAX((m_att_mtu - 1) / DISCOVERY_UUID128_LEN, 1) : 1;
+    m_reading_cnt = MIN(m_candidates_cnt - m_candidates_pos, per_read);
+
+    ++m_stats.round_trips;
+    ++m_stats.reads;
+    if (1 == m_reading_cnt) {
+        err_code = sd_ble_gattc_read(m_central_conn_handle, m_candidates[m_candidates_pos], 0);
+    } else {
+        err_code = sd_ble_gattc_read_multiple(m_central_conn_handle, &m_candidates[m_candidates_pos], m_reading_cnt);
+    }
+    if (NRF_SUCCESS != err_code) {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Reading service declarations returned error code 0x%04X\r\n", err_code);
+        discovery_finish(BLEAM_SERVICE_DISCOVERY_ERROR, NULL);
     }
 }
 
+/**@brief Function for continuing discovery after a read of candidate services.
+ *
+ * @returns Nothing.
+ */
+static void continue_discovery(void) {
+    m_candidates_pos += m_reading_cnt;
+    m_reading_cnt = 0;
+    if (m_candidates_pos < m_candidates_cnt) {
+        read_candidates();
+        return;
+    }
+    m_candidates_cnt = m_candidates_pos = 0;
+    if (BLE_GATTC_HANDLE_START != m_next_start_handle) {
+        discover_from(m_next_start_handle);
+    } else {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Service not found.\r\n");
+        discovery_finish(BLEAM_SERVICE_DISCOVERY_SRV_NOT_FOUND, NULL);
+    }
+}
+
+/**@brief Function for checking whether a 128-bit UUID is the one of the service being discovered.
+ *
+ * @param[in] p_uuid128    Pointer to 128-bit UUID, little endian.
+ *
+ * @returns True if it is the service being discovered, false otherwise.
+ */
+static bool uuid_matches(uint8_t const * p_uuid128) {
+    __LOG_XB(LOG_SRC_APP, LOG_LEVEL_DBG2, "128-bit UUID value\r\n", p_uuid128, DISCOVERY_UUID128_LEN);
+    return p_uuid128[13] == ((service_uuid_to_find >> 8) & 0x00FF) && p_uuid128[12] == (service_uuid_to_find & 0x00FF);
+}
+
 /**@brief Function for handling this custom service discovery.
  *
  * @param[in]     p_db_discovery     Pointer to the DB discovery event data.
@@ -54,57 +146,43 @@ static void continue_discovery(void) {
  * @returns Nothing.
  */
 static void on_primary_srv_discovery_rsp(ble_db_discovery_t *p_db_discovery, ble_gattc_evt_t const *p_ble_gattc_evt) {
-    uint32_t err_code = NRF_ERROR_NOT_FOUND;
-    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Services found = %i\r\n", p_ble_gattc_evt->params.prim_srvc_disc_rsp.count);
-    if (p_ble_gattc_evt->gatt_status != BLE_GATT_STATUS_SUCCESS) {
+    const uint16_t count = p_ble_gattc_evt->params.prim_srvc_disc_rsp.count;
+    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Services found = %i\r\n", count);
+    if (p_ble_gattc_evt->gatt_status != BLE_GATT_STATUS_SUCCESS || 0 == count) {
         __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "sd_ble_gattc_primary_services_discover returned gatt_status 0x%04X\r\n", p_ble_gattc_evt->gatt_status);
-        m_discovery_started = false;
-        bleam_service_discovery_evt_t evt = {0};
-        evt.params.err_code = NRF_ERROR_NOT_FOUND;
-        evt.evt_type = BLEAM_SERVICE_DISCOVERY_SRV_NOT_FOUND;
-        evt.conn_handle = m_central_conn_handle;
-        m_evt_handler(&evt);
+        discovery_finish(BLEAM_SERVICE_DISCOVERY_SRV_NOT_FOUND, NULL);
         return;
     }
+    m_stats.services += count;
+
     // Go through all Services.
-    for (uint16_t index = 0; index < p_ble_gattc_evt->params.prim_srvc_disc_rsp.count; index++) {
+    m_candidates_cnt = m_candidates_pos = 0;
+    for (uint16_t index = 0; index < count; index++) {
         const ble_gattc_service_t * service = &p_ble_gattc_evt->params.prim_srvc_disc_rsp.services[index];
-        // Log handle ranges for future use (in case this is our Service and we need to discover subsequent Characteristics).
-        handle_range.start_handle = service->handle_range.start_handle;
-        handle_range.end_handle = service->handle_range.end_handle;
         // We are interested only in one specific Service with 128-bit proprietary UUID
         // (assuming that we have only one such 128-bit UUID base registered in SoftDevice through "sd_ble_uuid_vs_add" call!).
         if (((service->uuid.uuid == service_uuid_to_find) && (service->uuid.type == BLE_UUID_TYPE_VENDOR_BEGIN)) ||
             (service->uuid.type == BLE_UUID_TYPE_UNKNOWN)) {
-            // This may be the service we're looking for
-            err_code = sd_ble_gattc_read(m_central_conn_handle, service->handle_range.start_handle, 0);
-            if (err_code != NRF_SUCCESS) {
-                __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "sd_ble_gattc_read returned error code 0x%04X\r\n", err_code);
-                return;
-            }            
+            // This may be the service we're looking for, read its declaration for full UUID
+            if (DISCOVERY_CANDIDATES_MAX > m_candidates_cnt) {
+                m_candidates[m_candidates_cnt++] = service->handle_range.start_handle;
+            }
         } else {
             __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Ignored Service index = %d, UUID = 0x%04X, UUID type = %d\r\n", index,
                 service->uuid.uuid,
                 service->uuid.type);
         }
     }
-    // If My Service not found => jump to next handle range.
-    if (!service_found) {
-        handle_range.start_handle = handle_range.end_handle;
-        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Scanned handle range ends at 0x%04X.\r\n", handle_range.start_handle);
-        if (handle_range.start_handle != BLE_GATTC_HANDLE_END) {
-            continue_discovery();
-        } else {
-            m_discovery_started = false;
-            // Service not found
-            __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Service not found.\r\n", handle_range.start_handle);
-            bleam_service_discovery_evt_t evt = {0};
-            evt.params.err_code = NRF_ERROR_NOT_FOUND;
-            evt.evt_type = BLEAM_SERVICE_DISCOVERY_SRV_NOT_FOUND;
-            evt.conn_handle = m_central_conn_handle;
-            m_evt_handler(&evt);
-            return;
-        }
+
+    // Continue after the last service of the response, unless it ends the handle range
+    const uint16_t end_handle = p_ble_gattc_evt->params.prim_srvc_disc_rsp.services[count - 1].handle_range.end_handle;
+    m_next_start_handle = (BLE_GATTC_HANDLE_END == end_handle) ? BLE_GATTC_HANDLE_START : end_handle + 1;
+    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Scanned handle range ends at 0x%04X.\r\n", end_handle);
+
+    if (0 != m_candidates_cnt) {
+        read_candidates();
+    } else {
+        continue_discovery();
     }
 }
 
@@ -115,38 +193,47 @@ static void on_primary_srv_discovery_rsp(ble_db_discovery_t *p_db_discovery, ble
  * @returns Nothing.
  */
 static void on_gattc_read_response(ble_gattc_evt_t const *p_ble_gattc_evt) {
-    uint32_t err_code = NRF_ERROR_NOT_FOUND;
     // Response should contain full 128-bit UUID.
     uint8_t *rsp_data = (uint8_t *)p_ble_gattc_evt->params.read_rsp.data;
     uint8_t rsp_data_len = p_ble_gattc_evt->params.read_rsp.len;
-    if (rsp_data_len == 16) {
+    if (BLE_GATT_STATUS_SUCCESS == p_ble_gattc_evt->gatt_status && DISCOVERY_UUID128_LEN == rsp_data_len) {
         __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Custom Primary Service with 128-bit UUID found.\r\n");
-        __LOG_XB(LOG_SRC_APP, LOG_LEVEL_DBG2, "128-bit UUID value\r\n", rsp_data, 16);
-        // Check if it is BLEAM service
-        if (rsp_data[13] == ((service_uuid_to_find >> 8) & 0x00FF) && rsp_data[12] == (service_uuid_to_find & 0x00FF)) {
-            // My Service found.
-            __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "My Service found, UUID = 0x%04X, handle = 0x%04X\r\n",
-                (uint16_t)(rsp_data[12] + 256 * rsp_data[13]),
-                handle_range.start_handle);
-            service_found = true;
-            m_discovery_started = false;
-
-            // save UUID of this device
-            bleam_service_discovery_evt_t evt = {0};
-            evt.params.err_code = NRF_SUCCESS;
-            memcpy(evt.params.srv_uuid128.uuid128, rsp_data, 16);
-            evt.params.srv_uuid16.uuid = service_uuid_to_find;
-            evt.evt_type = BLEAM_SERVICE_DISCOVERY_COMPLETE;
-            evt.conn_handle = m_central_conn_handle;
-            m_evt_handler(&evt);
+        if (uuid_matches(rsp_data)) {
+            __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "My Service found, handle = 0x%04X\r\n", p_ble_gattc_evt->params.read_rsp.handle);
+            discovery_finish(BLEAM_SERVICE_DISCOVERY_COMPLETE, rsp_data);
             return;
-        } else {
-            continue_discovery();
         }
     } else {
         __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Ignored Service, BLE_GATTC_EVT_READ_RSP len = %d\r\n", rsp_data_len);
-        continue_discovery();
     }
+    continue_discovery();
+}
+
+/**@brief Function for handling the GATTC read multiple request response.
+ *
+ * @param[in]     p_ble_gattc_evt    Pointer to the GATTC event data.
+ *
+ * @returns Nothing.
+ */
+static void on_gattc_read_multiple_response(ble_gattc_evt_t const *p_ble_gattc_evt) {
+    const uint16_t rsp_data_len = p_ble_gattc_evt->params.char_vals_read_rsp.len;
+    if (BLE_GATT_STATUS_SUCCESS != p_ble_gattc_evt->gatt_status || m_reading_cnt * DISCOVERY_UUID128_LEN != rsp_data_len) {
+        // Peer can't do it, read one by one
+        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Read Multiple failed, gatt_status 0x%04X, len = %d\r\n", p_ble_gattc_evt->gatt_status, rsp_data_len);
+        m_read_multiple = false;
+        m_reading_cnt = 0;
+        read_candidates();
+        return;
+    }
+    for (uint16_t index = 0; m_reading_cnt > index; ++index) {
+        uint8_t const * p_uuid128 = p_ble_gattc_evt->params.char_vals_read_rsp.values + index * DISCOVERY_UUID128_LEN;
+        if (uuid_matches(p_uuid128)) {
+            __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "My Service found, handle = 0x%04X\r\n", m_candidates[m_candidates_pos + index]);
+            discovery_finish(BLEAM_SERVICE_DISCOVERY_COMPLETE, p_uuid128);
+            return;
+        }
+    }
+    continue_discovery();
 }
 
 void bleam_service_discovery_start(ble_db_discovery_t *const p_db_discovery, uint16_t conn_handle) {
@@ -154,19 +241,28 @@ void bleam_service_discovery_start(ble_db_discovery_t *const p_db_discovery, uin
 
     m_central_conn_handle = conn_handle;
 
-    // Initiate discovery procedure ("tree-like" graph).
-    handle_range.start_handle = BLE_GATTC_HANDLE_START;
-    handle_range.end_handle = BLE_GATTC_HANDLE_END;
     m_discovery_started = true;
-    service_found = false;
+    m_candidates_cnt = m_candidates_pos = 0;
+    m_reading_cnt = 0;
+    m_read_multiple = true;
+    m_att_mtu = BLE_GATT_ATT_MTU_DEFAULT;
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_start_tick = blesc_wakeup_ticks_get();
 
-    // Discover next primary Service.
-    ret_code_t err_code = sd_ble_gattc_primary_services_discover(m_central_conn_handle, handle_range.start_handle, NULL);
-    if (err_code != NRF_SUCCESS) {
-        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "sd_ble_gattc_primary_services_discover returned error code 0x%04X\r\n", err_code);
+    // Discover first primary Services.
+    discover_from(BLE_GATTC_HANDLE_START);
+}
+
+void bleam_service_discovery_att_mtu_set(uint16_t conn_handle, uint16_t att_mtu) {
+    if (conn_handle == m_central_conn_handle) {
+        m_att_mtu = att_mtu;
     }
 }
 
+void bleam_service_discovery_stats_get(bleam_service_discovery_stats_t * p_stats) {
+    *p_stats = m_stats;
+}
+
 void bleam_service_discovery_on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context) {
     VERIFY_PARAM_NOT_NULL_VOID(p_ble_evt);
     VERIFY_PARAM_NOT_NULL_VOID(p_context);
@@ -182,6 +278,9 @@ void bleam_service_discovery_on_ble_evt(ble_evt_t const *p_ble_evt, void *p_cont
     case BLE_GATTC_EVT_READ_RSP:
         on_gattc_read_response(&(p_ble_evt->evt.gattc_evt));
         break;
+    case BLE_GATTC_EVT_CHAR_VALS_READ_RSP:
+        on_gattc_read_multiple_response(&(p_ble_evt->evt.gattc_evt));
+        break;
     }
 }
 
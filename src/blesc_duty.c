@@ -0,0 +1,74 @@
+/** @file blesc_duty.c
+ *
+ * @defgroup blesc_duty Adaptive duty cycle
+ * @{
+ * @ingroup bleam_time
+ *
+ * @brief Choice of scan period from BLEAM activity learned per time of day.
+ *
+ * @details Each hour of the day keeps an exponentially weighted rate of scans
+ *          that detected a BLEAM. Busy hours get the shortest period, quiet hours
+ *          the longest one, within bounds set in @ref global_app_config.
+ */
+
+#include "blesc_duty.h"
+#include "global_app_config.h"
+#include "sdk_common.h"
+
+#define DUTY_BUCKET_SECS (24 * 60 * 60 / BLESC_DUTY_BUCKETS) /**< Length of a time of day bucket, seconds */
+
+STATIC_ASSERT(0 < APP_CONFIG_DUTY_PERIODS_MIN && APP_CONFIG_DUTY_PERIODS_MIN < APP_CONFIG_DUTY_PERIODS_MAX);
+
+static uint16_t m_rate[BLESC_DUTY_BUCKETS]; /**< BLEAM hit rate of each time of day bucket */
+
+/**@brief Function for finding the time of day bucket.
+ *
+ * @param[in] system_time    System time in seconds passed since midnight.
+ *
+ * @returns Bucket index.
+ */
+static uint8_t duty_bucket(uint32_t system_time) {
+    return (system_time / DUTY_BUCKET_SECS) % BLESC_DUTY_BUCKETS;
+}
+
+/**@brief Function for converting a number of periods to the hit rate that results in it.
+ *
+ * @param[in] periods    Number of @ref BLESC_TIME_PERIOD_SECS in scan period.
+ *
+ * @returns Hit rate.
+ */
+static uint16_t duty_rate_from_periods(uint32_t periods) {
+    return (uint32_t)BLESC_DUTY_RATE_ONE * (APP_CONFIG_DUTY_PERIODS_MAX - periods)
+           / (APP_CONFIG_DUTY_PERIODS_MAX - APP_CONFIG_DUTY_PERIODS_MIN);
+}
+
+void blesc_duty_init(void) {
+    for (uint8_t bucket = 0; BLESC_DUTY_BUCKETS > bucket; ++bucket) {
+        const uint32_t start = bucket * DUTY_BUCKET_SECS;
+        const bool night = (BLESC_NIGHTTIME_START <= start && BLESC_DAYTIME_START > start);
+        m_rate[bucket] = duty_rate_from_periods(night ? BLESC_TIME_PERIODS_NIGHT : BLESC_TIME_PERIODS_DAY);
+    }
+}
+
+void blesc_duty_outcome(uint32_t system_time, bool bleam_nearby) {
+    uint16_t * p_rate = &m_rate[duty_bucket(system_time)];
+    if (bleam_nearby) {
+        *p_rate += (BLESC_DUTY_RATE_ONE - *p_rate) >> APP_CONFIG_DUTY_HIT_SHIFT;
+    } else {
+        // Round up, so that rate of a quiet bucket decays all the way to zero
+        *p_rate -= (*p_rate + (1 << APP_CONFIG_DUTY_MISS_SHIFT) - 1) >> APP_CONFIG_DUTY_MISS_SHIFT;
+    }
+}
+
+uint32_t blesc_duty_period_get(uint32_t system_time) {
+    const uint32_t range = APP_CONFIG_DUTY_PERIODS_MAX - APP_CONFIG_DUTY_PERIODS_MIN;
+    const uint32_t periods = APP_CONFIG_DUTY_PERIODS_MAX
+                             - (range * m_rate[duty_bucket(system_time)] + BLESC_DUTY_RATE_ONE / 2) / BLESC_DUTY_RATE_ONE;
+    return periods * BLESC_TIME_PERIOD_SECS;
+}
+
+uint16_t blesc_duty_rate_get(uint32_t system_time) {
+    return m_rate[duty_bucket(system_time)];
+}
+
+/** @}*/
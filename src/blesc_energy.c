@@ -0,0 +1,163 @@
+/** @file blesc_energy.c
+ *
+ * @defgroup blesc_energy Energy accounting
+ * @{
+ * @ingroup blesc_app
+ *
+ * @brief Accounting of time spent in each node state and estimation of drawn charge.
+ *
+ * @details Time between two accounted events is attributed to everything that was
+ *          active during it: current node state, scanner, connection, CPU sleep.
+ *          Charge is estimated from the same time using a current model set
+ *          in @ref global_app_config.
+ */
+
+#include "blesc_energy.h"
+#include "global_app_config.h"
+#include "app_timer.h"
+#include "blesc_wakeup.h"
+#include "app_util_platform.h"
+#include "sdk_common.h"
+
+#define ENERGY_TICKS_PER_SEC APP_TIMER_TICKS(1000) /**< RTC ticks in a second */
+
+static uint64_t m_state_ticks[BLESC_ENERGY_STATE_CNT]; /**< Time spent in each node state, ticks */
+static uint64_t m_scan_ticks;                          /**< Time spent with scanner running, ticks */
+static uint64_t m_conn_ticks;                          /**< Time spent in connections, ticks */
+static uint64_t m_sleep_ticks;                         /**< Time CPU spent sleeping, ticks */
+static uint64_t m_charge;                              /**< Estimated drawn charge, microampere-ticks */
+static uint16_t m_conn_cnt;                            /**< Number of connections */
+static uint64_t m_conn_start;                          /**< Clock value at the start of current connection, ticks */
+static uint32_t m_session_ms;                          /**< Duration of the latest finished connection, ms */
+
+static uint64_t m_last_tick;     /**< Clock value at the latest accounted event, ticks */
+static uint8_t  m_state;         /**< Current node state */
+static bool     m_scanning;      /**< Flag that denotes that scanner is running */
+static bool     m_connected;     /**< Flag that denotes that a connection is up */
+static bool     m_sleeping;      /**< Flag that denotes that CPU is sleeping */
+static uint32_t m_scan_rx_ua;    /**< Average radio current while scanning, uA */
+
+/**@brief Function for attributing time since the latest accounted event.
+ *
+ * @details Must be called from a critical region, together with
+ *          whatever reads or changes accounting state after it.
+ *
+ * @returns Nothing.
+ */
+static void energy_advance(void) {
+    const uint64_t now = blesc_wakeup_ticks_get();
+    const uint64_t ticks = now - m_last_tick;
+    m_last_tick = now;
+
+    uint32_t current_ua = m_sleeping ? APP_CONFIG_ENERGY_SLEEP_UA : APP_CONFIG_ENERGY_CPU_UA;
+    if (BLESC_ENERGY_STATE_CNT > m_state) {
+        m_state_ticks[m_state] += ticks;
+    }
+    if (m_sleeping) {
+        m_sleep_ticks += ticks;
+    }
+    if (m_scanning) {
+        m_scan_ticks += ticks;
+        current_ua += m_scan_rx_ua;
+    }
+    if (m_connected) {
+        m_conn_ticks += ticks;
+        current_ua += APP_CONFIG_ENERGY_CONN_UA;
+    }
+    m_charge += (uint64_t)ticks * current_ua;
+}
+
+void blesc_energy_init(uint8_t state) {
+    memset(m_state_ticks, 0, sizeof(m_state_ticks));
+    m_scan_ticks  = 0;
+    m_conn_ticks  = 0;
+    m_sleep_ticks = 0;
+    m_charge      = 0;
+    m_conn_cnt    = 0;
+    m_session_ms  = 0;
+    m_scanning    = false;
+    m_connected   = false;
+    m_sleeping    = false;
+    m_state       = state;
+    m_last_tick   = blesc_wakeup_ticks_get();
+}
+
+void blesc_energy_state_set(uint8_t state) {
+    CRITICAL_REGION_ENTER();
+    energy_advance();
+    m_state = state;
+    CRITICAL_REGION_EXIT();
+}
+
+void blesc_energy_scan_start(uint16_t window, uint16_t interval) {
+    CRITICAL_REGION_ENTER();
+    energy_advance();
+    m_scanning = true;
+    // Radio only listens during scan window
+    m_scan_rx_ua = (0 == interval) ? APP_CONFIG_ENERGY_RX_UA
+                                   : (uint32_t)APP_CONFIG_ENERGY_RX_UA * window / interval;
+    CRITICAL_REGION_EXIT();
+}
+
+void blesc_energy_scan_stop(void) {
+    CRITICAL_REGION_ENTER();
+    energy_advance();
+    m_scanning = false;
+    CRITICAL_REGION_EXIT();
+}
+
+void blesc_energy_conn_set(bool connected) {
+    CRITICAL_REGION_ENTER();
+    energy_advance();
+    if (connected && !m_connected) {
+        ++m_conn_cnt;
+        m_conn_start = m_last_tick;
+    } else if (!connected && m_connected) {
+        m_session_ms = (m_last_tick - m_conn_start) * 1000 / ENERGY_TICKS_PER_SEC;
+    }
+    m_connected = connected;
+    CRITICAL_REGION_EXIT();
+}
+
+void blesc_energy_sleep_set(bool sleeping) {
+    CRITICAL_REGION_ENTER();
+    energy_advance();
+    m_sleeping = sleeping;
+    CRITICAL_REGION_EXIT();
+}
+
+void blesc_energy_update(void) {
+    CRITICAL_REGION_ENTER();
+    energy_advance();
+    CRITICAL_REGION_EXIT();
+}
+
+void blesc_energy_report_get(blesc_energy_report_t * p_report) {
+    uint64_t state_ticks[BLESC_ENERGY_STATE_CNT];
+    uint64_t scan_ticks;
+    uint64_t conn_ticks;
+    uint64_t sleep_ticks;
+    uint64_t charge;
+
+    // 64-bit counters are not updated atomically, copy them in one go
+    CRITICAL_REGION_ENTER();
+    energy_advance();
+    memcpy(state_ticks, m_state_ticks, sizeof(state_ticks));
+    scan_ticks           = m_scan_ticks;
+    conn_ticks           = m_conn_ticks;
+    sleep_ticks          = m_sleep_ticks;
+    charge               = m_charge;
+    p_report->conn_cnt   = m_conn_cnt;
+    p_report->session_ms = m_session_ms;
+    CRITICAL_REGION_EXIT();
+
+    for (uint8_t state = 0; BLESC_ENERGY_STATE_CNT > state; ++state) {
+        p_report->state_secs[state] = state_ticks[state] / ENERGY_TICKS_PER_SEC;
+    }
+    p_report->scan_secs  = scan_ticks / ENERGY_TICKS_PER_SEC;
+    p_report->conn_secs  = conn_ticks / ENERGY_TICKS_PER_SEC;
+    p_report->sleep_secs = sleep_ticks / ENERGY_TICKS_PER_SEC;
+    p_report->charge_uah = charge / ((uint64_t)ENERGY_TICKS_PER_SEC * 3600);
+}
+
+/** @}*/
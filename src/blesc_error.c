@@ -6,6 +6,7 @@
 
 #include "app_error.h"
 #include "blesc_error.h"
+#include "blesc_rng.h"
 #include "app_config.h"
 
 #include "log.h"
@@ -26,6 +27,8 @@ blesc_retained_error_t blesc_error __attribute__((section(".retained_section")))
 
 /** Buffer for random error ID generation. */
 static uint8_t m_rng_buff[2] = {0xDE, 0xAD};
+/** Flag that denotes that error data was reset on boot before random ID was available. */
+static bool m_random_id_pending = false;
 
 /**@brief Function for saving error data to retained BLEAM Scanner error variable
  *
@@ -116,9 +119,8 @@ static void blesc_error_log(void) {
 
 void blesc_error_on_boot(void) {
     // If no error data retained, set it to hard reset
-    ret_code_t err_code = NRF_SUCCESS;
-    err_code = sd_rand_application_vector_get(m_rng_buff, 2);
-    APP_ERROR_CHECK(err_code);
+    // Random bytes may not be ready yet right after SoftDevice start, ID is then set later
+    bool rng_ready = blesc_rng_pool_get(m_rng_buff, 2);
     uint32_t gpregret_flag = 0;
     sd_power_gpregret_get(0, &gpregret_flag);
     if(gpregret_flag != BLESC_GPREGRET_RETAINED_VALUE) {
@@ -126,6 +128,7 @@ void blesc_error_on_boot(void) {
         sd_power_gpregret_set(0, BLESC_GPREGRET_RETAINED_VALUE);
         memset(&blesc_error, 0, sizeof(blesc_retained_error_t));
         memcpy(&blesc_error.random_id, m_rng_buff, 2);
+        m_random_id_pending = !rng_ready;
     } else if(BLESC_ERR_T_HARD_RESET == blesc_error.error_type) {
         blesc_error.error_type = BLESC_ERR_T_SOFT_RESET;
     }
@@ -133,6 +136,10 @@ void blesc_error_on_boot(void) {
 }
 
 blesc_retained_error_t blesc_error_get(void) {
+    if (m_random_id_pending && blesc_rng_pool_get(m_rng_buff, 2)) {
+        memcpy(&blesc_error.random_id, m_rng_buff, 2);
+        m_random_id_pending = false;
+    }
     return blesc_error;
 }
 
@@ -0,0 +1,74 @@
+/** @file blesc_rng.c
+ *
+ * @defgroup blesc_rng Random number pool
+ * @{
+ * @ingroup blesc_app
+ *
+ * @brief Pool of random bytes for salts and error IDs.
+ *
+ * @details Random bytes are collected from SoftDevice when CPU is idle,
+ *          so that signing salts and error IDs never wait for the RNG peripheral.
+ */
+
+#include "blesc_rng.h"
+#include "global_app_config.h"
+#include "app_util_platform.h"
+#include "sdk_common.h"
+#include "nrf_soc.h"
+
+STATIC_ASSERT(APP_CONFIG_RNG_POOL_SIZE <= UINT8_MAX);
+
+static uint8_t m_pool[APP_CONFIG_RNG_POOL_SIZE]; /**< Random bytes, valid ones are at the start */
+static uint8_t m_pool_len;                       /**< Number of random bytes in the pool */
+
+/**@brief Function for moving available SoftDevice random bytes into the pool.
+ *
+ * @details Must be called in critical region.
+ *
+ * @returns Nothing.
+ */
+static void pool_fill(void) {
+    uint8_t available = 0;
+    if (NRF_SUCCESS != sd_rand_application_bytes_available_get(&available)) {
+        return;
+    }
+    uint8_t len = APP_CONFIG_RNG_POOL_SIZE - m_pool_len;
+    if (available < len) {
+        len = available;
+    }
+    if (0 < len && NRF_SUCCESS == sd_rand_application_vector_get(m_pool + m_pool_len, len)) {
+        m_pool_len += len;
+    }
+}
+
+void blesc_rng_pool_fill(void) {
+    if (APP_CONFIG_RNG_POOL_SIZE == m_pool_len) {
+        return;
+    }
+    CRITICAL_REGION_ENTER();
+    pool_fill();
+    CRITICAL_REGION_EXIT();
+}
+
+bool blesc_rng_pool_get(uint8_t * p_buf, uint8_t len) {
+    bool result = false;
+    CRITICAL_REGION_ENTER();
+    if (m_pool_len < len) {
+        pool_fill();
+    }
+    if (m_pool_len >= len) {
+        // Take bytes from the end, so the rest stays in place
+        m_pool_len -= len;
+        memcpy(p_buf, m_pool + m_pool_len, len);
+        memset(m_pool + m_pool_len, 0, len);
+        result = true;
+    }
+    CRITICAL_REGION_EXIT();
+    return result;
+}
+
+uint8_t blesc_rng_pool_level(void) {
+    return m_pool_len;
+}
+
+/** @}*/
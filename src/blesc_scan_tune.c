@@ -0,0 +1,86 @@
+/** @file blesc_scan_tune.c
+ *
+ * @defgroup blesc_scan_tune Adaptive scan window
+ * @{
+ * @ingroup bleam_scan
+ *
+ * @brief Choice of scan window within a wakeup from arrival of BLEAM and Apple reports.
+ *
+ * @details Scan interval stays the same and only the window changes, so the radio
+ *          duty cycle goes from 20% to continuous. A report of interest opens the
+ *          widest window, every step without reports narrows it by one level.
+ */
+
+#include "blesc_scan_tune.h"
+#include "blesc_duty.h"
+#include "global_app_config.h"
+#include "sdk_common.h"
+#include "log.h"
+
+#define SCAN_TUNE_INTERVAL 0x00A0 /**< Scan interval of all levels in units of 0.625 ms, 100 ms */
+
+/** Scan window of each level in units of 0.625 ms. */
+static const uint16_t m_windows[BLESC_SCAN_TUNE_LEVELS] = {
+    0x0020, // 20 ms
+    0x0030, // 30 ms
+    0x0050, // 50 ms
+    0x00A0, // 100 ms, continuous
+};
+
+STATIC_ASSERT(BLESC_SCAN_TUNE_STATIC < BLESC_SCAN_TUNE_LEVELS);
+
+static uint8_t  m_level;   /**< Current level */
+static uint16_t m_reports; /**< Reports of interest since the previous step */
+static bool     m_active;  /**< Flag that denotes that scanner is running */
+static bool     m_changed; /**< Flag that denotes that level changed since it was last applied */
+
+void blesc_scan_tune_start(uint16_t hit_rate) {
+    const uint32_t level = ((uint32_t)hit_rate * (BLESC_SCAN_TUNE_LEVELS - 1) + BLESC_DUTY_RATE_ONE / 2) / BLESC_DUTY_RATE_ONE;
+    m_level   = MIN(level, BLESC_SCAN_TUNE_STATIC);
+    m_reports = 0;
+    m_active  = true;
+    m_changed = false;
+}
+
+void blesc_scan_tune_stop(void) {
+    m_active  = false;
+    m_changed = false;
+}
+
+void blesc_scan_tune_report(void) {
+    if (!m_active) {
+        return;
+    }
+    ++m_reports;
+    if (BLESC_SCAN_TUNE_LEVELS - 1 != m_level) {
+        m_level = BLESC_SCAN_TUNE_LEVELS - 1;
+        m_changed = true;
+    }
+}
+
+void blesc_scan_tune_step(void) {
+    if (!m_active) {
+        return;
+    }
+    if (0 == m_reports && 0 < m_level) {
+        --m_level;
+        m_changed = true;
+    }
+    m_reports = 0;
+}
+
+bool blesc_scan_tune_changed(void) {
+    const bool changed = m_active && m_changed;
+    m_changed = false;
+    return changed;
+}
+
+uint16_t blesc_scan_tune_window_get(void) {
+    return m_windows[m_level];
+}
+
+uint16_t blesc_scan_tune_interval_get(void) {
+    return SCAN_TUNE_INTERVAL;
+}
+
+/** @}*/
@@ -0,0 +1,97 @@
+/** @file blesc_time_sync.c
+ *
+ * @defgroup blesc_time_sync Time sync
+ * @{
+ * @ingroup bleam_time
+ *
+ * @brief Drift compensated system time and its uncertainty.
+ *
+ * @details Every BLEAM time sample is compared with the time predicted for it,
+ *          and the error over time since the previous sample corrects the RTC drift estimate.
+ *          Uncertainty grows from the read error with the remaining drift error,
+ *          so time is read from BLEAM only once it may be off by more than
+ *          @ref APP_CONFIG_TIME_SYNC_MAX_ERROR_MS.
+ */
+
+#include "blesc_time_sync.h"
+#include "global_app_config.h"
+#include "sdk_common.h"
+
+#define TIME_SYNC_HALF_DAY_MS ((int32_t)(BLESC_TIME_SYNC_DAY_MS / 2)) /**< Largest time error that is not a day wrap, ms */
+
+STATIC_ASSERT(APP_CONFIG_TIME_SYNC_READ_ERROR_MS < APP_CONFIG_TIME_SYNC_MAX_ERROR_MS);
+STATIC_ASSERT(APP_CONFIG_TIME_SYNC_RESIDUAL_PPM <= APP_CONFIG_TIME_SYNC_CLOCK_PPM);
+
+static uint64_t m_ref_uptime;   /**< Node uptime at the reference sample, ms */
+static uint32_t m_ref_time;     /**< Time at the reference sample in milliseconds passed since midnight */
+static int32_t  m_drift_ppm;    /**< Estimated RTC drift, ppm */
+static uint32_t m_drift_err;    /**< Maximum expected error of drift estimate, ppm */
+static bool     m_synced;       /**< Flag that denotes that time has been received from BLEAM */
+
+/**@brief Function for getting time passed since the reference sample, corrected for drift.
+ *
+ * @param[in] uptime_ms    Node uptime, ms.
+ *
+ * @returns Corrected time since the reference sample, ms.
+ */
+static uint64_t time_sync_elapsed(uint64_t uptime_ms) {
+    const uint64_t elapsed = uptime_ms - m_ref_uptime;
+    // Drift is bounded well under one, so the result stays positive
+    return elapsed + (int64_t)elapsed * m_drift_ppm / BLESC_TIME_SYNC_PPM_ONE;
+}
+
+void blesc_time_sync_init(uint32_t time_ms) {
+    m_ref_uptime = 0;
+    m_ref_time   = time_ms % BLESC_TIME_SYNC_DAY_MS;
+    m_drift_ppm  = 0;
+    m_drift_err  = APP_CONFIG_TIME_SYNC_CLOCK_PPM;
+    m_synced     = false;
+}
+
+void blesc_time_sync_sample(uint64_t uptime_ms, uint32_t bleam_ms) {
+    bleam_ms %= BLESC_TIME_SYNC_DAY_MS;
+    const uint64_t elapsed = uptime_ms - m_ref_uptime;
+    // Short spans are dominated by read error, long ones may hide a day wrap
+    if (m_synced && APP_CONFIG_TIME_SYNC_MIN_SPAN_MS <= elapsed && TIME_SYNC_HALF_DAY_MS > elapsed) {
+        int32_t error = (int32_t)bleam_ms - (int32_t)blesc_time_sync_time_get(uptime_ms);
+        if (TIME_SYNC_HALF_DAY_MS < error) {
+            error -= 2 * TIME_SYNC_HALF_DAY_MS;
+        } else if (-TIME_SYNC_HALF_DAY_MS > error) {
+            error += 2 * TIME_SYNC_HALF_DAY_MS;
+        }
+        const int32_t residual = (int64_t)error * BLESC_TIME_SYNC_PPM_ONE / (int64_t)elapsed;
+        const uint32_t residual_abs = (0 > residual) ? -residual : residual;
+
+        m_drift_ppm += residual / (1 << APP_CONFIG_TIME_SYNC_GAIN_SHIFT);
+        m_drift_ppm = MIN(m_drift_ppm, APP_CONFIG_TIME_SYNC_CLOCK_PPM);
+        m_drift_ppm = MAX(m_drift_ppm, -APP_CONFIG_TIME_SYNC_CLOCK_PPM);
+        // Error estimate follows measured residuals, never trusting the estimate beyond the floor
+        m_drift_err = (m_drift_err + MIN(residual_abs, APP_CONFIG_TIME_SYNC_CLOCK_PPM)) / 2;
+        m_drift_err = MAX(m_drift_err, APP_CONFIG_TIME_SYNC_RESIDUAL_PPM);
+    }
+    m_ref_uptime = uptime_ms;
+    m_ref_time   = bleam_ms;
+    m_synced     = true;
+}
+
+uint32_t blesc_time_sync_time_get(uint64_t uptime_ms) {
+    return (m_ref_time + time_sync_elapsed(uptime_ms)) % BLESC_TIME_SYNC_DAY_MS;
+}
+
+uint32_t blesc_time_sync_uncertainty_get(uint64_t uptime_ms) {
+    if (!m_synced) {
+        return UINT32_MAX;
+    }
+    const uint64_t drift_ms = (uptime_ms - m_ref_uptime) * m_drift_err / BLESC_TIME_SYNC_PPM_ONE;
+    return APP_CONFIG_TIME_SYNC_READ_ERROR_MS + MIN(drift_ms, UINT32_MAX - APP_CONFIG_TIME_SYNC_READ_ERROR_MS);
+}
+
+bool blesc_time_sync_needed(uint64_t uptime_ms) {
+    return APP_CONFIG_TIME_SYNC_MAX_ERROR_MS < blesc_time_sync_uncertainty_get(uptime_ms);
+}
+
+int32_t blesc_time_sync_drift_get(void) {
+    return m_drift_ppm;
+}
+
+/** @}*/
@@ -0,0 +1,226 @@
+/** @file blesc_wakeup.c
+ *
+ * @defgroup blesc_wakeup Wakeup planner
+ * @{
+ * @ingroup blesc_app
+ *
+ * @brief Application timers multiplexed on a single app_timer instance.
+ *
+ * @details The instance is always set to the earliest deadline, so only one RTC compare
+ *          is in use. On every wakeup all timers whose deadline is within their
+ *          tolerance expire together, so that loose deadlines ride on the
+ *          wakeups of exact ones instead of fragmenting sleep.
+ */
+
+#include "blesc_wakeup.h"
+#include "app_timer.h"
+#include "app_error.h"
+#include "app_util_platform.h"
+#include "sdk_common.h"
+#include "log.h"
+
+#define WAKEUP_MAX_SLEEP  (APP_TIMER_MAX_CNT_VAL / 2) /**< Longest sleep, keeps the counter from wrapping between reads */
+#define WAKEUP_HOUR_TICKS ((uint64_t)APP_TIMER_TICKS(1000) * 60 * 60) /**< RTC ticks in an hour */
+#define WAKEUP_IDLE       UINT64_MAX                  /**< Programmed deadline while app_timer instance is not running */
+
+/**@brief Planner timer. */
+typedef struct {
+    blesc_wakeup_handler_t handler;   /**< Timeout handler, NULL if the slot is free */
+    void *                 p_context; /**< Context to pass to the handler */
+    uint64_t               deadline;  /**< Expiry time, RTC ticks since boot */
+    uint32_t               period;    /**< Timeout of repeated timer, 0 for single shot */
+    uint32_t               tolerance; /**< How early the timer may expire, RTC ticks */
+    blesc_wakeup_mode_t    mode;      /**< Timer mode */
+    bool                   active;    /**< Flag that denotes that the timer is running */
+} wakeup_timer_t;
+
+APP_TIMER_DEF(m_wakeup_timer_id);                        /**< The only app_timer instance of the planner */
+static wakeup_timer_t m_timers[BLESC_WAKEUP_MAX_TIMERS]; /**< Planner timers */
+static uint8_t  m_timer_cnt;                             /**< Number of created timers */
+static bool     m_dispatching;                           /**< Flag that denotes that timeout handlers are being called */
+static uint64_t m_programmed;                            /**< Deadline app_timer instance is set to, @ref WAKEUP_IDLE if not running */
+
+static uint64_t m_ticks;         /**< RTC ticks since boot */
+static uint32_t m_last_cnt;      /**< RTC counter value at the latest @ref m_ticks update */
+
+static uint64_t m_hour_start;    /**< Start of the current wakeup accounting hour, RTC ticks */
+static uint32_t m_hour_wakeups;  /**< Wakeups in the current hour */
+static uint32_t m_last_wakeups;  /**< Wakeups in the latest full hour */
+
+/**@brief Function for reading the RTC counter.
+ *
+ * @details This is the only place the application reads the RTC counter,
+ *          everything else gets time from @ref blesc_wakeup_ticks_get.
+ *          A host build can replace it with a virtual clock.
+ *
+ * @returns RTC counter value.
+ */
+static uint32_t wakeup_rtc_cnt_get(void) {
+    return app_timer_cnt_get();
+}
+
+/**@brief Function for setting the app_timer instance to the earliest deadline.
+ *
+ * @details The instance is only reprogrammed if the earliest deadline is before
+ *          the programmed one. A later deadline keeps the programmed wakeup,
+ *          which then finds nothing due and reschedules, so starting and stopping
+ *          timers does not fill app_timer operation queue.
+ *
+ * @returns Nothing.
+ */
+static void wakeup_schedule(void) {
+    if (m_dispatching) {
+        return; // Done once all handlers are called
+    }
+    CRITICAL_REGION_ENTER();
+    const uint64_t now = blesc_wakeup_ticks_get();
+    uint64_t next = now + WAKEUP_MAX_SLEEP;
+    for (uint8_t i = 0; m_timer_cnt > i; ++i) {
+        if (m_timers[i].active) {
+            next = MIN(next, m_timers[i].deadline);
+        }
+    }
+    if (next < m_programmed) {
+        ret_code_t err_code;
+        if (WAKEUP_IDLE != m_programmed) {
+            err_code = app_timer_stop(m_wakeup_timer_id);
+            APP_ERROR_CHECK(err_code);
+        }
+        uint32_t timeout = (next > now) ? next - now : 0;
+        timeout = MAX(timeout, APP_TIMER_MIN_TIMEOUT_TICKS);
+        err_code = app_timer_start(m_wakeup_timer_id, timeout, NULL);
+        APP_ERROR_CHECK(err_code);
+        m_programmed = now + timeout;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+/**@brief Function for accounting a wakeup.
+ *
+ * @param[in] now    Current time, RTC ticks since boot.
+ *
+ * @returns Nothing.
+ */
+static void wakeup_account(uint64_t now) {
+    ++m_hour_wakeups;
+    if (WAKEUP_HOUR_TICKS <= now - m_hour_start) {
+        m_last_wakeups = m_hour_wakeups;
+        m_hour_wakeups = 0;
+        m_hour_start = now;
+        __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Wakeups in the latest hour: %u\r\n", m_last_wakeups);
+    }
+}
+
+/**@brief Function for handling the app_timer instance timeout.
+ *
+ * @details Calls handlers of all timers due now or within their tolerance.
+ *
+ * @param[in] p_context   Unused.
+ *
+ * @returns Nothing.
+ */
+static void wakeup_timer_handler(void * p_context) {
+    UNUSED_PARAMETER(p_context);
+    m_dispatching = true;
+    m_programmed = WAKEUP_IDLE; // Single shot instance is not running any more
+    const uint64_t now = blesc_wakeup_ticks_get();
+    wakeup_account(now);
+
+    for (uint8_t i = 0; m_timer_cnt > i; ++i) {
+        wakeup_timer_t * p_timer = &m_timers[i];
+        bool expired = false;
+        CRITICAL_REGION_ENTER();
+        if (p_timer->active && p_timer->deadline <= now + p_timer->tolerance) {
+            expired = true;
+            if (BLESC_WAKEUP_MODE_REPEATED == p_timer->mode) {
+                // Period counts from the deadline, so expiring early does not shift the timer
+                p_timer->deadline += p_timer->period;
+                if (p_timer->deadline <= now) {
+                    // Missed periods are skipped, not made up with a burst of expiries
+                    p_timer->deadline += ((now - p_timer->deadline) / p_timer->period + 1) * p_timer->period;
+                }
+            } else {
+                p_timer->active = false;
+            }
+        }
+        CRITICAL_REGION_EXIT();
+        // Handler may restart or stop any timer, including this one
+        if (expired) {
+            p_timer->handler(p_timer->p_context);
+        }
+    }
+
+    m_dispatching = false;
+    wakeup_schedule();
+}
+
+ret_code_t blesc_wakeup_init(void) {
+    memset(m_timers, 0, sizeof(m_timers));
+    m_timer_cnt    = 0;
+    m_dispatching  = false;
+    m_programmed   = WAKEUP_IDLE;
+    m_ticks        = 0;
+    m_last_cnt     = wakeup_rtc_cnt_get();
+    m_hour_start   = 0;
+    m_hour_wakeups = 0;
+    m_last_wakeups = 0;
+    ret_code_t err_code = app_timer_create(&m_wakeup_timer_id, APP_TIMER_MODE_SINGLE_SHOT, wakeup_timer_handler);
+    VERIFY_SUCCESS(err_code);
+    wakeup_schedule();
+    return NRF_SUCCESS;
+}
+
+ret_code_t blesc_wakeup_create(blesc_wakeup_id_t * p_id, blesc_wakeup_mode_t mode, uint32_t tolerance, blesc_wakeup_handler_t handler) {
+    VERIFY_PARAM_NOT_NULL(handler);
+    if (BLESC_WAKEUP_MAX_TIMERS <= m_timer_cnt) {
+        return NRF_ERROR_NO_MEM;
+    }
+    wakeup_timer_t * p_timer = &m_timers[m_timer_cnt];
+    p_timer->handler   = handler;
+    p_timer->mode      = mode;
+    p_timer->tolerance = tolerance;
+    p_timer->active    = false;
+    *p_id = m_timer_cnt++;
+    return NRF_SUCCESS;
+}
+
+ret_code_t blesc_wakeup_start(blesc_wakeup_id_t id, uint32_t timeout, void * p_context) {
+    if (m_timer_cnt <= id || 0 == timeout) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    CRITICAL_REGION_ENTER();
+    wakeup_timer_t * p_timer = &m_timers[id];
+    p_timer->p_context = p_context;
+    p_timer->period    = timeout;
+    p_timer->deadline  = blesc_wakeup_ticks_get() + timeout;
+    p_timer->active    = true;
+    CRITICAL_REGION_EXIT();
+    wakeup_schedule();
+    return NRF_SUCCESS;
+}
+
+ret_code_t blesc_wakeup_stop(blesc_wakeup_id_t id) {
+    if (m_timer_cnt <= id) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    m_timers[id].active = false;
+    // Programmed wakeup is kept, if this timer was the earliest it finds nothing due
+    return NRF_SUCCESS;
+}
+
+uint64_t blesc_wakeup_ticks_get(void) {
+    uint64_t ticks;
+    CRITICAL_REGION_ENTER();
+    const uint32_t cnt = wakeup_rtc_cnt_get();
+    m_ticks += app_timer_cnt_diff_compute(cnt, m_last_cnt);
+    m_last_cnt = cnt;
+    ticks = m_ticks;
+    CRITICAL_REGION_EXIT();
+    return ticks;
+}
+
+uint32_t blesc_wakeup_hourly_get(void) {
+    return m_last_wakeups;
+}
+
+/** @}*/
@@ -9,18 +9,19 @@
 /**@addtogroup bleam_time
  * @{
  */
-static uint32_t m_system_time;          /**< BLEAM Scanner system time in seconds passed since midnight */
-static uint32_t m_blesc_uptime;         /**< Node uptime in minutes since last boot */
 static uint32_t m_blesc_time_period;    /**< Scan period: maximum between scans */
-static bool m_system_time_needs_update; /**< Flag that denoted that system time needs to be updated */
 /** @} end of bleam_time */
 
+STATIC_ASSERT(WDT_CONFIG_RELOAD_VALUE > APP_CONFIG_DUTY_PERIODS_MAX * BLESC_TIME_PERIOD_SECS * 1000); // Node sleeps up to the longest scan period
+
 nrf_drv_wdt_channel_id m_channel_id; /**< Watchdog timer channed ID */
 
 static blesc_state_t m_blesc_node_state = BLESC_STATE_SCANNING;  /**< BLEAM Scanner node current state @ref blesc_state_t */
 
 static bool m_bleam_nearby = false; /**< @ingroup bleam_scan
                                       * Flag that denotes whether a BLEAM device has been detected by BLEAM Scanner node since latest scan start  */
+static bool m_scan_active = false;  /**< @ingroup bleam_scan
+                                      * Flag that denotes that scanner is running, so that a scan outcome is recorded once */
 
 static void eco_timer_handler(void *p_context);
 
@@ -31,8 +32,8 @@ static bool m_dfu_is_init; /**< @ingroup blesc_dfu
  */
 static uint8_t m_bleam_signature[NRF_CRYPTO_HASH_SIZE_SHA256]; /**< Array to store signature received from BLEAM. */
 static uint8_t m_digest[NRF_CRYPTO_HASH_SIZE_SHA256];          /**< Array to store generated signature. */
-static uint8_t m_bleam_signature_halves;                       /**< Bitwise flags denoting whether each half of the BLEAM signature have been received (binary 01 for first, 10 for second, 11 for both). */
-static nrf_crypto_hmac_context_t m_context;                    /**< Context for signing */
+static ocrypto_sha256_ctx m_hmac_inner;                        /**< SHA-256 state after app key XOR inner padding block. */
+static ocrypto_sha256_ctx m_hmac_outer;                        /**< SHA-256 state after app key XOR outer padding block. */
 /** @} end of bleam_security */
 
 static uint8_t m_adv_handle = BLE_GAP_ADV_SET_HANDLE_NOT_SET; /**< Advertising handle used to identify an advertising set. */
@@ -48,7 +49,6 @@ static ble_gap_adv_data_t m_adv_data = {
 
 NRF_BLE_GATT_DEF(m_gatt);                                /**< GATT module instance. */
 NRF_BLE_QWR_DEF(m_qwr);                                  /**< Context for the Queued Write module.*/
-static uint16_t m_conn_handle = BLE_CONN_HANDLE_INVALID; /**< Handle of the current connection. */
 BLEAM_SERVICE_DISCOVERY_DEF(m_db_disc);                  /**< BLEAM discovery module instance. */
 BLEAM_SERVICE_CLIENT_DEF(m_bleam_service_client);        /**< BLEAM service client instance. */
 CONFIG_S_SERVER_DEF(m_config_service_server);            /**< Configuration service server instance. */
@@ -69,20 +69,41 @@ static ble_gap_scan_params_t m_scan_params = {
     .filter_policy = BLE_GAP_SCAN_FP_ACCEPT_ALL,
     .scan_phys     = BLE_GAP_PHY_1MBPS,
 };
+static blesc_scan_stats_t m_scan_stats; /**< Advertising report counters since scan start. */
 /** @} end of bleam_scan */
 
-APP_TIMER_DEF(m_system_time_timer_id);      /**< @ingroup bleam_time
-                                              *  Timer for updating system time. */
-APP_TIMER_DEF(scan_connect_timer);          /**< @ingroup bleam_connect
-                                              *  Timer for scan/connect cycle. */
-APP_TIMER_DEF(drop_blacklist_timer_id);     /**< @ingroup ios_solution
-                                              * Battery measurement timer. */
-APP_TIMER_DEF(m_eco_timer_id);              /**< @ingroup blesc_app
-                                              * BLEAM Scanner sleep/wake cycle timer. */
-APP_TIMER_DEF(m_eco_watchdog_timer_id);     /**< @ingroup blesc_app
-                                              * Timer for feeding watchdog guring eco sleep. */
-APP_TIMER_DEF(m_bleam_inactivity_timer_id); /**< @ingroup bleam_connect
-                                              * BLEAM timeout for receiving salt. */
+#if APP_CONFIG_ADV_CAPTURE_ENABLED
+/**@addtogroup adv_capture
+ * @{
+ */
+static blesc_adv_capture_t m_adv_capture[APP_CONFIG_ADV_CAPTURE_SIZE];        /**< Captured advertising reports. */
+static uint16_t m_adv_capture_cnt;                                            /**< Number of reports in @ref m_adv_capture. */
+static bool m_adv_replay_active;                                              /**< Flag that denotes that captured reports are being replayed. */
+static bool m_adv_replay_done;                                                /**< Flag that denotes that the capture has been replayed. */
+static uint32_t m_adv_replay_ticks;                                           /**< Virtual time of replay, in RTC ticks. */
+static blesc_adv_replay_stats_t m_adv_replay_stats;                           /**< Results of the latest replay. */
+static bleam_ios_mac_entry_t m_adv_replay_maclist[MACLIST_HASH_SIZE];         /**< iOS MAC registry saved for the time of replay. */
+static blesc_model_rssi_data_t m_adv_replay_rssi_data[APP_CONFIG_MAX_BLEAMS]; /**< BLEAM storage saved for the time of replay. */
+static uint16_t m_adv_replay_storage_hash[BLEAM_STORAGE_HASH_SIZE];           /**< BLEAM storage hash index saved for the time of replay. */
+static uint16_t m_adv_replay_storage_free[APP_CONFIG_MAX_BLEAMS];             /**< BLEAM storage free index stack saved for the time of replay. */
+static void adv_capture_replay(void);
+/** @} end of adv_capture */
+#endif
+
+static blesc_wakeup_id_t m_system_time_timer_id;      /**< @ingroup bleam_time
+                                                        *  Timer for updating system time. */
+static blesc_wakeup_id_t scan_connect_timer;          /**< @ingroup bleam_connect
+                                                        *  Timer for scan/connect cycle. */
+static blesc_wakeup_id_t m_scan_tune_timer_id;        /**< @ingroup bleam_scan
+                                                        *  Timer for scan window tuning steps. */
+static blesc_wakeup_id_t m_maclist_timer_id;          /**< @ingroup ios_solution
+                                                        * iOS MAC registry generation timer. */
+static blesc_wakeup_id_t m_eco_timer_id;              /**< @ingroup blesc_app
+                                                        * BLEAM Scanner sleep/wake cycle timer. */
+static blesc_wakeup_id_t m_wdt_timer_id;              /**< @ingroup blesc_app
+                                                        * Watchdog wakeup timer, pushed back on every wakeup. */
+static blesc_wakeup_id_t m_bleam_inactivity_timer_id; /**< @ingroup bleam_connect
+                                                        * BLEAM timeout for receiving salt. */
 
 #ifdef BOARD_RUUVITAG_B
 /**@ingroup blesc_debug
@@ -91,8 +112,40 @@ APP_TIMER_DEF(m_bleam_inactivity_timer_id); /**< @ingroup bleam_connect
 static ruuvi_interface_gpio_interrupt_fp_t interrupt_table[RUUVI_BOARD_GPIO_NUMBER + 1] = {0};
 #endif
 
-static uint8_t m_bleam_uuid_index; /**< @ingroup bleam_connect
-                                    *  Index of BLEAM device to connect to in storage */
+/** \addtogroup bleam_connect
+ *  @{
+ */
+static blesc_session_t m_session = {.conn_handle = BLE_CONN_HANDLE_INVALID}; /**< Current connection session. */
+static uint16_t m_conn_queue[APP_CONFIG_MAX_BLEAMS];    /**< Storage indexes of BLEAMs to connect to, best score first. */
+static uint16_t m_conn_queue_len;                       /**< Number of BLEAMs in @ref m_conn_queue. */
+static uint16_t m_conn_queue_pos;                       /**< Position of the next BLEAM to connect to in @ref m_conn_queue. */
+static uint32_t m_report_latency_max;                   /**< Maximum time from first RSSI sample to delivery, ms. */
+static uint32_t m_report_latency_sum;                   /**< Sum of times from first RSSI sample to delivery, ms. */
+static uint32_t m_report_cnt;                           /**< Number of delivered RSSI reports. */
+static bleam_peer_cache_entry_t m_peer_cache[APP_CONFIG_PEER_CACHE_SIZE]; /**< Service handles and connection profiles of recently connected BLEAMs. */
+static uint32_t m_peer_cache_clock;                     /**< Counter of peer cache uses, for least recently used eviction. */
+static uint32_t m_first_write_sum[2];                   /**< Sum of times from connection to first data write, ms, without and with cached handles. */
+static uint32_t m_first_write_cnt[2];                   /**< Number of connections in @ref m_first_write_sum. */
+static uint16_t m_session_hist[SESSION_PHASE_CNT][SESSION_HIST_BUCKETS]; /**< Histograms of time spent in each session phase. */
+static uint32_t m_session_cnt;                          /**< Number of finished sessions. */
+STATIC_ASSERT(10 == SESSION_HIST_BUCKETS); // Histogram log prints exactly that many buckets
+
+/** Connection parameters of each @ref blesc_conn_profile_t */
+static const ble_gap_conn_params_t m_conn_profiles[BLESC_CONN_PROFILE_CNT] = {
+    [BLESC_CONN_PROFILE_FAST] = {
+        .min_conn_interval = FAST_MIN_CONN_INTERVAL,
+        .max_conn_interval = FAST_MAX_CONN_INTERVAL,
+        .slave_latency     = FAST_SLAVE_LATENCY,
+        .conn_sup_timeout  = FAST_CONN_SUP_TIMEOUT,
+    },
+    [BLESC_CONN_PROFILE_SAFE] = {
+        .min_conn_interval = SAFE_MIN_CONN_INTERVAL,
+        .max_conn_interval = SAFE_MAX_CONN_INTERVAL,
+        .slave_latency     = SAFE_SLAVE_LATENCY,
+        .conn_sup_timeout  = SAFE_CONN_SUP_TIMEOUT,
+    },
+};
+/** @} end of bleam_connect */
 
 /** \addtogroup blesc_fds
  *  @{
@@ -109,8 +162,11 @@ static void leave_config_mode(void);
  *  @{
  */
 static bleam_ios_rssi_data_t stupid_ios_data = {0};                        /**< Structure for storing data for iOS device that is being investigated to have BLEAM running int the background. */
-static bleam_ios_mac_whitelist_t ios_mac_whitelist[APP_CONFIG_MAX_BLEAMS]; /**< MAC address whitelist for iOS devices. */
-static bleam_ios_mac_blacklist_t ios_mac_blacklist[APP_CONFIG_MAX_BLEAMS]; /**< MAC address blacklist for iOS devices. */
+static bleam_ios_mac_entry_t m_maclist[MACLIST_HASH_SIZE];                /**< Open-addressed MAC address registry keeping iOS whitelist and blacklist. */
+static uint16_t m_maclist_cnt;                                             /**< Number of addresses in @ref m_maclist. */
+static uint8_t m_maclist_generation;                                       /**< Current generation of @ref m_maclist, advanced every @ref MACLIST_TIMEOUT. */
+
+STATIC_ASSERT(0 == (MACLIST_HASH_SIZE & (MACLIST_HASH_SIZE - 1)));
 /** @} end of ios_solution */
 
 /*************************** Data Storage *****************************/
@@ -122,19 +178,164 @@ static bleam_ios_mac_blacklist_t ios_mac_blacklist[APP_CONFIG_MAX_BLEAMS]; /**<
 /** Detected devices' RSSI data storage array */
 blesc_model_rssi_data_t bleam_rssi_data[APP_CONFIG_MAX_BLEAMS];
 
+static uint16_t m_bleam_storage_hash[BLEAM_STORAGE_HASH_SIZE];  /**< Open-addressed hash index of @ref bleam_rssi_data keyed on BLEAM UUID. */
+static uint16_t m_bleam_storage_free[APP_CONFIG_MAX_BLEAMS];    /**< Stack of free @ref bleam_rssi_data entry indexes. */
+static uint16_t m_bleam_storage_free_cnt;                       /**< Number of free entry indexes in @ref m_bleam_storage_free. */
+static uint32_t m_rssi_jitter_state;                            /**< State of pseudo-random generator for RSSI sampling jitter. */
+
+STATIC_ASSERT(0 == (BLEAM_STORAGE_HASH_SIZE & (BLEAM_STORAGE_HASH_SIZE - 1)));
+STATIC_ASSERT(BLEAM_STORAGE_HASH_EMPTY >= APP_CONFIG_MAX_BLEAMS);
+
+/** Function for calculating FNV-1a hash of a byte string
+ *
+ * @param[in] p_data    Pointer to data.
+ * @param[in] len       Length of data.
+ *
+ * @returns 32-bit hash of the data.
+*/
+static uint32_t fnv1a_hash(const uint8_t * p_data, uint8_t len) {
+    uint32_t hash = 2166136261UL;
+    for (uint8_t i = 0; len > i; ++i) {
+        hash ^= p_data[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/** Function for calculating the home slot of a BLEAM UUID in the storage hash index
+ *
+ * @param[in] p_uuid    Pointer to BLEAM UUID.
+ *
+ * @returns Slot of @ref m_bleam_storage_hash the UUID lookup starts from.
+*/
+static uint16_t bleam_storage_hash_slot(const uint8_t * p_uuid) {
+    return (uint16_t)(fnv1a_hash(p_uuid, APP_CONFIG_BLEAM_UUID_SIZE) & (BLEAM_STORAGE_HASH_SIZE - 1));
+}
+
+/** Function for looking up a BLEAM UUID in the storage hash index
+ *
+ * @param[in]  p_uuid    Pointer to BLEAM UUID to look for.
+ * @param[out] p_slot    Slot of the hash index where the UUID is, or where it should be inserted.
+ *
+ * @returns Index of BLEAM device in storage, or @ref APP_CONFIG_MAX_BLEAMS if it is not stored.
+*/
+static uint16_t bleam_storage_find(const uint8_t * p_uuid, uint16_t * p_slot) {
+    uint16_t slot = bleam_storage_hash_slot(p_uuid);
+    // Index is at most half full, so there always is an empty slot to stop at
+    while (BLEAM_STORAGE_HASH_EMPTY != m_bleam_storage_hash[slot]) {
+        const uint16_t index = m_bleam_storage_hash[slot];
+        if (0 == memcmp(p_uuid, bleam_rssi_data[index].bleam_uuid, APP_CONFIG_BLEAM_UUID_SIZE)) {
+            *p_slot = slot;
+            return index;
+        }
+        slot = (slot + 1) & (BLEAM_STORAGE_HASH_SIZE - 1);
+    }
+    *p_slot = slot;
+    return APP_CONFIG_MAX_BLEAMS;
+}
+
+/** Function for removing a slot from the storage hash index
+ *
+ * @details Removal shifts the following entries of the probe sequence back
+ *          into the hole instead of leaving a tombstone, so lookups never
+ *          have to walk over deleted slots.
+ *
+ * @param[in] slot    Slot of the hash index to empty.
+ * @returns Nothing.
+*/
+static void bleam_storage_hash_remove(uint16_t slot) {
+    uint16_t hole = slot;
+    uint16_t next = (slot + 1) & (BLEAM_STORAGE_HASH_SIZE - 1);
+    while (BLEAM_STORAGE_HASH_EMPTY != m_bleam_storage_hash[next]) {
+        const uint16_t home = bleam_storage_hash_slot(bleam_rssi_data[m_bleam_storage_hash[next]].bleam_uuid);
+        // Entry may fill the hole only if the hole lies between its home slot and its current slot
+        if (((next - home) & (BLEAM_STORAGE_HASH_SIZE - 1)) >= ((next - hole) & (BLEAM_STORAGE_HASH_SIZE - 1))) {
+            m_bleam_storage_hash[hole] = m_bleam_storage_hash[next];
+            hole = next;
+        }
+        next = (next + 1) & (BLEAM_STORAGE_HASH_SIZE - 1);
+    }
+    m_bleam_storage_hash[hole] = BLEAM_STORAGE_HASH_EMPTY;
+}
+
+/** Function for initialising BLEAM device storage
+ *
+ * @returns Nothing.
+*/
+static void bleam_storage_init(void) {
+    memset(bleam_rssi_data, 0, sizeof(bleam_rssi_data));
+    for (uint16_t slot = 0; BLEAM_STORAGE_HASH_SIZE > slot; ++slot) {
+        m_bleam_storage_hash[slot] = BLEAM_STORAGE_HASH_EMPTY;
+    }
+    // Stack the free indexes so that lower ones are used first
+    for (uint16_t index = 0; APP_CONFIG_MAX_BLEAMS > index; ++index) {
+        m_bleam_storage_free[index] = APP_CONFIG_MAX_BLEAMS - 1 - index;
+    }
+    m_bleam_storage_free_cnt = APP_CONFIG_MAX_BLEAMS;
+    // Device ID differs between scanners, so neighbours do not sample in lockstep
+    m_rssi_jitter_state = NRF_FICR->DEVICEID[0] | 1;
+}
+
 /** Function for clearing all RSSI data for a BLEAM device
+ *
+ * @details If the entry is in use, it is removed from the storage and its slot is freed.
  *
  * @param[in] data    Pointer to RSSI scan data entry to be cleared.
  * @returns Nothing.
 */
 static void clear_rssi_data(blesc_model_rssi_data_t *data) {
+    if (data->active) {
+        uint16_t slot;
+        const uint16_t index = bleam_storage_find(data->bleam_uuid, &slot);
+        if (APP_CONFIG_MAX_BLEAMS != index) {
+            bleam_storage_hash_remove(slot);
+            m_bleam_storage_free[m_bleam_storage_free_cnt++] = index;
+        }
+    }
     data->active = 0;
     data->scans_stored_cnt = 0;
+#if APP_CONFIG_RSSI_SUMMARY_ENABLED
+    memset(&data->summary, 0, sizeof(blesc_rssi_summary_t));
+#endif
     data->timestamp = 0;
+    data->sample_gap = 0;
+    data->first_seen = 0;
+    data->failures = 0;
     memset(data->bleam_uuid, 0, APP_CONFIG_BLEAM_UUID_SIZE);
     memset(data->mac, 0, BLE_GAP_ADDR_LEN);
     memset(data->rssi, INT8_MIN, APP_CONFIG_RSSI_PER_MSG);
     memset(data->aoa, 0, APP_CONFIG_RSSI_PER_MSG);
+    memset(data->offset_ms, 0, sizeof(data->offset_ms));
+}
+
+/** Function for getting current time for the scan pipeline.
+ *
+ * @details All time stamping and time differences of the scan pipeline go through it.
+ *          Time comes from @ref blesc_wakeup_ticks_get, wrapped like the RTC counter.
+ *
+ * @returns RTC ticks, or virtual time while captured reports are replayed.
+*/
+static uint32_t blesc_ticks_now(void) {
+#if APP_CONFIG_ADV_CAPTURE_ENABLED
+    if (m_adv_replay_active) {
+        return m_adv_replay_ticks;
+    }
+#endif
+    return blesc_wakeup_ticks_get() & RTC_MAX_TICKS;
+}
+
+/** Function for checking if the scan pipeline processes replayed reports.
+ *
+ * @details Replay must not touch the scanner, the eco timer or scan tuning.
+ *
+ * @returns Boolean value denoting if captured reports are being replayed.
+*/
+static bool blesc_replay_active(void) {
+#if APP_CONFIG_ADV_CAPTURE_ENABLED
+    return m_adv_replay_active;
+#else
+    return false;
+#endif
 }
 
 /** Wrapper function for calculating time difference between a timestamp and current moment.
@@ -142,10 +343,87 @@ static void clear_rssi_data(blesc_model_rssi_data_t *data) {
  * @param[in] past_timestamp    Value of a past timestamp.
 */
 static uint32_t how_long_ago(uint32_t past_timestamp) {
-    return app_timer_cnt_diff_compute(app_timer_cnt_get(), past_timestamp);
+    return app_timer_cnt_diff_compute(blesc_ticks_now(), past_timestamp);
+}
+
+/** Function for picking the time to wait before the next RSSI sample of a device
+ *
+ * @details Xorshift generator is enough here, jitter only has to break up
+ *          sampling in phase with the advertising interval of the device.
+ *
+ * @returns Time to the next RSSI sample, in ticks.
+*/
+static uint32_t rssi_sample_gap_get(void) {
+#if APP_CONFIG_RSSI_FILTER_JITTER
+    m_rssi_jitter_state ^= m_rssi_jitter_state << 13;
+    m_rssi_jitter_state ^= m_rssi_jitter_state >> 17;
+    m_rssi_jitter_state ^= m_rssi_jitter_state << 5;
+    return RSSI_FILTER_TIMEOUT + m_rssi_jitter_state % (RSSI_FILTER_JITTER + 1);
+#else
+    return RSSI_FILTER_TIMEOUT;
+#endif
+}
+
+#if APP_CONFIG_RSSI_SUMMARY_ENABLED
+/** Function for adding an RSSI sample to a streaming summary
+ *
+ * @details Mean and variance use Welford's method, median is a frugal
+ *          estimate that steps 1 dB towards each new sample.
+ *
+ * @param[in,out] p_summary    Pointer to RSSI summary.
+ * @param[in]     rssi         RSSI sample.
+ *
+ * @returns Nothing.
+*/
+static void rssi_summary_update(blesc_rssi_summary_t * p_summary, int8_t rssi) {
+    if (0 == p_summary->count) {
+        p_summary->min = p_summary->max = p_summary->median = rssi;
+        p_summary->mean = 0;
+        p_summary->m2 = 0;
+    }
+    if (UINT16_MAX != p_summary->count) {
+        ++p_summary->count;
+    }
+    const float delta = rssi - p_summary->mean;
+    p_summary->mean += delta / p_summary->count;
+    p_summary->m2 += delta * (rssi - p_summary->mean);
+
+    p_summary->min = MIN(p_summary->min, rssi);
+    p_summary->max = MAX(p_summary->max, rssi);
+    if (rssi > p_summary->median) {
+        ++p_summary->median;
+    } else if (rssi < p_summary->median) {
+        --p_summary->median;
+    }
+}
+#endif
+
+/** Function for checking if RSSI data of a BLEAM device is ready to be sent
+ *
+ * @param[in] p_data      Pointer to BLEAM device storage entry.
+ * @param[in] scan_over   True if scan-connect window is over and partial data has to be sent.
+ *
+ * @returns Boolean value denoting if RSSI data is ready.
+*/
+static bool rssi_data_ready(const blesc_model_rssi_data_t * p_data, bool scan_over) {
+    if (!p_data->active || 0 == p_data->scans_stored_cnt) {
+        return false;
+    }
+#if APP_CONFIG_RSSI_SUMMARY_ENABLED
+    // Summary is sent once per window, however long scanning goes on
+    UNUSED_PARAMETER(scan_over);
+    return RSSI_SUMMARY_WINDOW <= how_long_ago(p_data->first_seen);
+#else
+    return scan_over || APP_CONFIG_RSSI_PER_MSG <= p_data->scans_stored_cnt;
+#endif
 }
 
 /**@brief Function for adding RSSI scan data to storage
+ *
+ * @details Samples of one device are spaced at least @ref RSSI_FILTER_TIMEOUT
+ *          apart, plus up to @ref RSSI_FILTER_JITTER, so a fast advertiser
+ *          does not fill its storage with correlated samples in a burst.
+ *          Reports arriving earlier are dropped.
  *
  * @param[in] uuid_storage_index    BLEAM device index in data storage.
  * @param[in] rssi                  Pointer to RSSI level for scanned BLEAM
@@ -153,74 +431,77 @@ static uint32_t how_long_ago(uint32_t past_timestamp) {
  *
  *@returns Boolean value denoting if RSSI data is ready to send to BLEAM now
  */
-static bool app_blesc_save_rssi_to_storage(const uint8_t uuid_storage_index, const uint8_t *rssi, const uint8_t *aoa) {
+static bool app_blesc_save_rssi_to_storage(const uint16_t uuid_storage_index, const uint8_t *rssi, const uint8_t *aoa) {
     VERIFY_PARAM_NOT_NULL(rssi);
     VERIFY_PARAM_NOT_NULL(aoa);
-    if (bleam_rssi_data[uuid_storage_index].scans_stored_cnt >= APP_CONFIG_RSSI_PER_MSG) {
+    blesc_model_rssi_data_t * p_data = &bleam_rssi_data[uuid_storage_index];
+    if (rssi_data_ready(p_data, false)) {
         return true;
     }
 
-//    if(RSSI_FILTER_TIMEOUT > how_long_ago(bleam_rssi_data[uuid_storage_index].timestamp) &&
-//                        0 != how_long_ago(bleam_rssi_data[uuid_storage_index].timestamp)) {
-//        return false;
-//    }
+    if (0 != p_data->scans_stored_cnt && p_data->sample_gap > how_long_ago(p_data->timestamp)) {
+        return false;
+    }
 
-    bleam_rssi_data[uuid_storage_index].rssi[bleam_rssi_data[uuid_storage_index].scans_stored_cnt] = *rssi;
-    bleam_rssi_data[uuid_storage_index].aoa[bleam_rssi_data[uuid_storage_index].scans_stored_cnt] = *aoa;
-    bleam_rssi_data[uuid_storage_index].timestamp = app_timer_cnt_get();
-    ++bleam_rssi_data[uuid_storage_index].scans_stored_cnt;
+    if (0 == p_data->scans_stored_cnt) {
+        p_data->first_seen = blesc_ticks_now();
+    }
+    const uint16_t offset_ms = MIN((uint64_t)how_long_ago(p_data->first_seen) * 1000 / APP_TIMER_TICKS(1000), UINT16_MAX);
+#if APP_CONFIG_RSSI_SUMMARY_ENABLED
+    rssi_summary_update(&p_data->summary, (int8_t)*rssi);
+    // Only the latest raw sample is kept
+    p_data->rssi[0] = *rssi;
+    p_data->aoa[0] = *aoa;
+    p_data->offset_ms[0] = offset_ms;
+    p_data->scans_stored_cnt = 1;
+#else
+    p_data->rssi[p_data->scans_stored_cnt] = *rssi;
+    p_data->aoa[p_data->scans_stored_cnt] = *aoa;
+    p_data->offset_ms[p_data->scans_stored_cnt] = offset_ms;
+    ++p_data->scans_stored_cnt;
+#endif
+    p_data->timestamp = blesc_ticks_now();
+    p_data->sample_gap = rssi_sample_gap_get();
 
-    if (APP_CONFIG_RSSI_PER_MSG == bleam_rssi_data[uuid_storage_index].scans_stored_cnt)
-        return true;
-    else
-        return false;
+    return rssi_data_ready(p_data, false);
 }
 
 /**@brief Function for adding a new BLEAM device to storage
+ *
+ * @details BLEAM devices are looked up by UUID in @ref m_bleam_storage_hash,
+ *          so the cost of a lookup does not depend on the storage size.
  *
  * @param[in] p_uuid    UUID of BLEAM device to add.
  * @param[in] p_mac     MAC address of BLEAM device to add.
  *
- *@returns Index of BLEAM device in storage.
+ *@returns Index of BLEAM device in storage, or @ref APP_CONFIG_MAX_BLEAMS if storage is full.
  */
-static uint8_t app_blesc_save_bleam_to_storage(const uint8_t * p_uuid, const uint8_t * p_mac) {
-    uint8_t uuid_storage_empty_index = APP_CONFIG_MAX_BLEAMS;
-    
-    /* Find if received MAC has been scanned/received previously. 
-    *  If it wasn't, add new bleam_rssi_data[uuid_storage_empty_index] element */
-    for (uint8_t uuid_storage_index = 0; APP_CONFIG_MAX_BLEAMS > uuid_storage_index; ++uuid_storage_index) {
-        /* If UUIDs match, it means it was scanned/received before and there is bleam_rssi_data[] element for it */
-        if (0 == memcmp(p_uuid, bleam_rssi_data[uuid_storage_index].bleam_uuid, APP_CONFIG_BLEAM_UUID_SIZE)) {
-            /* If this MAC was already saved, nothing to do here anymore */
-            if (0 == memcmp(p_mac, bleam_rssi_data[uuid_storage_index].mac, BLE_GAP_ADDR_LEN)) {
-                return uuid_storage_index;
-            }
-            /* Save MAC address. */
-            for(uint8_t i = 0; BLE_GAP_ADDR_LEN > i; ++i)
-                bleam_rssi_data[uuid_storage_index].mac[i] = p_mac[i];
-            bleam_rssi_data[uuid_storage_index].active = 1;
-            return uuid_storage_index;
-        }
-        if (0 == bleam_rssi_data[uuid_storage_index].active) {
-            if (uuid_storage_empty_index > uuid_storage_index)
-                uuid_storage_empty_index = uuid_storage_index;
-            continue;
+static uint16_t app_blesc_save_bleam_to_storage(const uint8_t * p_uuid, const uint8_t * p_mac) {
+    uint16_t slot;
+    uint16_t uuid_storage_index = bleam_storage_find(p_uuid, &slot);
+
+    /* If UUIDs match, it means it was scanned/received before and there is bleam_rssi_data[] element for it */
+    if (APP_CONFIG_MAX_BLEAMS != uuid_storage_index) {
+        /* Save MAC address, in case it has changed. */
+        if (0 != memcmp(p_mac, bleam_rssi_data[uuid_storage_index].mac, BLE_GAP_ADDR_LEN)) {
+            memcpy(bleam_rssi_data[uuid_storage_index].mac, p_mac, BLE_GAP_ADDR_LEN);
         }
+        return uuid_storage_index;
     }
 
-    if (APP_CONFIG_MAX_BLEAMS == uuid_storage_empty_index) {
+    if (0 == m_bleam_storage_free_cnt) {
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "STORAGE: Storage is full, can't save new UUID and MAC\n");
         return APP_CONFIG_MAX_BLEAMS;
     }
 
     /* Save UUID and MAC address */
-    for (uint8_t i = 0; APP_CONFIG_BLEAM_UUID_SIZE > i; ++i)
-        bleam_rssi_data[uuid_storage_empty_index].bleam_uuid[i] = p_uuid[i];
-    for (uint8_t i = 0; BLE_GAP_ADDR_LEN > i; ++i)
-        bleam_rssi_data[uuid_storage_empty_index].mac[i] = p_mac[i];
-    bleam_rssi_data[uuid_storage_empty_index].active = 1;
+    uuid_storage_index = m_bleam_storage_free[--m_bleam_storage_free_cnt];
+    memcpy(bleam_rssi_data[uuid_storage_index].bleam_uuid, p_uuid, APP_CONFIG_BLEAM_UUID_SIZE);
+    memcpy(bleam_rssi_data[uuid_storage_index].mac, p_mac, BLE_GAP_ADDR_LEN);
+    bleam_rssi_data[uuid_storage_index].active = 1;
+    m_bleam_storage_hash[slot] = uuid_storage_index;
 
-    return uuid_storage_empty_index;
+    return uuid_storage_index;
 }
 
 /** @} end of bleam_storage */
@@ -229,7 +510,113 @@ static uint8_t app_blesc_save_bleam_to_storage(const uint8_t * p_uuid, const uin
  *  @{
  */
 
+/** Function for calculating the home slot of a MAC address in iOS MAC registry
+ *
+ * @param[in] p_mac    Pointer to MAC address.
+ *
+ * @returns Slot of @ref m_maclist the address lookup starts from.
+*/
+static uint16_t maclist_hash_slot(const uint8_t * p_mac) {
+    return (uint16_t)(fnv1a_hash(p_mac, BLE_GAP_ADDR_LEN) & (MACLIST_HASH_SIZE - 1));
+}
+
+/** Function for checking if an iOS MAC registry entry has not expired yet
+ *
+ * @details Whitelisted addresses live until the end of the generation after
+ *          the one they were last seen in, so they last from one to two
+ *          @ref MACLIST_TIMEOUT periods. Blacklisted addresses are dropped at
+ *          the end of the generation they were added in.
+ *
+ * @param[in] p_entry    Pointer to registry entry.
+ *
+ * @returns Boolean value denoting if the entry is still valid.
+*/
+static bool maclist_entry_alive(const bleam_ios_mac_entry_t * p_entry) {
+    const uint8_t age = (uint8_t)(m_maclist_generation - p_entry->generation);
+    if (p_entry->role & MACLIST_ROLE_WHITELIST) {
+        return 1 >= age;
+    }
+    return 0 == age;
+}
+
+/** Function for looking up a MAC address in iOS MAC registry
+ *
+ * @param[in]  p_mac     Pointer to MAC address to look for.
+ * @param[out] p_slot    Slot of the registry where the address is, or where it should be inserted.
+ *
+ * @returns Pointer to registry entry, or NULL if the address is not registered.
+ *          Returned entry may be expired, check it with @ref maclist_entry_alive.
+*/
+static bleam_ios_mac_entry_t * maclist_find(const uint8_t * p_mac, uint16_t * p_slot) {
+    uint16_t slot = maclist_hash_slot(p_mac);
+    // Registry is never full, so there always is an empty slot to stop at
+    while (MACLIST_ROLE_NONE != m_maclist[slot].role) {
+        if (0 == memcmp(p_mac, m_maclist[slot].mac, BLE_GAP_ADDR_LEN)) {
+            *p_slot = slot;
+            return &m_maclist[slot];
+        }
+        slot = (slot + 1) & (MACLIST_HASH_SIZE - 1);
+    }
+    *p_slot = slot;
+    return NULL;
+}
+
+/** Function for removing an entry from iOS MAC registry
+ *
+ * @details Same backward shift deletion as @ref bleam_storage_hash_remove,
+ *          the registry stays free of tombstones.
+ *
+ * @param[in] slot    Slot of the registry to empty.
+ * @returns Nothing.
+*/
+static void maclist_remove(uint16_t slot) {
+    uint16_t hole = slot;
+    uint16_t next = (slot + 1) & (MACLIST_HASH_SIZE - 1);
+    while (MACLIST_ROLE_NONE != m_maclist[next].role) {
+        const uint16_t home = maclist_hash_slot(m_maclist[next].mac);
+        if (((next - home) & (MACLIST_HASH_SIZE - 1)) >= ((next - hole) & (MACLIST_HASH_SIZE - 1))) {
+            m_maclist[hole] = m_maclist[next];
+            hole = next;
+        }
+        next = (next + 1) & (MACLIST_HASH_SIZE - 1);
+    }
+    memset(&m_maclist[hole], 0, sizeof(bleam_ios_mac_entry_t));
+    --m_maclist_cnt;
+}
+
+/** Function for registering a MAC address in iOS MAC registry with a role
+ *
+ * @param[in] p_mac     Pointer to MAC address to register.
+ * @param[in] role      Role of the address, @ref maclist_role_t.
+ * @param[in] p_uuid    Pointer to BLEAM UUID of the address, may be NULL.
+ *
+ *@retval NRF_SUCCESS if address is successfully registered.
+ *@retval NRF_ERROR_NO_MEM if registry is full.
+ */
+static ret_code_t maclist_add(const uint8_t * p_mac, maclist_role_t role, const uint8_t * p_uuid) {
+    uint16_t slot;
+    bleam_ios_mac_entry_t * p_entry = maclist_find(p_mac, &slot);
+    if (NULL == p_entry) {
+        if (MACLIST_MAX_ENTRIES <= m_maclist_cnt) {
+            __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "MACLIST: Registry is full\n");
+            return NRF_ERROR_NO_MEM;
+        }
+        p_entry = &m_maclist[slot];
+        memcpy(p_entry->mac, p_mac, BLE_GAP_ADDR_LEN);
+        ++m_maclist_cnt;
+    }
+    // An address is either whitelisted or blacklisted, never both
+    p_entry->role = role;
+    p_entry->generation = m_maclist_generation;
+    if (NULL != p_uuid) {
+        memcpy(p_entry->bleam_uuid, p_uuid, APP_CONFIG_BLEAM_UUID_SIZE);
+    }
+    return NRF_SUCCESS;
+}
+
 /**@brief Function for searching for a MAC address in iOS whitelist
+ *
+ * @details A hit refreshes the address, so it stays whitelisted while the device is seen.
  *
  * @param[in] p_mac     Pointer to MAC address to look for.
  * @param[in] p_uuid    Pointer to the UUID to look for.
@@ -238,22 +625,17 @@ static uint8_t app_blesc_save_bleam_to_storage(const uint8_t * p_uuid, const uin
  *         returns the pointer to corresponding UUID, otherwise returns a NULL pointer.
  */
 static uint8_t * mac_in_whitelist(const uint8_t * p_mac, uint8_t * p_uuid) {
-    uint8_t * res = NULL;
-    for(uint8_t index = 0; APP_CONFIG_MAX_BLEAMS > index; ++index) {
-        if(!ios_mac_whitelist[index].active)
-            continue;
-        if(0 == memcmp(ios_mac_whitelist[index].mac, p_mac, BLE_GAP_ADDR_LEN)) {
-            res = ios_mac_whitelist[index].bleam_uuid;
-            ios_mac_whitelist[index].timestamp = app_timer_cnt_get();
-            // If UUID is known and has changed, update it
-            if(p_uuid != NULL && 0 != memcmp(ios_mac_whitelist[index].bleam_uuid, p_uuid, APP_CONFIG_BLEAM_UUID_SIZE)) {
-                memcpy(ios_mac_whitelist[index].bleam_uuid, p_uuid, APP_CONFIG_BLEAM_UUID_SIZE);
-            }
-        } else if(MACLIST_TIMEOUT < how_long_ago(ios_mac_whitelist[index].timestamp)) {
-            ios_mac_whitelist[index].active = false;
-        }
+    uint16_t slot;
+    bleam_ios_mac_entry_t * p_entry = maclist_find(p_mac, &slot);
+    if (NULL == p_entry || !(p_entry->role & MACLIST_ROLE_WHITELIST) || !maclist_entry_alive(p_entry)) {
+        return NULL;
+    }
+    p_entry->generation = m_maclist_generation;
+    // If UUID is known and has changed, update it
+    if (p_uuid != NULL && 0 != memcmp(p_entry->bleam_uuid, p_uuid, APP_CONFIG_BLEAM_UUID_SIZE)) {
+        memcpy(p_entry->bleam_uuid, p_uuid, APP_CONFIG_BLEAM_UUID_SIZE);
     }
-    return res;
+    return p_entry->bleam_uuid;
 }
 
 /**@brief Function for adding a MAC address to iOS whitelist
@@ -265,16 +647,7 @@ static uint8_t * mac_in_whitelist(const uint8_t * p_mac, uint8_t * p_uuid) {
  *@retval NRF_ERROR_NO_MEM if whitelist is full.
  */
 static ret_code_t add_mac_in_whitelist(const uint8_t * p_mac, uint8_t * p_uuid) {
-    for(uint8_t index = 0; APP_CONFIG_MAX_BLEAMS > index; ++index) {
-        if(ios_mac_whitelist[index].active)
-            continue;
-        ios_mac_whitelist[index].active = true;
-        memcpy(ios_mac_whitelist[index].mac, p_mac, BLE_GAP_ADDR_LEN);
-        memcpy(ios_mac_whitelist[index].bleam_uuid, p_uuid, APP_CONFIG_BLEAM_UUID_SIZE);
-        ios_mac_whitelist[index].timestamp = app_timer_cnt_get();
-        return NRF_SUCCESS;
-    }
-    return NRF_ERROR_NO_MEM;
+    return maclist_add(p_mac, MACLIST_ROLE_WHITELIST, p_uuid);
 }
 
 /**@brief Function for searching for a MAC address in iOS blacklist
@@ -285,17 +658,9 @@ static ret_code_t add_mac_in_whitelist(const uint8_t * p_mac, uint8_t * p_uuid)
  *@retval false otherwise.
  */
 static bool mac_in_blacklist(const uint8_t * p_mac) {
-    bool res = false;
-    for(uint8_t index = 0; APP_CONFIG_MAX_BLEAMS > index; ++index) {
-        if(!ios_mac_blacklist[index].active)
-            continue;
-        if(0 == memcmp(ios_mac_blacklist[index].mac, p_mac, BLE_GAP_ADDR_LEN)) {
-            res = true;
-            ios_mac_blacklist[index].timestamp = app_timer_cnt_get();
-        } else if(MACLIST_TIMEOUT < how_long_ago(ios_mac_blacklist[index].timestamp))
-            ios_mac_blacklist[index].active = false;
-    }
-    return res;
+    uint16_t slot;
+    const bleam_ios_mac_entry_t * p_entry = maclist_find(p_mac, &slot);
+    return NULL != p_entry && (p_entry->role & MACLIST_ROLE_BLACKLIST) && maclist_entry_alive(p_entry);
 }
 
 /**@brief Function for adding a MAC address to iOS blacklist
@@ -307,44 +672,120 @@ static bool mac_in_blacklist(const uint8_t * p_mac) {
  *@retval NRF_ERROR_NO_MEM if blacklist is full.
  */
 static ret_code_t add_mac_in_blacklist(const uint8_t * p_mac) {
-    for(uint8_t index = 0; APP_CONFIG_MAX_BLEAMS > index; ++index) {
-        if(ios_mac_blacklist[index].active)
-            continue;
-        ios_mac_blacklist[index].active = true;
-        memcpy(ios_mac_blacklist[index].mac, p_mac, BLE_GAP_ADDR_LEN);
-        ios_mac_blacklist[index].timestamp = app_timer_cnt_get();
-        return NRF_SUCCESS;
-    }
-    return NRF_ERROR_NO_MEM;
+    return maclist_add(p_mac, MACLIST_ROLE_BLACKLIST, NULL);
 }
 
-/**@brief Function for handlind timeout event for drop_blacklist_timer_id.
- *@details Function erases all MAC addresses from iOS blacklist on timeout.
- *
+/**@brief Function for handling timeout event for m_maclist_timer_id.
+ *@details Function starts a new iOS MAC registry generation and sweeps expired
+ *         addresses out of the registry, so lookups never have to check time.
  *
  * @param[in] p_context   Pointer used for passing some arbitrary information (context) from the
  *                        app_start_timer() call to the timeout handler.
  *
  * @returns Nothing.
  */
-static void drop_blacklist(void * p_context) {
-    memset(ios_mac_blacklist, 0, APP_CONFIG_MAX_BLEAMS * sizeof(bleam_ios_mac_blacklist_t));
+static void maclist_generation_handler(void * p_context) {
+    ++m_maclist_generation;
+    uint16_t slot = 0;
+    while (MACLIST_HASH_SIZE > slot) {
+        if (MACLIST_ROLE_NONE != m_maclist[slot].role && !maclist_entry_alive(&m_maclist[slot])) {
+            // Removal may shift another entry into this slot, check it again
+            maclist_remove(slot);
+            continue;
+        }
+        ++slot;
+    }
 }
 
 /** @} end of ios_solution */
 
 /**********************  INTERNAL FUNCTIONS  ************************/
 
+/**@brief Function for getting time since boot.
+ * @ingroup bleam_time
+ *
+ * @details 24-bit RTC counter is extended by @ref blesc_wakeup,
+ *          which never sleeps long enough for it to wrap.
+ *
+ * @returns RTC ticks since boot.
+ */
+static uint64_t clock_ticks_get(void) {
+    return blesc_wakeup_ticks_get();
+}
+
+/**@brief Function for getting node uptime.
+ * @ingroup bleam_time
+ *
+ * @returns Seconds since boot.
+ */
+static uint32_t uptime_secs_get(void) {
+    return clock_ticks_get() / SYSTEM_TIME_SEC_TICKS;
+}
+
+/**@brief Function for getting node uptime with millisecond resolution.
+ * @ingroup bleam_time
+ *
+ * @returns Milliseconds since boot.
+ */
+static uint64_t uptime_ms_get(void) {
+    return clock_ticks_get() * 1000 / SYSTEM_TIME_SEC_TICKS;
+}
+
+/**@brief Function for getting drift compensated system time with millisecond resolution.
+ * @ingroup bleam_time
+ *
+ * @returns Milliseconds passed since midnight.
+ */
+static uint32_t system_time_ms_get(void) {
+    return blesc_time_sync_time_get(uptime_ms_get());
+}
+
+/**@brief Function for getting system time.
+ * @ingroup bleam_time
+ *
+ * @returns Seconds passed since midnight.
+ */
+static uint32_t system_time_get(void) {
+    return system_time_ms_get() / 1000;
+}
+
+/**@brief Function for checking whether system time has to be read from BLEAM.
+ * @ingroup bleam_time
+ *
+ * @returns True if system time may be off by more than @ref APP_CONFIG_TIME_SYNC_MAX_ERROR_MS.
+ */
+static bool system_time_needs_update(void) {
+    return blesc_time_sync_needed(uptime_ms_get());
+}
+
+/**@brief Function for starting system time timer to wake up at the next period start.
+ * @ingroup bleam_time
+ *
+ * @returns Nothing.
+ */
+static void system_time_timer_schedule(void) {
+    const uint32_t period_ms = m_blesc_time_period * 1000;
+    const uint32_t timeout = APP_TIMER_TICKS(period_ms - system_time_ms_get() % period_ms);
+    ret_code_t err_code = blesc_wakeup_start(m_system_time_timer_id, MAX(timeout, 1), NULL);
+    APP_ERROR_CHECK(err_code);
+}
+
 /**@brief Function to update system time value.
  * @ingroup bleam_time
  *
- * @param[in]  bleam_time   New system time value.
+ * @details Sample also refines RTC drift estimate, see @ref blesc_time_sync.
+ *
+ * @param[in]  bleam_time   New system time value in milliseconds passed since midnight.
  *
  * @returns Nothing.
  */
 static void system_time_update(uint32_t * bleam_time) {
-    m_system_time = (*bleam_time) / 1000;
-    m_system_time_needs_update = false;
+    const uint64_t uptime_ms = uptime_ms_get();
+    const int32_t error_ms = (int32_t)(*bleam_time % BLESC_TIME_SYNC_DAY_MS) - (int32_t)blesc_time_sync_time_get(uptime_ms);
+    blesc_time_sync_sample(uptime_ms, *bleam_time);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Time synced, error %d ms, drift %d ppm\r\n", error_ms, blesc_time_sync_drift_get());
+    // Period starts moved with the clock
+    system_time_timer_schedule();
 }
 
 /**@brief Function for controlling LEDs on BLEAM Scanner.
@@ -501,6 +942,53 @@ static uint16_t scan_address_type_decode(uint8_t const *p_addr) {
     }
 }
 
+/**@brief Function for changing BLEAM Scanner node state.
+ * @ingroup blesc_app
+ *
+ * @param[in] state    New node state.
+ *
+ * @returns Nothing.
+ */
+static void node_state_set(blesc_state_t state) {
+    if (state != m_blesc_node_state) {
+        blesc_energy_state_set(state);
+    }
+    m_blesc_node_state = state;
+}
+
+/**@brief Function for (re)starting scanner with tuned scan window and interval.
+ * @ingroup bleam_scan
+ *
+ * @returns Nothing.
+ */
+static void scan_tune_apply(void) {
+    m_scan_params.window   = blesc_scan_tune_window_get();
+    m_scan_params.interval = blesc_scan_tune_interval_get();
+    // Setting parameters stops the scanner
+    ret_code_t err_code = nrf_ble_scan_params_set(&m_scan, &m_scan_params);
+    APP_ERROR_CHECK(err_code);
+    err_code = nrf_ble_scan_start(&m_scan);
+    APP_ERROR_CHECK(err_code);
+    blesc_energy_scan_start(m_scan_params.window, m_scan_params.interval);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "Scan window %u of %u\r\n", m_scan_params.window, m_scan_params.interval);
+}
+
+/**@brief Function for handling the scan window tuning timer timeout.
+ * @ingroup bleam_scan
+ *
+ * @param[in] p_context   Pointer used for passing some arbitrary information (context) from the
+ *                        app_start_timer() call to the timeout handler.
+ *
+ * @returns Nothing.
+ */
+static void scan_tune_timer_handler(void * p_context) {
+    UNUSED_PARAMETER(p_context);
+    blesc_scan_tune_step();
+    if (blesc_scan_tune_changed()) {
+        scan_tune_apply();
+    }
+}
+
 /**@brief Function to start scanning.
  * @ingroup bleam_scan
  *
@@ -511,13 +999,17 @@ static void scan_start(void) {
 
     ret_code_t err_code;
 
-    m_blesc_node_state = BLESC_STATE_SCANNING;
+    node_state_set(BLESC_STATE_SCANNING);
     m_bleam_nearby = false;
+    m_scan_active = true;
+    memset(&m_scan_stats, 0, sizeof(m_scan_stats));
 
-    err_code = app_timer_start(scan_connect_timer, SCAN_CONNECT_TIME, NULL);
+    err_code = blesc_wakeup_start(scan_connect_timer, SCAN_CONNECT_TIME, NULL);
     APP_ERROR_CHECK(err_code);
 
-    err_code = nrf_ble_scan_start(&m_scan);
+    blesc_scan_tune_start(blesc_duty_rate_get(system_time_get()));
+    scan_tune_apply();
+    err_code = blesc_wakeup_start(m_scan_tune_timer_id, SCAN_TUNE_STEP, NULL);
     APP_ERROR_CHECK(err_code);
 
     __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Scanning for UUID %04X\r\n", BLEAM_SERVICE_UUID);
@@ -525,16 +1017,41 @@ static void scan_start(void) {
     blesc_toggle_leds(1, 0);
 }
 
+/**@brief Function for recording the outcome of a finished scan in adaptive duty cycle.
+ * @ingroup bleam_scan
+ *
+ * @details Every scan end goes through @ref scan_stop, whether it is a quiet eco scan,
+ *          a scan-connect timeout or a report that filled a storage entry.
+ *
+ * @returns Nothing.
+ */
+static void scan_outcome_record(void) {
+    if (!m_scan_active) {
+        return;
+    }
+    m_scan_active = false;
+    const uint32_t system_time = system_time_get();
+    blesc_duty_outcome(system_time, m_bleam_nearby);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "Duty: hit rate %u/%u, period %u s\r\n",
+          blesc_duty_rate_get(system_time), BLESC_DUTY_RATE_ONE, blesc_duty_period_get(system_time));
+}
+
 /**@brief Function to stop scanning.
  * @ingroup bleam_scan
  *
  * @returns Nothing.
  */
 static void scan_stop(void) {
+    scan_outcome_record();
     nrf_ble_scan_stop();
-    app_timer_stop(scan_connect_timer);
+    blesc_energy_scan_stop();
+    blesc_wakeup_stop(scan_connect_timer);
+    blesc_wakeup_stop(m_scan_tune_timer_id);
+    blesc_scan_tune_stop();
 
     __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Scanning stopped\r\n");
+    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "Reports: %u received, %u filtered, %u ignored, %u BLEAM, %u iOS\r\n",
+          m_scan_stats.received, m_scan_stats.filtered, m_scan_stats.ignored, m_scan_stats.bleam, m_scan_stats.apple);
     blesc_toggle_leds(0, 0);
 }
 
@@ -548,127 +1065,610 @@ static void advertising_start(void) {
     APP_ERROR_CHECK(err_code);
 }
 
-/**@brief Function for creating signature digest with HMAX SHA256 and given key.
+/**@brief Function for preparing HMAC SHA256 state for a signing key.
+ * @ingroup bleam_security
+ *
+ * @details Key never changes after configuration, so SHA-256 states after
+ *          the padded key blocks are computed once and copied for every signature.
+ *
+ * @param[in]  sign_key    Pointer to array with key to hash with.
+ *
+ * @returns Nothing.
+ */
+static void sign_key_set(const uint8_t *sign_key) {
+    uint8_t block[SIGN_BLOCK_SIZE] = {0};
+    memcpy(block, sign_key, BLEAM_KEY_SIZE);
+
+    for (uint8_t index = 0; SIGN_BLOCK_SIZE > index; ++index) {
+        block[index] ^= SIGN_IPAD;
+    }
+    ocrypto_sha256_init(&m_hmac_inner);
+    ocrypto_sha256_update(&m_hmac_inner, block, SIGN_BLOCK_SIZE);
+
+    for (uint8_t index = 0; SIGN_BLOCK_SIZE > index; ++index) {
+        block[index] ^= SIGN_IPAD ^ SIGN_OPAD;
+    }
+    ocrypto_sha256_init(&m_hmac_outer);
+    ocrypto_sha256_update(&m_hmac_outer, block, SIGN_BLOCK_SIZE);
+
+    memset(block, 0, SIGN_BLOCK_SIZE);
+}
+
+/**@brief Function for creating signature digest with HMAC SHA256 and the key set with @ref sign_key_set.
  * @ingroup bleam_security
  *
  * @param[out] p_digest    Pointer to array to store the hashing result in.
  * @param[in]  data        Pointer to array with data to hash.
- * @param[in]  sign_key    Pointer to array with key to hash with.
  *
  * @returns Nothing.
  */
-static void sign_data(uint8_t *p_digest, uint8_t *data, uint8_t *sign_key) {
-    char hex_buff[HEX_MAX_BUF_SIZE];
-	
-    uint32_t err_code = NRF_SUCCESS;
+static void sign_data(uint8_t *p_digest, uint8_t *data) {
+    ocrypto_sha256_ctx ctx = m_hmac_inner;
+    ocrypto_sha256_update(&ctx, data, SALT_SIZE);
+    ocrypto_sha256_final(&ctx, p_digest);
 
+    ctx = m_hmac_outer;
+    ocrypto_sha256_update(&ctx, p_digest, NRF_CRYPTO_HASH_SIZE_SHA256);
+    ocrypto_sha256_final(&ctx, p_digest);
+}
+
+#if NRF_MODULE_ENABLED(DEBUG)
+/**@brief Function for checking cached signing against nrf_crypto HMAC and comparing their cost.
+ * @ingroup bleam_security
+ *
+ * @param[in]  sign_key    Pointer to array with key to hash with.
+ *
+ * @returns Nothing.
+ */
+static void sign_data_benchmark(uint8_t *sign_key) {
+    static nrf_crypto_hmac_context_t context;
+    uint8_t salt[SALT_SIZE] = {0};
+    uint8_t digest_ref[NRF_CRYPTO_HASH_SIZE_SHA256];
+    uint8_t digest[NRF_CRYPTO_HASH_SIZE_SHA256];
     size_t digest_len = NRF_CRYPTO_HASH_SIZE_SHA256;
-    memset(p_digest, 0, digest_len);
-      
-    // Initialize the hash context
-    err_code = nrf_crypto_hmac_init(&m_context, 
-                                    &g_nrf_crypto_hmac_sha256_info,
-                                    sign_key,                             // Pointer to key buffer.
-                                    BLEAM_KEY_SIZE);                   // Length of key.
- 
-    APP_ERROR_CHECK(err_code);
+    ret_code_t err_code;
 
-    // Run the update function (this can be run multiples of time if the data is accessible
-    // in smaller chunks, e.g. when received on-air.
-    err_code = nrf_crypto_hmac_update(&m_context, data, SALT_SIZE);
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    uint32_t cycles_start = DWT->CYCCNT;
+    err_code = nrf_crypto_hmac_calculate(&context, &g_nrf_crypto_hmac_sha256_info, digest_ref, &digest_len,
+                                         sign_key, BLEAM_KEY_SIZE, salt, SALT_SIZE);
     APP_ERROR_CHECK(err_code);
+    const uint32_t cycles_ref = DWT->CYCCNT - cycles_start;
+
+    cycles_start = DWT->CYCCNT;
+    sign_data(digest, salt);
+    const uint32_t cycles = DWT->CYCCNT - cycles_start;
+
+    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "Signing: nrf_crypto %u cycles, cached %u cycles, %s\r\n",
+          cycles_ref, cycles, (0 == memcmp(digest_ref, digest, NRF_CRYPTO_HASH_SIZE_SHA256)) ? "match" : "MISMATCH");
+}
+#endif
+
+/**@brief Function for finding the latency histogram bucket of a phase duration.
+ * @ingroup bleam_connect
+ *
+ * @param[in] ms    Phase duration, ms.
+ *
+ * @returns Bucket index, bucket 0 holds durations under 8 ms and each next one twice as long.
+ */
+static uint8_t session_hist_bucket(uint32_t ms) {
+    uint8_t bucket = 0;
+    for (uint32_t limit = 8; SESSION_HIST_BUCKETS - 1 > bucket && ms >= limit; limit <<= 1) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+/**@brief Function for moving current session to another phase.
+ * @ingroup bleam_connect
+ *
+ * @details Time spent in the previous phase is added to the session and to phase latency histograms.
+ *
+ * @param[in] phase    New phase, @ref session_phase_t.
+ *
+ * @returns Nothing.
+ */
+static void session_phase_set(uint8_t phase) {
+    if (phase == m_session.phase) {
+        return;
+    }
+    if (SESSION_PHASE_NONE != m_session.phase) {
+        const uint32_t ms = (uint64_t)how_long_ago(m_session.phase_tick) * 1000 / APP_TIMER_TICKS(1000);
+        m_session.phase_ms[m_session.phase] = MIN((uint32_t)m_session.phase_ms[m_session.phase] + ms, UINT16_MAX);
+        uint16_t * p_count = &m_session_hist[m_session.phase][session_hist_bucket(ms)];
+        if (UINT16_MAX > *p_count) {
+            ++*p_count;
+        }
+        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG2, "Session phase %u -> %u after %u ms\r\n", m_session.phase, phase, ms);
+    }
+    m_session.phase = phase;
+    m_session.phase_tick = blesc_ticks_now();
+}
+
+/**@brief Function for moving current session to the phase of data being sent to BLEAM.
+ * @ingroup bleam_connect
+ *
+ * @returns Nothing.
+ */
+static void session_phase_sync(void) {
+    switch (bleam_send_char_get()) {
+    case BLEAM_S_SIGN:
+        session_phase_set(SESSION_PHASE_SIGN);
+        break;
+    case BLEAM_S_HEALTH:
+        session_phase_set(SESSION_PHASE_HEALTH);
+        break;
+    case BLEAM_S_RSSI:
+        session_phase_set(SESSION_PHASE_RSSI);
+        break;
+    default:
+        break;
+    }
+}
+
+/**@brief Function for starting a new connection session.
+ * @ingroup bleam_connect
+ *
+ * @returns Nothing.
+ */
+static void session_begin(void) {
+    m_session.phase = SESSION_PHASE_NONE;
+    m_session.signature_halves = 0;
+    m_session.handles_cached = false;
+    memset(m_session.phase_ms, 0, sizeof(m_session.phase_ms));
+    m_session.start_tick = blesc_ticks_now();
+    session_phase_set(SESSION_PHASE_CONNECTING);
+}
+
+/**@brief Function for finishing current connection session and reporting its phase times.
+ * @ingroup bleam_connect
+ *
+ * @returns Nothing.
+ */
+static void session_end(void) {
+    if (SESSION_PHASE_NONE == m_session.phase) {
+        return;
+    }
+    session_phase_set(SESSION_PHASE_NONE);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "Session %u ms: connect %u, discovery %u, salt %u, sign %u, health %u, RSSI %u, time %u, disconnect %u\r\n",
+          (uint32_t)((uint64_t)how_long_ago(m_session.start_tick) * 1000 / APP_TIMER_TICKS(1000)),
+          m_session.phase_ms[SESSION_PHASE_CONNECTING], m_session.phase_ms[SESSION_PHASE_DISCOVERY],
+          m_session.phase_ms[SESSION_PHASE_SALT], m_session.phase_ms[SESSION_PHASE_SIGN],
+          m_session.phase_ms[SESSION_PHASE_HEALTH], m_session.phase_ms[SESSION_PHASE_RSSI],
+          m_session.phase_ms[SESSION_PHASE_TIME], m_session.phase_ms[SESSION_PHASE_DISCONNECT]);
+
+    if (0 != (++m_session_cnt % SESSION_HIST_LOG_PERIOD)) {
+        return;
+    }
+    for (uint8_t phase = SESSION_PHASE_CONNECTING; SESSION_PHASE_CNT > phase; ++phase) {
+        const uint16_t * p_hist = m_session_hist[phase];
+        __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Phase %u histogram: %u %u %u %u %u %u %u %u %u %u\r\n", phase,
+              p_hist[0], p_hist[1], p_hist[2], p_hist[3], p_hist[4], p_hist[5], p_hist[6], p_hist[7], p_hist[8], p_hist[9]);
+    }
+}
+
+/**@brief Function for disconnecting current connection.
+ * @ingroup bleam_connect
+ *
+ * @returns Nothing.
+ */
+static void session_disconnect(void) {
+    if (SESSION_PHASE_NONE != m_session.phase) {
+        session_phase_set(SESSION_PHASE_DISCONNECT);
+    }
+    ret_code_t err_code = sd_ble_gap_disconnect(m_session.conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+    if(NRF_ERROR_INVALID_STATE != err_code)
+        APP_ERROR_CHECK(err_code);
+}
+
+/**@brief Function for looking up a recently connected BLEAM device.
+ * @ingroup bleam_connect
+ *
+ * @details Cache is kept apart from RSSI storage, which is cleared on delivery.
+ *
+ * @param[in] p_uuid    BLEAM UUID of the device.
+ * @param[in] p_mac     MAC address of the device.
+ *
+ * @returns Pointer to the cache entry, NULL if not found.
+ */
+static bleam_peer_cache_entry_t * peer_cache_find(const uint8_t * p_uuid, const uint8_t * p_mac) {
+    for (uint8_t index = 0; APP_CONFIG_PEER_CACHE_SIZE > index; ++index) {
+        bleam_peer_cache_entry_t * p_entry = &m_peer_cache[index];
+        if (0 != p_entry->last_used &&
+            0 == memcmp(p_entry->bleam_uuid, p_uuid, APP_CONFIG_BLEAM_UUID_SIZE) &&
+            0 == memcmp(p_entry->mac, p_mac, BLE_GAP_ADDR_LEN)) {
+            p_entry->last_used = ++m_peer_cache_clock;
+            return p_entry;
+        }
+    }
+    return NULL;
+}
 
-    //__LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Source string (length %u:)", p_for_sign.length)
-    //NRF_LOG_HEXDUMP_INFO( p_for_sign.p_data, sizeof(p_for_sign.p_data) );
+/**@brief Function for getting a cache entry for a BLEAM device, adding it if needed.
+ * @ingroup bleam_connect
+ *
+ * @details Least recently used entry is replaced when the cache is full.
+ *
+ * @param[in] p_uuid    BLEAM UUID of the device.
+ * @param[in] p_mac     MAC address of the device.
+ *
+ * @returns Pointer to the cache entry.
+ */
+static bleam_peer_cache_entry_t * peer_cache_get(const uint8_t * p_uuid, const uint8_t * p_mac) {
+    bleam_peer_cache_entry_t * p_entry = peer_cache_find(p_uuid, p_mac);
+    if (NULL == p_entry) {
+        p_entry = &m_peer_cache[0];
+        for (uint8_t index = 1; APP_CONFIG_PEER_CACHE_SIZE > index; ++index) {
+            if (m_peer_cache[index].last_used < p_entry->last_used) {
+                p_entry = &m_peer_cache[index];
+            }
+        }
+        memset(p_entry, 0, sizeof(bleam_peer_cache_entry_t));
+        memcpy(p_entry->bleam_uuid, p_uuid, APP_CONFIG_BLEAM_UUID_SIZE);
+        memcpy(p_entry->mac, p_mac, BLE_GAP_ADDR_LEN);
+        p_entry->conn_profile = BLESC_CONN_PROFILE_FAST;
+        p_entry->last_used = ++m_peer_cache_clock;
+    }
+    return p_entry;
+}
+
+/**@brief Function for choosing connection parameter profile for a BLEAM device.
+ * @ingroup bleam_connect
+ *
+ * @param[in] p_uuid    BLEAM UUID of the device.
+ * @param[in] p_mac     MAC address of the device.
+ *
+ * @returns @ref BLESC_CONN_PROFILE_SAFE if the device rejected fast transfer parameters before,
+ *          @ref BLESC_CONN_PROFILE_FAST otherwise.
+ */
+static uint8_t conn_profile_get(const uint8_t * p_uuid, const uint8_t * p_mac) {
+    const bleam_peer_cache_entry_t * p_entry = peer_cache_find(p_uuid, p_mac);
+    return (NULL == p_entry) ? BLESC_CONN_PROFILE_FAST : p_entry->conn_profile;
+}
 
-    // Run the finalize when all data has been fed to the update function.
-    // this gives you the result
-    err_code = nrf_crypto_hmac_finalize(&m_context, p_digest, &digest_len);
+/**@brief Function for preparing and executing a connection to BLEAM.
+ * @ingroup bleam_connect
+ *
+ * @details Connection parameter profile is chosen by @ref conn_profile_get.
+ *
+ * @param[in]  p_uuid      BLEAM UUID of the device, zeroes for unknown iOS device.
+ * @param[out] p_mac       MAC address of a BLEAM device to connect to.
+ *
+ * @returns Nothing.
+ */
+static void try_connect(const uint8_t * p_uuid, uint8_t * p_mac) {
+    ASSERT(NULL != p_mac);
+
+    // If connection is happening right now, we can't connect
+    if (BLE_CONN_HANDLE_INVALID != m_session.conn_handle)
+        return;
+
+    node_state_set(BLESC_STATE_CONNECT);
+
+    ble_gap_addr_t p_ble_gap_addr = {
+        .addr_type = scan_address_type_decode(p_mac),
+    };
+    for (uint8_t i = 0; i < BLE_GAP_ADDR_LEN; ++i) {
+        p_ble_gap_addr.addr[i] = p_mac[i];
+    }
+
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "MAC: %02x-%02x-%02x-%02x-%02x-%02x\r\n",
+        p_ble_gap_addr.addr[5],
+        p_ble_gap_addr.addr[4],
+        p_ble_gap_addr.addr[3],
+        p_ble_gap_addr.addr[2],
+        p_ble_gap_addr.addr[1],
+        p_ble_gap_addr.addr[0]);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Addr type: 0x%02X\r\n", p_ble_gap_addr.addr_type);
+
+    if (BLE_GAP_ADDR_TYPE_ANONYMOUS == p_ble_gap_addr.addr_type || BLE_ERROR_GAP_INVALID_BLE_ADDR == p_ble_gap_addr.addr_type) {
+        scan_start();
+        return;
+    }
+
+    // doesn't seem to connect well to public address
+    if (BLE_GAP_ADDR_TYPE_PUBLIC == p_ble_gap_addr.addr_type) {
+        p_ble_gap_addr.addr_type = BLE_GAP_ADDR_TYPE_RANDOM_STATIC;
+    }
+
+    ble_gap_scan_params_t p_scan_params;
+    memcpy(&p_scan_params, &(m_scan.scan_params), sizeof(ble_gap_scan_params_t));
+    // Scanner copy holds the tuned window, initiator always listens with the full one
+    p_scan_params.window   = SCAN_WINDOW;
+    p_scan_params.interval = SCAN_INTERVAL;
+    p_scan_params.timeout  = CONNECT_TIMEOUT;
+    // Session keeps its own copy of the peer key, storage entry may be cleared before disconnect
+    memcpy(m_session.bleam_uuid, p_uuid, APP_CONFIG_BLEAM_UUID_SIZE);
+    memcpy(m_session.mac, p_mac, BLE_GAP_ADDR_LEN);
+    m_session.conn_profile = conn_profile_get(p_uuid, p_mac);
+    ble_gap_conn_params_t const *p_conn_params = &m_conn_profiles[m_session.conn_profile];
+    uint8_t con_cfg_tag = m_scan.conn_cfg_tag;
+
+    session_begin();
+    ret_code_t err_code = sd_ble_gap_connect(&p_ble_gap_addr,
+                                             (ble_gap_scan_params_t const *)(&p_scan_params),
+                                             p_conn_params,
+                                             con_cfg_tag);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLE GAP CONNECT RETURN CODE: %d\r\n", err_code);
     APP_ERROR_CHECK(err_code);
 }
 
-/**@brief Function for preparing and executing a connection to BLEAM.
+/**@brief Function for trying to connect to chosen BLEAM device.
+ * @ingroup bleam_connect
+ *
+ * @param[in] p_index      Index of chosen BLEAM device data in storage.
+ * @param[in] scheduled    True if the device comes from connection queue, see @ref conn_scheduler_finish.
+ *
+ * @returns Nothing.
+ */
+static void try_bleam_connect(uint16_t p_index, bool scheduled) {
+#if APP_CONFIG_ADV_CAPTURE_ENABLED
+    if (m_adv_replay_active) {
+        // Count the attempt and act as if RSSI data was delivered
+        ++m_adv_replay_stats.connect_attempts;
+        clear_rssi_data(&bleam_rssi_data[p_index]);
+        return;
+    }
+#endif
+    m_session.bleam_index = p_index;
+    m_session.scheduled = scheduled;
+
+    __LOG_XB(LOG_SRC_APP, LOG_LEVEL_INFO, "\n\n\nConnecting to BLEAM with UUID",
+        bleam_rssi_data[m_session.bleam_index].bleam_uuid, APP_CONFIG_BLEAM_UUID_SIZE);
+
+    try_connect(bleam_rssi_data[m_session.bleam_index].bleam_uuid, bleam_rssi_data[m_session.bleam_index].mac);
+}
+
+/**@brief Function for trying to connect to chosen BLEAM device on iOS
+ *        with BLEAM service running in the background.
+ * @ingroup bleam_connect
+ *
+ * @returns Nothing.
+ */
+static void try_ios_connect() {
+#if APP_CONFIG_ADV_CAPTURE_ENABLED
+    if (m_adv_replay_active) {
+        ++m_adv_replay_stats.connect_attempts;
+        memset(&stupid_ios_data, 0, sizeof(bleam_ios_rssi_data_t));
+        return;
+    }
+#endif
+    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "\n\n\nSTUPID Connecting to iOS BLEAM\r\n");
+
+    try_connect(stupid_ios_data.bleam_uuid, stupid_ios_data.mac);
+}
+
+/**@brief Function for calculating connection priority of a BLEAM device.
+ * @ingroup bleam_connect
+ *
+ * @details More samples, stronger signal and longer wait raise the score,
+ *          failed deliveries lower it, so one unreachable device does not
+ *          block the others.
+ *
+ * @param[in] p_data    Pointer to BLEAM device storage entry.
+ *
+ * @returns Connection score.
+ */
+static int32_t conn_score(const blesc_model_rssi_data_t * p_data) {
+#if APP_CONFIG_RSSI_SUMMARY_ENABLED
+    const int32_t samples = MIN(p_data->summary.count, APP_CONFIG_RSSI_PER_MSG);
+    const int32_t rssi_mean = (int32_t)p_data->summary.mean;
+#else
+    const int32_t samples = p_data->scans_stored_cnt;
+    int32_t rssi_mean = 0;
+    for (uint8_t cnt = 0; p_data->scans_stored_cnt > cnt; ++cnt) {
+        rssi_mean += p_data->rssi[cnt];
+    }
+    rssi_mean /= p_data->scans_stored_cnt;
+#endif
+    return samples * CONN_SCORE_SAMPLE
+         + rssi_mean
+         + (int32_t)(how_long_ago(p_data->first_seen) / APP_TIMER_TICKS(1000)) * CONN_SCORE_AGE_SEC
+         - (int32_t)p_data->failures * CONN_SCORE_FAILURE;
+}
+
+/**@brief Function for queueing BLEAM devices that are ready to connect to.
+ * @ingroup bleam_connect
+ *
+ * @param[in] scan_over    True if scan-connect window is over and partial data has to be sent.
+ *
+ * @returns Number of queued devices.
+ */
+static uint16_t conn_scheduler_build(bool scan_over) {
+    int32_t scores[APP_CONFIG_MAX_BLEAMS];
+    m_conn_queue_len = 0;
+    m_conn_queue_pos = 0;
+    for (uint16_t index = 0; APP_CONFIG_MAX_BLEAMS > index; ++index) {
+        if (!rssi_data_ready(&bleam_rssi_data[index], scan_over)) {
+            continue;
+        }
+        // Insertion sort, best score first
+        const int32_t score = conn_score(&bleam_rssi_data[index]);
+        uint16_t pos = m_conn_queue_len++;
+        for (; 0 < pos && scores[pos - 1] < score; --pos) {
+            scores[pos] = scores[pos - 1];
+            m_conn_queue[pos] = m_conn_queue[pos - 1];
+        }
+        scores[pos] = score;
+        m_conn_queue[pos] = index;
+    }
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "%u BLEAMs ready to connect\r\n", m_conn_queue_len);
+    return m_conn_queue_len;
+}
+
+/**@brief Function for connecting to the next queued BLEAM device.
+ * @ingroup bleam_connect
+ *
+ * @returns Boolean value denoting if a connection has been started.
+ */
+static bool conn_scheduler_next(void) {
+    while (m_conn_queue_len > m_conn_queue_pos) {
+        const uint16_t index = m_conn_queue[m_conn_queue_pos++];
+        // Device could have been dropped since the queue was built
+        if (!bleam_rssi_data[index].active || 0 == bleam_rssi_data[index].scans_stored_cnt) {
+            continue;
+        }
+        try_bleam_connect(index, true);
+        return true;
+    }
+    m_conn_queue_len = 0;
+    m_conn_queue_pos = 0;
+    return false;
+}
+
+/**@brief Function for accounting the end of a scheduled connection.
+ * @ingroup bleam_connect
+ *
+ * @details Delivered RSSI data is cleared from storage, so stored samples
+ *          left after disconnect mean delivery failed. Has to be called on disconnect
+ *          before anything else clears the entry.
+ *
+ * @returns Nothing.
+ */
+static void conn_scheduler_finish(void) {
+    if (!m_session.scheduled) {
+        return;
+    }
+    m_session.scheduled = false;
+    blesc_model_rssi_data_t * p_data = &bleam_rssi_data[m_session.bleam_index];
+    if (p_data->active && 0 != p_data->scans_stored_cnt) {
+        if (APP_CONFIG_CONN_MAX_FAILURES <= ++p_data->failures) {
+            __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Dropping BLEAM after %u failed deliveries\r\n", p_data->failures);
+            clear_rssi_data(p_data);
+        }
+    }
+}
+
+/**@brief Function for accounting delivery of RSSI data of a BLEAM device.
+ * @ingroup bleam_connect
+ *
+ * @param[in] p_data    Pointer to BLEAM device storage entry.
+ *
+ * @returns Nothing.
+ */
+static void conn_report_delivered(const blesc_model_rssi_data_t * p_data) {
+    const uint32_t latency_ms = (uint64_t)how_long_ago(p_data->first_seen) * 1000 / APP_TIMER_TICKS(1000);
+    ++m_report_cnt;
+    m_report_latency_sum += latency_ms;
+    m_report_latency_max = MAX(m_report_latency_max, latency_ms);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Report latency %u ms, avg %u ms, max %u ms\r\n",
+          latency_ms, m_report_latency_sum / m_report_cnt, m_report_latency_max);
+}
+
+/**@brief Function for looking up BLEAM service handles of the session BLEAM.
+ * @ingroup bleam_connect
+ *
+ * @returns Pointer to cached handles, NULL if not found.
+ */
+static const bleam_service_db_t * handle_cache_find(void) {
+    const bleam_peer_cache_entry_t * p_entry = peer_cache_find(m_session.bleam_uuid, m_session.mac);
+    return (NULL != p_entry && p_entry->handles_valid) ? &p_entry->handles : NULL;
+}
+
+/**@brief Function for remembering discovered BLEAM service handles of the session BLEAM.
+ * @ingroup bleam_connect
+ *
+ * @param[in] p_handles    Pointer to discovered handles.
+ *
+ * @returns Nothing.
+ */
+static void handle_cache_store(const bleam_service_db_t * p_handles) {
+    bleam_peer_cache_entry_t * p_entry = peer_cache_get(m_session.bleam_uuid, m_session.mac);
+    p_entry->handles = *p_handles;
+    p_entry->handles_valid = true;
+}
+
+/**@brief Function for forgetting BLEAM service handles of the session BLEAM.
  * @ingroup bleam_connect
  *
- * @param[out] p_mac       MAC address of a BLEAM device to connect to.
+ * @details Connection profile of the device is kept.
  *
  * @returns Nothing.
  */
-static void try_connect(uint8_t * p_mac) {
-    ASSERT(NULL != p_mac);
-
-    // If connection is happening right now, we can't connect
-    if (BLE_CONN_HANDLE_INVALID != m_conn_handle)
-        return;
-
-    m_blesc_node_state = BLESC_STATE_CONNECT;
-
-    ble_gap_addr_t p_ble_gap_addr = {
-        .addr_type = scan_address_type_decode(p_mac),
-    };
-    for (uint8_t i = 0; i < BLE_GAP_ADDR_LEN; ++i) {
-        p_ble_gap_addr.addr[i] = p_mac[i];
+static void handle_cache_remove(void) {
+    bleam_peer_cache_entry_t * p_entry = peer_cache_find(m_session.bleam_uuid, m_session.mac);
+    if (NULL != p_entry) {
+        p_entry->handles_valid = false;
     }
+}
 
-    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "MAC: %02x-%02x-%02x-%02x-%02x-%02x\r\n",
-        p_ble_gap_addr.addr[5],
-        p_ble_gap_addr.addr[4],
-        p_ble_gap_addr.addr[3],
-        p_ble_gap_addr.addr[2],
-        p_ble_gap_addr.addr[1],
-        p_ble_gap_addr.addr[0]);
-    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Addr type: 0x%02X\r\n", p_ble_gap_addr.addr_type);
-
-    if (BLE_GAP_ADDR_TYPE_ANONYMOUS == p_ble_gap_addr.addr_type || BLE_ERROR_GAP_INVALID_BLE_ADDR == p_ble_gap_addr.addr_type) {
-        scan_start();
-        return;
-    }
+/**@brief Function for starting BLEAM service discovery on connected BLEAM.
+ * @ingroup bleam_connect
+ *
+ * @returns Nothing.
+ */
+static void bleam_discovery_start(void) {
+    ret_code_t err_code;
 
-    // doesn't seem to connect well to public address
-    if (BLE_GAP_ADDR_TYPE_PUBLIC == p_ble_gap_addr.addr_type) {
-        p_ble_gap_addr.addr_type = BLE_GAP_ADDR_TYPE_RANDOM_STATIC;
+    ble_uuid128_t m_bleam_service_base_uuid = {BLE_UUID_BLEAM_SERVICE_BASE_UUID};
+    for(uint8_t i = 1 + APP_CONFIG_BLEAM_UUID_SIZE, j = 0; APP_CONFIG_BLEAM_UUID_SIZE > j;) {
+        m_bleam_service_base_uuid.uuid128[i--] = bleam_rssi_data[m_session.bleam_index].bleam_uuid[j++];
     }
+    __LOG_XB(LOG_SRC_APP, LOG_LEVEL_INFO, "Add new BASE UUID", m_bleam_service_base_uuid.uuid128, 16);
+    err_code = bleam_service_uuid_vs_replace(&m_bleam_service_client, &m_bleam_service_base_uuid);
+    APP_ERROR_CHECK(err_code);
 
-    ble_gap_scan_params_t p_scan_params;
-    memcpy(&p_scan_params, &(m_scan.scan_params), sizeof(ble_gap_scan_params_t));
-    p_scan_params.timeout = CONNECT_TIMEOUT;
-    ble_gap_conn_params_t const *p_conn_params = &(m_scan.conn_params);
-    uint8_t con_cfg_tag = m_scan.conn_cfg_tag;
-
-    ret_code_t err_code = sd_ble_gap_connect(&p_ble_gap_addr,
-                                             (ble_gap_scan_params_t const *)(&p_scan_params),
-                                             p_conn_params,
-                                             con_cfg_tag);
-    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLE GAP CONNECT RETURN CODE: %d\r\n", err_code);
+    memset(&m_db_disc, 0, sizeof(m_db_disc));
+    err_code = ble_db_discovery_start(&m_db_disc, m_session.conn_handle);
     APP_ERROR_CHECK(err_code);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Discovering services\r\n");
 }
 
-/**@brief Function for trying to connect to chosen BLEAM device.
+/**@brief Function for enabling BLEAM notifications once BLEAM service handles are known.
  * @ingroup bleam_connect
  *
- * @param[in] p_index    Index of chosen BLEAM device data in storage.
+ * @param[in] p_bleam_client    Pointer to BLEAM service client.
  *
  * @returns Nothing.
  */
-static void try_bleam_connect(uint8_t p_index) {
-    m_bleam_uuid_index = p_index;
-
-    __LOG_XB(LOG_SRC_APP, LOG_LEVEL_INFO, "\n\n\nConnecting to BLEAM with UUID",
-        bleam_rssi_data[m_bleam_uuid_index].bleam_uuid, APP_CONFIG_BLEAM_UUID_SIZE);
+static void bleam_notify_start(bleam_service_client_t * p_bleam_client) {
+    ret_code_t err_code;
 
-    try_connect(bleam_rssi_data[m_bleam_uuid_index].mac);
+    // IOS BLEAM won't send salt if there is already a BLEAM Scanner connection happening
+    err_code = blesc_wakeup_start(m_bleam_inactivity_timer_id, BLEAM_SERVICE_BLEAM_INACTIVITY_TIMEOUT, NULL);
+    APP_ERROR_CHECK(err_code);
+    // read salt
+    err_code = bleam_service_client_notify_enable(p_bleam_client);
+    if(NRF_SUCCESS != err_code) {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Can't enable notify, remote disconnected\r\n");
+        session_disconnect();
+    }
 }
 
-/**@brief Function for trying to connect to chosen BLEAM device on iOS
- *        with BLEAM service running in the background.
+/**@brief Function for accounting time from BLEAM connection to the first data write.
  * @ingroup bleam_connect
  *
  * @returns Nothing.
  */
-static void try_ios_connect() {
-    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "\n\n\nSTUPID Connecting to iOS BLEAM\r\n");
+static void conn_first_write_account(void) {
+    const uint32_t latency_ms = (uint64_t)how_long_ago(m_session.start_tick) * 1000 / APP_TIMER_TICKS(1000);
+    m_first_write_sum[m_session.handles_cached] += latency_ms;
+    ++m_first_write_cnt[m_session.handles_cached];
+    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "Connect to first write %u ms, avg discovered %u ms, avg cached %u ms\r\n", latency_ms,
+          m_first_write_cnt[0] ? m_first_write_sum[0] / m_first_write_cnt[0] : 0,
+          m_first_write_cnt[1] ? m_first_write_sum[1] / m_first_write_cnt[1] : 0);
+}
 
-    try_connect(stupid_ios_data.mac);
+/**@brief Function for switching the session peer to fallback connection parameters.
+ * @ingroup bleam_connect
+ *
+ * @details Called when the peer did not accept fast transfer parameters,
+ *          following connections to it use @ref BLESC_CONN_PROFILE_SAFE.
+ *          Choice is kept in @ref m_peer_cache next to service handles.
+ *
+ * @returns Nothing.
+ */
+static void conn_profile_fallback(void) {
+    if (BLESC_CONN_PROFILE_FAST != m_session.conn_profile) {
+        return;
+    }
+    bleam_peer_cache_entry_t * p_entry = peer_cache_get(m_session.bleam_uuid, m_session.mac);
+    if (BLESC_CONN_PROFILE_SAFE != p_entry->conn_profile) {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLEAM rejected fast connection parameters, falling back\r\n");
+        p_entry->conn_profile = BLESC_CONN_PROFILE_SAFE;
+    }
 }
 
 /***********************  HANDLERS  *************************/
@@ -681,48 +1681,48 @@ static void try_ios_connect() {
  * @ingroup blesc_app
  *
  * @details If there is no pending log operation, then sleep until next the next event occurs.
+ *          Watchdog is fed here on every wakeup, once pending work is done,
+ *          and its own wakeup is pushed back, see @ref wdt_timer_handler.
  *
  * @returns Nothing.
  */
 static void idle_state_handle(void) {
     UNUSED_RETURN_VALUE(NRF_LOG_PROCESS());
-    nrf_pwr_mgmt_run();
+    blesc_rng_pool_fill();
     nrf_drv_wdt_channel_feed(m_channel_id);
+    // Deadline only moves later, so this does not reprogram the RTC
+    blesc_wakeup_start(m_wdt_timer_id, WDT_FEED_INTERVAL, NULL);
+    blesc_energy_sleep_set(true);
+    nrf_pwr_mgmt_run();
+    blesc_energy_sleep_set(false);
 }
 
-/**@brief Function for handling the system time increments.
+/**@brief Function for handling the system time timer timeout at a period start.
  * @ingroup bleam_time
  *
+ * @details System time itself is computed from the RTC counter when needed,
+ *          this timer only wakes the node up when there is something to do.
+ *
  * @param[in] p_context   Pointer used for passing some arbitrary information (context) from the
  *                        app_start_timer() call to the timeout handler.
  *
  * @returns Nothing.
  */
 static void system_time_timer_handler(void * p_context) {
-    // If in eco mode, feed watchdog as well
-    if (m_blesc_node_state == BLESC_STATE_IDLE) {
-        nrf_drv_wdt_channel_feed(m_channel_id);
-    }
-    ++m_system_time;
-    if (m_system_time >= 24 * 60 * 60) {
-        m_system_time = 0;
-        m_system_time_needs_update = true;
-    }
-
-    if(0 == m_system_time % 60) {
-        ++m_blesc_uptime;
-    }
+    blesc_energy_update();
 
-    if (BLESC_DAYTIME_START == m_system_time) {
-        m_blesc_time_period = BLESC_TIME_PERIODS_DAY * BLESC_TIME_PERIOD_SECS;
-    } else if (BLESC_NIGHTTIME_START == m_system_time) {
-        m_blesc_time_period = BLESC_TIME_PERIODS_NIGHT * BLESC_TIME_PERIOD_SECS;
-    }
+    // Follow learned BLEAM activity, keeping wakeups on the shared period grid
+    const uint32_t time_ms = system_time_ms_get();
+    const uint32_t period_ms = m_blesc_time_period * 1000;
+    // Timer may fire just short of a period start, then it is rescheduled to the start
+    const bool on_period_start = (time_ms % period_ms < 1000);
+    m_blesc_time_period = blesc_duty_period_get(time_ms / 1000);
 
     // try start scan every period
-    if(0 == m_system_time % m_blesc_time_period && m_blesc_node_state == BLESC_STATE_IDLE) {
+    if(on_period_start && m_blesc_node_state == BLESC_STATE_IDLE) {
         eco_timer_handler(NULL);
     }
+    system_time_timer_schedule();
 }
 
 /**@brief Function for handling the scan-connect timer timeout
@@ -734,9 +1734,10 @@ static void system_time_timer_handler(void * p_context) {
  * @returns Nothing.
  */
 static void scan_connect_timer_handle(void *p_context) {
+    // Outcome of the scan is recorded by @ref scan_stop
     if (m_bleam_nearby == false) {
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLESC doesn't see any BLEAMs around.\r\n");
-        for(uint8_t index = 0; APP_CONFIG_MAX_BLEAMS > index; ++index) {
+        for(uint16_t index = 0; APP_CONFIG_MAX_BLEAMS > index; ++index) {
             clear_rssi_data(&bleam_rssi_data[index]);
         }
         eco_timer_handler(NULL);
@@ -744,34 +1745,35 @@ static void scan_connect_timer_handle(void *p_context) {
     }
 
     scan_stop();
-    m_blesc_node_state = BLESC_STATE_CONNECT;
+    node_state_set(BLESC_STATE_CONNECT);
 
     __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLEAM scan timed out, looking for BLEAM to connect.\r\n");
 
-    for(uint8_t index = 0; APP_CONFIG_MAX_BLEAMS > index; ++index) {
-        if(bleam_rssi_data[index].active) {
-            try_bleam_connect(index);
-            return;
-        }
+    // Connect to every BLEAM with samples back-to-back, best first
+    conn_scheduler_build(true);
+    if(conn_scheduler_next()) {
+        return;
     }
 
     // In case there's no BLEAMS in storage, make some
-    m_blesc_node_state = BLESC_STATE_SCANNING;
+    node_state_set(BLESC_STATE_SCANNING);
     scan_start();
 }
 
-/**@brief Function for handling the Eco Watchdog timer timeout.
+/**@brief Function for handling the watchdog wakeup timer timeout.
  * @ingroup blesc_app
  *
- * @details This function will feed the watchdog while the node is in Eco mode
+ * @details Watchdog is fed in @ref idle_state_handle on the wakeups the node needs anyway.
+ *          This timer is restarted there too, so it only wakes the node if
+ *          nothing else did for @ref WDT_FEED_INTERVAL.
  *
  * @param[in] p_context   Pointer used for passing some arbitrary information (context) from the
  *                        app_start_timer() call to the timeout handler.
  *
  * @returns Nothing.
  */
-static void eco_watchdog_timer_handler(void * p_context) {
-    nrf_drv_wdt_channel_feed(m_channel_id);
+static void wdt_timer_handler(void * p_context) {
+    UNUSED_PARAMETER(p_context);
 }
 
 /**@brief Function for handling the Eco timer timeout.
@@ -789,25 +1791,22 @@ static void eco_timer_handler(void * p_context) {
     __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Eco timer interrupt\r\n");
     switch(m_blesc_node_state) {
     case BLESC_STATE_CONNECT:
-        m_blesc_node_state = BLESC_STATE_SCANNING;
+        node_state_set(BLESC_STATE_SCANNING);
     case BLESC_STATE_IDLE:
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Eco IDLE -> SCANNING\r\n");
-        m_blesc_node_state = BLESC_STATE_SCANNING;
-        app_timer_start(m_eco_timer_id, BLESC_SCAN_TIME, NULL);
-        app_timer_stop(m_eco_watchdog_timer_id);
-        // clear old lists
-        mac_in_blacklist(NULL);
-        mac_in_whitelist(NULL, NULL);
+        node_state_set(BLESC_STATE_SCANNING);
+        blesc_wakeup_start(m_eco_timer_id, BLESC_SCAN_TIME, NULL);
         scan_start();
         break;
     case BLESC_STATE_SCANNING:
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Eco SCANNING -> IDLE\r\n");
-        app_timer_start(m_eco_watchdog_timer_id, APP_TIMER_TICKS(1500), NULL);
         scan_stop();
-        m_blesc_node_state = BLESC_STATE_IDLE;
-        // In case BLEAM Scanner is going to idle for a long time,
-        // make sure it asks for time on next connection
-        m_system_time_needs_update = true;
+        node_state_set(BLESC_STATE_IDLE);
+#if APP_CONFIG_ADV_CAPTURE_ENABLED
+        if (APP_CONFIG_ADV_CAPTURE_SIZE == m_adv_capture_cnt && !m_adv_replay_done) {
+            adv_capture_replay();
+        }
+#endif
         break;
     }
 }
@@ -823,12 +1822,14 @@ static void eco_timer_handler(void * p_context) {
  * @returns Nothing.
  */
 static void bleam_inactivity_timeout_handler(void *p_context) {
-    if(BLE_CONN_HANDLE_INVALID != m_conn_handle) {
+    if(BLE_CONN_HANDLE_INVALID != m_session.conn_handle) {
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Didn't receive data from BLEAM\r\n");
-        clear_rssi_data(&bleam_rssi_data[m_bleam_uuid_index]);
-        ret_code_t err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-        if(NRF_ERROR_INVALID_STATE != err_code)
-            APP_ERROR_CHECK(err_code);
+        // Cached handles may be stale, discover services next time
+        if(m_session.handles_cached) {
+            handle_cache_remove();
+        }
+        clear_rssi_data(&bleam_rssi_data[m_session.bleam_index]);
+        session_disconnect();
     }
 }
 
@@ -932,14 +1933,18 @@ static void db_disc_handler(ble_db_discovery_evt_t *p_evt) {
  */
 void bleam_service_discovery_evt_handler(const bleam_service_discovery_evt_t *p_evt) {
     // Whatever it was, we have to disconnect
-    if(p_evt->conn_handle != m_conn_handle)
+    if(p_evt->conn_handle != m_session.conn_handle)
         return;
-    ret_code_t err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-    if(NRF_ERROR_INVALID_STATE != err_code)
-        APP_ERROR_CHECK(err_code);
+    session_disconnect();
+
+    bleam_service_discovery_stats_t stats;
+    bleam_service_discovery_stats_get(&stats);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "iOS discovery: %u services, %u reads, %u requests, %u ms\r\n",
+          stats.services, stats.reads, stats.round_trips, stats.duration_ms);
+
     // Check if the BLEAM Service was discovered on iOS.
     if (p_evt->evt_type == BLEAM_SERVICE_DISCOVERY_COMPLETE && p_evt->params.srv_uuid16.uuid == BLEAM_SERVICE_UUID) {
-        if(stupid_ios_data.active) {
+        if(IOS_STATE_NONE != stupid_ios_data.state) {
             m_bleam_nearby = true;
 
             for(int i = 1 + APP_CONFIG_BLEAM_UUID_SIZE, j = 0; i > 1;)
@@ -947,8 +1952,8 @@ void bleam_service_discovery_evt_handler(const bleam_service_discovery_evt_t *p_
             // Save device to storage
             if(!mac_in_whitelist(stupid_ios_data.mac, stupid_ios_data.bleam_uuid))
                 add_mac_in_whitelist(stupid_ios_data.mac, stupid_ios_data.bleam_uuid);
-            const uint8_t uuid_index = app_blesc_save_bleam_to_storage(stupid_ios_data.bleam_uuid, stupid_ios_data.mac);
-            stupid_ios_data.active = 0;
+            const uint16_t uuid_index = app_blesc_save_bleam_to_storage(stupid_ios_data.bleam_uuid, stupid_ios_data.mac);
+            stupid_ios_data.state = IOS_STATE_NONE;
             // If storage is full
             if (APP_CONFIG_MAX_BLEAMS == uuid_index) {
                 __LOG(LOG_SRC_APP, LOG_LEVEL_WARN, "BLEAM storage full!\r\n");
@@ -957,7 +1962,7 @@ void bleam_service_discovery_evt_handler(const bleam_service_discovery_evt_t *p_
             __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Scanned iOS RSSI %d\r\n", (int8_t)stupid_ios_data.rssi);
             uint8_t aoa = 0;
             if(app_blesc_save_rssi_to_storage(uuid_index, &stupid_ios_data.rssi, &aoa)) {
-                try_bleam_connect(uuid_index);
+                try_bleam_connect(uuid_index, false);
             }
         }
     } else if (p_evt->evt_type == BLE_DB_DISCOVERY_SRV_NOT_FOUND ||
@@ -966,7 +1971,7 @@ void bleam_service_discovery_evt_handler(const bleam_service_discovery_evt_t *p_
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Wrong iOS device!\r\n");
         if(!mac_in_blacklist(stupid_ios_data.mac))
             add_mac_in_blacklist(stupid_ios_data.mac);
-        stupid_ios_data.active = 0;
+        stupid_ios_data.state = IOS_STATE_NONE;
         eco_timer_handler(NULL);
     }
 }
@@ -986,6 +1991,7 @@ static void ble_evt_handler(ble_evt_t const *p_ble_evt, void *p_context) {
     switch (p_ble_evt->header.evt_id) {
     case BLE_GAP_EVT_CONNECTED:
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Gap event: Connected\r\n");
+        blesc_energy_conn_set(true);
 
         if(BLE_CONN_HANDLE_INVALID == p_gap_evt->conn_handle) {
             __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Connection handle is bogus\r\n");
@@ -998,41 +2004,44 @@ static void ble_evt_handler(ble_evt_t const *p_ble_evt, void *p_context) {
         // Connected to config service
         if(CONFIG_S_STATUS_WAITING == config_s_get_status()) {
             sd_ble_gap_adv_stop(m_adv_handle);
-            m_conn_handle = p_gap_evt->conn_handle;
-            err_code = nrf_ble_qwr_conn_handle_assign(&m_qwr, m_conn_handle);
+            m_session.conn_handle = p_gap_evt->conn_handle;
+            err_code = nrf_ble_qwr_conn_handle_assign(&m_qwr, m_session.conn_handle);
             APP_ERROR_CHECK(err_code);
         } else
         // If unknown iOS, we look for BLEAM service the stupid way via service discovery and GATTC read
-        if (CONFIG_S_STATUS_DONE == config_s_get_status() && stupid_ios_data.active) {
-            m_conn_handle = p_gap_evt->conn_handle;
-            bleam_service_discovery_start(&m_db_disc, m_conn_handle);
+        if (CONFIG_S_STATUS_DONE == config_s_get_status() && IOS_STATE_NONE != stupid_ios_data.state) {
+            m_session.conn_handle = p_gap_evt->conn_handle;
+            session_phase_set(SESSION_PHASE_DISCOVERY);
+            bleam_service_discovery_start(&m_db_disc, m_session.conn_handle);
             __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Discovering services on iOS.\r\n");
         } else
         // Connected to BLEAM and configuration is over
-        if (CONFIG_S_STATUS_DONE == config_s_get_status() && APP_CONFIG_MAX_BLEAMS != m_bleam_uuid_index) {
+        if (CONFIG_S_STATUS_DONE == config_s_get_status() && APP_CONFIG_MAX_BLEAMS != m_session.bleam_index) {
             err_code = bleam_service_client_handles_assign(&m_bleam_service_client, p_gap_evt->conn_handle, NULL);
             APP_ERROR_CHECK(err_code);
 
             err_code = bsp_indication_set(BSP_INDICATE_CONNECTED);
             APP_ERROR_CHECK(err_code);
-            m_conn_handle = p_gap_evt->conn_handle;
-            err_code = nrf_ble_qwr_conn_handle_assign(&m_qwr, m_conn_handle);
+            m_session.conn_handle = p_gap_evt->conn_handle;
+            err_code = nrf_ble_qwr_conn_handle_assign(&m_qwr, m_session.conn_handle);
             APP_ERROR_CHECK(err_code);
-
-            ble_uuid128_t m_bleam_service_base_uuid = {BLE_UUID_BLEAM_SERVICE_BASE_UUID};
-            for(uint8_t i = 1 + APP_CONFIG_BLEAM_UUID_SIZE, j = 0; APP_CONFIG_BLEAM_UUID_SIZE > j;) {
-                m_bleam_service_base_uuid.uuid128[i--] = bleam_rssi_data[m_bleam_uuid_index].bleam_uuid[j++];
+            m_session.start_tick = blesc_ticks_now();
+
+            // Known BLEAM, skip service discovery
+            const bleam_service_db_t * p_cached = handle_cache_find();
+            m_session.handles_cached = (NULL != p_cached);
+            if(m_session.handles_cached) {
+                __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Using cached BLEAM service handles\r\n");
+                err_code = bleam_service_client_handles_assign(&m_bleam_service_client, m_session.conn_handle, p_cached);
+                APP_ERROR_CHECK(err_code);
+                session_phase_set(SESSION_PHASE_SALT);
+                bleam_notify_start(&m_bleam_service_client);
+            } else {
+                session_phase_set(SESSION_PHASE_DISCOVERY);
+                bleam_discovery_start();
             }
-            __LOG_XB(LOG_SRC_APP, LOG_LEVEL_INFO, "Add new BASE UUID", m_bleam_service_base_uuid.uuid128, 16);
-            err_code = bleam_service_uuid_vs_replace(&m_bleam_service_client, &m_bleam_service_base_uuid);
-            APP_ERROR_CHECK(err_code);
-
-            memset(&m_db_disc, 0, sizeof(m_db_disc));
-            err_code = ble_db_discovery_start(&m_db_disc, m_conn_handle);
-            APP_ERROR_CHECK(err_code);
 //            err_code = app_timer_start(m_bleam_inactivity_timer_id, APP_TIMER_TICKS(3000), NULL);
 //            APP_ERROR_CHECK(err_code);
-            __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Discovering services\r\n");
 
             blesc_toggle_leds(0, 1);
         } else {
@@ -1046,27 +2055,44 @@ static void ble_evt_handler(ble_evt_t const *p_ble_evt, void *p_context) {
 
     case BLE_GAP_EVT_DISCONNECTED:
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Gap event: Disconnected\r\n");
-        m_conn_handle = BLE_CONN_HANDLE_INVALID;
+        blesc_energy_conn_set(false);
+        m_session.conn_handle = BLE_CONN_HANDLE_INVALID;
         if(CONFIG_S_STATUS_DONE == config_s_get_status()) {
-            if(1 == stupid_ios_data.active) {
+            session_end();
+            if(BLE_HCI_CONN_INTERVAL_UNACCEPTABLE == p_gap_evt->params.disconnected.reason ||
+               BLE_HCI_CONN_FAILED_TO_BE_ESTABLISHED == p_gap_evt->params.disconnected.reason) {
+                conn_profile_fallback();
+            }
+            if(IOS_STATE_DISCOVER == stupid_ios_data.state) {
                 memset(&stupid_ios_data, 0, sizeof(bleam_ios_rssi_data_t));
-            } else if(2 == stupid_ios_data.active) {
+            } else if(IOS_STATE_RETRY == stupid_ios_data.state) {
                 try_ios_connect();
             }
-            // clear old lists
-            mac_in_whitelist(NULL, NULL);
-            mac_in_blacklist(NULL);
-
-            scan_start();
+            conn_scheduler_finish();
+            // Drain the rest of ready BLEAMs before going back to scanning
+            if(IOS_STATE_RETRY == stupid_ios_data.state || !conn_scheduler_next()) {
+                scan_start();
+            }
         }
         break;
 
     case BLE_GAP_EVT_TIMEOUT:
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Gap event: Timeout\r\n");
+        if(BLE_GAP_TIMEOUT_SRC_CONN == p_gap_evt->params.timeout.src) {
+            session_end();
+            conn_scheduler_finish();
+            if(conn_scheduler_next()) {
+                break;
+            }
+        }
         scan_start();
         break;
 
     case BLE_GAP_EVT_CONN_PARAM_UPDATE_REQUEST:
+        // Peer wants slower parameters than fast transfer profile, use its choice from the start next time
+        if(p_gap_evt->params.conn_param_update_request.conn_params.min_conn_interval > FAST_MAX_CONN_INTERVAL) {
+            conn_profile_fallback();
+        }
         // Accept parameters requested by peer.
         err_code = sd_ble_gap_conn_param_update(p_gap_evt->conn_handle,
             &p_gap_evt->params.conn_param_update_request.conn_params);
@@ -1085,33 +2111,42 @@ static void ble_evt_handler(ble_evt_t const *p_ble_evt, void *p_context) {
 
     case BLE_GAP_EVT_SEC_PARAMS_REQUEST:
         // Pairing not supported
-        err_code = sd_ble_gap_sec_params_reply(m_conn_handle, BLE_GAP_SEC_STATUS_PAIRING_NOT_SUPP, NULL, NULL);
+        err_code = sd_ble_gap_sec_params_reply(m_session.conn_handle, BLE_GAP_SEC_STATUS_PAIRING_NOT_SUPP, NULL, NULL);
         APP_ERROR_CHECK(err_code);
         break;
 
     case BLE_GATTS_EVT_SYS_ATTR_MISSING:
         // No system attributes have been stored.
-        err_code = sd_ble_gatts_sys_attr_set(m_conn_handle, NULL, 0, 0);
+        err_code = sd_ble_gatts_sys_attr_set(m_session.conn_handle, NULL, 0, 0);
         APP_ERROR_CHECK(err_code);
         break;
 
     case BLE_GATTC_EVT_TIMEOUT:
         // Disconnect on GATT Client timeout event.
-        if(BLE_CONN_HANDLE_INVALID != m_conn_handle && p_ble_evt->evt.gattc_evt.conn_handle == m_conn_handle) {
+        if(BLE_CONN_HANDLE_INVALID != m_session.conn_handle && p_ble_evt->evt.gattc_evt.conn_handle == m_session.conn_handle) {
             __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "GATT Client Timeout.\r\n");
-            err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-            if(NRF_ERROR_INVALID_STATE != err_code)
-                APP_ERROR_CHECK(err_code);
+            session_disconnect();
         }
         break;
 
     case BLE_GATTS_EVT_TIMEOUT:
         // Disconnect on GATT Server timeout event.
-        if(BLE_CONN_HANDLE_INVALID != m_conn_handle && p_ble_evt->evt.gatts_evt.conn_handle == m_conn_handle) {
+        if(BLE_CONN_HANDLE_INVALID != m_session.conn_handle && p_ble_evt->evt.gatts_evt.conn_handle == m_session.conn_handle) {
             __LOG(LOG_SRC_APP, LOG_LEVEL_INFO,  "GATT Server Timeout.\r\n");
-            err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-            if(NRF_ERROR_INVALID_STATE != err_code)
-                APP_ERROR_CHECK(err_code);
+            session_disconnect();
+        }
+        break;
+
+    case BLE_GATTC_EVT_WRITE_RSP:
+        // Write to cached handle failed, handles may be stale, fall back to service discovery
+        if(m_session.handles_cached && p_ble_evt->evt.gattc_evt.conn_handle == m_bleam_service_client.conn_handle &&
+           BLE_GATT_STATUS_SUCCESS != p_ble_evt->evt.gattc_evt.gatt_status) {
+            __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Cached BLEAM service handles failed, GATT status 0x%04X\r\n", p_ble_evt->evt.gattc_evt.gatt_status);
+            blesc_wakeup_stop(m_bleam_inactivity_timer_id);
+            handle_cache_remove();
+            m_session.handles_cached = false;
+            session_phase_set(SESSION_PHASE_DISCOVERY);
+            bleam_discovery_start();
         }
         break;
 
@@ -1119,7 +2154,8 @@ static void ble_evt_handler(ble_evt_t const *p_ble_evt, void *p_context) {
         // Finished writing a package to BLEAM, may proceed
         if (CONFIG_S_STATUS_DONE == config_s_get_status()) {
             // If device is configured, we were probably sending RSSI data
-            bleam_send_continue();
+            bleam_send_continue(p_ble_evt->evt.gattc_evt.params.write_cmd_tx_complete.count);
+            session_phase_sync();
         } else if (CONFIG_S_STATUS_FAIL == config_s_get_status()) {
             // If device isn't configured and config status written was FAIL, reinit FDS and reset
             nrf_sdh_disable_request();
@@ -1209,15 +2245,11 @@ static void config_s_event_handler(config_s_server_t *p_config_s_server, config_
             if (CONFIG_S_STATUS_SET == config_s_get_status() && CONFIG_S_STATUS_DONE == p_evt_write->data[0]) {
                 // Configuration finished
                 config_s_finish();
-                err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-                if(NRF_ERROR_INVALID_STATE != err_code)
-                    APP_ERROR_CHECK(err_code);
+                session_disconnect();
                 leave_config_mode();
             } else if (CONFIG_S_STATUS_FAIL == p_evt_write->data[0]) {
                 // Configuration failed
-                err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-                if(NRF_ERROR_INVALID_STATE != err_code)
-                    APP_ERROR_CHECK(err_code);
+                session_disconnect();
                 memset(&m_blesc_config, 0, sizeof(configuration_t));
                 flash_config_delete();
             }
@@ -1264,7 +2296,7 @@ static void battery_level_measure(void) {
     }
     __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Battery level is at " NRF_LOG_FLOAT_MARKER " V, %d.\r\n", NRF_LOG_FLOAT(voltage_batt_lvl), (int)(voltage_batt_lvl * 10));
 
-    bleam_health_queue_add(voltage_batt_lvl * 10, m_blesc_uptime, m_system_time);
+    bleam_health_queue_add(voltage_batt_lvl * 10, uptime_secs_get() / 60, system_time_get());
 #endif
 }
 
@@ -1293,7 +2325,7 @@ void saadc_event_handler(nrf_drv_saadc_evt_t const * p_event)
         voltage_batt_lvl = (ADC_RESULT_IN_MILLI_VOLTS(adc_result) + DIODE_FWD_VOLT_DROP_MILLIVOLTS) * 0.001;
 
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Battery level is at "NRF_LOG_FLOAT_MARKER" V, %d.\r\n", NRF_LOG_FLOAT(voltage_batt_lvl), (int)(voltage_batt_lvl * 10));
-        bleam_health_queue_add(voltage_batt_lvl * 10, m_blesc_uptime, m_system_time);
+        bleam_health_queue_add(voltage_batt_lvl * 10, uptime_secs_get() / 60, system_time_get());
     }
 }
 #endif
@@ -1329,24 +2361,15 @@ static void bleam_service_evt_handler(bleam_service_client_t *p_bleam_client, bl
     case BLEAM_SERVICE_CLIENT_EVT_DISCOVERY_COMPLETE: {
 //        app_timer_stop(m_bleam_inactivity_timer_id);
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLEAM service event: Service discovery complete\r\n");
-
-        // IOS BLEAM won't send salt if there is already a BLEAM Scanner connection happening
-        err_code = app_timer_start(m_bleam_inactivity_timer_id, BLEAM_SERVICE_BLEAM_INACTIVITY_TIMEOUT, NULL);
-        APP_ERROR_CHECK(err_code);
-        // read salt
-        err_code = bleam_service_client_notify_enable(p_bleam_client);
-        if(NRF_SUCCESS != err_code) {
-            __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Can't enable notify, remote disconnected\r\n");
-            err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-            if(NRF_ERROR_INVALID_STATE != err_code)
-                APP_ERROR_CHECK(err_code);
-        }
+        handle_cache_store(&p_evt->handles);
+        session_phase_set(SESSION_PHASE_SALT);
+        bleam_notify_start(p_bleam_client);
         break;
     }
 
     case BLEAM_SERVICE_CLIENT_EVT_RECV_SALT: {
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLEAM service event: Received salt\r\n");
-        app_timer_stop(m_bleam_inactivity_timer_id);
+        blesc_wakeup_stop(m_bleam_inactivity_timer_id);
 
         uint8_t cmd = p_evt->p_data[0];
         // Received salt for regular BLEAM connect
@@ -1355,25 +2378,25 @@ static void bleam_service_evt_handler(bleam_service_client_t *p_bleam_client, bl
             uint8_t salt[SALT_SIZE];
             memcpy(salt, p_evt->p_data + 1, SALT_SIZE);
             __LOG_XB(LOG_SRC_APP, LOG_LEVEL_INFO, "Received salt", salt, SALT_SIZE);
-            sign_data(m_digest, salt, m_blesc_config.app_key);
+            sign_data(m_digest, salt);
             __LOG_XB(LOG_SRC_APP, LOG_LEVEL_INFO, "Signed salt", m_digest, NRF_CRYPTO_HASH_SIZE_SHA256);
+            conn_first_write_account();
             bleam_send_init(p_bleam_client, m_digest);
+            session_phase_sync();
         // Received first half of BLEAM signature
         } else if(BLEAM_SERVICE_CLIENT_CMD_SIGN1 == cmd) {
-            m_bleam_signature_halves |= 1;
+            m_session.signature_halves |= 1;
             memcpy(m_bleam_signature, p_evt->p_data + 1, SALT_SIZE);
         // Received second half of BLEAM signature
         } else if(BLEAM_SERVICE_CLIENT_CMD_SIGN2 == cmd) {
-            m_bleam_signature_halves |= 2;
+            m_session.signature_halves |= 2;
             memcpy(m_bleam_signature + SALT_SIZE, p_evt->p_data + 1, SALT_SIZE);
             // If signature received is incorrect, disconnect
-            if(m_bleam_signature_halves != 3
+            if(m_session.signature_halves != 3
                || 0 != memcmp(m_digest, m_bleam_signature, NRF_CRYPTO_HASH_SIZE_SHA256)) {
                 // TODO: Maybe add to blacklist?
-                clear_rssi_data(&bleam_rssi_data[m_bleam_uuid_index]);
-                err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-                if(NRF_ERROR_INVALID_STATE != err_code)
-                    APP_ERROR_CHECK(err_code);
+                clear_rssi_data(&bleam_rssi_data[m_session.bleam_index]);
+                session_disconnect();
                 break;
             }
             // If signature matches, do da thing
@@ -1382,7 +2405,7 @@ static void bleam_service_evt_handler(bleam_service_client_t *p_bleam_client, bl
                 enter_dfu_mode();
 #else
                 __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "This firmware does not support DFU.\r\n");
-                err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+                err_code = sd_ble_gap_disconnect(m_session.conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
 //                APP_ERROR_CHECK(err_code);
 #endif
             } else if(BLEAM_SERVICE_CLIENT_MODE_REBOOT == bleam_service_mode_get()) {
@@ -1394,16 +2417,21 @@ static void bleam_service_evt_handler(bleam_service_client_t *p_bleam_client, bl
         } else {
             __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Received NOTIFY command %u\r\n", cmd);
             // Send salt to BLEAM to confirm BLEAM is genuine
-            uint8_t salt[BLEAM_MAX_DATA_LEN] = {0};
-            err_code = nrf_crypto_rng_vector_generate(salt, SALT_SIZE);
+            uint8_t salt[BLEAM_SALT_DATA_LEN] = {0};
+            if (!blesc_rng_pool_get(salt, SALT_SIZE)) {
+                __LOG(LOG_SRC_APP, LOG_LEVEL_WARN, "Random pool empty, generating salt.\r\n");
+                err_code = nrf_crypto_rng_vector_generate(salt, SALT_SIZE);
+                APP_ERROR_CHECK(err_code);
+            }
             __LOG_XB(LOG_SRC_APP, LOG_LEVEL_INFO, "Generated salt", salt, SALT_SIZE);
-            sign_data(m_digest, salt, m_blesc_config.app_key);
+            sign_data(m_digest, salt);
             __LOG_XB(LOG_SRC_APP, LOG_LEVEL_INFO, "Signature for BLEAM to match", m_digest, NRF_CRYPTO_HASH_SIZE_SHA256);
-            m_bleam_signature_halves = 0;
+            m_session.signature_halves = 0;
             memset(m_bleam_signature, 0, NRF_CRYPTO_HASH_SIZE_SHA256);
             bleam_send_salt(p_bleam_client, salt);
+            session_phase_set(SESSION_PHASE_SIGN);
             // Wait for signature in salt
-            err_code = app_timer_start(m_bleam_inactivity_timer_id, BLEAM_SERVICE_BLEAM_INACTIVITY_TIMEOUT, NULL);
+            err_code = blesc_wakeup_start(m_bleam_inactivity_timer_id, BLEAM_SERVICE_BLEAM_INACTIVITY_TIMEOUT, NULL);
             APP_ERROR_CHECK(err_code);
             // Prepare for DFU mode, 
             if(BLEAM_SERVICE_CLIENT_CMD_DFU == cmd) {
@@ -1418,10 +2446,8 @@ static void bleam_service_evt_handler(bleam_service_client_t *p_bleam_client, bl
                 bleam_service_mode_set(BLEAM_SERVICE_CLIENT_MODE_UNCONFIG);
             } else {
                 __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Impossible NOTIFY command %u\r\n", cmd);
-                clear_rssi_data(&bleam_rssi_data[m_bleam_uuid_index]);
-                err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-                if(NRF_ERROR_INVALID_STATE != err_code)
-                    APP_ERROR_CHECK(err_code);
+                clear_rssi_data(&bleam_rssi_data[m_session.bleam_index]);
+                session_disconnect();
                 break;
             }
         }
@@ -1432,49 +2458,73 @@ static void bleam_service_evt_handler(bleam_service_client_t *p_bleam_client, bl
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLEAM service event: Done sending signature\r\n");
 
         if(BLEAM_SERVICE_CLIENT_MODE_RSSI == bleam_service_mode_get()) {
+            bleam_send_batch_header_set(m_blesc_config.node_id, system_time_get());
+
             // Collect and send health data
             battery_level_measure();
+            blesc_energy_report_t energy_report;
+            blesc_energy_report_get(&energy_report);
+            __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "Energy: idle %u s, scanning %u s, connect %u s, sleep %u s, %u uAh\r\n",
+                  energy_report.state_secs[BLESC_STATE_IDLE], energy_report.state_secs[BLESC_STATE_SCANNING],
+                  energy_report.state_secs[BLESC_STATE_CONNECT], energy_report.sleep_secs, energy_report.charge_uah);
+            bleam_health_energy_queue_add(&energy_report);
 
             // Collect and send RSSI data
+#if APP_CONFIG_RSSI_SUMMARY_ENABLED
+            const blesc_rssi_summary_t * p_summary = &bleam_rssi_data[m_session.bleam_index].summary;
+            const float variance = (1 < p_summary->count) ? p_summary->m2 / (p_summary->count - 1) : 0;
+            bleam_service_rssi_summary_t summary = {
+                .sender_id = m_blesc_config.node_id,
+                .count     = p_summary->count,
+                .min       = p_summary->min,
+                .max       = p_summary->max,
+                .mean      = (int8_t)(p_summary->mean - 0.5f),
+                .median    = p_summary->median,
+                .variance  = (uint16_t)MIN(variance * 10 + 0.5f, UINT16_MAX),
+                .aoa       = bleam_rssi_data[m_session.bleam_index].aoa[0],
+            };
+            bleam_rssi_summary_add(&summary);
+            session_phase_sync();
+#else
+            const blesc_model_rssi_data_t * p_data = &bleam_rssi_data[m_session.bleam_index];
+            const uint32_t elapsed_ms = (uint64_t)how_long_ago(p_data->first_seen) * 1000 / APP_TIMER_TICKS(1000);
             for(uint8_t cnt = 0; APP_CONFIG_RSSI_PER_MSG > cnt; ++cnt) {
-                bleam_rssi_queue_add(m_blesc_config.node_id, bleam_rssi_data[m_bleam_uuid_index].rssi[cnt], bleam_rssi_data[m_bleam_uuid_index].aoa[cnt]);
+                const uint32_t age_ms = (elapsed_ms > p_data->offset_ms[cnt]) ? elapsed_ms - p_data->offset_ms[cnt] : 0;
+                bleam_rssi_queue_add(m_blesc_config.node_id, p_data->rssi[cnt], p_data->aoa[cnt], age_ms);
             }
+            session_phase_sync();
+#endif
         }
         break;
     }
 
     case BLEAM_SERVICE_CLIENT_EVT_DONE_SENDING: {
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLEAM service event: Done sending data\r\n");
-        mac_in_whitelist(bleam_rssi_data[m_bleam_uuid_index].mac, NULL);
-        clear_rssi_data(&bleam_rssi_data[m_bleam_uuid_index]);
+        mac_in_whitelist(bleam_rssi_data[m_session.bleam_index].mac, NULL);
+        conn_report_delivered(&bleam_rssi_data[m_session.bleam_index]);
+        clear_rssi_data(&bleam_rssi_data[m_session.bleam_index]);
 
-        // Wind up the clock
-        if(m_system_time_needs_update) {
+        // Wind up the clock only when it may have drifted off the period grid
+        if(system_time_needs_update()) {
             if(NRF_SUCCESS == bleam_service_client_read_time(p_bleam_client)) {
+                session_phase_set(SESSION_PHASE_TIME);
                 break;
             }
         }
-        err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-        if(NRF_ERROR_INVALID_STATE != err_code)
-            APP_ERROR_CHECK(err_code);
+        session_disconnect();
         break;
     }
 
     case BLEAM_SERVICE_CLIENT_EVT_RECV_TIME: {
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLEAM service event: Received time\r\n");
-        if(m_system_time_needs_update) {
-            system_time_update((uint32_t *)p_evt->p_data);
-        }
-        err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-        if(NRF_ERROR_INVALID_STATE != err_code)
-            APP_ERROR_CHECK(err_code);
+        system_time_update((uint32_t *)p_evt->p_data);
+        session_disconnect();
         break;
     }
 
     case BLEAM_SERVICE_CLIENT_EVT_DISCONNECTED: {
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLEAM service event: Disconnected\r\n");
-        // clear data just in case
-        clear_rssi_data(&bleam_rssi_data[m_bleam_uuid_index]);
+        // Undelivered RSSI data stays in storage, @ref conn_scheduler_finish decides whether to retry or drop it
         bleam_service_mode_set(BLEAM_SERVICE_CLIENT_MODE_NONE);
         bleam_send_uninit();
         break;
@@ -1482,30 +2532,26 @@ static void bleam_service_evt_handler(bleam_service_client_t *p_bleam_client, bl
 
     case BLEAM_SERVICE_CLIENT_EVT_SRV_NOT_FOUND: {
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLEAM service event: BLEAM service not found\r\n");
-//        if(!mac_in_blacklist(bleam_rssi_data[m_bleam_uuid_index].mac))
-//            add_mac_in_blacklist(bleam_rssi_data[m_bleam_uuid_index].mac);
-        stupid_ios_data.active = 2;
+//        if(!mac_in_blacklist(bleam_rssi_data[m_session.bleam_index].mac))
+//            add_mac_in_blacklist(bleam_rssi_data[m_session.bleam_index].mac);
+        stupid_ios_data.state = IOS_STATE_RETRY;
         uint8_t last_scan_index = 0;
-        if(0 < bleam_rssi_data[m_bleam_uuid_index].scans_stored_cnt)
-            last_scan_index = bleam_rssi_data[m_bleam_uuid_index].scans_stored_cnt - 1;
-        stupid_ios_data.rssi = bleam_rssi_data[m_bleam_uuid_index].rssi[last_scan_index];
-        stupid_ios_data.aoa = bleam_rssi_data[m_bleam_uuid_index].aoa[last_scan_index];
-        memcpy(stupid_ios_data.mac, bleam_rssi_data[m_bleam_uuid_index].mac, BLE_GAP_ADDR_LEN);
-        memcpy(stupid_ios_data.bleam_uuid, bleam_rssi_data[m_bleam_uuid_index].bleam_uuid, APP_CONFIG_BLEAM_UUID_SIZE);
-
-        clear_rssi_data(&bleam_rssi_data[m_bleam_uuid_index]);
-        err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-        if(NRF_ERROR_INVALID_STATE != err_code)
-            APP_ERROR_CHECK(err_code);
+        if(0 < bleam_rssi_data[m_session.bleam_index].scans_stored_cnt)
+            last_scan_index = bleam_rssi_data[m_session.bleam_index].scans_stored_cnt - 1;
+        stupid_ios_data.rssi = bleam_rssi_data[m_session.bleam_index].rssi[last_scan_index];
+        stupid_ios_data.aoa = bleam_rssi_data[m_session.bleam_index].aoa[last_scan_index];
+        memcpy(stupid_ios_data.mac, bleam_rssi_data[m_session.bleam_index].mac, BLE_GAP_ADDR_LEN);
+        memcpy(stupid_ios_data.bleam_uuid, bleam_rssi_data[m_session.bleam_index].bleam_uuid, APP_CONFIG_BLEAM_UUID_SIZE);
+
+        clear_rssi_data(&bleam_rssi_data[m_session.bleam_index]);
+        session_disconnect();
         break;
     }
 
     case BLEAM_SERVICE_CLIENT_EVT_BAD_CONNECTION: {
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLEAM service event: Bad connection\r\n");
-        clear_rssi_data(&bleam_rssi_data[m_bleam_uuid_index]);
-        err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-        if(NRF_ERROR_INVALID_STATE != err_code)
-            APP_ERROR_CHECK(err_code);
+        clear_rssi_data(&bleam_rssi_data[m_session.bleam_index]);
+        session_disconnect();
         break;
     }
 
@@ -1533,7 +2579,7 @@ static void conn_params_evt_handler(ble_conn_params_evt_t *p_evt) {
 
     if (p_evt->evt_type == BLE_CONN_PARAMS_EVT_FAILED) {
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Conn params event FAILED\r\n");
-        err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_CONN_INTERVAL_UNACCEPTABLE);
+        err_code = sd_ble_gap_disconnect(m_session.conn_handle, BLE_HCI_CONN_INTERVAL_UNACCEPTABLE);
         if(NRF_ERROR_INVALID_STATE != err_code)
             APP_ERROR_CHECK(err_code);
     }
@@ -1550,6 +2596,62 @@ static void conn_params_error_handler(uint32_t nrf_error) {
     APP_ERROR_HANDLER(nrf_error);
 }
 
+/**@brief Function for classifying an advertising report in a single pass.
+ * @ingroup bleam_scan
+ *
+ * @details Function walks the AD structures of the report once and looks for
+ *          the BLEAM service 128-bit UUID and for Apple manufacturer specific data.
+ *          BLEAM UUID takes precedence over Apple data, so the walk stops as soon
+ *          as a BLEAM UUID is found. Nothing is copied: on success @p p_field
+ *          points into the original report payload, right after the AD type octet.
+ *
+ * @param[in]  p_adv_data    Pointer to the advertising report payload.
+ * @param[out] p_field       Pointer to the AD structure data that was matched.
+ *
+ * @returns Report class @ref blesc_adv_type_t.
+ */
+static blesc_adv_type_t adv_report_classify(data_t const * p_adv_data, data_t * p_field) {
+    blesc_adv_type_t adv_type = BLESC_ADV_TYPE_IGNORE;
+    uint16_t index = 0;
+
+    while (p_adv_data->data_len > index) {
+        uint8_t const field_len = p_adv_data->p_data[index];
+        // Zero length field marks the end of significant data
+        if (0 == field_len || p_adv_data->data_len < index + 1 + field_len) {
+            break;
+        }
+        uint8_t const * p_field_data = &p_adv_data->p_data[index + 2];
+
+        switch (p_adv_data->p_data[index + 1]) {
+        case BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_COMPLETE:
+            if (ADV_BLEAM_UUID_FIELD_LEN == field_len &&
+                uuid_bleam_to_scan[0] == p_field_data[13] &&
+                uuid_bleam_to_scan[1] == p_field_data[12]) {
+                p_field->p_data = (uint8_t *)p_field_data;
+                p_field->data_len = field_len - 1;
+                return BLESC_ADV_TYPE_BLEAM;
+            }
+            break;
+
+        case BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA:
+            if (BLESC_ADV_TYPE_IGNORE == adv_type &&
+                ADV_APPLE_DATA_FIELD_LEN == field_len &&
+                (uint8_t)(ADV_APPLE_COMPANY_ID & 0x00FF) == p_field_data[0] &&
+                (uint8_t)(ADV_APPLE_COMPANY_ID >> 8) == p_field_data[1]) {
+                p_field->p_data = (uint8_t *)p_field_data;
+                p_field->data_len = field_len - 1;
+                adv_type = BLESC_ADV_TYPE_APPLE;
+            }
+            break;
+
+        default:
+            break;
+        }
+        index += 1 + field_len;
+    }
+    return adv_type;
+}
+
 /**@brief Function for handling received device adv data.
  * @ingroup bleam_scan
  *
@@ -1562,44 +2664,32 @@ static void conn_params_error_handler(uint32_t nrf_error) {
  * @returns Nothing.
  */
 static void process_scan_data(ble_gap_evt_adv_report_t const *p_adv_report) {
-    ret_code_t err_code;
-    uint8_t idx = 0;
-    uint16_t dev_name_offset = 0;
-    uint16_t field_len;
-    data_t adv_data;
-    uint32_t time_diff;
-
-    // Initialize advertisement report for parsing
-    adv_data.p_data = (uint8_t *)p_adv_report->data.p_data;
-    adv_data.data_len = p_adv_report->data.len;
-
-    uint8_t p_data_uuid[20] = {0};
-
-    for(uint8_t i = 0; p_adv_report->data.len > i; ++i) {
-        if(adv_data.p_data[i] == 17 &&
-            adv_data.data_len >= i + 1 + adv_data.p_data[i] &&
-            adv_data.p_data[i+1] == 0x07) {
-           memcpy(p_data_uuid, &adv_data.p_data[i+2], adv_data.p_data[i]-1);
-           break;
-        }
-        i += adv_data.p_data[i];
-    }
+    data_t adv_data = {
+        .p_data = (uint8_t *)p_adv_report->data.p_data,
+        .data_len = p_adv_report->data.len,
+    };
+    data_t adv_field;
 
+    switch (adv_report_classify(&adv_data, &adv_field)) {
     // Show BLEAM scans
-    if (p_data_uuid[13] == uuid_bleam_to_scan[0] && p_data_uuid[12] == uuid_bleam_to_scan[1]) {
+    case BLESC_ADV_TYPE_BLEAM: {
 //        __LOG(LOG_SRC_APP, LOG_LEVEL_WARN, "NORMAL BLEAM!\r\n");
-        m_bleam_nearby = true;
-        app_timer_stop(m_eco_timer_id);
+        ++m_scan_stats.bleam;
+        if (!blesc_replay_active()) {
+            m_bleam_nearby = true;
+            blesc_scan_tune_report();
+            blesc_wakeup_stop(m_eco_timer_id);
+        }
 
         uint8_t bleam_uuid_to_send[APP_CONFIG_BLEAM_UUID_SIZE];
         for(int i = 1 + APP_CONFIG_BLEAM_UUID_SIZE, j = 0; i > 1;)
-            bleam_uuid_to_send[j++] = p_data_uuid[i--];
+            bleam_uuid_to_send[j++] = adv_field.p_data[i--];
 
         if(NULL == mac_in_whitelist(p_adv_report->peer_addr.addr, bleam_uuid_to_send))
             add_mac_in_whitelist(p_adv_report->peer_addr.addr, bleam_uuid_to_send);
         
         // Save device to storage
-        const uint8_t uuid_index = app_blesc_save_bleam_to_storage(bleam_uuid_to_send, p_adv_report->peer_addr.addr);
+        const uint16_t uuid_index = app_blesc_save_bleam_to_storage(bleam_uuid_to_send, p_adv_report->peer_addr.addr);
         // If storage is full
         if(APP_CONFIG_MAX_BLEAMS == uuid_index) {
             __LOG(LOG_SRC_APP, LOG_LEVEL_WARN, "BLEAM storage full!\r\n");
@@ -1608,32 +2698,29 @@ static void process_scan_data(ble_gap_evt_adv_report_t const *p_adv_report) {
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Scanned RSSI %d\r\n", (int8_t)p_adv_report->rssi);
         uint8_t aoa = 0;
         if(app_blesc_save_rssi_to_storage(uuid_index, &p_adv_report->rssi, &aoa)) {
-            scan_stop();
-            try_bleam_connect(uuid_index);
+            if (!blesc_replay_active()) {
+                scan_stop();
+            }
+            conn_scheduler_build(false);
+            conn_scheduler_next();
         }
-        return;
+        break;
     }
 
-    memset(p_data_uuid, 0, 20);
-    for(uint8_t i = 0; p_adv_report->data.len > i; ++i) {
-        if(adv_data.p_data[i] == 20 &&
-            adv_data.data_len >= i + 1 + adv_data.p_data[i] &&
-            adv_data.p_data[i+1] == 0xFF) {
-           memcpy(p_data_uuid, &adv_data.p_data[i+2], adv_data.p_data[i]-1);
-           break;
-        }
-        i += adv_data.p_data[i];
-    }
     // Apple twist
-    if (p_data_uuid[0] == 0x4C && p_data_uuid[1] == 00) {
+    case BLESC_ADV_TYPE_APPLE: {
 //        __LOG(LOG_SRC_APP, LOG_LEVEL_WARN, "APPLE TWIST!\r\n");
+        ++m_scan_stats.apple;
         uint8_t * bleam_uuid_to_send;
         bleam_uuid_to_send = mac_in_whitelist(p_adv_report->peer_addr.addr, NULL);
         if(NULL != bleam_uuid_to_send) {// Save device to storage
-            app_timer_stop(m_eco_timer_id);
-            m_bleam_nearby = true;
+            if (!blesc_replay_active()) {
+                blesc_wakeup_stop(m_eco_timer_id);
+                blesc_scan_tune_report();
+                m_bleam_nearby = true;
+            }
 
-            const uint8_t uuid_index = app_blesc_save_bleam_to_storage(bleam_uuid_to_send, p_adv_report->peer_addr.addr);
+            const uint16_t uuid_index = app_blesc_save_bleam_to_storage(bleam_uuid_to_send, p_adv_report->peer_addr.addr);
             // If storage is full
             if(APP_CONFIG_MAX_BLEAMS == uuid_index) {
                 __LOG(LOG_SRC_APP, LOG_LEVEL_WARN, "BLEAM storage full!\r\n");
@@ -1642,22 +2729,84 @@ static void process_scan_data(ble_gap_evt_adv_report_t const *p_adv_report) {
             __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Scanned iOS RSSI %d\r\n", (int8_t)p_adv_report->rssi);
             uint8_t aoa = 0;
             if(app_blesc_save_rssi_to_storage(uuid_index, &p_adv_report->rssi, &aoa)) {
-                scan_stop();
-                try_bleam_connect(uuid_index);
+                if (!blesc_replay_active()) {
+                    scan_stop();
+                }
+                conn_scheduler_build(false);
+                conn_scheduler_next();
             }
         } else {
             if(mac_in_blacklist(p_adv_report->peer_addr.addr))
                 return;
-            app_timer_stop(m_eco_timer_id);
-            stupid_ios_data.active = 1;
+            if (!blesc_replay_active()) {
+                blesc_wakeup_stop(m_eco_timer_id);
+                blesc_scan_tune_report();
+            }
+            stupid_ios_data.state = IOS_STATE_DISCOVER;
             memcpy(stupid_ios_data.mac, p_adv_report->peer_addr.addr, BLE_GAP_ADDR_LEN);
             stupid_ios_data.rssi = p_adv_report->rssi;
             stupid_ios_data.aoa = NULL;
-            scan_stop();
+            if (!blesc_replay_active()) {
+                scan_stop();
+            }
             try_ios_connect();
         }
+        break;
+    }
+
+    default:
+        ++m_scan_stats.ignored;
+        break;
+    }
+}
+
+#if APP_CONFIG_SCAN_FILTER_ENABLED
+/**@brief Function for dropping advertising reports that can not be of interest.
+ * @ingroup bleam_scan
+ *
+ * @details Check only looks at report header, so most foreign advertisements in dense
+ *          RF environments are dropped without parsing their data. Both BLEAM and iOS
+ *          devices are connected to, so they always advertise connectably. Scan
+ *          responses are let through, since they carry no connectable flag.
+ *
+ * @param[in] p_adv_report    Pointer to the adv report.
+ *
+ * @returns Boolean value denoting if the report has to be parsed.
+ */
+static bool adv_report_prefilter(ble_gap_evt_adv_report_t const *p_adv_report) {
+    if (ADV_REPORT_MIN_LEN > p_adv_report->data.len) {
+        return false;
+    }
+    return p_adv_report->type.connectable || p_adv_report->type.scan_response;
+}
+#endif
+
+#if APP_CONFIG_ADV_CAPTURE_ENABLED
+/**@brief Function for copying an advertising report into capture buffer.
+ * @ingroup adv_capture
+ *
+ * @param[in] p_adv_report    Pointer to the adv report.
+ *
+ * @returns Nothing.
+ */
+static void adv_capture_record(ble_gap_evt_adv_report_t const *p_adv_report) {
+    if (m_adv_replay_active || APP_CONFIG_ADV_CAPTURE_SIZE <= m_adv_capture_cnt) {
+        return;
     }
+    blesc_adv_capture_t * p_rec = &m_adv_capture[m_adv_capture_cnt++];
+    p_rec->timestamp = blesc_ticks_now();
+    memcpy(p_rec->peer_addr, p_adv_report->peer_addr.addr, BLE_GAP_ADDR_LEN);
+    p_rec->addr_type = p_adv_report->peer_addr.addr_type;
+    p_rec->rssi = p_adv_report->rssi;
+    p_rec->ch_index = p_adv_report->ch_index;
+    p_rec->type = (p_adv_report->type.connectable   << 0) |
+                  (p_adv_report->type.scannable     << 1) |
+                  (p_adv_report->type.directed      << 2) |
+                  (p_adv_report->type.scan_response << 3);
+    p_rec->data_len = MIN(p_adv_report->data.len, NRF_BLE_SCAN_BUFFER);
+    memcpy(p_rec->data, p_adv_report->data.p_data, p_rec->data_len);
 }
+#endif
 
 /**@brief Function for handling Scanning events.
  * @ingroup bleam_scan
@@ -1689,7 +2838,21 @@ static void scan_evt_handler(scan_evt_t const *p_scan_evt) {
     } break;
 
     case NRF_BLE_SCAN_EVT_NOT_FOUND:
+#if APP_CONFIG_ADV_CAPTURE_ENABLED
+        adv_capture_record(p_scan_evt->params.p_not_found);
+#endif
+        ++m_scan_stats.received;
+#if APP_CONFIG_SCAN_FILTER_ENABLED
+        if (!adv_report_prefilter(p_scan_evt->params.p_not_found)) {
+            ++m_scan_stats.filtered;
+            break;
+        }
+#endif
         process_scan_data(p_scan_evt->params.p_not_found);
+        // Report may have opened the window, unless scanning stopped for a connection
+        if (blesc_scan_tune_changed()) {
+            scan_tune_apply();
+        }
         break;
     default:
         __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Scan over event\r\n");
@@ -1699,6 +2862,128 @@ static void scan_evt_handler(scan_evt_t const *p_scan_evt) {
 
 /** @} end of handlers */
 
+#if APP_CONFIG_ADV_CAPTURE_ENABLED
+/*********************** ADVERTISING CAPTURE **********************/
+
+/**@addtogroup adv_capture
+ * @{
+ */
+
+/**@brief Function for dumping captured advertising reports to log.
+ *
+ * @returns Nothing.
+ */
+static void adv_capture_dump(void) {
+    for (uint16_t index = 0; m_adv_capture_cnt > index; ++index) {
+        const blesc_adv_capture_t * p_rec = &m_adv_capture[index];
+        __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "CAP %u t=%u ch=%u rssi=%d type=%X %02x-%02x-%02x-%02x-%02x-%02x/%u\r\n",
+              index, p_rec->timestamp, p_rec->ch_index, p_rec->rssi, p_rec->type,
+              p_rec->peer_addr[5], p_rec->peer_addr[4], p_rec->peer_addr[3],
+              p_rec->peer_addr[2], p_rec->peer_addr[1], p_rec->peer_addr[0], p_rec->addr_type);
+        __LOG_XB(LOG_SRC_APP, LOG_LEVEL_INFO, "CAP data", p_rec->data, p_rec->data_len);
+    }
+}
+
+/**@brief Function for replaying captured advertising reports through the scan pipeline.
+ *
+ * @details Reports are fed to @ref scan_evt_handler() in capture order, with
+ *          @ref blesc_ticks_now() returning capture timestamps. Replay starts
+ *          from empty storage and iOS candidate. BLEAM storage, iOS candidate,
+ *          iOS MAC registry, connection scheduler and scan counters are saved
+ *          before and restored after replay, scanner and timers are not
+ *          touched, see @ref blesc_replay_active().
+ *
+ * @returns Nothing.
+ */
+static void adv_capture_replay(void) {
+    ble_gap_evt_adv_report_t report;
+    scan_evt_t scan_evt = {
+        .scan_evt_id = NRF_BLE_SCAN_EVT_NOT_FOUND,
+        .params.p_not_found = &report,
+    };
+
+    adv_capture_dump();
+
+    // DWT cycle counter measures processing cost
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Save field state that replay goes through
+    memcpy(m_adv_replay_rssi_data, bleam_rssi_data, sizeof(bleam_rssi_data));
+    memcpy(m_adv_replay_storage_hash, m_bleam_storage_hash, sizeof(m_bleam_storage_hash));
+    memcpy(m_adv_replay_storage_free, m_bleam_storage_free, sizeof(m_bleam_storage_free));
+    const uint16_t storage_free_cnt = m_bleam_storage_free_cnt;
+    const uint32_t rssi_jitter_state = m_rssi_jitter_state;
+    const bleam_ios_rssi_data_t ios_data = stupid_ios_data;
+    const blesc_scan_stats_t scan_stats = m_scan_stats;
+    memcpy(m_adv_replay_maclist, m_maclist, sizeof(m_maclist));
+    const uint16_t maclist_cnt = m_maclist_cnt;
+    const uint16_t conn_queue_len = m_conn_queue_len;
+    const uint16_t conn_queue_pos = m_conn_queue_pos;
+    uint16_t conn_queue[APP_CONFIG_MAX_BLEAMS];
+    memcpy(conn_queue, m_conn_queue, sizeof(conn_queue));
+
+    memset(&m_adv_replay_stats, 0, sizeof(m_adv_replay_stats));
+    memset(&m_scan_stats, 0, sizeof(m_scan_stats));
+    memset(&stupid_ios_data, 0, sizeof(bleam_ios_rssi_data_t));
+    bleam_storage_init();
+    m_adv_replay_active = true;
+
+    for (uint16_t index = 0; m_adv_capture_cnt > index; ++index) {
+        const blesc_adv_capture_t * p_rec = &m_adv_capture[index];
+        memset(&report, 0, sizeof(report));
+        memcpy(report.peer_addr.addr, p_rec->peer_addr, BLE_GAP_ADDR_LEN);
+        report.peer_addr.addr_type = p_rec->addr_type;
+        report.rssi = p_rec->rssi;
+        report.ch_index = p_rec->ch_index;
+        report.type.connectable   = (p_rec->type >> 0) & 1;
+        report.type.scannable     = (p_rec->type >> 1) & 1;
+        report.type.directed      = (p_rec->type >> 2) & 1;
+        report.type.scan_response = (p_rec->type >> 3) & 1;
+        report.data.p_data = (uint8_t *)p_rec->data;
+        report.data.len = p_rec->data_len;
+        m_adv_replay_ticks = p_rec->timestamp;
+
+        const uint32_t cycles_start = DWT->CYCCNT;
+        scan_evt_handler(&scan_evt);
+        const uint32_t cycles = DWT->CYCCNT - cycles_start;
+
+        ++m_adv_replay_stats.reports;
+        m_adv_replay_stats.cycles_total += cycles;
+        m_adv_replay_stats.cycles_max = MAX(m_adv_replay_stats.cycles_max, cycles);
+        m_adv_replay_stats.storage_used_max = MAX(m_adv_replay_stats.storage_used_max,
+                                                  APP_CONFIG_MAX_BLEAMS - m_bleam_storage_free_cnt);
+    }
+
+    m_adv_replay_active = false;
+    m_adv_replay_done = true;
+
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "REPLAY: %u reports, %u cycles avg, %u cycles max\r\n",
+          m_adv_replay_stats.reports,
+          m_adv_replay_stats.cycles_total / MAX(m_adv_replay_stats.reports, 1),
+          m_adv_replay_stats.cycles_max);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "REPLAY: %u connection attempts, %u BLEAMs in storage at most\r\n",
+          m_adv_replay_stats.connect_attempts, m_adv_replay_stats.storage_used_max);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "REPLAY: %u filtered, %u ignored, %u BLEAM, %u iOS\r\n",
+          m_scan_stats.filtered, m_scan_stats.ignored, m_scan_stats.bleam, m_scan_stats.apple);
+
+    memcpy(bleam_rssi_data, m_adv_replay_rssi_data, sizeof(bleam_rssi_data));
+    memcpy(m_bleam_storage_hash, m_adv_replay_storage_hash, sizeof(m_bleam_storage_hash));
+    memcpy(m_bleam_storage_free, m_adv_replay_storage_free, sizeof(m_bleam_storage_free));
+    m_bleam_storage_free_cnt = storage_free_cnt;
+    m_rssi_jitter_state = rssi_jitter_state;
+    stupid_ios_data = ios_data;
+    m_scan_stats = scan_stats;
+    memcpy(m_maclist, m_adv_replay_maclist, sizeof(m_maclist));
+    m_maclist_cnt = maclist_cnt;
+    memcpy(m_conn_queue, conn_queue, sizeof(conn_queue));
+    m_conn_queue_len = conn_queue_len;
+    m_conn_queue_pos = conn_queue_pos;
+}
+
+/** @} end of adv_capture */
+#endif
+
 /*************************  INITIALIZERS ***************************/
 
 /**@addtogroup initializers
@@ -1724,44 +3009,50 @@ static void logging_init(void) {
  *
  * @details Besides initialising all main application timers, this function also
  *          sets initial system time values until the time is updated via BLEAM connection.
+ *          All timers share a single app_timer instance through @ref blesc_wakeup.
  *
  * @returns Nothing.
  */
 static void timers_init(void) {
-    m_system_time = BLESC_DAYTIME_START;
-    m_blesc_uptime = 0;
-    m_blesc_time_period = BLESC_TIME_PERIODS_DAY * BLESC_TIME_PERIOD_SECS;
-    m_system_time_needs_update = true;
+    blesc_time_sync_init(BLESC_DAYTIME_START * 1000);
+    blesc_duty_init();
+    m_blesc_time_period = blesc_duty_period_get(BLESC_DAYTIME_START);
     ret_code_t err_code = app_timer_init();
     APP_ERROR_CHECK(err_code);
+    err_code = blesc_wakeup_init();
+    APP_ERROR_CHECK(err_code);
 
-    // System time timer.
-    err_code = app_timer_create(&m_system_time_timer_id, APP_TIMER_MODE_REPEATED, system_time_timer_handler);
+    // System time timer, defines the period grid, so it has no tolerance.
+    err_code = blesc_wakeup_create(&m_system_time_timer_id, BLESC_WAKEUP_MODE_SINGLE_SHOT, 0, system_time_timer_handler);
     APP_ERROR_CHECK(err_code);
 
     // Timer for scan/connect cycle    
-    err_code = app_timer_create(&scan_connect_timer, APP_TIMER_MODE_SINGLE_SHOT, scan_connect_timer_handle);
+    err_code = blesc_wakeup_create(&scan_connect_timer, BLESC_WAKEUP_MODE_SINGLE_SHOT, WAKEUP_TOLERANCE, scan_connect_timer_handle);
+    APP_ERROR_CHECK(err_code);
+
+    // Scan window tuning timer.
+    err_code = blesc_wakeup_create(&m_scan_tune_timer_id, BLESC_WAKEUP_MODE_REPEATED, WAKEUP_TOLERANCE, scan_tune_timer_handler);
     APP_ERROR_CHECK(err_code);
 
     // BLEAM inactivity timer.
-    err_code = app_timer_create(&m_bleam_inactivity_timer_id, APP_TIMER_MODE_SINGLE_SHOT, bleam_inactivity_timeout_handler);
+    err_code = blesc_wakeup_create(&m_bleam_inactivity_timer_id, BLESC_WAKEUP_MODE_SINGLE_SHOT, WAKEUP_TOLERANCE, bleam_inactivity_timeout_handler);
     APP_ERROR_CHECK(err_code);
  
-    // Timer for blacklist
-    err_code = app_timer_create(&drop_blacklist_timer_id, APP_TIMER_MODE_REPEATED, drop_blacklist);
+    // Timer for iOS MAC registry expiry
+    err_code = blesc_wakeup_create(&m_maclist_timer_id, BLESC_WAKEUP_MODE_REPEATED, MACLIST_TOLERANCE, maclist_generation_handler);
     APP_ERROR_CHECK(err_code);
 
     // Eco timer.
-    err_code = app_timer_create(&m_eco_timer_id, APP_TIMER_MODE_SINGLE_SHOT, eco_timer_handler);
+    err_code = blesc_wakeup_create(&m_eco_timer_id, BLESC_WAKEUP_MODE_SINGLE_SHOT, WAKEUP_TOLERANCE, eco_timer_handler);
     APP_ERROR_CHECK(err_code);
 
-    // Eco watchdog timer.
-    err_code = app_timer_create(&m_eco_watchdog_timer_id, APP_TIMER_MODE_REPEATED, eco_watchdog_timer_handler);
+    // Watchdog wakeup timer, started in @ref wdt_init.
+    err_code = blesc_wakeup_create(&m_wdt_timer_id, BLESC_WAKEUP_MODE_SINGLE_SHOT, WAKEUP_TOLERANCE, wdt_timer_handler);
     APP_ERROR_CHECK(err_code);
 
-    // Start watchdog timer
-    app_timer_start(drop_blacklist_timer_id, MACLIST_TIMEOUT, NULL);
-    app_timer_start(m_system_time_timer_id, APP_TIMER_TICKS(1000), NULL);
+    err_code = blesc_wakeup_start(m_maclist_timer_id, MACLIST_TIMEOUT, NULL);
+    APP_ERROR_CHECK(err_code);
+    system_time_timer_schedule();
 }
 
 #if NRF_MODULE_ENABLED(DEBUG)
@@ -1883,6 +3174,8 @@ static void wdt_init() {
     err_code = nrf_drv_wdt_channel_alloc(&m_channel_id);
     APP_ERROR_CHECK(err_code);
     nrf_drv_wdt_enable();
+    err_code = blesc_wakeup_start(m_wdt_timer_id, WDT_FEED_INTERVAL, NULL);
+    APP_ERROR_CHECK(err_code);
 }
 
 /**@brief Function for initializing power management.
@@ -1929,26 +3222,28 @@ static void ble_stack_init(void) {
     err_code = nrf_sdh_ble_default_cfg_set(APP_BLE_CONN_CFG_TAG, &ram_start);
     APP_ERROR_CHECK(err_code);
 
+    // Let BLEAM uploads queue several write commands per connection event
+    ble_cfg_t ble_cfg;
+    memset(&ble_cfg, 0, sizeof(ble_cfg));
+    ble_cfg.conn_cfg.conn_cfg_tag = APP_BLE_CONN_CFG_TAG;
+    ble_cfg.conn_cfg.params.gattc_conn_cfg.write_cmd_tx_queue_size = APP_CONFIG_BLEAM_TX_QUEUE_SIZE;
+    err_code = sd_ble_cfg_set(BLE_CONN_CFG_GATTC, &ble_cfg, ram_start);
+    APP_ERROR_CHECK(err_code);
+
     // Enable BLE stack.
+    const uint32_t ram_start_link = ram_start;
     err_code = nrf_sdh_ble_enable(&ram_start);
+    // RAM_START in bleam_scanner_2.emProject has to match what SoftDevice reports here
+    if (ram_start_link != ram_start) {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_WARN, "SoftDevice RAM start is 0x%08X, needs 0x%08X\r\n", ram_start_link, ram_start);
+    }
     APP_ERROR_CHECK(err_code);
 
     // Register a handler for BLE events.
     NRF_SDH_BLE_OBSERVER(m_ble_observer, APP_BLE_OBSERVER_PRIO, ble_evt_handler, NULL);
-    
-    // Wait for random bytes
-    size_t cnt = 0;
-    for (; 100 > cnt; ++cnt) {
-        uint8_t bytes;
-        sd_rand_application_bytes_available_get(&bytes);
-        if(2 > bytes) {
-            nrf_delay_ms(100);
-        } else
-            break;
-    }
-    if(100 <= cnt) {
-        APP_ERROR_CHECK(NRF_ERROR_NO_MEM);
-    }
+
+    // Take whatever random bytes are ready, the rest is collected when idle
+    blesc_rng_pool_fill();
 }
 
 #ifndef BOARD_RUUVITAG_B
@@ -2031,19 +3326,56 @@ static void gap_params_init(void) {
     APP_ERROR_CHECK(err_code);
 }
 
+/**@brief Function for handling events from the GATT library.
+ * @ingroup bleam_connect
+ *
+ * @param[in] p_gatt    Pointer to GATT module instance.
+ * @param[in] p_evt     Pointer to GATT event.
+ *
+ * @returns Nothing.
+ */
+static void gatt_evt_handler(nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_t const * p_evt) {
+    switch (p_evt->evt_id) {
+    case NRF_BLE_GATT_EVT_ATT_MTU_UPDATED:
+        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "ATT MTU updated to %u\r\n", p_evt->params.att_mtu_effective);
+        bleam_service_discovery_att_mtu_set(p_evt->conn_handle, p_evt->params.att_mtu_effective);
+        if (p_evt->conn_handle == m_bleam_service_client.conn_handle) {
+            bleam_service_data_len_set(p_evt->params.att_mtu_effective - OPCODE_LENGTH - HANDLE_LENGTH);
+        }
+        break;
+
+    case NRF_BLE_GATT_EVT_DATA_LENGTH_UPDATED:
+        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "Data length updated to %u\r\n", p_evt->params.data_length);
+        break;
+
+    default:
+        break;
+    }
+}
+
 /**@brief Function for initializing the GATT library.
  * @ingroup bleam_connect
  *
+ * @details Larger ATT MTU and data length are requested on connections to BLEAM,
+ *          so that signature and RSSI data take fewer packets.
+ *          Peripheral connections keep default ATT MTU.
+ *
  * @returns Nothing.
  */
 static void gatt_init(void) {
     ret_code_t err_code;
 
-    err_code = nrf_ble_gatt_init(&m_gatt, NULL);
+    err_code = nrf_ble_gatt_init(&m_gatt, gatt_evt_handler);
     APP_ERROR_CHECK(err_code);
 
     err_code = nrf_ble_gatt_att_mtu_periph_set(&m_gatt, BLE_GATT_ATT_MTU_DEFAULT);
     APP_ERROR_CHECK(err_code);
+
+    err_code = nrf_ble_gatt_att_mtu_central_set(&m_gatt, NRF_SDH_BLE_GATT_MAX_MTU_SIZE);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = nrf_ble_gatt_data_length_set(&m_gatt, BLE_CONN_HANDLE_INVALID, NRF_SDH_BLE_GAP_DATA_LENGTH);
+    APP_ERROR_CHECK(err_code);
 }
 
 /**@brief Function for initializing basic services that will be used in all BLEAM Scanner modes.
@@ -2213,6 +3545,11 @@ static ret_code_t flash_config_load(void) {
     err_code = fds_record_close(&desc);
     APP_ERROR_CHECK(err_code);
 
+    sign_key_set(m_blesc_config.app_key);
+#if NRF_MODULE_ENABLED(DEBUG)
+    sign_data_benchmark(m_blesc_config.app_key);
+#endif
+
     return NRF_SUCCESS;
 }
 
@@ -2295,7 +3632,6 @@ static void fds_evt_handler(fds_evt_t const *p_evt) {
                 advertising_init();
                 __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "BLESc is waiting to be configured.\r\n");
                 advertising_start();
-                app_timer_start(m_eco_watchdog_timer_id, APP_TIMER_TICKS(1500), NULL);
             }
         }
         break;
@@ -2389,10 +3725,12 @@ int main(void) {
 
     // Initialize.
     logging_init();
+    bleam_storage_init();
     ble_stack_init();
     blesc_error_on_boot();
 
     timers_init();
+    blesc_energy_init(m_blesc_node_state);
 
 #ifndef BOARD_RUUVITAG_B
 #if NRF_MODULE_ENABLED(DEBUG)